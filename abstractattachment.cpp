@@ -2,10 +2,12 @@
 
 #include "./exceptions.h"
 #include "./mediafileinfo.h"
+#include "./memoryusage.h"
 #include "./progressfeedback.h"
 
 #include <c++utilities/io/copy.h>
 
+#include <algorithm>
 #include <memory>
 #include <sstream>
 
@@ -79,12 +81,44 @@ void StreamDataBlock::makeBuffer() const
 
 /*!
  * \brief Copies the data to the specified \a stream.
- * \remarks Makes use of the buffer allocated with makeBuffer() if this method has been called before.
+ * \remarks
+ * - Makes use of the buffer allocated with makeBuffer() if this method has been called before.
+ * - The specified \a stream might be the stream the data is read from (e.g. when a file is modified in-place). In this case
+ *   the data is copied in chunks if it is not located after the current write position. If the data is already located
+ *   at the current write position it is just skipped. Otherwise (the data would be overwritten before it has been read) the
+ *   data is read into a temporary buffer first.
  */
 void StreamDataBlock::copyTo(ostream &stream) const
 {
     if (buffer()) {
         stream.write(buffer().get(), static_cast<std::streamsize>(size()));
+    } else if (stream.rdbuf() == m_stream().rdbuf()) {
+        // copy within the same stream: the read position is the write position so it needs to be set before each read/write
+        auto writeOffset = static_cast<std::uint64_t>(stream.tellp());
+        if (writeOffset == startOffset()) {
+            stream.seekp(static_cast<std::streamoff>(endOffset()));
+            return;
+        }
+        auto &inputStream = m_stream();
+        if (writeOffset > startOffset()) {
+            auto data = std::unique_ptr<char[]>(new char[size()]);
+            inputStream.seekg(static_cast<std::streamoff>(startOffset()));
+            inputStream.read(data.get(), static_cast<std::streamsize>(size()));
+            stream.seekp(static_cast<std::streamoff>(writeOffset));
+            stream.write(data.get(), static_cast<std::streamsize>(size()));
+            return;
+        }
+        char buffer[0x2000];
+        for (auto readOffset = startOffset(), bytesLeft = size(); bytesLeft;) {
+            const auto chunkSize = std::min<std::uint64_t>(bytesLeft, sizeof(buffer));
+            inputStream.seekg(static_cast<std::streamoff>(readOffset));
+            inputStream.read(buffer, static_cast<std::streamsize>(chunkSize));
+            stream.seekp(static_cast<std::streamoff>(writeOffset));
+            stream.write(buffer, static_cast<std::streamsize>(chunkSize));
+            readOffset += chunkSize;
+            writeOffset += chunkSize;
+            bytesLeft -= chunkSize;
+        }
     } else {
         CopyHelper<0x2000> copyHelper;
         m_stream().seekg(static_cast<std::streamsize>(startOffset()));
@@ -137,6 +171,7 @@ AbstractAttachment::AbstractAttachment()
     : m_id(0)
     , m_isDataFromFile(false)
     , m_ignored(false)
+    , m_modified(true)
 {
 }
 
@@ -163,6 +198,22 @@ string AbstractAttachment::label() const
     return ss.str();
 }
 
+/*!
+ * \brief Adds the memory held by the attachment (except the object itself) to \a usage.
+ * \remarks The data is only accounted if it has been buffered (see StreamDataBlock::makeBuffer()).
+ */
+void AbstractAttachment::addMemoryUsage(MemoryUsage &usage) const
+{
+    usage.attachments += MemoryUsage::ofString(m_description) + MemoryUsage::ofString(m_name) + MemoryUsage::ofString(m_mimeType);
+    if (!m_data) {
+        return;
+    }
+    usage.attachments += m_isDataFromFile ? sizeof(FileDataBlock) : sizeof(StreamDataBlock);
+    if (m_data->buffer()) {
+        usage.attachments += static_cast<std::size_t>(m_data->size());
+    }
+}
+
 /*!
  * \brief Resets the object to its initial state.
  */
@@ -173,6 +224,7 @@ void AbstractAttachment::clear()
     m_mimeType.clear();
     m_id = 0;
     m_data.reset();
+    m_modified = true;
 }
 
 /*!
@@ -202,6 +254,7 @@ void AbstractAttachment::setFile(string_view path, Diagnostics &diag, AbortableP
     }
     m_data = std::move(file);
     m_isDataFromFile = true;
+    m_modified = true;
 }
 
 } // namespace TagParser
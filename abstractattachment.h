@@ -12,6 +12,7 @@ namespace TagParser {
 
 class AbortableProgressFeedback;
 class MediaFileInfo;
+struct MemoryUsage;
 
 class TAG_PARSER_EXPORT StreamDataBlock {
 public:
@@ -123,10 +124,13 @@ public:
     bool isIgnored() const;
     void setIgnored(bool ignored);
     bool isEmpty() const;
+    bool isModified() const;
+    void addMemoryUsage(MemoryUsage &usage) const;
 
 protected:
     explicit AbstractAttachment();
     virtual ~AbstractAttachment();
+    void setModified(bool modified);
 
 private:
     std::string m_description;
@@ -137,6 +141,7 @@ private:
     std::unique_ptr<AbstractAttachmentPrivate> m_p;
     bool m_isDataFromFile;
     bool m_ignored;
+    bool m_modified;
 };
 
 /*!
@@ -152,7 +157,10 @@ inline const std::string &AbstractAttachment::description() const
  */
 inline void AbstractAttachment::setDescription(std::string_view description)
 {
-    m_description = description;
+    if (m_description != description) {
+        m_description = description;
+        m_modified = true;
+    }
 }
 
 /*!
@@ -168,7 +176,10 @@ inline const std::string &AbstractAttachment::name() const
  */
 inline void AbstractAttachment::setName(std::string_view name)
 {
-    m_name = name;
+    if (m_name != name) {
+        m_name = name;
+        m_modified = true;
+    }
 }
 
 /*!
@@ -184,7 +195,10 @@ inline const std::string &AbstractAttachment::mimeType() const
  */
 inline void AbstractAttachment::setMimeType(std::string_view mimeType)
 {
-    m_mimeType = mimeType;
+    if (m_mimeType != mimeType) {
+        m_mimeType = mimeType;
+        m_modified = true;
+    }
 }
 
 /*!
@@ -200,7 +214,10 @@ inline std::uint64_t AbstractAttachment::id() const
  */
 inline void AbstractAttachment::setId(uint64_t id)
 {
-    m_id = id;
+    if (m_id != id) {
+        m_id = id;
+        m_modified = true;
+    }
 }
 
 /*!
@@ -224,6 +241,7 @@ inline void AbstractAttachment::setData(std::unique_ptr<StreamDataBlock> &&data)
 {
     m_data = std::move(data);
     m_isDataFromFile = false;
+    m_modified = true;
 }
 
 /*!
@@ -252,7 +270,10 @@ inline bool AbstractAttachment::isIgnored() const
  */
 inline void AbstractAttachment::setIgnored(bool ignored)
 {
-    m_ignored = ignored;
+    if (m_ignored != ignored) {
+        m_ignored = ignored;
+        m_modified = true;
+    }
 }
 
 /*!
@@ -264,6 +285,27 @@ inline bool AbstractAttachment::isEmpty() const
     return m_description.empty() && m_name.empty() && !m_mimeType.empty() && !m_data;
 }
 
+/*!
+ * \brief Returns whether the attachment has been altered since it has been parsed.
+ * \remarks
+ * - An attachment which has not been parsed (e.g. one created via MatroskaContainer::createAttachment()) is always considered modified.
+ * - Assigning a value equal to the present one is not considered a modification. Assigning data is always considered a modification.
+ * \sa MediaFileInfo::hasPendingChanges()
+ */
+inline bool AbstractAttachment::isModified() const
+{
+    return m_modified;
+}
+
+/*!
+ * \brief Sets whether the attachment is considered modified.
+ * \remarks Supposed to be called by the parser of the derived class once the attachment has been parsed.
+ */
+inline void AbstractAttachment::setModified(bool modified)
+{
+    m_modified = modified;
+}
+
 } // namespace TagParser
 
 #endif // TAG_PARSER_ABSTRACTATTACHMENT_H
@@ -1,5 +1,7 @@
 #include "./abstractcontainer.h"
 #include "./diagnostics.h"
+#include "./memoryusage.h"
+#include "./tracing.h"
 
 using namespace std;
 using namespace CppUtilities;
@@ -29,6 +31,7 @@ AbstractContainer::AbstractContainer(iostream &stream, std::uint64_t startOffset
     , m_tagsParsed(false)
     , m_tracksParsed(false)
     , m_tracksAltered(false)
+    , m_titlesAltered(false)
     , m_chaptersParsed(false)
     , m_attachmentsParsed(false)
     , m_startOffset(startOffset)
@@ -60,6 +63,7 @@ AbstractContainer::~AbstractContainer()
 void AbstractContainer::parseHeader(Diagnostics &diag, AbortableProgressFeedback &progress)
 {
     if (!isHeaderParsed()) {
+        TAG_PARSER_TRACE_SPAN("AbstractContainer::parseHeader");
         removeAllTags();
         removeAllTracks();
         internalParseHeader(diag, progress);
@@ -87,6 +91,7 @@ void AbstractContainer::parseHeader(Diagnostics &diag, AbortableProgressFeedback
 void AbstractContainer::parseTags(Diagnostics &diag, AbortableProgressFeedback &progress)
 {
     if (!areTagsParsed()) {
+        TAG_PARSER_TRACE_SPAN("AbstractContainer::parseTags");
         parseHeader(diag, progress);
         internalParseTags(diag, progress);
         m_tagsParsed = true;
@@ -111,6 +116,7 @@ void AbstractContainer::parseTags(Diagnostics &diag, AbortableProgressFeedback &
 void AbstractContainer::parseTracks(Diagnostics &diag, AbortableProgressFeedback &progress)
 {
     if (!areTracksParsed()) {
+        TAG_PARSER_TRACE_SPAN("AbstractContainer::parseTracks");
         parseHeader(diag, progress);
         internalParseTracks(diag, progress);
         m_tracksParsed = true;
@@ -131,6 +137,7 @@ void AbstractContainer::parseTracks(Diagnostics &diag, AbortableProgressFeedback
 void AbstractContainer::parseChapters(Diagnostics &diag, AbortableProgressFeedback &progress)
 {
     if (!areChaptersParsed()) {
+        TAG_PARSER_TRACE_SPAN("AbstractContainer::parseChapters");
         parseHeader(diag, progress);
         internalParseChapters(diag, progress);
         m_chaptersParsed = true;
@@ -150,6 +157,7 @@ void AbstractContainer::parseChapters(Diagnostics &diag, AbortableProgressFeedba
 void AbstractContainer::parseAttachments(Diagnostics &diag, AbortableProgressFeedback &progress)
 {
     if (!areAttachmentsParsed()) {
+        TAG_PARSER_TRACE_SPAN("AbstractContainer::parseAttachments");
         parseHeader(diag, progress);
         internalParseAttachments(diag, progress);
         m_attachmentsParsed = true;
@@ -165,9 +173,25 @@ void AbstractContainer::parseAttachments(Diagnostics &diag, AbortableProgressFee
  */
 void AbstractContainer::makeFile(Diagnostics &diag, AbortableProgressFeedback &progress)
 {
+    TAG_PARSER_TRACE_SPAN("AbstractContainer::makeFile");
     internalMakeFile(diag, progress);
 }
 
+/*!
+ * \brief Determines how makeFile() would apply the changes without actually altering the file.
+ * \remarks Elements of the original file might be parsed and buffered as makeFile() would do.
+ * \throws Throws std::ios_base::failure when an IO error occurs.
+ * \throws Throws TagParser::Failure or a derived exception when a parsing error occurs or planning is not implemented.
+ * \sa MediaFileInfo::planChanges()
+ */
+ChangePlan AbstractContainer::planChanges(Diagnostics &diag, AbortableProgressFeedback &progress)
+{
+    TAG_PARSER_TRACE_SPAN("AbstractContainer::planChanges");
+    auto plan = ChangePlan();
+    internalPlanChanges(plan, diag, progress);
+    return plan;
+}
+
 /*!
  * \brief Returns whether the implementation supports adding or removing of tracks.
  */
@@ -281,6 +305,22 @@ void AbstractContainer::internalMakeFile(Diagnostics &diag, AbortableProgressFee
     throw NotImplementedException();
 }
 
+/*!
+ * \brief Internally called to determine how the file would be made.
+ *
+ * Should be implemented along with internalMakeFile() using the same size and padding calculations. Must not alter the file.
+ *
+ * \throws Throws Failure or a derived class when a parsing error occurs.
+ * \throws Throws std::ios_base::failure when an IO error occurs.
+ */
+void AbstractContainer::internalPlanChanges(ChangePlan &plan, Diagnostics &diag, AbortableProgressFeedback &progress)
+{
+    CPP_UTILITIES_UNUSED(plan);
+    CPP_UTILITIES_UNUSED(diag);
+    CPP_UTILITIES_UNUSED(progress);
+    throw NotImplementedException();
+}
+
 /*!
  * \brief Creates and returns a tag for the specified \a target.
  * \remarks
@@ -519,6 +559,15 @@ size_t AbstractContainer::segmentCount() const
     return 1;
 }
 
+/*!
+ * \brief Adds the memory held by the container (except the object itself) to \a usage.
+ * \remarks This method is meant to be implemented when subclassing; the default implementation does nothing.
+ */
+void AbstractContainer::addMemoryUsage(MemoryUsage &usage) const
+{
+    CPP_UTILITIES_UNUSED(usage);
+}
+
 /*!
  * \brief Discards all parsing results.
  */
@@ -528,6 +577,7 @@ void AbstractContainer::reset()
     m_tagsParsed = false;
     m_tracksParsed = false;
     m_tracksAltered = false;
+    m_titlesAltered = false;
     m_chaptersParsed = false;
     m_attachmentsParsed = false;
     m_version = 0;
@@ -1,6 +1,7 @@
 #ifndef TAG_PARSER_ABSTRACTCONTAINER_H
 #define TAG_PARSER_ABSTRACTCONTAINER_H
 
+#include "./changeplan.h"
 #include "./exceptions.h"
 #include "./settings.h"
 #include "./tagtarget.h"
@@ -27,6 +28,7 @@ class AbstractAttachment;
 class Diagnostics;
 class AbortableProgressFeedback;
 struct AbstractContainerPrivate;
+struct MemoryUsage;
 
 class TAG_PARSER_EXPORT AbstractContainer {
 public:
@@ -44,6 +46,7 @@ public:
     void parseChapters(Diagnostics &diag, AbortableProgressFeedback &progress);
     void parseAttachments(Diagnostics &diag, AbortableProgressFeedback &progress);
     void makeFile(Diagnostics &diag, AbortableProgressFeedback &progress);
+    ChangePlan planChanges(Diagnostics &diag, AbortableProgressFeedback &progress);
 
     bool isHeaderParsed() const;
     bool areTagsParsed() const;
@@ -87,6 +90,8 @@ public:
     CppUtilities::DateTime creationTime() const;
     CppUtilities::DateTime modificationTime() const;
     std::uint32_t timeScale() const;
+    bool isModified() const;
+    virtual void addMemoryUsage(MemoryUsage &usage) const;
 
     virtual void reset();
 
@@ -99,6 +104,7 @@ protected:
     virtual void internalParseChapters(Diagnostics &diag, AbortableProgressFeedback &progress);
     virtual void internalParseAttachments(Diagnostics &diag, AbortableProgressFeedback &progress);
     virtual void internalMakeFile(Diagnostics &diag, AbortableProgressFeedback &progress);
+    virtual void internalPlanChanges(ChangePlan &plan, Diagnostics &diag, AbortableProgressFeedback &progress);
     std::vector<std::string> &muxingApplications();
     std::vector<std::string> &writingApplications();
 
@@ -117,6 +123,7 @@ protected:
     bool m_tagsParsed;
     bool m_tracksParsed;
     bool m_tracksAltered;
+    bool m_titlesAltered;
     bool m_chaptersParsed;
     bool m_attachmentsParsed;
 
@@ -276,7 +283,10 @@ inline const std::vector<std::string> &AbstractContainer::titles() const
  */
 inline void AbstractContainer::setTitle(std::string_view title, std::size_t segmentIndex)
 {
-    m_titles.at(segmentIndex) = title;
+    if (auto &presentTitle = m_titles.at(segmentIndex); presentTitle != title) {
+        presentTitle = title;
+        m_titlesAltered = true;
+    }
 }
 
 /*!
@@ -311,6 +321,16 @@ inline std::uint32_t AbstractContainer::timeScale() const
     return m_timeScale;
 }
 
+/*!
+ * \brief Returns whether tracks have been added/removed or titles have been altered since the container has been parsed.
+ * \remarks Modifications of tags, tracks and attachments themselves are tracked by the corresponding objects.
+ * \sa MediaFileInfo::hasPendingChanges()
+ */
+inline bool AbstractContainer::isModified() const
+{
+    return m_tracksAltered || m_titlesAltered;
+}
+
 } // namespace TagParser
 
 #endif // TAG_PARSER_ABSTRACTCONTAINER_H
@@ -1,6 +1,8 @@
 #include "./abstracttrack.h"
 #include "./exceptions.h"
 #include "./mediaformat.h"
+#include "./memoryusage.h"
+#include "./tracing.h"
 
 #include "./mp4/mp4ids.h"
 
@@ -242,16 +244,30 @@ string AbstractTrack::shortDescription() const
  */
 void AbstractTrack::parseHeader(Diagnostics &diag, AbortableProgressFeedback &progress)
 {
+    TAG_PARSER_TRACE_SPAN("AbstractTrack::parseHeader");
     m_flags -= TrackFlags::HeaderValid;
     m_istream->seekg(static_cast<streamoff>(m_startOffset), ios_base::beg);
     try {
         internalParseHeader(diag, progress);
         m_flags += TrackFlags::HeaderValid;
+        m_flags -= TrackFlags::Modified;
     } catch (const Failure &) {
         throw;
     }
 }
 
+/*!
+ * \brief Adds the memory held by the track (except the object itself) to \a usage.
+ * \remarks
+ * - Accounts the strings and the locale. Subclasses need to account further data such as sample tables.
+ * - The object itself is supposed to be accounted by the owner as only it knows the actual type.
+ */
+void AbstractTrack::addMemoryUsage(MemoryUsage &usage) const
+{
+    usage.tracks += MemoryUsage::ofString(m_formatId) + MemoryUsage::ofString(m_formatName) + MemoryUsage::ofString(m_name)
+        + MemoryUsage::ofString(m_compressorName) + MemoryUsage::ofLocale(m_locale);
+}
+
 /*!
  * \fn AbstractTrack::internalParseHeader()
  * \brief This method is internally called to parse header information.
@@ -14,6 +14,7 @@
 #include <c++utilities/io/binarywriter.h>
 #include <c++utilities/misc/flagenumclass.h>
 
+#include <algorithm>
 #include <iosfwd>
 #include <memory>
 #include <string>
@@ -25,6 +26,7 @@ class AbortableProgressFeedback;
 class MpegAudioFrameStream;
 class WaveAudioStream;
 class Mp4Track;
+struct MemoryUsage;
 
 /*!
  * \brief The TrackType enum specifies the underlying file type of a track and the concrete class of the track object.
@@ -55,6 +57,7 @@ enum class TrackFlags : std::uint64_t {
     UsedInPresentation = (1 << 7), /**< The track is supposed to be used in presentation. */
     UsedWhenPreviewing = (1 << 8), /**< The track is supposed to be used when previewing. */
     Interlaced = (1 << 9), /**< The video is interlaced. */
+    Modified = (1 << 10), /**< The track has been altered via one of the setters since its header has been parsed. */
 };
 
 /*!
@@ -183,6 +186,8 @@ public:
 
     void parseHeader(Diagnostics &diag, AbortableProgressFeedback &progress);
     bool isHeaderValid() const;
+    bool isModified() const;
+    virtual void addMemoryUsage(MemoryUsage &usage) const;
 
 protected:
     AbstractTrack(std::istream &inputStream, std::ostream &outputStream, std::uint64_t startOffset);
@@ -423,7 +428,10 @@ inline std::uint32_t AbstractTrack::trackNumber() const
  */
 inline void AbstractTrack::setTrackNumber(std::uint32_t trackNumber)
 {
-    m_trackNumber = trackNumber;
+    if (m_trackNumber != trackNumber) {
+        m_trackNumber = trackNumber;
+        m_flags += TrackFlags::Modified;
+    }
 }
 
 /*!
@@ -440,7 +448,10 @@ inline std::uint64_t AbstractTrack::id() const
  */
 inline void AbstractTrack::setId(std::uint64_t id)
 {
-    m_id = id;
+    if (m_id != id) {
+        m_id = id;
+        m_flags += TrackFlags::Modified;
+    }
 }
 
 /*!
@@ -457,7 +468,10 @@ inline const std::string AbstractTrack::name() const
  */
 inline void AbstractTrack::setName(std::string_view name)
 {
-    m_name = name;
+    if (m_name != name) {
+        m_name = name;
+        m_flags += TrackFlags::Modified;
+    }
 }
 
 /*!
@@ -516,7 +530,12 @@ inline const Locale &AbstractTrack::locale() const
  */
 inline void AbstractTrack::setLocale(const Locale &locale)
 {
-    m_locale = locale;
+    if (m_locale.size() != locale.size()
+        || !std::equal(m_locale.cbegin(), m_locale.cend(), locale.cbegin(),
+            [](const LocaleDetail &lhs, const LocaleDetail &rhs) { return lhs.format == rhs.format && lhs == rhs; })) {
+        m_locale = locale;
+        m_flags += TrackFlags::Modified;
+    }
 }
 
 /*!
@@ -627,7 +646,10 @@ inline const std::string &AbstractTrack::compressorName() const
  */
 inline void AbstractTrack::setCompressorName(std::string_view compressorName)
 {
-    m_compressorName = compressorName;
+    if (m_compressorName != compressorName) {
+        m_compressorName = compressorName;
+        m_flags += TrackFlags::Modified;
+    }
 }
 
 /*!
@@ -700,7 +722,10 @@ inline bool AbstractTrack::isEnabled() const
  */
 inline void AbstractTrack::setEnabled(bool enabled)
 {
-    CppUtilities::modFlagEnum(m_flags, TrackFlags::Enabled, enabled);
+    if (static_cast<bool>(m_flags & TrackFlags::Enabled) != enabled) {
+        CppUtilities::modFlagEnum(m_flags, TrackFlags::Enabled, enabled);
+        m_flags += TrackFlags::Modified;
+    }
 }
 
 /*!
@@ -717,7 +742,10 @@ inline bool AbstractTrack::isDefault() const
  */
 inline void AbstractTrack::setDefault(bool isDefault)
 {
-    CppUtilities::modFlagEnum(m_flags, TrackFlags::Default, isDefault);
+    if (static_cast<bool>(m_flags & TrackFlags::Default) != isDefault) {
+        CppUtilities::modFlagEnum(m_flags, TrackFlags::Default, isDefault);
+        m_flags += TrackFlags::Modified;
+    }
 }
 
 /*!
@@ -734,7 +762,10 @@ inline bool AbstractTrack::isForced() const
  */
 inline void AbstractTrack::setForced(bool forced)
 {
-    CppUtilities::modFlagEnum(m_flags, TrackFlags::Forced, forced);
+    if (static_cast<bool>(m_flags & TrackFlags::Forced) != forced) {
+        CppUtilities::modFlagEnum(m_flags, TrackFlags::Forced, forced);
+        m_flags += TrackFlags::Modified;
+    }
 }
 
 /*!
@@ -777,6 +808,16 @@ inline bool AbstractTrack::isHeaderValid() const
     return m_flags & TrackFlags::HeaderValid;
 }
 
+/*!
+ * \brief Returns whether the track has been altered via one of the setters since its header has been parsed.
+ * \remarks Assigning a value equal to the present one is not considered a modification.
+ * \sa MediaFileInfo::hasPendingChanges()
+ */
+inline bool AbstractTrack::isModified() const
+{
+    return m_flags & TrackFlags::Modified;
+}
+
 } // namespace TagParser
 
 #endif // TAG_PARSER_ABSTRACTTRACK_H
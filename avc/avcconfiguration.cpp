@@ -91,10 +91,8 @@ void AvcConfiguration::parse(BinaryReader &reader, std::uint64_t maxSize, Diagno
 
     // log parsing errors
     if (ignoredSpsEntries || ignoredPpsEntries) {
-        diag.emplace_back(DiagLevel::Debug,
-            argsToString(
-                "Ignored ", ignoredSpsEntries, " SPS entries and ", ignoredPpsEntries, " PPS entries. This AVC config is likely just not supported."),
-            "parsing AVC config");
+        diag.emplaceFormatted(DiagLevel::Debug, "parsing AVC config", "Ignored ", ignoredSpsEntries, " SPS entries and ", ignoredPpsEntries,
+            " PPS entries. This AVC config is likely just not supported.");
     }
 
     // ignore remaining data
@@ -0,0 +1,246 @@
+#include "./batchscanner.h"
+#include "./exceptions.h"
+#include "./progressfeedback.h"
+#include "./threadjoiner.h"
+
+#include <c++utilities/conversion/stringbuilder.h>
+
+#include <algorithm>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+using namespace CppUtilities;
+
+namespace TagParser {
+
+/// \cond
+namespace {
+
+/*!
+ * \brief The WorkRange struct holds the indices of the files not yet taken by a certain worker.
+ *
+ * The owning worker takes indices from the front of its range. Idle workers steal the back half of the range of
+ * another worker. This way each worker processes mostly consecutive files (which are usually close to each other on
+ * disk) and workers only contend on the mutexes when running out of work.
+ */
+struct WorkRange {
+    std::mutex mutex;
+    std::size_t begin = 0;
+    std::size_t end = 0;
+};
+
+/*!
+ * \brief Takes the next index for the worker with the specified \a workerIndex; steals from other workers if necessary.
+ * \returns Returns whether an index could be taken; returns false if there is no work left.
+ */
+bool takeWork(std::vector<WorkRange> &ranges, std::size_t workerIndex, std::size_t &index)
+{
+    auto &ownRange = ranges[workerIndex];
+    {
+        const auto lock = std::lock_guard<std::mutex>(ownRange.mutex);
+        if (ownRange.begin < ownRange.end) {
+            index = ownRange.begin++;
+            return true;
+        }
+    }
+    for (auto offset = std::size_t(1); offset < ranges.size(); ++offset) {
+        auto &victimRange = ranges[(workerIndex + offset) % ranges.size()];
+        auto stolenBegin = std::size_t(), stolenEnd = std::size_t();
+        {
+            const auto lock = std::lock_guard<std::mutex>(victimRange.mutex);
+            if (victimRange.begin >= victimRange.end) {
+                continue;
+            }
+            stolenEnd = victimRange.end;
+            stolenBegin = victimRange.end -= (victimRange.end - victimRange.begin + 1) / 2;
+        }
+        const auto lock = std::lock_guard<std::mutex>(ownRange.mutex);
+        ownRange.begin = stolenBegin + 1;
+        ownRange.end = stolenEnd;
+        index = stolenBegin;
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+/// \endcond
+
+/*!
+ * \class TagParser::BatchScanner
+ * \brief The BatchScanner class parses a batch of files in parallel.
+ *
+ * The files are parsed via MediaFileInfo using a pool of threads. The paths are distributed evenly over the threads
+ * upfront; threads running out of work steal from others so slow files (e.g. due to a full parse or a slow device) do
+ * not stall the whole batch. Each file is only open while it is parsed so the number of open files never exceeds the
+ * number of threads (which can be limited further via setMaxOpenFiles()).
+ *
+ * The results are passed to a callback as soon as a file has been parsed, so they are not necessarily passed in the
+ * order of the specified paths (see BatchScanResult::index). The callback is never invoked concurrently so it does not
+ * need to care about synchronization itself. However, it should return quickly as it blocks other threads from passing
+ * their results.
+ */
+
+/*!
+ * \brief Constructs a new BatchScanner parsing files up to the specified \a depth.
+ */
+BatchScanner::BatchScanner(ParsingDepth depth)
+    : m_depth(depth)
+    , m_threadCount(0)
+    , m_maxOpenFiles(0)
+    , m_fileHandlingFlags(MediaFileInfo().fileHandlingFlags())
+    , m_minDiagLevel(DiagLevel::None)
+{
+}
+
+/*!
+ * \brief Parses the files with the specified \a paths and passes the results to the specified \a callback.
+ * \returns Returns the number of files which have been scanned.
+ * \throws Throws OperationAbortedException if \a progress has been aborted. Files which have already been scanned
+ *         are passed to the callback nevertheless. Exceptions thrown by \a callback are propagated as well; in this case
+ *         the scanning is stopped as if it had been aborted.
+ * \remarks
+ * - Errors which occur when parsing a file do not stop the scanning but are reported via BatchScanResult::diag. This
+ *   includes unexpected exceptions (e.g. std::bad_alloc) which are reported as critical messages.
+ * - If the system is unable to start as many threads as requested, the files are scanned by fewer threads.
+ * - The \a progress is updated only from the calling thread and only reports the overall percentage. Aborting it stops
+ *   all threads; files which are being parsed at this point are aborted as well and not passed to the callback.
+ */
+std::size_t BatchScanner::scan(const std::vector<std::string> &paths, const ResultCallback &callback, AbortableProgressFeedback &progress) const
+{
+    progress.nextStepOrStop("Scanning files ...", 0);
+    if (paths.empty()) {
+        return 0;
+    }
+
+    // determine number of threads
+    auto threadCount = m_threadCount ? m_threadCount : std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    if (m_maxOpenFiles) {
+        threadCount = std::min(threadCount, m_maxOpenFiles);
+    }
+    threadCount = std::max<std::size_t>(std::min(threadCount, paths.size()), 1);
+
+    // distribute paths evenly over the threads
+    auto ranges = std::vector<WorkRange>(threadCount);
+    for (auto i = std::size_t(0); i != threadCount; ++i) {
+        ranges[i].begin = paths.size() * i / threadCount;
+        ranges[i].end = paths.size() * (i + 1) / threadCount;
+    }
+
+    // scan files, pass the results to the callback (one at a time) and abort on the first exception thrown by the callback
+    // note: Checking whether the scanning has been aborted under the lock ensures no results are passed after aborting,
+    //       even if the callback itself aborts the scanning.
+    auto scannedFiles = ProgressCounter(progress, paths.size());
+    auto callbackMutex = std::mutex();
+    auto callbackException = std::exception_ptr();
+    const auto serializedCallback = ResultCallback([&](BatchScanResult &&result) {
+        const auto lock = std::lock_guard<std::mutex>(callbackMutex);
+        if (callbackException || progress.isAborted()) {
+            return;
+        }
+        try {
+            callback(std::move(result));
+        } catch (...) {
+            callbackException = std::current_exception();
+            progress.tryToAbort();
+        }
+    });
+    // note: Errors are reported per file so exceptions are only caught here if even reporting an error failed (e.g. std::bad_alloc)
+    //       or reporting the progress failed. They are treated like exceptions thrown by the callback.
+    const auto scanFiles = [&](std::size_t workerIndex, bool reportProgress) {
+        try {
+            for (auto index = std::size_t(); !progress.isAborted() && takeWork(ranges, workerIndex, index);) {
+                scanFile(paths[index], index, serializedCallback, progress);
+                scannedFiles.add();
+                if (reportProgress) {
+                    scannedFiles.report();
+                }
+            }
+        } catch (...) {
+            const auto lock = std::lock_guard<std::mutex>(callbackMutex);
+            if (!callbackException) {
+                callbackException = std::current_exception();
+            }
+            progress.tryToAbort();
+        }
+    };
+
+    // start additional threads; the calling thread scans files as well
+    // note: If the system is unable to start as many threads as requested, the work ranges of the missing threads are stolen
+    //       by the others. The ThreadJoiner joins the threads on every path, so it must be declared after all state they refer to.
+    auto workers = ThreadJoiner();
+    for (auto i = std::size_t(1); i < threadCount && workers.tryToStart(scanFiles, i, false); ++i) {
+    }
+    scanFiles(0, true);
+    workers.joinAll();
+    scannedFiles.reportNow();
+    if (callbackException) {
+        std::rethrow_exception(callbackException);
+    }
+    progress.stopIfAborted();
+    return scannedFiles.value();
+}
+
+/*!
+ * \brief Parses the file with the specified \a path and passes the result to the specified \a callback.
+ * \remarks Invoked from the threads of scan(). Uses its own AbortableProgressFeedback for parsing which is aborted
+ *          as soon as \a progress is aborted.
+ */
+void BatchScanner::scanFile(const std::string &path, std::size_t index, const ResultCallback &callback, AbortableProgressFeedback &progress) const
+{
+    static const auto context = DiagContext("scanning files");
+    auto result = BatchScanResult();
+    result.index = index;
+    auto &diag = result.diag;
+    diag.setMinLevel(m_minDiagLevel);
+    auto fileProgress = AbortableProgressFeedback([&progress](AbortableProgressFeedback &feedback) {
+        if (progress.isAborted()) {
+            feedback.tryToAbort();
+        }
+    });
+    try {
+        result.fileInfo = std::make_unique<MediaFileInfo>(path);
+        auto &fileInfo = *result.fileInfo;
+        fileInfo.setFileHandlingFlags(m_fileHandlingFlags);
+        fileInfo.setTagFieldFilter(m_tagFieldFilter);
+        fileInfo.open(true);
+        switch (m_depth) {
+        case ParsingDepth::Container:
+            fileInfo.parseContainerFormat(diag, fileProgress);
+            break;
+        case ParsingDepth::Tracks:
+            fileInfo.parseContainerFormat(diag, fileProgress);
+            fileInfo.parseTracks(diag, fileProgress);
+            break;
+        case ParsingDepth::Tags:
+            fileInfo.parseContainerFormat(diag, fileProgress);
+            fileInfo.parseTracks(diag, fileProgress);
+            fileInfo.parseTags(diag, fileProgress);
+            break;
+        case ParsingDepth::Everything:
+            fileInfo.parseEverything(diag, fileProgress);
+            break;
+        }
+    } catch (const OperationAbortedException &) {
+        fileProgress.tryToAbort();
+    } catch (const Failure &) {
+        diag.emplace_back(DiagLevel::Critical, "Unable to parse the file.", context);
+    } catch (const std::ios_base::failure &failure) {
+        diag.emplace_back(DiagLevel::Critical, argsToString("An IO error occurred: ", failure.what()), context);
+    } catch (const std::exception &e) {
+        diag.emplace_back(DiagLevel::Critical, argsToString("An unexpected error occurred: ", e.what()), context);
+    } catch (...) {
+        diag.emplace_back(DiagLevel::Critical, "An unknown error occurred.", context);
+    }
+    if (result.fileInfo) {
+        result.fileInfo->close();
+    }
+    if (fileProgress.isAborted() || progress.isAborted()) {
+        return;
+    }
+    callback(std::move(result));
+}
+
+} // namespace TagParser
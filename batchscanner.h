@@ -0,0 +1,181 @@
+#ifndef TAG_PARSER_BATCHSCANNER_H
+#define TAG_PARSER_BATCHSCANNER_H
+
+#include "./diagnostics.h"
+#include "./mediafileinfo.h"
+#include "./tagfieldfilter.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace TagParser {
+
+class AbortableProgressFeedback;
+
+/*!
+ * \brief The ParsingDepth enum specifies which parts of a file are parsed by the BatchScanner.
+ */
+enum class ParsingDepth : std::uint8_t {
+    Container, /**< only the container format is parsed (see MediaFileInfo::parseContainerFormat()) */
+    Tracks, /**< the container format and the tracks are parsed (see MediaFileInfo::parseTracks()) */
+    Tags, /**< the container format, the tracks and the tags are parsed (see MediaFileInfo::parseTags()) */
+    Everything, /**< everything is parsed (see MediaFileInfo::parseEverything()) */
+};
+
+/*!
+ * \brief The BatchScanResult struct holds the result of scanning a single file via the BatchScanner.
+ */
+struct TAG_PARSER_EXPORT BatchScanResult {
+    /// \brief The index of the file within the paths passed to BatchScanner::scan().
+    std::size_t index = 0;
+    /// \brief The parsed file; it has already been closed. It is only null if it could not be constructed (see \a diag).
+    std::unique_ptr<MediaFileInfo> fileInfo;
+    /// \brief The diagnostic messages emitted when parsing the file.
+    Diagnostics diag;
+};
+
+class TAG_PARSER_EXPORT BatchScanner {
+public:
+    using ResultCallback = std::function<void(BatchScanResult &&result)>;
+
+    explicit BatchScanner(ParsingDepth depth = ParsingDepth::Tags);
+
+    ParsingDepth depth() const;
+    void setDepth(ParsingDepth depth);
+    std::size_t threadCount() const;
+    void setThreadCount(std::size_t threadCount);
+    std::size_t maxOpenFiles() const;
+    void setMaxOpenFiles(std::size_t maxOpenFiles);
+    MediaFileHandlingFlags fileHandlingFlags() const;
+    void setFileHandlingFlags(MediaFileHandlingFlags flags);
+    const TagFieldFilter &tagFieldFilter() const;
+    void setTagFieldFilter(const TagFieldFilter &filter);
+    DiagLevel minDiagLevel() const;
+    void setMinDiagLevel(DiagLevel minDiagLevel);
+
+    std::size_t scan(const std::vector<std::string> &paths, const ResultCallback &callback, AbortableProgressFeedback &progress) const;
+
+private:
+    void scanFile(const std::string &path, std::size_t index, const ResultCallback &callback, AbortableProgressFeedback &progress) const;
+
+    ParsingDepth m_depth;
+    std::size_t m_threadCount;
+    std::size_t m_maxOpenFiles;
+    MediaFileHandlingFlags m_fileHandlingFlags;
+    TagFieldFilter m_tagFieldFilter;
+    DiagLevel m_minDiagLevel;
+};
+
+/*!
+ * \brief Returns which parts of the files are parsed.
+ */
+inline ParsingDepth BatchScanner::depth() const
+{
+    return m_depth;
+}
+
+/*!
+ * \brief Sets which parts of the files are parsed.
+ */
+inline void BatchScanner::setDepth(ParsingDepth depth)
+{
+    m_depth = depth;
+}
+
+/*!
+ * \brief Returns the number of threads to use for scanning.
+ * \remarks Zero (the default) means the number of threads is determined via std::thread::hardware_concurrency().
+ */
+inline std::size_t BatchScanner::threadCount() const
+{
+    return m_threadCount;
+}
+
+/*!
+ * \brief Sets the number of threads to use for scanning.
+ * \sa threadCount()
+ */
+inline void BatchScanner::setThreadCount(std::size_t threadCount)
+{
+    m_threadCount = threadCount;
+}
+
+/*!
+ * \brief Returns the max. number of files which are open at the same time.
+ * \remarks Zero (the default) means the number is only limited by the number of threads.
+ */
+inline std::size_t BatchScanner::maxOpenFiles() const
+{
+    return m_maxOpenFiles;
+}
+
+/*!
+ * \brief Sets the max. number of files which are open at the same time.
+ * \sa maxOpenFiles()
+ */
+inline void BatchScanner::setMaxOpenFiles(std::size_t maxOpenFiles)
+{
+    m_maxOpenFiles = maxOpenFiles;
+}
+
+/*!
+ * \brief Returns the flags which are assigned to each MediaFileInfo before parsing.
+ * \sa MediaFileInfo::setFileHandlingFlags()
+ */
+inline MediaFileHandlingFlags BatchScanner::fileHandlingFlags() const
+{
+    return m_fileHandlingFlags;
+}
+
+/*!
+ * \brief Sets the flags which are assigned to each MediaFileInfo before parsing.
+ * \remarks The results are closed before they are passed to the callback. So MediaFileInfo::reopen() needs to be
+ *          called on a result before accessing lazily loaded pictures (see MediaFileHandlingFlags::LoadPicturesLazily).
+ */
+inline void BatchScanner::setFileHandlingFlags(MediaFileHandlingFlags flags)
+{
+    m_fileHandlingFlags = flags;
+}
+
+/*!
+ * \brief Returns the filter which is assigned to each MediaFileInfo before parsing.
+ * \sa MediaFileInfo::setTagFieldFilter()
+ */
+inline const TagFieldFilter &BatchScanner::tagFieldFilter() const
+{
+    return m_tagFieldFilter;
+}
+
+/*!
+ * \brief Sets the filter which is assigned to each MediaFileInfo before parsing.
+ */
+inline void BatchScanner::setTagFieldFilter(const TagFieldFilter &filter)
+{
+    m_tagFieldFilter = filter;
+}
+
+/*!
+ * \brief Returns the minimum level of the diagnostic messages which are kept (by default all messages are kept).
+ * \sa Diagnostics::minLevel()
+ */
+inline DiagLevel BatchScanner::minDiagLevel() const
+{
+    return m_minDiagLevel;
+}
+
+/*!
+ * \brief Sets the minimum level of the diagnostic messages which are kept.
+ * \remarks Dropping e.g. information messages avoids formatting and storing them when scanning many files.
+ */
+inline void BatchScanner::setMinDiagLevel(DiagLevel minDiagLevel)
+{
+    m_minDiagLevel = minDiagLevel;
+}
+
+} // namespace TagParser
+
+#endif // TAG_PARSER_BATCHSCANNER_H
@@ -0,0 +1,354 @@
+#include "./batchwriter.h"
+#include "./exceptions.h"
+#include "./progressfeedback.h"
+#include "./threadjoiner.h"
+
+#include <c++utilities/conversion/stringbuilder.h>
+#include <c++utilities/conversion/stringconversion.h>
+#include <c++utilities/io/path.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+
+#ifdef PLATFORM_UNIX
+#include <sys/stat.h>
+#endif
+
+using namespace std;
+using namespace CppUtilities;
+
+namespace TagParser {
+
+/// \cond
+namespace {
+
+/*!
+ * \brief Returns an identifier for the device the file with the specified \a path is stored on.
+ * \remarks Returns an empty string if the device can not be determined so all such files are treated as if they
+ *          were stored on the same device.
+ */
+std::string deviceOf(const std::string &path)
+{
+#ifdef PLATFORM_UNIX
+    struct stat fileStat;
+    if (::stat(BasicFileInfo::pathForOpen(path).data(), &fileStat) == 0) {
+        return numberToString(static_cast<std::uint64_t>(fileStat.st_dev));
+    }
+    return std::string();
+#else
+    auto ec = std::error_code();
+    const auto absolutePath = std::filesystem::absolute(makeNativePath(BasicFileInfo::pathForOpen(path)), ec);
+    return ec ? std::string() : absolutePath.root_name().string();
+#endif
+}
+
+/*!
+ * \brief The DeviceState struct holds the rewrites of a certain device which are in progress and pending.
+ */
+struct DeviceState {
+    std::size_t activeRewrites = 0;
+    std::deque<BatchWriteResult> pendingRewrites;
+};
+
+} // namespace
+/// \endcond
+
+/*!
+ * \class TagParser::BatchWriter
+ * \brief The BatchWriter class applies changes to a batch of files in parallel.
+ *
+ * Each file is parsed via MediaFileInfo::parseEverything(). Then the edit callback is invoked to make the actual
+ * changes (e.g. assigning tag values or setting the padding). Then the changes are planned via MediaFileInfo::planChanges():
+ * - Files without pending changes are skipped. Note that padding and element positions not satisfying the settings count
+ *   as pending changes (see MediaFileInfo::hasPendingChanges()), so the edit callback should configure them as well.
+ * - Files which are supposed to be updated in-place are updated right away. This happens on all threads concurrently.
+ * - Files which need to be rewritten are queued per device. Only rewritesPerDevice() files are rewritten at the same
+ *   time on each device so expensive rewrites do not compete for the same disk.
+ *
+ * The results are passed to a callback as soon as the changes have been applied. Like BatchScanner, the callback is
+ * never invoked concurrently, so it does not need to care about synchronization itself. The edit callback however is
+ * invoked concurrently (for different files) and must therefore be thread-safe.
+ */
+
+/*!
+ * \brief Constructs a new BatchWriter.
+ */
+BatchWriter::BatchWriter()
+    : m_threadCount(0)
+    , m_rewritesPerDevice(1)
+    , m_fileHandlingFlags(MediaFileInfo().fileHandlingFlags())
+{
+    modFlagEnum(m_fileHandlingFlags, MediaFileHandlingFlags::ForceRewrite, false);
+}
+
+/*!
+ * \brief Parses the files with the specified \a paths, invokes \a edit on them, applies the changes and passes the
+ *        results to the specified \a callback.
+ * \returns Returns the number of files which have been processed.
+ * \throws Throws OperationAbortedException if \a progress has been aborted. Exceptions thrown by \a edit or \a callback
+ *         are propagated as well; in this case the processing is stopped as if it had been aborted. Only the first of
+ *         these exceptions is propagated.
+ * \remarks
+ * - Errors which occur when processing a file do not stop the processing of other files but are reported via
+ *   BatchWriteResult::diag. This includes unexpected exceptions (e.g. std::bad_alloc) which are reported as critical
+ *   messages.
+ * - If the system is unable to start as many threads as requested, the files are processed by fewer threads.
+ * - The \a progress is updated only from the calling thread. It reports the percentage of processed files.
+ * - Aborting \a progress stops all threads. Files which are being modified at this point are aborted as well (see
+ *   MediaFileInfo::applyChanges()) and are not passed to the callback. Files which have not been processed yet are
+ *   left untouched.
+ */
+std::size_t BatchWriter::write(
+    const std::vector<std::string> &paths, const EditCallback &edit, const ResultCallback &callback, AbortableProgressFeedback &progress) const
+{
+    static const auto context = DiagContext("applying changes to files");
+    progress.nextStepOrStop("Applying changes to files ...", 0);
+    if (paths.empty()) {
+        return 0;
+    }
+
+    // determine number of threads and how many rewrites may be pending (to limit the number of files kept in memory)
+    auto threadCount = m_threadCount ? m_threadCount : std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    threadCount = std::max<std::size_t>(std::min(threadCount, paths.size()), 1);
+    const auto rewritesPerDevice = std::max<std::size_t>(m_rewritesPerDevice, 1);
+    const auto maxPendingRewrites = threadCount * 4;
+
+    // define the state shared between all threads
+    auto mutex = std::mutex();
+    auto stateChanged = std::condition_variable();
+    auto devices = std::unordered_map<std::string, DeviceState>();
+    auto nextIndex = std::size_t(), pendingRewrites = std::size_t(), finishedThreads = std::size_t();
+    auto processedFileCount = std::atomic<std::size_t>(0);
+    auto callbackException = std::exception_ptr();
+
+    // define function to keep the first exception thrown by a callback (to rethrow it later) and to abort; must be called from a catch block
+    auto callbackMutex = std::mutex();
+    const auto abortDueToCallbackException = [&] {
+        if (!callbackException) {
+            callbackException = std::current_exception();
+        }
+        progress.tryToAbort();
+    };
+
+    // define function to pass a result to the callback (one at a time) and abort on the first exception thrown by the callback
+    const auto passResult = [&](BatchWriteResult &&result) {
+        const auto lock = std::lock_guard<std::mutex>(callbackMutex);
+        ++processedFileCount;
+        if (callbackException || progress.isAborted()) {
+            return;
+        }
+        try {
+            callback(std::move(result));
+        } catch (...) {
+            abortDueToCallbackException();
+        }
+    };
+
+    // define function to report exceptions which are not supposed to occur when parsing or applying changes
+    const auto reportUnexpectedException = [](Diagnostics &diag) {
+        try {
+            throw;
+        } catch (const std::exception &e) {
+            diag.emplace_back(DiagLevel::Critical, argsToString("An unexpected error occurred: ", e.what()), context);
+        } catch (...) {
+            diag.emplace_back(DiagLevel::Critical, "An unknown error occurred.", context);
+        }
+    };
+
+    // define function to parse and edit a file; returns the result only if a rewrite is required (and has been deferred)
+    const auto prepareFile = [&](std::size_t index) -> std::optional<BatchWriteResult> {
+        auto result = BatchWriteResult();
+        result.index = index;
+        auto &diag = result.diag;
+        auto fileProgress = AbortableProgressFeedback([&progress](AbortableProgressFeedback &feedback) {
+            if (progress.isAborted()) {
+                feedback.tryToAbort();
+            }
+        });
+        try {
+            result.fileInfo = std::make_unique<MediaFileInfo>(paths[index]);
+            auto &fileInfo = *result.fileInfo;
+            fileInfo.setFileHandlingFlags(m_fileHandlingFlags);
+            fileInfo.open(true);
+            fileInfo.parseEverything(diag, fileProgress);
+            fileProgress.stopIfAborted();
+            try {
+                edit(fileInfo, diag);
+            } catch (...) {
+                const auto lock = std::lock_guard<std::mutex>(callbackMutex);
+                abortDueToCallbackException();
+                fileInfo.close();
+                return std::nullopt;
+            }
+            result.plan = fileInfo.planChanges(diag, fileProgress);
+            switch (result.plan.strategy) {
+            case ChangeStrategy::None:
+                break;
+            case ChangeStrategy::InPlace:
+                fileInfo.applyChanges(diag, fileProgress);
+                break;
+            case ChangeStrategy::Rewrite:
+                fileInfo.close();
+                return std::make_optional(std::move(result));
+            }
+        } catch (const OperationAbortedException &) {
+            fileProgress.tryToAbort();
+        } catch (const Failure &) {
+            diag.emplace_back(DiagLevel::Critical, "Unable to apply changes.", context);
+        } catch (const std::ios_base::failure &failure) {
+            diag.emplace_back(DiagLevel::Critical, argsToString("An IO error occurred: ", failure.what()), context);
+        } catch (...) {
+            reportUnexpectedException(diag);
+        }
+        if (result.fileInfo) {
+            result.fileInfo->close();
+        }
+        if (!fileProgress.isAborted()) {
+            passResult(std::move(result));
+        }
+        return std::nullopt;
+    };
+
+    // define function to rewrite a file which has been deferred
+    const auto rewriteFile = [&](BatchWriteResult &&result) {
+        auto &fileInfo = *result.fileInfo;
+        auto &diag = result.diag;
+        auto fileProgress = AbortableProgressFeedback([&progress](AbortableProgressFeedback &feedback) {
+            if (progress.isAborted()) {
+                feedback.tryToAbort();
+            }
+        });
+        try {
+            fileInfo.open(true);
+            fileInfo.applyChanges(diag, fileProgress);
+        } catch (const OperationAbortedException &) {
+            fileProgress.tryToAbort();
+        } catch (const Failure &) {
+            diag.emplace_back(DiagLevel::Critical, "Unable to apply changes.", context);
+        } catch (const std::ios_base::failure &failure) {
+            diag.emplace_back(DiagLevel::Critical, argsToString("An IO error occurred: ", failure.what()), context);
+        } catch (...) {
+            reportUnexpectedException(diag);
+        }
+        fileInfo.close();
+        if (!fileProgress.isAborted()) {
+            passResult(std::move(result));
+        }
+    };
+
+    // define function to defer the rewrite of a prepared file until a rewrite on its device may be started
+    // note: If deferring fails (e.g. std::bad_alloc) the file is reported as failed right away.
+    const auto deferRewrite = [&](std::unique_lock<std::mutex> &lock, BatchWriteResult &&result) {
+        try {
+            const auto deviceId = deviceOf(paths[result.index]);
+            lock.lock();
+            devices[deviceId].pendingRewrites.emplace_back(std::move(result));
+            ++pendingRewrites;
+            stateChanged.notify_all();
+        } catch (...) {
+            if (lock.owns_lock()) {
+                lock.unlock();
+            }
+            reportUnexpectedException(result.diag);
+            passResult(std::move(result));
+            lock.lock();
+        }
+    };
+
+    // define function for the threads: prefer starting rewrites (as they take long), otherwise prepare the next file
+    const auto processFilesUntilDone = [&] {
+        auto lock = std::unique_lock<std::mutex>(mutex);
+        while (!progress.isAborted()) {
+            const auto device = std::find_if(devices.begin(), devices.end(),
+                [&](const auto &entry) { return !entry.second.pendingRewrites.empty() && entry.second.activeRewrites < rewritesPerDevice; });
+            if (device != devices.end()) {
+                auto &deviceState = device->second;
+                auto result = std::move(deviceState.pendingRewrites.front());
+                deviceState.pendingRewrites.pop_front();
+                ++deviceState.activeRewrites;
+                --pendingRewrites;
+                lock.unlock();
+                rewriteFile(std::move(result));
+                lock.lock();
+                --deviceState.activeRewrites;
+                stateChanged.notify_all();
+                continue;
+            }
+            if (nextIndex < paths.size() && pendingRewrites < maxPendingRewrites) {
+                const auto index = nextIndex++;
+                lock.unlock();
+                if (auto deferredResult = prepareFile(index)) {
+                    deferRewrite(lock, std::move(*deferredResult));
+                } else {
+                    lock.lock();
+                }
+                continue;
+            }
+            if (nextIndex >= paths.size() && !pendingRewrites) {
+                break;
+            }
+            // wait until a rewrite has been finished or deferred; poll as aborting is not signalled via stateChanged
+            stateChanged.wait_for(lock, std::chrono::milliseconds(100));
+        }
+    };
+
+    // define function to run a thread; errors are reported per file so exceptions are only caught here if even reporting an
+    // error failed (e.g. std::bad_alloc) in which case they are treated like exceptions thrown by a callback
+    // note: The thread must be counted as finished in any case as the calling thread waits for it.
+    const auto processFiles = [&] {
+        try {
+            processFilesUntilDone();
+        } catch (...) {
+            const auto lock = std::lock_guard<std::mutex>(callbackMutex);
+            abortDueToCallbackException();
+        }
+        const auto lock = std::lock_guard<std::mutex>(mutex);
+        ++finishedThreads;
+        stateChanged.notify_all();
+    };
+
+    // start threads; continue with fewer threads if the system is unable to start as many threads as requested
+    // note: The ThreadJoiner joins the threads on every path, so it must be declared after all state the threads refer to.
+    auto workers = ThreadJoiner();
+    while (workers.count() != threadCount && workers.tryToStart(processFiles)) {
+    }
+    if (!workers.count()) {
+        processFiles();
+    }
+    const auto startedThreads = std::max<std::size_t>(workers.count(), 1);
+
+    // report the progress from the calling thread until all threads have finished; abort them if reporting fails
+    try {
+        auto reportedPercentage = std::uint8_t();
+        for (auto finished = false; !finished;) {
+            {
+                auto lock = std::unique_lock<std::mutex>(mutex);
+                finished = stateChanged.wait_for(lock, std::chrono::milliseconds(100), [&] { return finishedThreads == startedThreads; });
+            }
+            const auto percentage = static_cast<std::uint8_t>(processedFileCount.load() * 100 / paths.size());
+            if (percentage != reportedPercentage) {
+                progress.updateStepPercentage(reportedPercentage = percentage);
+            }
+        }
+    } catch (...) {
+        progress.tryToAbort();
+        throw;
+    }
+    workers.joinAll();
+    if (callbackException) {
+        std::rethrow_exception(callbackException);
+    }
+    progress.stopIfAborted();
+    return processedFileCount.load();
+}
+
+} // namespace TagParser
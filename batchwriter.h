@@ -0,0 +1,110 @@
+#ifndef TAG_PARSER_BATCHWRITER_H
+#define TAG_PARSER_BATCHWRITER_H
+
+#include "./diagnostics.h"
+#include "./mediafileinfo.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace TagParser {
+
+class AbortableProgressFeedback;
+
+/*!
+ * \brief The BatchWriteResult struct holds the result of applying changes to a single file via the BatchWriter.
+ */
+struct TAG_PARSER_EXPORT BatchWriteResult {
+    /// \brief The index of the file within the paths passed to BatchWriter::write().
+    std::size_t index = 0;
+    /// \brief The plan the changes have been applied according to; its strategy is ChangeStrategy::None if the file has been skipped.
+    ChangePlan plan;
+    /// \brief The file the changes have been applied to; it has already been closed. It is only null if it could not be constructed (see \a diag).
+    std::unique_ptr<MediaFileInfo> fileInfo;
+    /// \brief The diagnostic messages emitted when parsing the file and applying the changes.
+    Diagnostics diag;
+};
+
+class TAG_PARSER_EXPORT BatchWriter {
+public:
+    using EditCallback = std::function<void(MediaFileInfo &fileInfo, Diagnostics &diag)>;
+    using ResultCallback = std::function<void(BatchWriteResult &&result)>;
+
+    explicit BatchWriter();
+
+    std::size_t threadCount() const;
+    void setThreadCount(std::size_t threadCount);
+    std::size_t rewritesPerDevice() const;
+    void setRewritesPerDevice(std::size_t rewritesPerDevice);
+    MediaFileHandlingFlags fileHandlingFlags() const;
+    void setFileHandlingFlags(MediaFileHandlingFlags flags);
+
+    std::size_t write(
+        const std::vector<std::string> &paths, const EditCallback &edit, const ResultCallback &callback, AbortableProgressFeedback &progress) const;
+
+private:
+    std::size_t m_threadCount;
+    std::size_t m_rewritesPerDevice;
+    MediaFileHandlingFlags m_fileHandlingFlags;
+};
+
+/*!
+ * \brief Returns the number of threads to use for parsing files and applying changes.
+ * \remarks Zero (the default) means the number of threads is determined via std::thread::hardware_concurrency().
+ */
+inline std::size_t BatchWriter::threadCount() const
+{
+    return m_threadCount;
+}
+
+/*!
+ * \brief Sets the number of threads to use for parsing files and applying changes.
+ * \sa threadCount()
+ */
+inline void BatchWriter::setThreadCount(std::size_t threadCount)
+{
+    m_threadCount = threadCount;
+}
+
+/*!
+ * \brief Returns the max. number of files which are rewritten at the same time per device (by default 1).
+ */
+inline std::size_t BatchWriter::rewritesPerDevice() const
+{
+    return m_rewritesPerDevice;
+}
+
+/*!
+ * \brief Sets the max. number of files which are rewritten at the same time per device.
+ * \remarks Values smaller than 1 are treated as 1.
+ */
+inline void BatchWriter::setRewritesPerDevice(std::size_t rewritesPerDevice)
+{
+    m_rewritesPerDevice = rewritesPerDevice;
+}
+
+/*!
+ * \brief Returns the flags which are assigned to each MediaFileInfo before parsing.
+ * \remarks By default the flags of a default-constructed MediaFileInfo are used, except that a rewrite is *not* forced.
+ */
+inline MediaFileHandlingFlags BatchWriter::fileHandlingFlags() const
+{
+    return m_fileHandlingFlags;
+}
+
+/*!
+ * \brief Sets the flags which are assigned to each MediaFileInfo before parsing.
+ * \sa MediaFileInfo::setFileHandlingFlags()
+ */
+inline void BatchWriter::setFileHandlingFlags(MediaFileHandlingFlags flags)
+{
+    m_fileHandlingFlags = flags;
+}
+
+} // namespace TagParser
+
+#endif // TAG_PARSER_BATCHWRITER_H
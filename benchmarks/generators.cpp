@@ -0,0 +1,643 @@
+#include "./generators.h"
+
+#include "../matroska/ebmlelement.h"
+#include "../matroska/ebmlid.h"
+#include "../matroska/matroskaid.h"
+#include "../ogg/oggpage.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+using namespace std;
+
+namespace TagParser {
+namespace Benchmarks {
+
+/// \cond
+namespace {
+
+/*!
+ * \brief Appends the specified \a value as big-endian integer with the specified number of \a bytes to \a buffer.
+ * \remarks If \a bytes exceeds the size of \a value, zero bytes are prepended (useful for reserved fields).
+ */
+void appendBE(std::string &buffer, std::uint64_t value, std::size_t bytes)
+{
+    for (auto shift = bytes * 8; shift;) {
+        shift -= 8;
+        buffer += shift < 64 ? static_cast<char>((value >> shift) & 0xFF) : '\0';
+    }
+}
+
+/*!
+ * \brief Appends the specified \a value as little-endian integer with the specified number of \a bytes to \a buffer.
+ */
+void appendLE(std::string &buffer, std::uint64_t value, std::size_t bytes)
+{
+    for (auto shift = std::size_t(); shift != bytes * 8; shift += 8) {
+        buffer += static_cast<char>((value >> shift) & 0xFF);
+    }
+}
+
+/*!
+ * \brief Returns \a size bytes of pseudo-random data; the data only serves as filler so no particular codec is involved.
+ */
+std::string makePayload(std::size_t size, std::uint32_t seed)
+{
+    auto payload = std::string(size, '\0');
+    auto state = seed | 1u;
+    for (auto &byte : payload) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        byte = static_cast<char>(state >> 24);
+    }
+    return payload;
+}
+
+/*!
+ * \brief Opens the file at the specified \a path for writing; failures are reported via std::ios_base::failure.
+ */
+void openForWriting(std::ofstream &file, const std::string &path)
+{
+    file.exceptions(std::ios_base::failbit | std::ios_base::badbit);
+    file.open(path, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+}
+
+// MP4
+
+std::string makeAtom(std::string_view id, std::string_view content)
+{
+    auto atom = std::string();
+    atom.reserve(8 + content.size());
+    appendBE(atom, 8 + content.size(), 4);
+    atom += id;
+    atom += content;
+    return atom;
+}
+
+std::string makeFullAtom(std::string_view id, std::uint8_t version, std::uint32_t flags, std::string_view content)
+{
+    auto fullContent = std::string();
+    fullContent.reserve(4 + content.size());
+    appendBE(fullContent, version, 1);
+    appendBE(fullContent, flags, 3);
+    fullContent += content;
+    return makeAtom(id, fullContent);
+}
+
+void appendMatrix(std::string &buffer)
+{
+    for (const auto value : { 0x00010000u, 0u, 0u, 0u, 0x00010000u, 0u, 0u, 0u, 0x40000000u }) {
+        appendBE(buffer, value, 4);
+    }
+}
+
+constexpr std::uint32_t mp4MovieTimeScale = 1000;
+constexpr std::uint32_t mp4MediaTimeScale = 44100;
+constexpr std::uint32_t mp4SampleDuration = 1024;
+
+std::string makeMp4Header(bool fragmented)
+{
+    auto content = std::string();
+    content += "isom";
+    appendBE(content, 0x200, 4);
+    content += fragmented ? "isomiso6mp41" : "isomiso2mp41";
+    return makeAtom("ftyp", content);
+}
+
+std::string makeMp4Track(std::size_t trackIndex, const GeneratorParameters &parameters, const std::vector<std::uint64_t> &chunkOffsets, bool co64)
+{
+    const auto sampleCount = chunkOffsets.size();
+    const auto mediaDuration = static_cast<std::uint64_t>(parameters.clusterCount) * mp4SampleDuration;
+    const auto movieDuration = mediaDuration * mp4MovieTimeScale / mp4MediaTimeScale;
+
+    auto tkhd = std::string();
+    appendBE(tkhd, 0, 8); // creation and modification time
+    appendBE(tkhd, trackIndex + 1, 4); // track ID
+    appendBE(tkhd, 0, 4); // reserved
+    appendBE(tkhd, movieDuration, 4);
+    appendBE(tkhd, 0, 8); // reserved
+    appendBE(tkhd, 0, 4); // layer and alternate group
+    appendBE(tkhd, 0x0100, 2); // volume
+    appendBE(tkhd, 0, 2); // reserved
+    appendMatrix(tkhd);
+    appendBE(tkhd, 0, 8); // width and height
+
+    auto mdhd = std::string();
+    appendBE(mdhd, 0, 8); // creation and modification time
+    appendBE(mdhd, mp4MediaTimeScale, 4);
+    appendBE(mdhd, mediaDuration, 4);
+    appendBE(mdhd, (('u' - 0x60) << 10) | (('n' - 0x60) << 5) | ('d' - 0x60), 2); // language
+    appendBE(mdhd, 0, 2); // pre-defined
+
+    auto hdlr = std::string();
+    appendBE(hdlr, 0, 4); // pre-defined
+    hdlr += "soun";
+    appendBE(hdlr, 0, 12); // reserved
+    hdlr += "SoundHandler";
+    hdlr += '\0';
+
+    auto smhd = std::string();
+    appendBE(smhd, 0, 4); // balance and reserved
+
+    auto dref = std::string();
+    appendBE(dref, 1, 4); // entry count
+    dref += makeFullAtom("url ", 0, 1, std::string_view());
+
+    auto mp4a = std::string();
+    appendBE(mp4a, 0, 6); // reserved
+    appendBE(mp4a, 1, 2); // data reference index
+    appendBE(mp4a, 0, 8); // version, revision level and vendor
+    appendBE(mp4a, 2, 2); // channel count
+    appendBE(mp4a, 16, 2); // sample size
+    appendBE(mp4a, 0, 4); // compression ID and packet size
+    appendBE(mp4a, static_cast<std::uint64_t>(mp4MediaTimeScale) << 16, 4);
+    auto stsd = std::string();
+    appendBE(stsd, 1, 4); // entry count
+    stsd += makeAtom("mp4a", mp4a);
+
+    auto stts = std::string(), stsc = std::string(), stsz = std::string(), stco = std::string();
+    appendBE(stts, sampleCount ? 1 : 0, 4);
+    appendBE(stsc, sampleCount ? 1 : 0, 4);
+    if (sampleCount) {
+        appendBE(stts, sampleCount, 4);
+        appendBE(stts, mp4SampleDuration, 4);
+        appendBE(stsc, 1, 4); // first chunk
+        appendBE(stsc, 1, 4); // samples per chunk
+        appendBE(stsc, 1, 4); // sample description index
+    }
+    appendBE(stsz, sampleCount ? parameters.blockSize : 0, 4);
+    appendBE(stsz, sampleCount, 4);
+    appendBE(stco, sampleCount, 4);
+    for (const auto offset : chunkOffsets) {
+        appendBE(stco, offset, co64 ? 8 : 4);
+    }
+
+    const auto stbl = makeAtom("stbl",
+        makeFullAtom("stsd", 0, 0, stsd) + makeFullAtom("stts", 0, 0, stts) + makeFullAtom("stsc", 0, 0, stsc) + makeFullAtom("stsz", 0, 0, stsz)
+            + makeFullAtom(co64 ? "co64" : "stco", 0, 0, stco));
+    const auto minf = makeAtom("minf", makeFullAtom("smhd", 0, 0, smhd) + makeAtom("dinf", makeFullAtom("dref", 0, 0, dref)) + stbl);
+    const auto mdia = makeAtom("mdia", makeFullAtom("mdhd", 0, 0, mdhd) + makeFullAtom("hdlr", 0, 0, hdlr) + minf);
+    return makeAtom("trak", makeFullAtom("tkhd", 0, 0x000003, tkhd) + mdia);
+}
+
+std::string makeMp4Movie(
+    const GeneratorParameters &parameters, const std::vector<std::vector<std::uint64_t>> &chunkOffsets, bool co64, bool fragmented)
+{
+    const auto movieDuration = static_cast<std::uint64_t>(parameters.clusterCount) * mp4SampleDuration * mp4MovieTimeScale / mp4MediaTimeScale;
+    auto mvhd = std::string();
+    appendBE(mvhd, 0, 8); // creation and modification time
+    appendBE(mvhd, mp4MovieTimeScale, 4);
+    appendBE(mvhd, movieDuration, 4);
+    appendBE(mvhd, 0x00010000, 4); // rate
+    appendBE(mvhd, 0x0100, 2); // volume
+    appendBE(mvhd, 0, 10); // reserved
+    appendMatrix(mvhd);
+    appendBE(mvhd, 0, 24); // pre-defined
+    appendBE(mvhd, parameters.trackCount + 1, 4); // next track ID
+
+    auto content = makeFullAtom("mvhd", 0, 0, mvhd);
+    if (fragmented) {
+        auto mehd = std::string(), mvex = std::string();
+        appendBE(mehd, movieDuration, 4);
+        mvex += makeFullAtom("mehd", 0, 0, mehd);
+        for (auto trackIndex = std::size_t(); trackIndex != parameters.trackCount; ++trackIndex) {
+            auto trex = std::string();
+            appendBE(trex, trackIndex + 1, 4); // track ID
+            appendBE(trex, 1, 4); // default sample description index
+            appendBE(trex, mp4SampleDuration, 4);
+            appendBE(trex, parameters.blockSize, 4);
+            appendBE(trex, 0, 4); // default sample flags
+            mvex += makeFullAtom("trex", 0, 0, trex);
+        }
+        content += makeAtom("mvex", mvex);
+    }
+    for (auto trackIndex = std::size_t(); trackIndex != parameters.trackCount; ++trackIndex) {
+        content += makeMp4Track(trackIndex, parameters, fragmented ? std::vector<std::uint64_t>() : chunkOffsets[trackIndex], co64);
+    }
+    return makeAtom("moov", content);
+}
+
+std::string makeMp4MediaDataHeader(std::uint64_t dataSize)
+{
+    auto header = std::string();
+    if (dataSize + 8 > 0xFFFFFFFFu) {
+        appendBE(header, 1, 4);
+        header += "mdat";
+        appendBE(header, dataSize + 16, 8);
+    } else {
+        appendBE(header, dataSize + 8, 4);
+        header += "mdat";
+    }
+    return header;
+}
+
+/*!
+ * \brief Generates an MP4 file; the media data is interleaved so each chunk holds one sample of one track.
+ */
+void generateMp4(const GeneratorParameters &parameters, std::ofstream &file)
+{
+    const auto ftyp = makeMp4Header(false);
+    const auto dataSize = static_cast<std::uint64_t>(parameters.clusterCount) * parameters.trackCount * parameters.blockSize;
+    const auto co64 = dataSize > 0xFFFFFFFFu - 0x100000u;
+    const auto mdatHeader = makeMp4MediaDataHeader(dataSize);
+
+    // determine size of "moov"-atom (which does not depend on the values of the chunk offsets) to compute the actual chunk offsets
+    auto chunkOffsets = std::vector<std::vector<std::uint64_t>>(parameters.trackCount, std::vector<std::uint64_t>(parameters.clusterCount));
+    const auto dataOffset = ftyp.size() + makeMp4Movie(parameters, chunkOffsets, co64, false).size() + mdatHeader.size();
+    for (auto chunk = std::size_t(); chunk != parameters.clusterCount; ++chunk) {
+        for (auto trackIndex = std::size_t(); trackIndex != parameters.trackCount; ++trackIndex) {
+            chunkOffsets[trackIndex][chunk]
+                = dataOffset + (static_cast<std::uint64_t>(chunk) * parameters.trackCount + trackIndex) * parameters.blockSize;
+        }
+    }
+
+    file << ftyp << makeMp4Movie(parameters, chunkOffsets, co64, false) << mdatHeader;
+    const auto payload = makePayload(parameters.blockSize, 0x4D503420u);
+    for (auto chunk = std::size_t(); chunk != parameters.clusterCount; ++chunk) {
+        for (auto trackIndex = std::size_t(); trackIndex != parameters.trackCount; ++trackIndex) {
+            file << payload;
+        }
+    }
+}
+
+/*!
+ * \brief Generates a fragmented MP4 file; each fragment holds one sample per track.
+ */
+void generateFragmentedMp4(const GeneratorParameters &parameters, std::ofstream &file)
+{
+    const auto makeMovieFragment = [&parameters](std::size_t sequenceNumber, std::uint64_t movieFragmentSize) {
+        auto mfhd = std::string();
+        appendBE(mfhd, sequenceNumber, 4);
+        auto content = makeFullAtom("mfhd", 0, 0, mfhd);
+        for (auto trackIndex = std::size_t(); trackIndex != parameters.trackCount; ++trackIndex) {
+            auto tfhd = std::string(), trun = std::string();
+            appendBE(tfhd, trackIndex + 1, 4); // track ID
+            appendBE(tfhd, mp4SampleDuration, 4);
+            appendBE(tfhd, parameters.blockSize, 4);
+            appendBE(trun, 1, 4); // sample count
+            appendBE(trun, movieFragmentSize + 8 + trackIndex * parameters.blockSize, 4); // data offset (relative to "moof"-atom)
+            content += makeAtom("traf", makeFullAtom("tfhd", 0, 0x020018, tfhd) + makeFullAtom("trun", 0, 0x000001, trun));
+        }
+        return makeAtom("moof", content);
+    };
+    const auto movieFragmentSize = makeMovieFragment(0, 0).size();
+
+    file << makeMp4Header(true) << makeMp4Movie(parameters, std::vector<std::vector<std::uint64_t>>(), false, true);
+    const auto mdatHeader = makeMp4MediaDataHeader(static_cast<std::uint64_t>(parameters.trackCount) * parameters.blockSize);
+    const auto payload = makePayload(parameters.blockSize, 0x4D503446u);
+    for (auto fragment = std::size_t(); fragment != parameters.clusterCount; ++fragment) {
+        file << makeMovieFragment(fragment + 1, movieFragmentSize) << mdatHeader;
+        for (auto trackIndex = std::size_t(); trackIndex != parameters.trackCount; ++trackIndex) {
+            file << payload;
+        }
+    }
+}
+
+// Matroska
+
+std::string makeEbmlElement(EbmlElement::IdentifierType id, std::string_view content)
+{
+    char buff[8];
+    auto element = std::string(buff, EbmlElement::makeId(id, buff));
+    element.append(buff, EbmlElement::makeSizeDenotation(content.size(), buff));
+    element += content;
+    return element;
+}
+
+template <typename ContentType> std::string makeSimpleEbmlElement(EbmlElement::IdentifierType id, ContentType content)
+{
+    auto stream = std::stringstream(std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+    EbmlElement::makeSimpleElement(stream, id, content);
+    return stream.str();
+}
+
+std::string makeFloatEbmlElement(EbmlElement::IdentifierType id, double value)
+{
+    auto bits = std::uint64_t();
+    static_assert(sizeof(bits) == sizeof(value));
+    std::memcpy(&bits, &value, sizeof(bits));
+    auto content = std::string();
+    appendBE(content, bits, 8);
+    return makeEbmlElement(id, content);
+}
+
+/*!
+ * \brief Generates a Matroska file; each cluster holds one SimpleBlock per track.
+ */
+void generateMatroska(const GeneratorParameters &parameters, std::ofstream &file)
+{
+    constexpr auto clusterDuration = std::uint64_t(20); // in milliseconds as the default timecode scale is used
+
+    const auto ebmlHeader = makeEbmlElement(EbmlIds::Header,
+        makeSimpleEbmlElement(EbmlIds::Version, 1) + makeSimpleEbmlElement(EbmlIds::ReadVersion, 1) + makeSimpleEbmlElement(EbmlIds::MaxIdLength, 4)
+            + makeSimpleEbmlElement(EbmlIds::MaxSizeLength, 8) + makeSimpleEbmlElement(EbmlIds::DocType, std::string_view("matroska"))
+            + makeSimpleEbmlElement(EbmlIds::DocTypeVersion, 4) + makeSimpleEbmlElement(EbmlIds::DocTypeReadVersion, 2));
+    const auto info = makeEbmlElement(MatroskaIds::SegmentInfo,
+        makeSimpleEbmlElement(MatroskaIds::TimeCodeScale, 1000000)
+            + makeFloatEbmlElement(MatroskaIds::Duration, static_cast<double>(parameters.clusterCount * clusterDuration))
+            + makeSimpleEbmlElement(MatroskaIds::MuxingApp, std::string_view("tagparser benchmarks"))
+            + makeSimpleEbmlElement(MatroskaIds::WrittingApp, std::string_view("tagparser benchmarks")));
+    auto trackEntries = std::string();
+    for (auto trackIndex = std::size_t(); trackIndex != parameters.trackCount; ++trackIndex) {
+        trackEntries += makeEbmlElement(MatroskaIds::TrackEntry,
+            makeSimpleEbmlElement(MatroskaIds::TrackNumber, trackIndex + 1) + makeSimpleEbmlElement(MatroskaIds::TrackUID, 0x1000 + trackIndex)
+                + makeSimpleEbmlElement(MatroskaIds::TrackType, MatroskaTrackType::Audio)
+                + makeSimpleEbmlElement(MatroskaIds::CodecID, std::string_view("A_OPUS"))
+                + makeEbmlElement(MatroskaIds::TrackAudio,
+                    makeFloatEbmlElement(MatroskaIds::SamplingFrequency, 48000.0) + makeSimpleEbmlElement(MatroskaIds::Channels, 2)));
+    }
+    const auto tracks = makeEbmlElement(MatroskaIds::Tracks, trackEntries);
+
+    // make the header of the SimpleBlock of each track (track number, relative timecode and flags)
+    char buff[8];
+    auto blockHeaders = std::vector<std::string>();
+    blockHeaders.reserve(parameters.trackCount);
+    for (auto trackIndex = std::size_t(); trackIndex != parameters.trackCount; ++trackIndex) {
+        auto blockContent = std::string(buff, EbmlElement::makeSizeDenotation(trackIndex + 1, buff));
+        appendBE(blockContent, 0, 2); // relative timecode
+        blockContent += '\x80'; // keyframe
+        auto &blockHeader = blockHeaders.emplace_back(buff, EbmlElement::makeId(MatroskaIds::SimpleBlock, buff));
+        blockHeader.append(buff, EbmlElement::makeSizeDenotation(blockContent.size() + parameters.blockSize, buff));
+        blockHeader += blockContent;
+    }
+    auto blocksSize = std::uint64_t();
+    for (const auto &blockHeader : blockHeaders) {
+        blocksSize += blockHeader.size() + parameters.blockSize;
+    }
+    const auto makeClusterHeader = [&](std::size_t cluster) {
+        const auto timecode = makeSimpleEbmlElement(MatroskaIds::Timecode, cluster * clusterDuration);
+        auto clusterHeader = std::string(buff, EbmlElement::makeId(MatroskaIds::Cluster, buff));
+        clusterHeader.append(buff, EbmlElement::makeSizeDenotation(timecode.size() + blocksSize, buff));
+        return clusterHeader + timecode;
+    };
+
+    // compute the size of the segment upfront to avoid buffering all clusters
+    auto segmentSize = static_cast<std::uint64_t>(info.size() + tracks.size());
+    for (auto cluster = std::size_t(); cluster != parameters.clusterCount; ++cluster) {
+        segmentSize += makeClusterHeader(cluster).size() + blocksSize;
+    }
+    file << ebmlHeader;
+    file.write(buff, EbmlElement::makeId(MatroskaIds::Segment, buff));
+    file.write(buff, EbmlElement::makeSizeDenotation(segmentSize, buff));
+    file << info << tracks;
+    const auto payload = makePayload(parameters.blockSize, 0x4D4B5620u);
+    for (auto cluster = std::size_t(); cluster != parameters.clusterCount; ++cluster) {
+        file << makeClusterHeader(cluster);
+        for (const auto &blockHeader : blockHeaders) {
+            file << blockHeader << payload;
+        }
+    }
+}
+
+// Ogg
+
+/*!
+ * \brief Writes an Ogg page containing the specified \a packets (which must fit into a single page) to \a file.
+ */
+void writeOggPage(std::ofstream &file, std::uint8_t headerType, std::uint64_t granulePosition, std::uint32_t serialNumber,
+    std::uint32_t sequenceNumber, std::initializer_list<std::string_view> packets)
+{
+    auto segmentTable = std::string();
+    auto dataSize = std::size_t();
+    for (const auto packet : packets) {
+        segmentTable.append(packet.size() / 0xFF, '\xFF');
+        segmentTable += static_cast<char>(packet.size() % 0xFF);
+        dataSize += packet.size();
+    }
+    auto page = std::string("OggS");
+    page.reserve(27 + segmentTable.size() + dataSize);
+    page += '\0'; // stream structure version
+    page += static_cast<char>(headerType);
+    appendLE(page, granulePosition, 8);
+    appendLE(page, serialNumber, 4);
+    appendLE(page, sequenceNumber, 4);
+    appendLE(page, 0, 4); // checksum (updated below)
+    page += static_cast<char>(segmentTable.size());
+    page += segmentTable;
+    for (const auto packet : packets) {
+        page += packet;
+    }
+    auto pageStream = std::stringstream(page, std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+    OggPage::updateChecksum(pageStream, 0);
+    file << pageStream.str();
+}
+
+/*!
+ * \brief Generates an Ogg file with one logical stream per track; each page holds a single packet.
+ * \remarks The packet size is limited to what fits into a single page.
+ */
+void generateOgg(const GeneratorParameters &parameters, std::ofstream &file, bool opus)
+{
+    constexpr auto maxPacketSize = std::size_t(0xFF * 0xFF - 1);
+    constexpr auto firstPage = std::uint8_t(0x02), lastPage = std::uint8_t(0x04);
+    const auto samplesPerPacket = std::uint64_t(opus ? 960 : 1024);
+    const auto vendor = std::string_view("tagparser benchmarks");
+
+    auto identificationHeader = std::string(), commentHeader = std::string(), setupHeader = std::string();
+    if (opus) {
+        identificationHeader += "OpusHead";
+        appendLE(identificationHeader, 1, 1); // version
+        appendLE(identificationHeader, 2, 1); // channel count
+        appendLE(identificationHeader, 312, 2); // pre-skip
+        appendLE(identificationHeader, 48000, 4); // input sample rate
+        appendLE(identificationHeader, 0, 2); // output gain
+        appendLE(identificationHeader, 0, 1); // channel mapping family
+        commentHeader += "OpusTags";
+    } else {
+        identificationHeader += "\x01vorbis";
+        appendLE(identificationHeader, 0, 4); // version
+        appendLE(identificationHeader, 2, 1); // channel count
+        appendLE(identificationHeader, 44100, 4); // sample rate
+        appendLE(identificationHeader, 0, 4); // max. bitrate
+        appendLE(identificationHeader, 128000, 4); // nominal bitrate
+        appendLE(identificationHeader, 0, 4); // min. bitrate
+        appendLE(identificationHeader, 0xB8, 1); // block sizes
+        appendLE(identificationHeader, 1, 1); // framing flag
+        commentHeader += "\x03vorbis";
+        setupHeader += "\x05vorbis";
+        setupHeader += makePayload(64, 0x5345545Bu);
+    }
+    appendLE(commentHeader, vendor.size(), 4);
+    commentHeader += vendor;
+    appendLE(commentHeader, 0, 4); // field count
+    if (!opus) {
+        appendLE(commentHeader, 1, 1); // framing flag
+    }
+
+    // ensure audio packets are not mistaken as header packets (Vorbis audio packets have the lowest bit cleared)
+    auto payload = makePayload(std::min(parameters.blockSize, maxPacketSize), opus ? 0x4F505553u : 0x564F5242u);
+    if (!payload.empty()) {
+        payload.front() = '\x00';
+    }
+
+    // write the beginning-of-stream pages first, followed by the remaining header pages and the interleaved audio pages
+    const auto serialNumber = [](std::size_t trackIndex) { return static_cast<std::uint32_t>(0x1000 + trackIndex); };
+    for (auto trackIndex = std::size_t(); trackIndex != parameters.trackCount; ++trackIndex) {
+        writeOggPage(file, firstPage, 0, serialNumber(trackIndex), 0, { identificationHeader });
+    }
+    for (auto trackIndex = std::size_t(); trackIndex != parameters.trackCount; ++trackIndex) {
+        if (opus) {
+            writeOggPage(file, 0, 0, serialNumber(trackIndex), 1, { commentHeader });
+        } else {
+            writeOggPage(file, 0, 0, serialNumber(trackIndex), 1, { commentHeader, setupHeader });
+        }
+    }
+    for (auto page = std::size_t(); page != parameters.clusterCount; ++page) {
+        const auto headerType = page + 1 == parameters.clusterCount ? lastPage : std::uint8_t();
+        const auto granulePosition = (page + 1) * samplesPerPacket;
+        for (auto trackIndex = std::size_t(); trackIndex != parameters.trackCount; ++trackIndex) {
+            writeOggPage(file, headerType, granulePosition, serialNumber(trackIndex), static_cast<std::uint32_t>(page + 2), { payload });
+        }
+    }
+}
+
+// FLAC and MP3
+
+/*!
+ * \brief Generates a raw FLAC file with only a "STREAMINFO" block and a frame of \a blockSize bytes per cluster.
+ */
+void generateFlac(const GeneratorParameters &parameters, std::ofstream &file)
+{
+    constexpr auto samplesPerFrame = std::uint64_t(4096), sampleRate = std::uint64_t(44100);
+    constexpr auto channelCount = std::uint64_t(2), bitsPerSample = std::uint64_t(16);
+    const auto totalSampleCount = samplesPerFrame * parameters.clusterCount;
+    auto header = std::string("fLaC");
+    appendBE(header, 0x80, 1); // last-metadata-block flag and block type (STREAMINFO)
+    appendBE(header, 34, 3); // block size
+    appendBE(header, samplesPerFrame, 2); // min. block size
+    appendBE(header, samplesPerFrame, 2); // max. block size
+    appendBE(header, 0, 3); // min. frame size (unknown)
+    appendBE(header, 0, 3); // max. frame size (unknown)
+    appendBE(header, (sampleRate << 44) | ((channelCount - 1) << 41) | ((bitsPerSample - 1) << 36) | (totalSampleCount & 0xFFFFFFFFFu), 8);
+    appendBE(header, 0, 8); // MD5 signature
+    appendBE(header, 0, 8);
+    file << header;
+
+    auto frame = makePayload(std::max<std::size_t>(parameters.blockSize, 2), 0x464C4143u);
+    frame[0] = '\xFF'; // frame sync code
+    frame[1] = '\xF8';
+    for (auto cluster = std::size_t(); cluster != parameters.clusterCount; ++cluster) {
+        file << frame;
+    }
+}
+
+/*!
+ * \brief Generates MPEG-1 Layer 3 frames (128 kbit/s, 44.1 kHz) amounting to about the size of \a clusterCount blocks.
+ */
+void generateMp3(const GeneratorParameters &parameters, std::ofstream &file)
+{
+    constexpr auto frameSize = std::size_t(417);
+    const auto frameCount = std::max<std::size_t>(static_cast<std::uint64_t>(parameters.clusterCount) * parameters.blockSize / frameSize, 1);
+    auto frame = makePayload(frameSize, 0x4D503320u);
+    std::memcpy(frame.data(), "\xFF\xFB\x90\x00", 4);
+    for (auto index = std::size_t(); index != frameCount; ++index) {
+        file << frame;
+    }
+}
+
+constexpr std::array<std::string_view, syntheticFormatCount> formatNames = {
+    "mp4",
+    "mp4-fragmented",
+    "mkv",
+    "ogg-vorbis",
+    "ogg-opus",
+    "flac",
+    "mp3",
+};
+
+constexpr std::array<std::string_view, syntheticFormatCount> formatExtensions = {
+    "mp4",
+    "mp4",
+    "mkv",
+    "ogg",
+    "opus",
+    "flac",
+    "mp3",
+};
+
+} // namespace
+/// \endcond
+
+/*!
+ * \brief Returns the name of the specified \a format as used on the command line and in the results.
+ */
+std::string_view syntheticFormatName(SyntheticFormat format)
+{
+    return formatNames[static_cast<std::size_t>(format)];
+}
+
+/*!
+ * \brief Returns the file extension (without dot) used for files of the specified \a format.
+ */
+std::string_view syntheticFormatExtension(SyntheticFormat format)
+{
+    return formatExtensions[static_cast<std::size_t>(format)];
+}
+
+/*!
+ * \brief Assigns the format with the specified \a name to \a format.
+ * \returns Returns whether \a name is a known format name.
+ */
+bool syntheticFormatFromName(std::string_view name, SyntheticFormat &format)
+{
+    const auto i = std::find(formatNames.begin(), formatNames.end(), name);
+    if (i == formatNames.end()) {
+        return false;
+    }
+    format = static_cast<SyntheticFormat>(i - formatNames.begin());
+    return true;
+}
+
+/*!
+ * \brief Generates a file of the specified \a format at the specified \a path.
+ *
+ * The generated files contain no tags (besides empty Vorbis comments required by Ogg streams) and no meaningful media
+ * data. They are only supposed to be structurally valid so tags can be added and the files can be parsed and rewritten.
+ *
+ * \returns Returns the size of the generated file.
+ * \throws Throws std::ios_base::failure when an IO error occurs.
+ */
+std::uint64_t generateFile(SyntheticFormat format, const GeneratorParameters &parameters, const std::string &path)
+{
+    auto normalizedParameters = parameters;
+    normalizedParameters.trackCount = std::max<std::size_t>(parameters.trackCount, 1);
+    normalizedParameters.clusterCount = std::max<std::size_t>(parameters.clusterCount, 1);
+    normalizedParameters.blockSize = std::max<std::size_t>(parameters.blockSize, 1);
+
+    auto file = std::ofstream();
+    openForWriting(file, path);
+    switch (format) {
+    case SyntheticFormat::Mp4:
+        generateMp4(normalizedParameters, file);
+        break;
+    case SyntheticFormat::FragmentedMp4:
+        generateFragmentedMp4(normalizedParameters, file);
+        break;
+    case SyntheticFormat::Matroska:
+        generateMatroska(normalizedParameters, file);
+        break;
+    case SyntheticFormat::OggVorbis:
+        generateOgg(normalizedParameters, file, false);
+        break;
+    case SyntheticFormat::OggOpus:
+        generateOgg(normalizedParameters, file, true);
+        break;
+    case SyntheticFormat::Flac:
+        generateFlac(normalizedParameters, file);
+        break;
+    case SyntheticFormat::Mp3:
+        generateMp3(normalizedParameters, file);
+        break;
+    }
+    const auto size = static_cast<std::uint64_t>(file.tellp());
+    file.close();
+    return size;
+}
+
+} // namespace Benchmarks
+} // namespace TagParser
@@ -0,0 +1,49 @@
+#ifndef TAG_PARSER_BENCHMARKS_GENERATORS_H
+#define TAG_PARSER_BENCHMARKS_GENERATORS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace TagParser {
+namespace Benchmarks {
+
+/*!
+ * \brief The SyntheticFormat enum specifies the formats synthetic files can be generated for.
+ */
+enum class SyntheticFormat : std::uint8_t {
+    Mp4, /**< MP4 file with interleaved chunks in a single "mdat"-atom */
+    FragmentedMp4, /**< MP4 file with one "moof"-atom and one "mdat"-atom per fragment */
+    Matroska, /**< Matroska file with SimpleBlocks in clusters */
+    OggVorbis, /**< Ogg file with one Vorbis stream per track */
+    OggOpus, /**< Ogg file with one Opus stream per track */
+    Flac, /**< raw FLAC file */
+    Mp3, /**< raw MPEG-1 Layer 3 frames */
+};
+
+/// \brief The number of formats within SyntheticFormat.
+constexpr std::size_t syntheticFormatCount = 7;
+
+/*!
+ * \brief The GeneratorParameters struct specifies the layout of a synthetic file.
+ */
+struct GeneratorParameters {
+    /// \brief The number of tracks (ignored for FLAC and MP3 which only support a single track).
+    std::size_t trackCount = 2;
+    /// \brief The number of clusters (Matroska), chunks (MP4), fragments (fragmented MP4) or pages (Ogg) per track;
+    ///        for FLAC and MP3 this multiplied with blockSize determines the size of the media data.
+    std::size_t clusterCount = 500;
+    /// \brief The number of bytes per block, sample, packet or frame.
+    std::size_t blockSize = 4096;
+};
+
+std::string_view syntheticFormatName(SyntheticFormat format);
+std::string_view syntheticFormatExtension(SyntheticFormat format);
+bool syntheticFormatFromName(std::string_view name, SyntheticFormat &format);
+std::uint64_t generateFile(SyntheticFormat format, const GeneratorParameters &parameters, const std::string &path);
+
+} // namespace Benchmarks
+} // namespace TagParser
+
+#endif // TAG_PARSER_BENCHMARKS_GENERATORS_H
@@ -0,0 +1,797 @@
+#include "./generators.h"
+
+#include "../batchscanner.h"
+#include "../diagnostics.h"
+#include "../flatmultimap.h"
+#include "../mediafileinfo.h"
+#include "../progressfeedback.h"
+#include "../tag.h"
+#include "../tagvalue.h"
+
+#include "../matroska/ebmlelement.h"
+#include "../matroska/matroskaid.h"
+#include "../matroska/matroskatag.h"
+#include "../vorbis/vorbiscomment.h"
+
+#include <c++utilities/conversion/conversionexception.h>
+#include <c++utilities/conversion/stringbuilder.h>
+#include <c++utilities/conversion/stringconversion.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace CppUtilities;
+using namespace TagParser;
+using namespace TagParser::Benchmarks;
+
+/// \cond
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+/*!
+ * \brief The Options struct holds the options specified on the command line.
+ */
+struct Options {
+    std::string outputPath;
+    std::string workingDirectory;
+    std::string label;
+    std::string filter;
+    std::vector<SyntheticFormat> formats;
+    GeneratorParameters generator;
+    std::size_t tagFieldCount = 50;
+    std::size_t iterations = 5;
+    std::size_t batchFileCount = 32;
+    bool keepFiles = false;
+};
+
+/*!
+ * \brief The Result struct holds the samples of a single benchmark.
+ */
+struct Result {
+    std::string name;
+    std::string format;
+    std::size_t threads = 1;
+    std::uint64_t bytes = 0;
+    std::uint64_t operations = 1;
+    std::string strategy;
+    DiagLevel diagLevel = DiagLevel::None;
+    std::vector<Clock::duration> samples;
+};
+
+/*!
+ * \brief Runs \a setup and \a function \a iterations times but only measures the time spent in \a function.
+ * \remarks The object returned by \a setup is passed to \a function and destroyed after the time has been taken.
+ */
+template <typename Setup, typename Function>
+std::vector<Clock::duration> measure(std::size_t iterations, const Setup &setup, const Function &function)
+{
+    auto samples = std::vector<Clock::duration>();
+    samples.reserve(iterations);
+    for (auto iteration = std::size_t(); iteration != iterations; ++iteration) {
+        auto state = setup(iteration);
+        const auto start = Clock::now();
+        function(state);
+        samples.emplace_back(Clock::now() - start);
+    }
+    return samples;
+}
+
+/*!
+ * \brief Returns \a text as JSON string literal.
+ */
+std::string jsonString(std::string_view text)
+{
+    auto json = std::string("\"");
+    json.reserve(text.size() + 2);
+    for (const auto c : text) {
+        switch (c) {
+        case '"':
+            json += "\\\"";
+            break;
+        case '\\':
+            json += "\\\\";
+            break;
+        case '\n':
+            json += "\\n";
+            break;
+        case '\t':
+            json += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                static constexpr char hexDigits[] = "0123456789abcdef";
+                json += "\\u00";
+                json += hexDigits[(c >> 4) & 0xF];
+                json += hexDigits[c & 0xF];
+            } else {
+                json += c;
+            }
+        }
+    }
+    json += '"';
+    return json;
+}
+
+std::string_view changeStrategyName(ChangeStrategy strategy)
+{
+    switch (strategy) {
+    case ChangeStrategy::None:
+        return "none";
+    case ChangeStrategy::InPlace:
+        return "in-place";
+    case ChangeStrategy::Rewrite:
+        return "rewrite";
+    }
+    return std::string_view();
+}
+
+/*!
+ * \brief Writes the specified \a results as JSON document to \a out.
+ */
+void writeJson(std::ostream &out, const Options &options, const std::vector<Result> &results)
+{
+    out << "{\n  \"label\": " << jsonString(options.label) << ",\n  \"parameters\": {\"tracks\": " << options.generator.trackCount
+        << ", \"clusters\": " << options.generator.clusterCount << ", \"block_size\": " << options.generator.blockSize
+        << ", \"tag_fields\": " << options.tagFieldCount << ", \"iterations\": " << options.iterations
+        << ", \"hardware_concurrency\": " << std::thread::hardware_concurrency() << "},\n  \"results\": [";
+    auto first = true;
+    for (const auto &result : results) {
+        auto samples = std::vector<std::uint64_t>();
+        samples.reserve(result.samples.size());
+        for (const auto sample : result.samples) {
+            samples.emplace_back(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(sample).count()));
+        }
+        std::sort(samples.begin(), samples.end());
+        const auto count = std::max<std::size_t>(samples.size(), 1);
+        const auto min = samples.empty() ? 0 : samples.front();
+        const auto max = samples.empty() ? 0 : samples.back();
+        const auto median = samples.empty() ? 0 : samples[samples.size() / 2];
+        const auto mean = std::accumulate(samples.begin(), samples.end(), std::uint64_t()) / count;
+        out << (first ? "\n" : ",\n") << "    {\"name\": " << jsonString(result.name) << ", \"format\": " << jsonString(result.format)
+            << ", \"threads\": " << result.threads << ", \"bytes\": " << result.bytes << ", \"operations\": " << result.operations
+            << ", \"iterations\": " << samples.size() << ", \"min_ns\": " << min << ", \"median_ns\": " << median << ", \"mean_ns\": " << mean
+            << ", \"max_ns\": " << max;
+        if (median && result.bytes) {
+            out << ", \"mib_per_s\": " << (static_cast<double>(result.bytes) / 1048576.0) / (static_cast<double>(median) / 1e9);
+        }
+        if (median && result.operations > 1) {
+            out << ", \"ops_per_s\": " << static_cast<double>(result.operations) / (static_cast<double>(median) / 1e9);
+        }
+        if (!result.strategy.empty()) {
+            out << ", \"strategy\": " << jsonString(result.strategy);
+        }
+        out << ", \"diag_level\": " << jsonString(diagLevelName(result.diagLevel)) << '}';
+        first = false;
+    }
+    out << "\n  ]\n}\n";
+}
+
+/*!
+ * \brief The BenchmarkRunner class runs the benchmarks selected via Options and collects the results.
+ */
+class BenchmarkRunner {
+public:
+    explicit BenchmarkRunner(const Options &options);
+
+    void runFileBenchmarks();
+    void runBatchScanBenchmarks();
+    void runMicroBenchmarks();
+    void removeFiles();
+    const std::vector<Result> &results() const;
+
+private:
+    bool isSelected(std::string_view name, std::string_view format = std::string_view()) const;
+    void addResult(Result &&result);
+    std::string makePath(SyntheticFormat format, std::string_view suffix) const;
+    std::string prepareFile(SyntheticFormat format);
+    void runParsingBenchmarks(SyntheticFormat format, const std::string &path);
+    void runWritingBenchmarks(SyntheticFormat format, const std::string &path);
+    std::unique_ptr<MediaFileInfo> openForEditing(const std::string &preparedPath, const std::string &workingPath, std::size_t iteration);
+
+    const Options &m_options;
+    std::vector<std::string> m_preparedFiles;
+    std::vector<std::string> m_files;
+    std::vector<Result> m_results;
+    AbortableProgressFeedback m_progress;
+};
+
+BenchmarkRunner::BenchmarkRunner(const Options &options)
+    : m_options(options)
+{
+}
+
+const std::vector<Result> &BenchmarkRunner::results() const
+{
+    return m_results;
+}
+
+bool BenchmarkRunner::isSelected(std::string_view name, std::string_view format) const
+{
+    if (m_options.filter.empty()) {
+        return true;
+    }
+    const auto id = format.empty() ? std::string(name) : argsToString(format, '/', name);
+    return id.find(m_options.filter) != std::string::npos;
+}
+
+void BenchmarkRunner::addResult(Result &&result)
+{
+    std::cerr << " - " << (result.format.empty() ? std::string() : result.format + '/') << result.name;
+    if (result.threads > 1) {
+        std::cerr << " (" << result.threads << " threads)";
+    }
+    if (!result.samples.empty()) {
+        auto samples = result.samples;
+        std::sort(samples.begin(), samples.end());
+        std::cerr << ": " << std::chrono::duration_cast<std::chrono::microseconds>(samples[samples.size() / 2]).count() << " us (median)";
+    }
+    if (!result.strategy.empty()) {
+        std::cerr << ", strategy: " << result.strategy;
+    }
+    if (result.diagLevel >= DiagLevel::Warning) {
+        std::cerr << ", diagnostics: " << diagLevelName(result.diagLevel);
+    }
+    std::cerr << '\n';
+    m_results.emplace_back(std::move(result));
+}
+
+std::string BenchmarkRunner::makePath(SyntheticFormat format, std::string_view suffix) const
+{
+    return argsToString(m_options.workingDirectory, '/', syntheticFormatName(format), suffix, '.', syntheticFormatExtension(format));
+}
+
+/*!
+ * \brief Populates all tags of \a fileInfo (creating them if necessary) with some common fields and \a fieldCount comments.
+ */
+void populateTags(MediaFileInfo &fileInfo, std::size_t fieldCount)
+{
+    fileInfo.createAppropriateTags();
+    for (auto *const tag : fileInfo.tags()) {
+        tag->setValue(KnownField::Title, TagValue("Benchmark title 0000000000"));
+        tag->setValue(KnownField::Artist, TagValue("Benchmark artist"));
+        tag->setValue(KnownField::Album, TagValue("Benchmark album"));
+        tag->setValue(KnownField::Genre, TagValue("Benchmark genre"));
+        auto comments = std::vector<TagValue>();
+        comments.reserve(fieldCount);
+        for (auto index = std::size_t(); index != fieldCount; ++index) {
+            auto &comment = comments.emplace_back(argsToString("Benchmark comment ", index, ": Lorem ipsum dolor sit amet, consetetur sadipscing"));
+            comment.setDescription(argsToString("comment ", index));
+        }
+        tag->setValues(KnownField::Comment, comments);
+    }
+}
+
+/*!
+ * \brief Generates a file of the specified \a format and adds tags with padding to it.
+ * \returns Returns the path of the prepared file which serves as input for all further benchmarks of \a format.
+ */
+std::string BenchmarkRunner::prepareFile(SyntheticFormat format)
+{
+    const auto path = m_files.emplace_back(makePath(format, "-prepared"));
+    generateFile(format, m_options.generator, path);
+
+    auto diag = Diagnostics();
+    auto fileInfo = MediaFileInfo(path);
+    fileInfo.setPreferredPadding(4096);
+    fileInfo.setMaxPadding(0x100000);
+    fileInfo.open();
+    fileInfo.parseEverything(diag, m_progress);
+    populateTags(fileInfo, m_options.tagFieldCount);
+    fileInfo.applyChanges(diag, m_progress);
+    fileInfo.close();
+    m_files.emplace_back(path + ".bak");
+    if (diag.has(DiagLevel::Critical)) {
+        std::cerr << "Unable to prepare " << syntheticFormatName(format) << " file:\n";
+        for (const auto &message : diag) {
+            std::cerr << " - " << message.levelName() << ": " << message.message() << " (" << message.context() << ")\n";
+        }
+    }
+    return path;
+}
+
+/*!
+ * \brief Runs the benchmarks for parsing the container format, the tracks and the tags of the file at \a path.
+ * \remarks Parsing is measured cumulatively: "parse-tracks" includes parsing the container and "parse-tags" includes parsing
+ *          the container and the tracks (like an application would invoke the functions).
+ */
+void BenchmarkRunner::runParsingBenchmarks(SyntheticFormat format, const std::string &path)
+{
+    static constexpr std::string_view names[] = { "parse-container", "parse-tracks", "parse-tags" };
+    const auto size = std::filesystem::file_size(path);
+    for (auto depth = std::size_t(); depth != 3; ++depth) {
+        if (!isSelected(names[depth], syntheticFormatName(format))) {
+            continue;
+        }
+        auto result = Result();
+        result.name = names[depth];
+        result.format = syntheticFormatName(format);
+        result.bytes = size;
+        result.samples = measure(
+            m_options.iterations,
+            [&](std::size_t) {
+                auto fileInfo = std::make_unique<MediaFileInfo>(path);
+                fileInfo->open(true);
+                return fileInfo;
+            },
+            [&](std::unique_ptr<MediaFileInfo> &fileInfo) {
+                auto diag = Diagnostics();
+                fileInfo->parseContainerFormat(diag, m_progress);
+                if (depth >= 1) {
+                    fileInfo->parseTracks(diag, m_progress);
+                }
+                if (depth >= 2) {
+                    fileInfo->parseTags(diag, m_progress);
+                }
+                result.diagLevel = std::max(result.diagLevel, diag.level());
+            });
+        addResult(std::move(result));
+    }
+}
+
+/*!
+ * \brief Copies the prepared file to \a workingPath, parses it and alters the title so there are pending changes.
+ * \remarks The title keeps its size so the changes can be applied in-place if the file has enough padding.
+ */
+std::unique_ptr<MediaFileInfo> BenchmarkRunner::openForEditing(const std::string &preparedPath, const std::string &workingPath, std::size_t iteration)
+{
+    std::filesystem::remove(workingPath + ".bak");
+    std::filesystem::copy_file(preparedPath, workingPath, std::filesystem::copy_options::overwrite_existing);
+    auto diag = Diagnostics();
+    auto fileInfo = std::make_unique<MediaFileInfo>(workingPath);
+    fileInfo->setForceRewrite(false);
+    fileInfo->setMaxPadding(0x100000);
+    fileInfo->open();
+    fileInfo->parseEverything(diag, m_progress);
+    auto title = std::to_string(iteration);
+    title.insert(0, 10 - std::min<std::size_t>(title.size(), 10), '0');
+    for (auto *const tag : fileInfo->tags()) {
+        tag->setValue(KnownField::Title, TagValue("Benchmark title " + title));
+    }
+    return fileInfo;
+}
+
+/*!
+ * \brief Runs the benchmarks for planning and applying changes to the file at \a path.
+ * \remarks Copying the file and parsing it is not measured. Backup files are removed before each iteration.
+ */
+void BenchmarkRunner::runWritingBenchmarks(SyntheticFormat format, const std::string &path)
+{
+    const auto workingPath = m_files.emplace_back(makePath(format, "-working"));
+    m_files.emplace_back(workingPath + ".bak");
+    const auto size = std::filesystem::file_size(path);
+
+    if (isSelected("plan-changes", syntheticFormatName(format))) {
+        auto result = Result();
+        result.name = "plan-changes";
+        result.format = syntheticFormatName(format);
+        result.samples = measure(
+            m_options.iterations, [&](std::size_t iteration) { return openForEditing(path, workingPath, iteration); },
+            [&](std::unique_ptr<MediaFileInfo> &fileInfo) {
+                auto diag = Diagnostics();
+                result.strategy = changeStrategyName(fileInfo->planChanges(diag, m_progress).strategy);
+                result.diagLevel = std::max(result.diagLevel, diag.level());
+            });
+        addResult(std::move(result));
+    }
+
+    static constexpr std::string_view names[] = { "apply-in-place", "apply-rewrite" };
+    for (auto rewrite = std::size_t(); rewrite != 2; ++rewrite) {
+        if (!isSelected(names[rewrite], syntheticFormatName(format))) {
+            continue;
+        }
+        auto result = Result();
+        result.name = names[rewrite];
+        result.format = syntheticFormatName(format);
+        result.bytes = size;
+        result.samples = measure(
+            m_options.iterations,
+            [&](std::size_t iteration) {
+                auto fileInfo = openForEditing(path, workingPath, iteration);
+                fileInfo->setForceRewrite(rewrite);
+                auto diag = Diagnostics();
+                result.strategy = changeStrategyName(fileInfo->planChanges(diag, m_progress).strategy);
+                return fileInfo;
+            },
+            [&](std::unique_ptr<MediaFileInfo> &fileInfo) {
+                auto diag = Diagnostics();
+                fileInfo->applyChanges(diag, m_progress);
+                fileInfo->close();
+                result.diagLevel = std::max(result.diagLevel, diag.level());
+            });
+        addResult(std::move(result));
+    }
+}
+
+/*!
+ * \brief Generates and prepares a file for each selected format and runs the parsing and writing benchmarks on it.
+ */
+void BenchmarkRunner::runFileBenchmarks()
+{
+    std::filesystem::create_directories(m_options.workingDirectory);
+    for (const auto format : m_options.formats) {
+        std::cerr << "Preparing " << syntheticFormatName(format) << " file ...\n";
+        const auto &path = m_preparedFiles.emplace_back(prepareFile(format));
+        runParsingBenchmarks(format, path);
+        runWritingBenchmarks(format, path);
+    }
+}
+
+/*!
+ * \brief Scans the prepared files with the BatchScanner using different numbers of threads.
+ * \remarks The prepared files are scanned multiple times to have at least Options::batchFileCount files.
+ */
+void BenchmarkRunner::runBatchScanBenchmarks()
+{
+    if (m_preparedFiles.empty() || !isSelected("batch-scan")) {
+        return;
+    }
+    auto paths = std::vector<std::string>();
+    auto bytes = std::uint64_t();
+    paths.reserve(m_options.batchFileCount);
+    while (paths.size() < m_options.batchFileCount) {
+        const auto &path = paths.emplace_back(m_preparedFiles[paths.size() % m_preparedFiles.size()]);
+        bytes += std::filesystem::file_size(path);
+    }
+    auto threadCounts = std::vector<std::size_t>();
+    const auto hardwareConcurrency = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    for (auto threadCount = std::size_t(1); threadCount < hardwareConcurrency; threadCount *= 2) {
+        threadCounts.emplace_back(threadCount);
+    }
+    threadCounts.emplace_back(hardwareConcurrency);
+
+    for (const auto threadCount : threadCounts) {
+        auto result = Result();
+        result.name = "batch-scan";
+        result.threads = threadCount;
+        result.bytes = bytes;
+        result.operations = paths.size();
+        auto scanner = BatchScanner(ParsingDepth::Tags);
+        scanner.setThreadCount(threadCount);
+        result.samples = measure(
+            m_options.iterations, [](std::size_t) { return 0; },
+            [&](int) {
+                scanner.scan(
+                    paths, [&](BatchScanResult &&scanResult) { result.diagLevel = std::max(result.diagLevel, scanResult.diag.level()); },
+                    m_progress);
+            });
+        addResult(std::move(result));
+    }
+}
+
+/*!
+ * \brief Runs micro-benchmarks for code paths which are hard to isolate when processing files.
+ */
+void BenchmarkRunner::runMicroBenchmarks()
+{
+    constexpr auto operations = std::size_t(100000);
+    auto random = std::mt19937_64(42);
+    auto sink = std::uint64_t();
+
+    // encoding and decoding EBML IDs and size denotations (done for each element of a Matroska file)
+    if (isSelected("ebml-size-denotation")) {
+        auto sizes = std::vector<std::uint64_t>(operations);
+        for (auto &size : sizes) {
+            size = random() >> (random() % 64); // sizes of different magnitudes
+            size = std::min<std::uint64_t>(size, 0xFFFFFFFFFFFFFEu);
+        }
+        auto result = Result();
+        result.name = "ebml-size-denotation";
+        result.operations = operations;
+        result.samples = measure(
+            m_options.iterations, [](std::size_t) { return 0; },
+            [&](int) {
+                char buff[8];
+                for (const auto size : sizes) {
+                    EbmlElement::makeSizeDenotation(size, buff);
+                    sink += EbmlElement::decodeSizeDenotation(buff, EbmlElement::calculateDenotationLength(static_cast<std::uint8_t>(buff[0])));
+                }
+            });
+        addResult(std::move(result));
+    }
+    if (isSelected("ebml-id")) {
+        static constexpr EbmlElement::IdentifierType ids[] = { MatroskaIds::Segment, MatroskaIds::Cluster, MatroskaIds::SimpleBlock,
+            MatroskaIds::Timecode, MatroskaIds::TrackEntry, MatroskaIds::CodecID, MatroskaIds::SimpleTag, MatroskaIds::TagName };
+        auto result = Result();
+        result.name = "ebml-id";
+        result.operations = operations;
+        result.samples = measure(
+            m_options.iterations, [](std::size_t) { return 0; },
+            [&](int) {
+                char buff[4];
+                for (auto index = std::size_t(); index != operations; ++index) {
+                    const auto length = EbmlElement::makeId(ids[index % (sizeof(ids) / sizeof(ids[0]))], buff);
+                    sink += EbmlElement::decodeId(buff, length);
+                }
+            });
+        addResult(std::move(result));
+    }
+
+    // building and querying field maps like FieldMapBasedTag does (FlatMultiMap vs. std::multimap)
+    const auto fieldIds = [&] {
+        static constexpr const char *names[] = { "TITLE", "ARTIST", "ALBUM", "GENRE", "COMMENT", "DATE", "TRACKNUMBER", "DISCNUMBER", "COMPOSER",
+            "LYRICIST", "PERFORMER", "ENCODER", "LANGUAGE", "RATING", "LYRICS", "DESCRIPTION" };
+        auto ids = std::vector<std::string>();
+        ids.reserve(std::max<std::size_t>(m_options.tagFieldCount, 1));
+        for (auto index = std::size_t(); index != ids.capacity(); ++index) {
+            ids.emplace_back(names[random() % (sizeof(names) / sizeof(names[0]))]);
+        }
+        return ids;
+    }();
+    const auto fieldMapOperations = std::max<std::size_t>(operations / fieldIds.size(), 1);
+    const auto benchmarkFieldMap = [&](std::string_view name, auto makeMap) {
+        if (!isSelected(name)) {
+            return;
+        }
+        auto result = Result();
+        result.name = name;
+        result.operations = fieldMapOperations * fieldIds.size();
+        result.samples = measure(
+            m_options.iterations, [](std::size_t) { return 0; },
+            [&](int) {
+                for (auto repetition = std::size_t(); repetition != fieldMapOperations; ++repetition) {
+                    auto map = makeMap();
+                    for (const auto &id : fieldIds) {
+                        map.emplace(id, repetition);
+                    }
+                    for (const auto &id : fieldIds) {
+                        const auto range = map.equal_range(id);
+                        sink += static_cast<std::uint64_t>(std::distance(range.first, range.second));
+                    }
+                }
+            });
+        addResult(std::move(result));
+    };
+    benchmarkFieldMap("field-map-flat", [&] {
+        auto map = FlatMultiMap<std::string, std::size_t>();
+        map.reserve(fieldIds.size());
+        return map;
+    });
+    benchmarkFieldMap("field-map-std", [] { return std::multimap<std::string, std::size_t>(); });
+
+    // converting tag values to another encoding (done when reading/writing most tag formats)
+    if (isSelected("tag-value-conversion")) {
+        const auto value = TagValue("Benchmark text with some non-ASCII characters: äöüß, ÄÖÜ, € and more", TagTextEncoding::Utf8);
+        auto result = Result();
+        result.name = "tag-value-conversion";
+        result.operations = operations;
+        result.samples = measure(
+            m_options.iterations, [](std::size_t) { return std::string(); },
+            [&](std::string &converted) {
+                for (auto index = std::size_t(); index != operations; ++index) {
+                    value.toString(converted, index % 2 ? TagTextEncoding::Utf16LittleEndian : TagTextEncoding::Utf16BigEndian);
+                    sink += converted.size();
+                }
+            });
+        addResult(std::move(result));
+    }
+
+    // mapping known fields to field IDs when setting and getting values
+    const auto benchmarkKnownFields = [&](std::string_view name, auto &tag) {
+        if (!isSelected(name)) {
+            return;
+        }
+        static constexpr KnownField fields[] = { KnownField::Title, KnownField::Artist, KnownField::Album, KnownField::Genre, KnownField::Comment,
+            KnownField::RecordDate, KnownField::Composer, KnownField::Lyricist };
+        const auto value = TagValue("Benchmark value");
+        auto result = Result();
+        result.name = name;
+        result.operations = operations;
+        result.samples = measure(
+            m_options.iterations, [](std::size_t) { return 0; },
+            [&](int) {
+                for (auto index = std::size_t(); index != operations; ++index) {
+                    const auto field = fields[index % (sizeof(fields) / sizeof(fields[0]))];
+                    tag.setValue(field, value);
+                    sink += tag.value(field).dataSize();
+                }
+            });
+        addResult(std::move(result));
+    };
+    auto vorbisComment = VorbisComment();
+    auto matroskaTag = MatroskaTag();
+    benchmarkKnownFields("known-fields-vorbis-comment", vorbisComment);
+    benchmarkKnownFields("known-fields-matroska-tag", matroskaTag);
+
+    // adding diagnostic messages (done for many elements when parsing broken files or with a low diag level)
+    const auto benchmarkDiagMessages = [&](std::string_view name, const auto &context) {
+        if (!isSelected(name)) {
+            return;
+        }
+        auto result = Result();
+        result.name = name;
+        result.operations = operations;
+        result.samples = measure(
+            m_options.iterations,
+            [](std::size_t) {
+                auto diag = Diagnostics();
+                diag.reserve(operations);
+                return diag;
+            },
+            [&](Diagnostics &diag) {
+                for (auto index = std::size_t(); index != operations; ++index) {
+                    diag.emplace_back(DiagLevel::Information, "Benchmark message", context);
+                }
+                sink += diag.size();
+            });
+        addResult(std::move(result));
+    };
+    static const auto diagContext = DiagContext("parsing benchmark elements of some container");
+    benchmarkDiagMessages("diag-message-shared-context", diagContext);
+    benchmarkDiagMessages("diag-message-copied-context", std::string(diagContext));
+
+    // print sink so the compiler can not optimize the measured code away
+    std::cerr << "(checksum of micro-benchmarks: " << sink << ")\n";
+}
+
+/*!
+ * \brief Removes the files created when running the benchmarks.
+ */
+void BenchmarkRunner::removeFiles()
+{
+    auto ec = std::error_code();
+    for (const auto &path : m_files) {
+        std::filesystem::remove(path, ec);
+    }
+}
+
+void printHelp()
+{
+    std::cout << "Runs benchmarks on synthetic files and prints the results as JSON.\n\n"
+                 "--output <path>        writes the results to the specified file instead of stdout\n"
+                 "--dir <path>           directory to create the synthetic files in (default: temp directory)\n"
+                 "--label <text>         label to add to the results (e.g. the commit ID)\n"
+                 "--formats <names>      comma-separated list of formats (default: all)\n"
+                 "--filter <text>        only runs benchmarks containing the text in \"format/name\"\n"
+                 "--iterations <n>       number of iterations per benchmark (default: 5)\n"
+                 "--tracks <n>           number of tracks (default: 2)\n"
+                 "--clusters <n>         number of clusters/chunks/fragments/pages per track (default: 500)\n"
+                 "--block-size <n>       number of bytes per block/sample/packet (default: 4096)\n"
+                 "--tag-fields <n>       number of comment fields per tag (default: 50)\n"
+                 "--batch-files <n>      number of files to scan in batch benchmarks (default: 32)\n"
+                 "--keep-files           keeps the generated files\n\n"
+                 "formats: ";
+    for (auto index = std::size_t(); index != syntheticFormatCount; ++index) {
+        std::cout << (index ? ", " : "") << syntheticFormatName(static_cast<SyntheticFormat>(index));
+    }
+    std::cout << '\n';
+}
+
+/*!
+ * \brief The ParsingResult enum specifies whether the benchmarks should be run after parsing the command line.
+ */
+enum class ParsingResult { Run, Exit, Error };
+
+/*!
+ * \brief Parses the command line into \a options.
+ * \throws Throws ConversionException if a number is invalid.
+ */
+ParsingResult parseArgs(int argc, char *argv[], Options &options)
+{
+    for (auto index = 1; index < argc; ++index) {
+        const auto arg = std::string_view(argv[index]);
+        if (arg == "--help" || arg == "-h") {
+            printHelp();
+            return ParsingResult::Exit;
+        }
+        if (arg == "--keep-files") {
+            options.keepFiles = true;
+            continue;
+        }
+        if (index + 1 >= argc) {
+            std::cerr << "Missing value for argument \"" << arg << "\" or unknown argument.\n";
+            return ParsingResult::Error;
+        }
+        const auto value = std::string(argv[++index]);
+        if (arg == "--output") {
+            options.outputPath = value;
+        } else if (arg == "--dir") {
+            options.workingDirectory = value;
+        } else if (arg == "--label") {
+            options.label = value;
+        } else if (arg == "--filter") {
+            options.filter = value;
+        } else if (arg == "--formats") {
+            options.formats.clear();
+            for (auto begin = std::size_t(), end = std::size_t(); begin < value.size(); begin = end + 1) {
+                end = std::min(value.find(',', begin), value.size());
+                const auto name = std::string_view(value).substr(begin, end - begin);
+                auto format = SyntheticFormat();
+                if (name.empty()) {
+                    continue;
+                }
+                if (!syntheticFormatFromName(name, format)) {
+                    std::cerr << "Unknown format \"" << name << "\".\n";
+                    return ParsingResult::Error;
+                }
+                options.formats.emplace_back(format);
+            }
+        } else if (arg == "--iterations") {
+            options.iterations = stringToNumber<std::size_t>(value);
+        } else if (arg == "--tracks") {
+            options.generator.trackCount = stringToNumber<std::size_t>(value);
+        } else if (arg == "--clusters") {
+            options.generator.clusterCount = stringToNumber<std::size_t>(value);
+        } else if (arg == "--block-size") {
+            options.generator.blockSize = stringToNumber<std::size_t>(value);
+        } else if (arg == "--tag-fields") {
+            options.tagFieldCount = stringToNumber<std::size_t>(value);
+        } else if (arg == "--batch-files") {
+            options.batchFileCount = stringToNumber<std::size_t>(value);
+        } else {
+            std::cerr << "Unknown argument \"" << arg << "\".\n";
+            return ParsingResult::Error;
+        }
+    }
+    return ParsingResult::Run;
+}
+
+} // namespace
+/// \endcond
+
+int main(int argc, char *argv[])
+{
+    auto options = Options();
+    for (auto index = std::size_t(); index != syntheticFormatCount; ++index) {
+        options.formats.emplace_back(static_cast<SyntheticFormat>(index));
+    }
+    try {
+        switch (parseArgs(argc, argv, options)) {
+        case ParsingResult::Run:
+            break;
+        case ParsingResult::Exit:
+            return EXIT_SUCCESS;
+        case ParsingResult::Error:
+            return EXIT_FAILURE;
+        }
+    } catch (const ConversionException &e) {
+        std::cerr << "Invalid number specified: " << e.what() << '\n';
+        return EXIT_FAILURE;
+    }
+    if (options.workingDirectory.empty()) {
+        options.workingDirectory = (std::filesystem::temp_directory_path() / "tagparser-benchmarks").string();
+    }
+
+    auto benchmarks = BenchmarkRunner(options);
+    auto exitCode = EXIT_SUCCESS;
+    try {
+        benchmarks.runFileBenchmarks();
+        benchmarks.runBatchScanBenchmarks();
+        benchmarks.runMicroBenchmarks();
+    } catch (const std::exception &e) {
+        std::cerr << "Unable to run benchmarks: " << e.what() << '\n';
+        exitCode = EXIT_FAILURE;
+    }
+    if (!options.keepFiles) {
+        benchmarks.removeFiles();
+    }
+
+    if (options.outputPath.empty()) {
+        writeJson(std::cout, options, benchmarks.results());
+    } else {
+        auto output = std::ofstream();
+        output.exceptions(std::ios_base::failbit | std::ios_base::badbit);
+        try {
+            output.open(options.outputPath, std::ios_base::out | std::ios_base::trunc);
+            writeJson(output, options, benchmarks.results());
+        } catch (const std::ios_base::failure &e) {
+            std::cerr << "Unable to write results to \"" << options.outputPath << "\": " << e.what() << '\n';
+            exitCode = EXIT_FAILURE;
+        }
+    }
+    return exitCode;
+}
@@ -18,7 +18,7 @@ struct TAG_PARSER_EXPORT CaseInsensitiveCharComparer {
         return (c >= 'A' && c <= 'Z') ? (c + ('a' - 'A')) : c;
     }
 
-    bool operator()(const unsigned char lhs, const unsigned char rhs) const
+    constexpr bool operator()(const unsigned char lhs, const unsigned char rhs) const
     {
         return toLower(lhs) < toLower(rhs);
     }
@@ -32,9 +32,18 @@ struct TAG_PARSER_EXPORT CaseInsensitiveStringComparer {
     {
         return std::lexicographical_compare(lhs.cbegin(), lhs.cend(), rhs.cbegin(), rhs.cend(), CaseInsensitiveCharComparer());
     }
-    bool operator()(std::string_view lhs, std::string_view rhs) const
+    constexpr bool operator()(std::string_view lhs, std::string_view rhs) const
     {
-        return std::lexicographical_compare(lhs.cbegin(), lhs.cend(), rhs.cbegin(), rhs.cend(), CaseInsensitiveCharComparer());
+        // note: Not using std::lexicographical_compare() here as it is not constexpr before C++20.
+        const auto size = lhs.size() < rhs.size() ? lhs.size() : rhs.size();
+        for (std::size_t i = 0; i != size; ++i) {
+            const auto l = CaseInsensitiveCharComparer::toLower(static_cast<unsigned char>(lhs[i]));
+            const auto r = CaseInsensitiveCharComparer::toLower(static_cast<unsigned char>(rhs[i]));
+            if (l != r) {
+                return l < r;
+            }
+        }
+        return lhs.size() < rhs.size();
     }
 };
 
@@ -0,0 +1,47 @@
+#ifndef TAG_PARSER_CHANGEPLAN_H
+#define TAG_PARSER_CHANGEPLAN_H
+
+#include "./global.h"
+#include "./settings.h"
+
+#include <cstdint>
+
+namespace TagParser {
+
+/*!
+ * \brief The ChangeStrategy enum specifies how MediaFileInfo::applyChanges() would apply the pending changes.
+ */
+enum class ChangeStrategy : std::uint8_t {
+    None, /**< there are no pending changes; the file would be left untouched */
+    InPlace, /**< the file would be updated in-place; the media data is neither moved nor copied */
+    Rewrite, /**< the file would be rewritten entirely; the media data is copied from a backup file */
+};
+
+/*!
+ * \brief The ChangePlan struct describes how MediaFileInfo::applyChanges() would apply the pending changes.
+ *
+ * An instance is obtained via MediaFileInfo::planChanges(). It is computed from the same size and padding calculations
+ * applyChanges() uses but without touching the file.
+ */
+struct TAG_PARSER_EXPORT ChangePlan {
+    /// \brief Whether the file would be left untouched, updated in-place or rewritten.
+    ChangeStrategy strategy = ChangeStrategy::None;
+    /// \brief The padding the file would have after applying the changes.
+    std::uint64_t newPadding = 0;
+    /// \brief The number of bytes which would be copied from the original file (mainly the media data when rewriting).
+    std::uint64_t bytesToCopy = 0;
+    /// \brief The total number of bytes which would be written (including bytesToCopy and padding).
+    std::uint64_t bytesToWrite = 0;
+    /// \brief The size the file would have after applying the changes.
+    std::uint64_t newSize = 0;
+    /// \brief Where tags would be placed (ElementPosition::Keep if not applicable or not changed).
+    ElementPosition tagPosition = ElementPosition::Keep;
+    /// \brief Where the index would be placed (ElementPosition::Keep if not applicable or not changed).
+    ElementPosition indexPosition = ElementPosition::Keep;
+    /// \brief Whether the numbers are only estimated (e.g. for Ogg files where the page layout is only determined when writing).
+    bool isEstimated = false;
+};
+
+} // namespace TagParser
+
+#endif // TAG_PARSER_CHANGEPLAN_H
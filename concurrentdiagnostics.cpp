@@ -0,0 +1,88 @@
+#include "./concurrentdiagnostics.h"
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <thread>
+
+using namespace std;
+
+namespace TagParser {
+
+/*!
+ * \class TagParser::ConcurrentDiagnostics
+ * \brief The ConcurrentDiagnostics class collects diagnostic messages from multiple threads.
+ *
+ * Parsing functions take a plain Diagnostics object which must not be shared between threads. So each thread obtains
+ * its own buffer via makeBuffer() (or collect()), passes it to the parsing functions and submits it under an order key
+ * when done with a unit of work. Submitting only locks one of multiple shards (chosen by thread ID) so threads hardly
+ * contend and messages are not locked individually.
+ *
+ * When reading the messages via merge() or mergeInto(), the buffers are concatenated ordered by their keys. So the
+ * order of the messages does not depend on the scheduling of the threads as long as the keys are unique (e.g. the
+ * index of the processed element or file). Buffers with the same key are ordered by shard and submission.
+ */
+
+/*!
+ * \brief Constructs a new instance; messages below \a minLevel are dropped by the buffers.
+ */
+ConcurrentDiagnostics::ConcurrentDiagnostics(DiagLevel minLevel)
+    : m_minLevel(minLevel)
+{
+}
+
+/*!
+ * \brief Submits the specified \a buffer under the specified \a order.
+ * \remarks
+ * - This function is thread-safe.
+ * - Empty buffers are discarded right away.
+ */
+void ConcurrentDiagnostics::submit(std::uint64_t order, Diagnostics &&buffer)
+{
+    if (buffer.empty()) {
+        return;
+    }
+    auto &shard = m_shards[std::hash<std::thread::id>()(std::this_thread::get_id()) % shardCount];
+    const auto lock = std::lock_guard<std::mutex>(shard.mutex);
+    shard.buffers.emplace_back(order, std::move(buffer));
+}
+
+/*!
+ * \brief Moves all submitted messages to the end of the specified \a diag ordered by the keys they have been submitted with.
+ * \remarks
+ * - This function is thread-safe but buffers submitted concurrently might be missed. So it is supposed to be called
+ *   after all threads have submitted their buffers.
+ * - The current instance is empty afterwards.
+ */
+void ConcurrentDiagnostics::mergeInto(Diagnostics &diag)
+{
+    auto buffers = std::vector<std::pair<std::uint64_t, Diagnostics>>();
+    for (auto &shard : m_shards) {
+        const auto lock = std::lock_guard<std::mutex>(shard.mutex);
+        std::move(shard.buffers.begin(), shard.buffers.end(), std::back_inserter(buffers));
+        shard.buffers.clear();
+    }
+    std::stable_sort(buffers.begin(), buffers.end(), [](const auto &lhs, const auto &rhs) { return lhs.first < rhs.first; });
+    auto messageCount = diag.size();
+    for (const auto &buffer : buffers) {
+        messageCount += buffer.second.size();
+    }
+    diag.reserve(messageCount);
+    for (auto &buffer : buffers) {
+        diag.insert(diag.end(), std::make_move_iterator(buffer.second.begin()), std::make_move_iterator(buffer.second.end()));
+    }
+}
+
+/*!
+ * \brief Returns all submitted messages ordered by the keys they have been submitted with.
+ * \remarks Same as mergeInto() but returns a new Diagnostics object.
+ */
+Diagnostics ConcurrentDiagnostics::merge()
+{
+    auto diag = Diagnostics();
+    diag.setMinLevel(m_minLevel);
+    mergeInto(diag);
+    return diag;
+}
+
+} // namespace TagParser
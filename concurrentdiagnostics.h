@@ -0,0 +1,84 @@
+#ifndef TAG_PARSER_CONCURRENTDIAGNOSTICS_H
+#define TAG_PARSER_CONCURRENTDIAGNOSTICS_H
+
+#include "./diagnostics.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace TagParser {
+
+class TAG_PARSER_EXPORT ConcurrentDiagnostics {
+public:
+    explicit ConcurrentDiagnostics(DiagLevel minLevel = DiagLevel::None);
+    ConcurrentDiagnostics(const ConcurrentDiagnostics &) = delete;
+    ConcurrentDiagnostics &operator=(const ConcurrentDiagnostics &) = delete;
+
+    DiagLevel minLevel() const;
+    Diagnostics makeBuffer() const;
+    void submit(std::uint64_t order, Diagnostics &&buffer);
+    template <typename Function> void collect(std::uint64_t order, Function &&function);
+    void mergeInto(Diagnostics &diag);
+    Diagnostics merge();
+
+private:
+    /// \brief The number of shards; submissions from different threads likely end up in different shards.
+    static constexpr std::size_t shardCount = 16;
+
+    /*!
+     * \brief The Shard struct holds the buffers submitted to a certain shard along with their order keys.
+     * \remarks Aligned to avoid false sharing between the mutexes of different shards.
+     */
+    struct alignas(64) Shard {
+        std::mutex mutex;
+        std::vector<std::pair<std::uint64_t, Diagnostics>> buffers;
+    };
+
+    DiagLevel m_minLevel;
+    std::array<Shard, shardCount> m_shards;
+};
+
+/*!
+ * \brief Returns the minimum level of messages which are kept.
+ */
+inline DiagLevel ConcurrentDiagnostics::minLevel() const
+{
+    return m_minLevel;
+}
+
+/*!
+ * \brief Returns a new, empty buffer using the minLevel() of the current instance.
+ * \remarks The buffer is supposed to be passed to parsing functions by a single thread and to be submitted afterwards.
+ */
+inline Diagnostics ConcurrentDiagnostics::makeBuffer() const
+{
+    auto buffer = Diagnostics();
+    buffer.setMinLevel(m_minLevel);
+    return buffer;
+}
+
+/*!
+ * \brief Invokes \a function with a new buffer and submits the buffer under the specified \a order afterwards.
+ * \remarks
+ * - This function is thread-safe.
+ * - The buffer is submitted even if \a function throws.
+ */
+template <typename Function> void ConcurrentDiagnostics::collect(std::uint64_t order, Function &&function)
+{
+    auto buffer = makeBuffer();
+    try {
+        function(buffer);
+    } catch (...) {
+        submit(order, std::move(buffer));
+        throw;
+    }
+    submit(order, std::move(buffer));
+}
+
+} // namespace TagParser
+
+#endif // TAG_PARSER_CONCURRENTDIAGNOSTICS_H
@@ -9,11 +9,25 @@ namespace TagParser {
  * \brief The DiagMessage class holds an information, warning or error gathered during parsing or making.
  */
 
+/*!
+ * \class DiagContext
+ * \brief The DiagContext class holds a context which is used by many DiagMessage instances.
+ *
+ * Most contexts are static strings like "parsing ID3v2 tag". Instead of copying such a context into every single message,
+ * it is supposed to be defined once as static constant where it is used, e.g.
+ * `static const auto context = DiagContext("parsing ID3v2 tag");`. Messages constructed with it merely refer to it so
+ * constructing them neither allocates nor synchronizes for the context.
+ *
+ * \remarks As messages only refer to the DiagContext, it must outlive all messages constructed with it. Dynamically composed
+ *          contexts should therefore just be passed as string.
+ */
+
 /*!
  * \class Diagnostics
  * \brief The Diagnostics class is a container for DiagMessage.
  * \remarks A lot of methods in this library take such a container as argument. The method will add additional
- *          information, warnings or errors to it.
+ *          information, warnings or errors to it. Messages below minLevel() are dropped without being formatted
+ *          when added via emplaceFormatted().
  */
 
 /*!
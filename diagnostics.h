@@ -4,8 +4,11 @@
 #include "./global.h"
 
 #include <c++utilities/chrono/datetime.h>
+#include <c++utilities/conversion/stringbuilder.h>
 
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace TagParser {
@@ -38,12 +41,23 @@ constexpr DiagLevel &operator|=(DiagLevel &lhs, const DiagLevel &rhs)
     return lhs;
 }
 
-class DiagMessage {
+class TAG_PARSER_EXPORT DiagContext : public std::string {
 public:
-    DiagMessage(DiagLevel level, const std::string &message, const std::string &context);
-    DiagMessage(DiagLevel level, std::string &&message, const std::string &context);
-    DiagMessage(DiagLevel level, const std::string &message, std::string &&context);
-    DiagMessage(DiagLevel level, std::string &&message, std::string &&context);
+    explicit DiagContext(std::string_view context);
+};
+
+/*!
+ * \brief Constructs a new DiagContext with the specified \a context.
+ */
+inline DiagContext::DiagContext(std::string_view context)
+    : std::string(context)
+{
+}
+
+class TAG_PARSER_EXPORT DiagMessage {
+public:
+    DiagMessage(DiagLevel level, std::string message, std::string_view context);
+    DiagMessage(DiagLevel level, std::string message, const DiagContext &context);
 
     DiagLevel level() const;
     std::string_view levelName() const;
@@ -57,50 +71,32 @@ public:
 private:
     DiagLevel m_level;
     std::string m_message;
-    std::string m_context;
+    std::string m_ownContext;
+    const std::string *m_sharedContext;
     CppUtilities::DateTime m_creationTime;
 };
 
 /*!
  * \brief Constructs a new DiagMessage.
+ * \remarks The \a context is copied. Use the overload taking a DiagContext for contexts which are not composed dynamically.
  */
-inline DiagMessage::DiagMessage(DiagLevel level, const std::string &message, const std::string &context)
+inline DiagMessage::DiagMessage(DiagLevel level, std::string message, std::string_view context)
     : m_level(level)
-    , m_message(message)
-    , m_context(context)
+    , m_message(std::move(message))
+    , m_ownContext(context)
+    , m_sharedContext(nullptr)
     , m_creationTime(CppUtilities::DateTime::gmtNow())
 {
 }
 
 /*!
- * \brief Constructs a new DiagMessage.
+ * \brief Constructs a new DiagMessage referring to the specified \a context.
+ * \remarks The \a context is not copied so it must outlive the message (see DiagContext).
  */
-inline DiagMessage::DiagMessage(DiagLevel level, std::string &&message, const std::string &context)
+inline DiagMessage::DiagMessage(DiagLevel level, std::string message, const DiagContext &context)
     : m_level(level)
-    , m_message(message)
-    , m_context(context)
-    , m_creationTime(CppUtilities::DateTime::gmtNow())
-{
-}
-
-/*!
- * \brief Constructs a new DiagMessage.
- */
-inline DiagMessage::DiagMessage(DiagLevel level, const std::string &message, std::string &&context)
-    : m_level(level)
-    , m_message(message)
-    , m_context(context)
-    , m_creationTime(CppUtilities::DateTime::gmtNow())
-{
-}
-
-/*!
- * \brief Constructs a new DiagMessage.
- */
-inline DiagMessage::DiagMessage(DiagLevel level, std::string &&message, std::string &&context)
-    : m_level(level)
-    , m_message(message)
-    , m_context(context)
+    , m_message(std::move(message))
+    , m_sharedContext(&context)
     , m_creationTime(CppUtilities::DateTime::gmtNow())
 {
 }
@@ -134,7 +130,7 @@ inline const std::string &DiagMessage::message() const
  */
 inline const std::string &DiagMessage::context() const
 {
-    return m_context;
+    return m_sharedContext ? *m_sharedContext : m_ownContext;
 }
 
 /*!
@@ -150,7 +146,7 @@ inline const CppUtilities::DateTime &DiagMessage::creationTime() const
  */
 inline bool DiagMessage::operator==(const DiagMessage &other) const
 {
-    return m_level == other.m_level && m_message == other.m_message && m_context == other.m_context;
+    return m_level == other.m_level && m_message == other.m_message && context() == other.context();
 }
 
 class TAG_PARSER_EXPORT Diagnostics : public std::vector<DiagMessage> {
@@ -158,8 +154,17 @@ public:
     Diagnostics() = default;
     Diagnostics(std::initializer_list<DiagMessage> list);
 
+    DiagLevel minLevel() const;
+    void setMinLevel(DiagLevel minLevel);
+    bool isEnabled(DiagLevel level) const;
+    template <typename... Args> void emplace_back(DiagLevel level, Args &&...args);
+    template <typename Context, typename... MessageParts>
+    void emplaceFormatted(DiagLevel level, const Context &context, MessageParts &&...messageParts);
     bool has(DiagLevel level) const;
     DiagLevel level() const;
+
+private:
+    DiagLevel m_minLevel = DiagLevel::None;
 };
 
 /*!
@@ -170,6 +175,58 @@ inline Diagnostics::Diagnostics(std::initializer_list<DiagMessage> list)
 {
 }
 
+/*!
+ * \brief Returns the minimum level of messages added via emplace_back() and emplaceFormatted().
+ * \remarks By default, all messages are added.
+ */
+inline DiagLevel Diagnostics::minLevel() const
+{
+    return m_minLevel;
+}
+
+/*!
+ * \brief Sets the minimum level of messages added via emplace_back() and emplaceFormatted().
+ * \remarks Messages of a lower level are dropped. If emplaceFormatted() is used they are not even formatted.
+ */
+inline void Diagnostics::setMinLevel(DiagLevel minLevel)
+{
+    m_minLevel = minLevel;
+}
+
+/*!
+ * \brief Returns whether messages of the specified \a level are added.
+ * \remarks Can be used to skip expensive computations which are only done to compose a message.
+ */
+inline bool Diagnostics::isEnabled(DiagLevel level) const
+{
+    return level >= m_minLevel;
+}
+
+/*!
+ * \brief Constructs a new DiagMessage with the specified \a level and \a args and appends it if its level is enabled.
+ * \remarks Hides std::vector::emplace_back() to take minLevel() into account.
+ */
+template <typename... Args> inline void Diagnostics::emplace_back(DiagLevel level, Args &&...args)
+{
+    if (isEnabled(level)) {
+        std::vector<DiagMessage>::emplace_back(level, std::forward<Args>(args)...);
+    }
+}
+
+/*!
+ * \brief Appends a new DiagMessage with the specified \a level and \a context if its level is enabled.
+ * \remarks The message is composed from the specified \a messageParts via CppUtilities::argsToString() only if the level
+ *          is enabled. So this is preferable over emplace_back() for messages which need to be formatted.
+ * \remarks The \a context might be a DiagContext or anything convertible to std::string_view.
+ */
+template <typename Context, typename... MessageParts>
+inline void Diagnostics::emplaceFormatted(DiagLevel level, const Context &context, MessageParts &&...messageParts)
+{
+    if (isEnabled(level)) {
+        std::vector<DiagMessage>::emplace_back(level, CppUtilities::argsToString(std::forward<MessageParts>(messageParts)...), context);
+    }
+}
+
 } // namespace TagParser
 
 #endif // TAGPARSER_DIAGNOSTICS_H
@@ -1,10 +1,13 @@
 #ifndef TAG_PARSER_FIELDBASEDTAG_H
 #define TAG_PARSER_FIELDBASEDTAG_H
 
+#include "./flatmultimap.h"
+#include "./memoryusage.h"
 #include "./tag.h"
 
 #include <functional>
 #include <map>
+#include <type_traits>
 
 namespace TagParser {
 
@@ -12,14 +15,27 @@ namespace TagParser {
  * \class TagParser::FieldMapBasedTagTraits
  * \brief Defines traits for the specified \a ImplementationType.
  *
- * A template specialization for each FieldMapBasedTag subclass must be provided.
+ * A template specialization for each FieldMapBasedTag subclass must be provided. It needs to define the FieldType and the
+ * Compare function for the field IDs. It may define the alias template Container<Key, Value, Compare> to select the associative
+ * container used to store the fields (e.g. FlatMultiMap). If not defined, std::multimap is used.
  */
 template <typename ImplementationType> class FieldMapBasedTagTraits {};
 
+/// \cond
+template <typename Traits, typename Key, typename Value, typename Compare, typename = void> struct FieldMapBasedTagContainer {
+    using type = std::multimap<Key, Value, Compare>;
+};
+
+template <typename Traits, typename Key, typename Value, typename Compare>
+struct FieldMapBasedTagContainer<Traits, Key, Value, Compare, std::void_t<typename Traits::template Container<Key, Value, Compare>>> {
+    using type = typename Traits::template Container<Key, Value, Compare>;
+};
+/// \endcond
+
 /*!
  * \class TagParser::FieldMapBasedTag
  * \brief The FieldMapBasedTag provides a generic implementation of Tag which stores
- *        the tag fields using std::multimap.
+ *        the tag fields using std::multimap or another associative container selected via FieldMapBasedTagTraits.
  *
  * The FieldMapBasedTag class only provides the interface and common functionality.
  * It is meant to be subclassed using CRTP pattern.
@@ -34,6 +50,8 @@ public:
     using FieldType = typename FieldMapBasedTagTraits<ImplementationType>::FieldType;
     using IdentifierType = typename FieldMapBasedTagTraits<ImplementationType>::FieldType::IdentifierType;
     using Compare = typename FieldMapBasedTagTraits<ImplementationType>::Compare;
+    using FieldMap = typename FieldMapBasedTagContainer<FieldMapBasedTagTraits<ImplementationType>, IdentifierType, FieldType, Compare>::type;
+    using SkippedFieldMap = typename FieldMapBasedTagContainer<FieldMapBasedTagTraits<ImplementationType>, IdentifierType, TagValue, Compare>::type;
 
     FieldMapBasedTag();
 
@@ -51,8 +69,10 @@ public:
     bool hasField(KnownField field) const;
     bool hasField(const IdentifierType &id) const;
     void removeAllFields();
-    const std::multimap<IdentifierType, FieldType, Compare> &fields() const;
-    std::multimap<IdentifierType, FieldType, Compare> &fields();
+    const FieldMap &fields() const;
+    FieldMap &fields();
+    const SkippedFieldMap &skippedFields() const;
+    SkippedFieldMap &skippedFields();
     std::size_t fieldCount() const;
     IdentifierType fieldId(KnownField value) const;
     KnownField knownField(const IdentifierType &id) const;
@@ -62,6 +82,7 @@ public:
     std::size_t insertFields(const FieldMapBasedTag<ImplementationType> &from, bool overwrite);
     std::size_t insertValues(const Tag &from, bool overwrite);
     void ensureTextValuesAreProperlyEncoded();
+    void addMemoryUsage(MemoryUsage &usage) const override;
 
 protected:
     using CRTPBase = FieldMapBasedTag<ImplementationType>;
@@ -75,9 +96,13 @@ protected:
     // no default implementation: IdentifierType internallyGetFieldId(KnownField field) const;
     // no default implementation: KnownField internallyGetKnownField(const IdentifierType &id) const;
     TagDataType internallyGetProposedDataType(const IdentifierType &id) const;
+    FieldMap &internallyGetFields();
+    SkippedFieldMap &internallyGetSkippedFields();
+    static void addFieldMemoryUsage(const FieldType &field, MemoryUsage &usage);
 
 private:
-    std::multimap<IdentifierType, FieldType, Compare> m_fields;
+    FieldMap m_fields;
+    SkippedFieldMap m_skippedFields;
 };
 
 /*!
@@ -233,16 +258,17 @@ bool FieldMapBasedTag<ImplementationType>::internallySetValues(const FieldMapBas
             ++range.first;
         }
     }
+    // remove remaining existing values (there are more existing values than specified ones)
+    for (; range.first != range.second; ++range.first) {
+        range.first->second.clearValue();
+    }
     // add remaining specified values (there are more specified values than existing ones)
+    // note: Done last as inserting might invalidate the iterators of range (depending on the container).
     for (; valuesIterator != values.cend(); ++valuesIterator) {
         if (!valuesIterator->isEmpty()) {
             m_fields.insert(std::make_pair(id, FieldType(id, *valuesIterator)));
         }
     }
-    // remove remaining existing values (there are more existing values than specified ones)
-    for (; range.first != range.second; ++range.first) {
-        range.first->second.clearValue();
-    }
     return true;
 }
 
@@ -252,6 +278,11 @@ bool FieldMapBasedTag<ImplementationType>::internallySetValues(const FieldMapBas
  */
 template <class ImplementationType> bool FieldMapBasedTag<ImplementationType>::setValue(const IdentifierType &id, const TagParser::TagValue &value)
 {
+    if (!m_skippedFields.erase(id) && this->value(id).compareTo(value, TagValueComparisionFlags::Exact)) {
+        // leave the tag untouched if the value is already present so it is not considered modified
+        return !value.isEmpty() || m_fields.find(id) != m_fields.end();
+    }
+    m_modified = true;
     return static_cast<ImplementationType *>(this)->internallySetValue(id, value);
 }
 
@@ -264,6 +295,25 @@ template <class ImplementationType> bool FieldMapBasedTag<ImplementationType>::s
 template <class ImplementationType>
 bool FieldMapBasedTag<ImplementationType>::setValues(const IdentifierType &id, const std::vector<TagValue> &values)
 {
+    if (!m_skippedFields.erase(id)) {
+        // leave the tag untouched if the (non-empty) values are already present in the same order so it is not considered modified
+        const auto presentValues = this->values(id);
+        auto presentValue = presentValues.cbegin();
+        auto specifiedValue = values.cbegin();
+        for (; specifiedValue != values.cend(); ++specifiedValue) {
+            if (specifiedValue->isEmpty()) {
+                continue;
+            }
+            if (presentValue == presentValues.cend() || !(*presentValue)->compareTo(*specifiedValue, TagValueComparisionFlags::Exact)) {
+                break;
+            }
+            ++presentValue;
+        }
+        if (specifiedValue == values.cend() && presentValue == presentValues.cend()) {
+            return true;
+        }
+    }
+    m_modified = true;
     return static_cast<ImplementationType *>(this)->internallySetValues(id, values);
 }
 
@@ -317,26 +367,81 @@ template <class ImplementationType> inline bool FieldMapBasedTag<ImplementationT
 
 template <class ImplementationType> inline void FieldMapBasedTag<ImplementationType>::removeAllFields()
 {
+    if (m_fields.empty() && m_skippedFields.empty()) {
+        return;
+    }
     m_fields.clear();
+    m_skippedFields.clear();
+    m_modified = true;
 }
 
 /*!
  * \brief Returns the fields of the tag by providing direct access to the field map of the tag.
+ * \remarks Depending on FieldMapBasedTagTraits this is not necessarily a std::multimap. In case it is a FlatMultiMap, inserting
+ *          and removing fields invalidates iterators and references to other fields.
  */
 template <class ImplementationType>
-inline auto FieldMapBasedTag<ImplementationType>::fields() const -> const std::multimap<IdentifierType, FieldType, Compare> &
+inline auto FieldMapBasedTag<ImplementationType>::fields() const -> const FieldMap &
 {
     return m_fields;
 }
 
 /*!
  * \brief Returns the fields of the tag by providing direct access to the field map of the tag.
+ * \remarks
+ * - The tag is considered modified after calling this method, see Tag::isModified().
+ * - Depending on FieldMapBasedTagTraits this is not necessarily a std::multimap. In case it is a FlatMultiMap, inserting
+ *   and removing fields invalidates iterators and references to other fields.
+ */
+template <class ImplementationType> inline auto FieldMapBasedTag<ImplementationType>::fields() -> FieldMap &
+{
+    m_modified = true;
+    return m_fields;
+}
+
+/*!
+ * \brief Returns the raw data of fields which have been skipped when parsing the tag due to a TagFieldFilter.
+ *
+ * The fields have not been decoded and are therefore not present in fields(). Their raw data (in the format
+ * of the particular tag, possibly loaded lazily via TagValue::lazyData()) is written back as-is when making the tag. Setting
+ * a value via setValue() or setValues() discards skipped fields with the same ID.
+ */
+template <class ImplementationType>
+inline auto FieldMapBasedTag<ImplementationType>::skippedFields() const -> const SkippedFieldMap &
+{
+    return m_skippedFields;
+}
+
+/*!
+ * \brief Returns the raw data of fields which have been skipped when parsing the tag due to a TagFieldFilter.
+ * \sa See the const overload for details.
+ * \remarks The tag is considered modified after calling this method, see Tag::isModified().
  */
-template <class ImplementationType> inline auto FieldMapBasedTag<ImplementationType>::fields() -> std::multimap<IdentifierType, FieldType, Compare> &
+template <class ImplementationType>
+inline auto FieldMapBasedTag<ImplementationType>::skippedFields() -> SkippedFieldMap &
+{
+    m_modified = true;
+    return m_skippedFields;
+}
+
+/*!
+ * \brief Returns the fields of the tag without considering the tag modified.
+ * \remarks Only meant to be used when making the tag which requires mutable access to the fields but does not alter their values.
+ */
+template <class ImplementationType> inline auto FieldMapBasedTag<ImplementationType>::internallyGetFields() -> FieldMap &
 {
     return m_fields;
 }
 
+/*!
+ * \brief Returns the skipped fields of the tag without considering the tag modified.
+ * \remarks Only meant to be used when making the tag, see internallyGetFields().
+ */
+template <class ImplementationType> inline auto FieldMapBasedTag<ImplementationType>::internallyGetSkippedFields() -> SkippedFieldMap &
+{
+    return m_skippedFields;
+}
+
 template <class ImplementationType> std::size_t FieldMapBasedTag<ImplementationType>::fieldCount() const
 {
     auto count = std::size_t(0);
@@ -445,6 +550,35 @@ template <class ImplementationType> void FieldMapBasedTag<ImplementationType>::e
     }
 }
 
+/*!
+ * \brief Adds the memory held by the fields (including skipped fields) and their values to \a usage.
+ * \remarks The storage of the fields is estimated from their number.
+ */
+template <class ImplementationType> void FieldMapBasedTag<ImplementationType>::addMemoryUsage(MemoryUsage &usage) const
+{
+    Tag::addMemoryUsage(usage);
+    usage.tags += m_fields.size() * sizeof(typename FieldMap::value_type) + m_skippedFields.size() * sizeof(typename SkippedFieldMap::value_type);
+    for (const auto &field : m_fields) {
+        addFieldMemoryUsage(field.second, usage);
+    }
+    for (const auto &skippedField : m_skippedFields) {
+        usage.tagValuesOfType(skippedField.second.type()) += skippedField.second.memoryUsage();
+    }
+}
+
+/*!
+ * \brief Adds the memory held by the value and the nested fields of the specified \a field to \a usage.
+ */
+template <class ImplementationType>
+void FieldMapBasedTag<ImplementationType>::addFieldMemoryUsage(const FieldType &field, MemoryUsage &usage)
+{
+    usage.tagValuesOfType(field.value().type()) += field.value().memoryUsage();
+    usage.tags += MemoryUsage::ofVector(field.nestedFields());
+    for (const auto &nestedField : field.nestedFields()) {
+        addFieldMemoryUsage(nestedField, usage);
+    }
+}
+
 } // namespace TagParser
 
 #endif // TAG_PARSER_FIELDBASEDTAG_H
@@ -0,0 +1,98 @@
+#ifndef TAG_PARSER_FIELDIDTABLE_H
+#define TAG_PARSER_FIELDIDTABLE_H
+
+#include "./tag.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+namespace TagParser {
+
+/// \cond
+
+/*!
+ * \brief The FieldIdMapping struct associates a native field ID with a KnownField.
+ */
+template <typename IdType> struct FieldIdMapping {
+    IdType id = IdType();
+    KnownField field = KnownField::Invalid;
+};
+
+/*!
+ * \brief Returns the specified \a mappings and \a exceptions sorted by ID using \a compare at compile-time.
+ * \remarks The \a exceptions only apply when looking up the KnownField for an ID and take precedence over the \a mappings. So
+ *          they can add further IDs for a field (e.g. alternative spellings) or exclude an ID from the lookup by mapping it to
+ *          KnownField::Invalid.
+ * \remarks Insertion sort is used as it is stable (so the first of multiple mappings with an equivalent ID is found when
+ *          looking up an ID via knownFieldFromTable()) and the tables are small.
+ */
+template <typename IdType, std::size_t size, std::size_t exceptionCount, typename Compare>
+constexpr std::array<FieldIdMapping<IdType>, exceptionCount + size> makeKnownFieldTable(
+    const FieldIdMapping<IdType> (&mappings)[size], const FieldIdMapping<IdType> (&exceptions)[exceptionCount], Compare compare)
+{
+    auto table = std::array<FieldIdMapping<IdType>, exceptionCount + size>();
+    for (std::size_t i = 0; i < exceptionCount; ++i) {
+        table[i] = exceptions[i];
+    }
+    for (std::size_t i = 0; i < size; ++i) {
+        table[exceptionCount + i] = mappings[i];
+    }
+    for (std::size_t i = 1; i < table.size(); ++i) {
+        const auto mapping = table[i];
+        auto j = i;
+        for (; j > 0 && compare(mapping.id, table[j - 1].id); --j) {
+            table[j] = table[j - 1];
+        }
+        table[j] = mapping;
+    }
+    return table;
+}
+
+/*!
+ * \brief Returns the KnownField for the specified \a id looking it up in the specified \a table via binary search.
+ * \remarks The \a table must have been created via makeKnownFieldTable() using the same \a compare function.
+ */
+template <typename IdType, std::size_t size, typename Compare>
+inline KnownField knownFieldFromTable(const std::array<FieldIdMapping<IdType>, size> &table, IdType id, Compare compare)
+{
+    const auto i = std::lower_bound(
+        table.cbegin(), table.cend(), id, [&compare](const FieldIdMapping<IdType> &mapping, IdType id) { return compare(mapping.id, id); });
+    return i != table.cend() && !compare(id, i->id) ? i->field : KnownField::Invalid;
+}
+
+/*!
+ * \brief Returns an array mapping each KnownField (used as index) to its ID as specified via \a mappings at compile-time.
+ * \remarks Fields without mapping are mapped to a default-constructed ID. If there are multiple mappings for the same field, the
+ *          first one takes precedence.
+ */
+template <typename IdType, std::size_t size>
+constexpr std::array<IdType, knownFieldArraySize> makeFieldIdTable(const FieldIdMapping<IdType> (&mappings)[size])
+{
+    auto table = std::array<IdType, knownFieldArraySize>();
+    auto assigned = std::array<bool, knownFieldArraySize>();
+    for (const auto &mapping : mappings) {
+        const auto index = static_cast<std::size_t>(mapping.field);
+        if (index < knownFieldArraySize && !assigned[index]) {
+            table[index] = mapping.id;
+            assigned[index] = true;
+        }
+    }
+    return table;
+}
+
+/*!
+ * \brief Returns the ID for the specified \a field looking it up in the specified \a table.
+ * \remarks The \a table must have been created via makeFieldIdTable().
+ */
+template <typename IdType> inline IdType fieldIdFromTable(const std::array<IdType, knownFieldArraySize> &table, KnownField field)
+{
+    const auto index = static_cast<std::size_t>(field);
+    return index < knownFieldArraySize ? table[index] : IdType();
+}
+
+/// \endcond
+
+} // namespace TagParser
+
+#endif // TAG_PARSER_FIELDIDTABLE_H
@@ -1,5 +1,6 @@
 #include "./flacmetadata.h"
 
+#include "../abstractattachment.h"
 #include "../exceptions.h"
 #include "../tagvalue.h"
 
@@ -78,9 +79,10 @@ void FlacMetaDataBlockStreamInfo::parse(std::string_view buffer)
 /*!
  * \brief Parses the FLAC "METADATA_BLOCK_PICTURE".
  *
- * \a maxSize specifies the maximum size of the structure.
+ * \a maxSize specifies the maximum size of the structure. If \a loadDataLazily is set, the picture data is only read
+ * when accessed (see TagValue::assignLazyData()) so \a inputStream must remain valid until then.
  */
-void FlacMetaDataBlockPicture::parse(istream &inputStream, std::uint32_t maxSize)
+void FlacMetaDataBlockPicture::parse(istream &inputStream, std::uint32_t maxSize, bool loadDataLazily)
 {
     CHECK_MAX_SIZE(32);
     BinaryReader reader(&inputStream);
@@ -95,7 +97,13 @@ void FlacMetaDataBlockPicture::parse(istream &inputStream, std::uint32_t maxSize
     inputStream.seekg(4 * 4, ios_base::cur);
     size = reader.readUInt32BE();
     CHECK_MAX_SIZE(size);
-    if (size) {
+    if (size && loadDataLazily) {
+        const auto startOffset = static_cast<std::uint64_t>(inputStream.tellg());
+        m_value.assignLazyData(make_unique<StreamDataBlock>([&inputStream]() -> std::istream & { return inputStream; }, startOffset, ios_base::beg,
+                                   startOffset + size, ios_base::beg),
+            TagDataType::Picture);
+        inputStream.seekg(size, ios_base::cur);
+    } else if (size) {
         auto data = make_unique<char[]>(size);
         inputStream.read(data.get(), size);
         m_value.assignData(std::move(data), size, TagDataType::Picture);
@@ -139,7 +147,7 @@ void FlacMetaDataBlockPicture::make(ostream &outputStream)
     writer.writeUInt32BE(0); // skip color depth
     writer.writeUInt32BE(0); // skip number of colors used
     writer.writeUInt32BE(static_cast<std::uint32_t>(m_value.dataSize()));
-    writer.write(value().dataPointer(), static_cast<streamoff>(m_value.dataSize()));
+    m_value.copyDataTo(outputStream);
 }
 
 } // namespace TagParser
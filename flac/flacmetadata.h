@@ -249,7 +249,7 @@ class TAG_PARSER_EXPORT FlacMetaDataBlockPicture {
 public:
     FlacMetaDataBlockPicture(TagValue &tagValue);
 
-    void parse(std::istream &inputStream, std::uint32_t maxSize);
+    void parse(std::istream &inputStream, std::uint32_t maxSize, bool loadDataLazily = false);
     std::uint32_t requiredSize() const;
     void make(std::ostream &outputStream);
 
@@ -6,6 +6,7 @@
 #include "../exceptions.h"
 #include "../mediafileinfo.h"
 #include "../mediaformat.h"
+#include "../memoryusage.h"
 
 #include "resources/config.h"
 
@@ -37,6 +38,18 @@ FlacStream::FlacStream(MediaFileInfo &mediaFileInfo, std::uint64_t startOffset)
     m_mediaType = MediaType::Audio;
 }
 
+/*!
+ * \brief Adds the memory held by the stream including its Vorbis comment to \a usage.
+ */
+void FlacStream::addMemoryUsage(MemoryUsage &usage) const
+{
+    AbstractTrack::addMemoryUsage(usage);
+    if (m_vorbisComment) {
+        usage.tags += sizeof(VorbisComment);
+        m_vorbisComment->addMemoryUsage(usage);
+    }
+}
+
 /*!
  * \brief Creates a new Vorbis comment for the stream.
  * \remarks Just returns the current Vorbis comment if already present.
@@ -66,7 +79,7 @@ void FlacStream::internalParseHeader(Diagnostics &diag, AbortableProgressFeedbac
 {
     CPP_UTILITIES_UNUSED(progress)
 
-    static const string context("parsing raw FLAC header");
+    static const auto context = DiagContext("parsing raw FLAC header");
     if (!m_istream) {
         throw NoDataFoundException();
     }
@@ -119,7 +132,7 @@ void FlacStream::internalParseHeader(Diagnostics &diag, AbortableProgressFeedbac
                 if (m_mediaFileInfo.fileHandlingFlags() & MediaFileHandlingFlags::ConvertTotalFields) {
                     flags += VorbisCommentFlags::ConvertTotalFields;
                 }
-                m_vorbisComment->parse(*m_istream, header.dataSize(), flags, diag);
+                m_vorbisComment->parse(*m_istream, header.dataSize(), flags, diag, &m_mediaFileInfo.tagFieldFilter());
             } catch (const Failure &) {
                 // error is logged via notifications, just continue with the next metadata block
             }
@@ -131,7 +144,7 @@ void FlacStream::internalParseHeader(Diagnostics &diag, AbortableProgressFeedbac
                 VorbisCommentField coverField;
                 coverField.setId(m_vorbisComment->fieldId(KnownField::Cover));
                 FlacMetaDataBlockPicture picture(coverField.value());
-                picture.parse(*m_istream, header.dataSize());
+                picture.parse(*m_istream, header.dataSize(), m_mediaFileInfo.fileHandlingFlags() & MediaFileHandlingFlags::LoadPicturesLazily);
                 coverField.setTypeInfo(picture.pictureType());
 
                 if (coverField.value().isEmpty()) {
@@ -143,7 +156,10 @@ void FlacStream::internalParseHeader(Diagnostics &diag, AbortableProgressFeedbac
                         m_vorbisComment = make_unique<VorbisComment>();
                         m_vorbisComment->setVendor(TagValue(APP_NAME " v" APP_VERSION, TagTextEncoding::Utf8));
                     }
+                    // note: Not considered a modification of the Vorbis comment as the cover is present in the file anyways.
+                    const auto modified = m_vorbisComment->m_modified;
                     m_vorbisComment->fields().insert(make_pair(coverField.id(), std::move(coverField)));
+                    m_vorbisComment->m_modified = modified;
                 }
 
             } catch (const TruncatedDataException &) {
@@ -258,7 +274,7 @@ std::streamoff FlacStream::makeHeader(ostream &outputStream, Diagnostics &diag)
         return lastStartOffset;
     }
     header.setType(FlacMetaDataBlockType::Picture);
-    const auto coverFields = m_vorbisComment->fields().equal_range(coverId);
+    const auto coverFields = m_vorbisComment->internallyGetFields().equal_range(coverId);
     for (auto i = coverFields.first; i != coverFields.second;) {
         const auto lastCoverStartOffset = outputStream.tellp();
 
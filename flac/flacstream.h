@@ -17,6 +17,7 @@ public:
     ~FlacStream() override;
 
     TrackType type() const override;
+    void addMemoryUsage(MemoryUsage &usage) const override;
     VorbisComment *vorbisComment() const;
     VorbisComment *createVorbisComment();
     bool removeVorbisComment();
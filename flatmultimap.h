@@ -0,0 +1,299 @@
+#ifndef TAG_PARSER_FLATMULTIMAP_H
+#define TAG_PARSER_FLATMULTIMAP_H
+
+#include "./global.h"
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace TagParser {
+
+/*!
+ * \class TagParser::FlatMultiMap
+ * \brief The FlatMultiMap class is an associative container storing key-value-pairs contiguously in a vector which is kept
+ *        sorted by key.
+ *
+ * The class provides the subset of the std::multimap interface required by FieldMapBasedTag with the same ordering
+ * semantics: Elements are ordered by \a Compare and elements with equivalent keys keep their insertion order as new
+ * elements are inserted at the upper bound of the range of equivalent keys.
+ *
+ * Compared to std::multimap there is only one allocation for all elements and iterating is cache-friendly. On the other
+ * hand inserting and erasing elements invalidates iterators, pointers and references to elements after the affected
+ * position (or to all elements if the capacity is exceeded). So unlike with std::multimap, elements must not be inserted
+ * while holding on to iterators or references.
+ *
+ * \remarks The key of the elements must not be modified via iterators as this would break the ordering.
+ */
+template <typename Key, typename Value, typename Compare = std::less<Key>> class FlatMultiMap {
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair<Key, Value>;
+    using key_compare = Compare;
+    using container_type = std::vector<value_type>;
+    using size_type = typename container_type::size_type;
+    using difference_type = typename container_type::difference_type;
+    using reference = value_type &;
+    using const_reference = const value_type &;
+    using iterator = typename container_type::iterator;
+    using const_iterator = typename container_type::const_iterator;
+
+    explicit FlatMultiMap(const Compare &compare = Compare());
+
+    iterator begin();
+    const_iterator begin() const;
+    const_iterator cbegin() const;
+    iterator end();
+    const_iterator end() const;
+    const_iterator cend() const;
+    bool empty() const;
+    size_type size() const;
+    void reserve(size_type capacity);
+    void clear();
+    key_compare key_comp() const;
+
+    iterator lower_bound(const key_type &key);
+    const_iterator lower_bound(const key_type &key) const;
+    iterator upper_bound(const key_type &key);
+    const_iterator upper_bound(const key_type &key) const;
+    std::pair<iterator, iterator> equal_range(const key_type &key);
+    std::pair<const_iterator, const_iterator> equal_range(const key_type &key) const;
+    iterator find(const key_type &key);
+    const_iterator find(const key_type &key) const;
+    size_type count(const key_type &key) const;
+
+    template <typename... Args> iterator emplace(Args &&...args);
+    iterator insert(const value_type &value);
+    iterator insert(value_type &&value);
+    template <typename Pair> iterator insert(Pair &&value);
+    iterator erase(const_iterator position);
+    iterator erase(const_iterator first, const_iterator last);
+    size_type erase(const key_type &key);
+
+private:
+    struct KeyCompare {
+        bool operator()(const value_type &lhs, const key_type &rhs) const
+        {
+            return compare(lhs.first, rhs);
+        }
+        bool operator()(const key_type &lhs, const value_type &rhs) const
+        {
+            return compare(lhs, rhs.first);
+        }
+        Compare compare;
+    };
+
+    container_type m_elements;
+    KeyCompare m_compare;
+};
+
+/*!
+ * \brief Constructs an empty map using the specified \a compare function.
+ */
+template <typename Key, typename Value, typename Compare>
+inline FlatMultiMap<Key, Value, Compare>::FlatMultiMap(const Compare &compare)
+    : m_compare{ compare }
+{
+}
+
+template <typename Key, typename Value, typename Compare> inline auto FlatMultiMap<Key, Value, Compare>::begin() -> iterator
+{
+    return m_elements.begin();
+}
+
+template <typename Key, typename Value, typename Compare> inline auto FlatMultiMap<Key, Value, Compare>::begin() const -> const_iterator
+{
+    return m_elements.begin();
+}
+
+template <typename Key, typename Value, typename Compare> inline auto FlatMultiMap<Key, Value, Compare>::cbegin() const -> const_iterator
+{
+    return m_elements.cbegin();
+}
+
+template <typename Key, typename Value, typename Compare> inline auto FlatMultiMap<Key, Value, Compare>::end() -> iterator
+{
+    return m_elements.end();
+}
+
+template <typename Key, typename Value, typename Compare> inline auto FlatMultiMap<Key, Value, Compare>::end() const -> const_iterator
+{
+    return m_elements.end();
+}
+
+template <typename Key, typename Value, typename Compare> inline auto FlatMultiMap<Key, Value, Compare>::cend() const -> const_iterator
+{
+    return m_elements.cend();
+}
+
+template <typename Key, typename Value, typename Compare> inline bool FlatMultiMap<Key, Value, Compare>::empty() const
+{
+    return m_elements.empty();
+}
+
+template <typename Key, typename Value, typename Compare> inline auto FlatMultiMap<Key, Value, Compare>::size() const -> size_type
+{
+    return m_elements.size();
+}
+
+/*!
+ * \brief Reserves space for the specified number of elements to avoid reallocations when inserting elements.
+ */
+template <typename Key, typename Value, typename Compare> inline void FlatMultiMap<Key, Value, Compare>::reserve(size_type capacity)
+{
+    m_elements.reserve(capacity);
+}
+
+template <typename Key, typename Value, typename Compare> inline void FlatMultiMap<Key, Value, Compare>::clear()
+{
+    m_elements.clear();
+}
+
+template <typename Key, typename Value, typename Compare> inline auto FlatMultiMap<Key, Value, Compare>::key_comp() const -> key_compare
+{
+    return m_compare.compare;
+}
+
+/*!
+ * \brief Returns an iterator to the first element whose key is not less than the specified \a key.
+ */
+template <typename Key, typename Value, typename Compare> inline auto FlatMultiMap<Key, Value, Compare>::lower_bound(const key_type &key) -> iterator
+{
+    return std::lower_bound(m_elements.begin(), m_elements.end(), key, m_compare);
+}
+
+template <typename Key, typename Value, typename Compare>
+inline auto FlatMultiMap<Key, Value, Compare>::lower_bound(const key_type &key) const -> const_iterator
+{
+    return std::lower_bound(m_elements.begin(), m_elements.end(), key, m_compare);
+}
+
+/*!
+ * \brief Returns an iterator to the first element whose key is greater than the specified \a key.
+ */
+template <typename Key, typename Value, typename Compare> inline auto FlatMultiMap<Key, Value, Compare>::upper_bound(const key_type &key) -> iterator
+{
+    return std::upper_bound(m_elements.begin(), m_elements.end(), key, m_compare);
+}
+
+template <typename Key, typename Value, typename Compare>
+inline auto FlatMultiMap<Key, Value, Compare>::upper_bound(const key_type &key) const -> const_iterator
+{
+    return std::upper_bound(m_elements.begin(), m_elements.end(), key, m_compare);
+}
+
+/*!
+ * \brief Returns the range of elements whose key is equivalent to the specified \a key.
+ */
+template <typename Key, typename Value, typename Compare>
+inline auto FlatMultiMap<Key, Value, Compare>::equal_range(const key_type &key) -> std::pair<iterator, iterator>
+{
+    return std::equal_range(m_elements.begin(), m_elements.end(), key, m_compare);
+}
+
+template <typename Key, typename Value, typename Compare>
+inline auto FlatMultiMap<Key, Value, Compare>::equal_range(const key_type &key) const -> std::pair<const_iterator, const_iterator>
+{
+    return std::equal_range(m_elements.begin(), m_elements.end(), key, m_compare);
+}
+
+/*!
+ * \brief Returns an iterator to the first element whose key is equivalent to the specified \a key or end() if there is none.
+ */
+template <typename Key, typename Value, typename Compare> inline auto FlatMultiMap<Key, Value, Compare>::find(const key_type &key) -> iterator
+{
+    const auto i = lower_bound(key);
+    return i != m_elements.end() && !m_compare(key, *i) ? i : m_elements.end();
+}
+
+template <typename Key, typename Value, typename Compare>
+inline auto FlatMultiMap<Key, Value, Compare>::find(const key_type &key) const -> const_iterator
+{
+    const auto i = lower_bound(key);
+    return i != m_elements.end() && !m_compare(key, *i) ? i : m_elements.end();
+}
+
+/*!
+ * \brief Returns the number of elements whose key is equivalent to the specified \a key.
+ */
+template <typename Key, typename Value, typename Compare> inline auto FlatMultiMap<Key, Value, Compare>::count(const key_type &key) const -> size_type
+{
+    const auto range = equal_range(key);
+    return static_cast<size_type>(range.second - range.first);
+}
+
+/*!
+ * \brief Constructs a new element from the specified \a args and inserts it after the elements with an equivalent key.
+ * \returns Returns an iterator to the inserted element.
+ */
+template <typename Key, typename Value, typename Compare>
+template <typename... Args>
+auto FlatMultiMap<Key, Value, Compare>::emplace(Args &&...args) -> iterator
+{
+    auto value = value_type(std::forward<Args>(args)...);
+    // check the last element first to insert elements which are already in order without searching
+    if (m_elements.empty() || !m_compare(value.first, m_elements.back())) {
+        m_elements.emplace_back(std::move(value));
+        return m_elements.end() - 1;
+    }
+    const auto position = upper_bound(value.first);
+    return m_elements.insert(position, std::move(value));
+}
+
+/*!
+ * \brief Inserts the specified \a value after the elements with an equivalent key.
+ * \returns Returns an iterator to the inserted element.
+ */
+template <typename Key, typename Value, typename Compare> inline auto FlatMultiMap<Key, Value, Compare>::insert(const value_type &value) -> iterator
+{
+    return emplace(value);
+}
+
+template <typename Key, typename Value, typename Compare> inline auto FlatMultiMap<Key, Value, Compare>::insert(value_type &&value) -> iterator
+{
+    return emplace(std::move(value));
+}
+
+template <typename Key, typename Value, typename Compare>
+template <typename Pair>
+inline auto FlatMultiMap<Key, Value, Compare>::insert(Pair &&value) -> iterator
+{
+    return emplace(std::forward<Pair>(value));
+}
+
+/*!
+ * \brief Removes the element at the specified \a position.
+ * \returns Returns an iterator to the element following the removed element.
+ */
+template <typename Key, typename Value, typename Compare> inline auto FlatMultiMap<Key, Value, Compare>::erase(const_iterator position) -> iterator
+{
+    return m_elements.erase(position);
+}
+
+/*!
+ * \brief Removes the elements within the range [\a first, \a last).
+ * \returns Returns an iterator to the element following the last removed element.
+ */
+template <typename Key, typename Value, typename Compare>
+inline auto FlatMultiMap<Key, Value, Compare>::erase(const_iterator first, const_iterator last) -> iterator
+{
+    return m_elements.erase(first, last);
+}
+
+/*!
+ * \brief Removes all elements whose key is equivalent to the specified \a key.
+ * \returns Returns the number of removed elements.
+ */
+template <typename Key, typename Value, typename Compare> auto FlatMultiMap<Key, Value, Compare>::erase(const key_type &key) -> size_type
+{
+    const auto range = equal_range(key);
+    const auto count = static_cast<size_type>(range.second - range.first);
+    m_elements.erase(range.first, range.second);
+    return count;
+}
+
+} // namespace TagParser
+
+#endif // TAG_PARSER_FLATMULTIMAP_H
@@ -2,9 +2,12 @@
 #define TAG_PARSER_GENERICCONTAINER_H
 
 #include "./abstractcontainer.h"
+#include "./genericfileelement.h"
+#include "./memoryusage.h"
 
 #include <algorithm>
 #include <memory>
+#include <type_traits>
 #include <vector>
 
 namespace TagParser {
@@ -47,6 +50,7 @@ public:
     bool addTrack(TrackType *track);
     bool removeTrack(AbstractTrack *track) override;
     void removeAllTracks() override;
+    void addMemoryUsage(MemoryUsage &usage) const override;
     void reset() override;
 
     using ContainerFileInfoType = FileInfoType;
@@ -262,7 +266,7 @@ TagType *GenericContainer<FileInfoType, TagType, TrackType, ElementType>::create
     if (!m_tags.empty()) {
         if (!target.isEmpty() && m_tags.front()->supportsTarget()) {
             for (auto &tag : m_tags) {
-                if (tag->target() == target) {
+                if (const_cast<const TagType *>(tag.get())->target() == target) {
                     return tag.get();
                 }
             }
@@ -364,6 +368,32 @@ void GenericContainer<FileInfoType, TagType, TrackType, ElementType>::removeAllT
     }
 }
 
+/*!
+ * \brief Adds the memory held by the element trees, the tags and the tracks of the container to \a usage.
+ * \remarks Element trees are only accounted if ElementType is a GenericFileElement (e.g. not for Ogg pages).
+ */
+template <class FileInfoType, class TagType, class TrackType, class ElementType>
+void GenericContainer<FileInfoType, TagType, TrackType, ElementType>::addMemoryUsage(MemoryUsage &usage) const
+{
+    if constexpr (std::is_base_of_v<GenericFileElement<ElementType>, ElementType>) {
+        if (m_firstElement) {
+            m_firstElement->addMemoryUsage(usage);
+        }
+        usage.elementNodes += MemoryUsage::ofVector(m_additionalElements);
+        for (const auto &element : m_additionalElements) {
+            element->addMemoryUsage(usage);
+        }
+    }
+    usage.tags += MemoryUsage::ofVector(m_tags) + m_tags.size() * sizeof(TagType);
+    for (const auto &tag : m_tags) {
+        tag->addMemoryUsage(usage);
+    }
+    usage.tracks += MemoryUsage::ofVector(m_tracks) + m_tracks.size() * sizeof(TrackType);
+    for (const auto &track : m_tracks) {
+        track->addMemoryUsage(usage);
+    }
+}
+
 template <class FileInfoType, class TagType, class TrackType, class ElementType>
 void GenericContainer<FileInfoType, TagType, TrackType, ElementType>::reset()
 {
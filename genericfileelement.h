@@ -2,6 +2,7 @@
 #define TAG_PARSER_GENERICFILEELEMENT_H
 
 #include "./exceptions.h"
+#include "./memoryusage.h"
 #include "./progressfeedback.h"
 
 #include <c++utilities/io/copy.h>
@@ -12,6 +13,7 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace CppUtilities {
 class BinaryReader;
@@ -129,6 +131,7 @@ public:
     template <typename TargetStream = std::ostream>
     void copyPreferablyFromBuffer(TargetStream &targetStream, Diagnostics &diag, AbortableProgressFeedback *progress);
     const std::unique_ptr<char[]> &buffer();
+    void addMemoryUsage(MemoryUsage &usage) const;
     ImplementationType *denoteFirstChild(std::uint32_t offset);
 
 protected:
@@ -952,8 +955,14 @@ void GenericFileElement<ImplementationType>::copyInternal(
     stream.seekg(static_cast<std::streamoff>(startOffset), std::ios_base::beg);
     CppUtilities::CopyHelper<0x10000> copyHelper;
     if (progress) {
-        copyHelper.callbackCopy(stream, targetStream, bytesToCopy, std::bind(&AbortableProgressFeedback::isAborted, std::ref(progress)),
-            std::bind(&AbortableProgressFeedback::updateStepPercentageFromFraction, std::ref(progress), std::placeholders::_1));
+        auto counter = ProgressCounter(*progress, bytesToCopy);
+        copyHelper.callbackCopy(
+            stream, targetStream, bytesToCopy, [&counter] { return counter.isAborted(); },
+            [&counter](double fraction) {
+                counter.set(static_cast<std::uint64_t>(fraction * static_cast<double>(counter.total())));
+                counter.report();
+            });
+        counter.reportNow();
     } else {
         copyHelper.copy(stream, targetStream, bytesToCopy);
     }
@@ -998,6 +1007,30 @@ template <class ImplementationType> constexpr std::uint8_t GenericFileElement<Im
     return FileElementTraits<ImplementationType>::minimumElementSize();
 }
 
+/*!
+ * \brief Adds the memory held by the element, its children and its subsequent siblings to \a usage.
+ * \remarks The nodes are visited iteratively so deeply nested or long sibling chains can not exhaust the stack.
+ */
+template <class ImplementationType> void GenericFileElement<ImplementationType>::addMemoryUsage(MemoryUsage &usage) const
+{
+    auto pending = std::vector<const GenericFileElement<ImplementationType> *>{ this };
+    while (!pending.empty()) {
+        const auto *const element = pending.back();
+        pending.pop_back();
+        ++usage.elementCount;
+        usage.elementNodes += sizeof(ImplementationType);
+        if (element->m_buffer) {
+            usage.elementBuffers += static_cast<std::size_t>(element->totalSize());
+        }
+        if (element->m_nextSibling) {
+            pending.emplace_back(element->m_nextSibling.get());
+        }
+        if (element->m_firstChild) {
+            pending.emplace_back(element->m_firstChild.get());
+        }
+    }
+}
+
 /*!
  * \fn GenericFileElement<ImplementationType>::internalParse()
  * \brief This method is called to perform parsing.
@@ -2,6 +2,7 @@
 
 #include "../diagnostics.h"
 #include "../exceptions.h"
+#include "../memoryusage.h"
 
 #include <c++utilities/conversion/conversionexception.h>
 #include <c++utilities/conversion/stringbuilder.h>
@@ -81,6 +82,7 @@ void Id3v1Tag::parse(std::istream &stream, Diagnostics &diag)
         m_trackPos.assignPosition(PositionInSet(*reinterpret_cast<char *>(buffer + 126), 0));
     }
     m_genre.assignStandardGenreIndex(*reinterpret_cast<unsigned char *>(buffer + 127));
+    m_modified = false;
 }
 
 /*!
@@ -92,7 +94,7 @@ void Id3v1Tag::parse(std::istream &stream, Diagnostics &diag)
  */
 void Id3v1Tag::make(ostream &stream, Diagnostics &diag)
 {
-    static const string context("making ID3v1 tag");
+    static const auto context = DiagContext("making ID3v1 tag");
     char buffer[30];
     buffer[0] = 0x54;
     buffer[1] = 0x41;
@@ -165,31 +167,36 @@ const TagValue &Id3v1Tag::value(KnownField field) const
 
 bool Id3v1Tag::setValue(KnownField field, const TagValue &value)
 {
+    TagValue *presentValue;
     switch (field) {
     case KnownField::Title:
-        m_title = value;
+        presentValue = &m_title;
         break;
     case KnownField::Artist:
-        m_artist = value;
+        presentValue = &m_artist;
         break;
     case KnownField::Album:
-        m_album = value;
+        presentValue = &m_album;
         break;
     case KnownField::RecordDate:
-        m_year = value;
+        presentValue = &m_year;
         break;
     case KnownField::Comment:
-        m_comment = value;
+        presentValue = &m_comment;
         break;
     case KnownField::TrackPosition:
-        m_trackPos = value;
+        presentValue = &m_trackPos;
         break;
     case KnownField::Genre:
-        m_genre = value;
+        presentValue = &m_genre;
         break;
     default:
         return false;
     }
+    if (!presentValue->compareTo(value, TagValueComparisionFlags::Exact)) {
+        *presentValue = value;
+        m_modified = true;
+    }
     return true;
 }
 
@@ -228,6 +235,7 @@ void Id3v1Tag::removeAllFields()
     m_comment.clearDataAndMetadata();
     m_trackPos.clearDataAndMetadata();
     m_genre.clearDataAndMetadata();
+    m_modified = true;
 }
 
 std::size_t Id3v1Tag::fieldCount() const
@@ -268,10 +276,22 @@ void Id3v1Tag::ensureTextValuesAreProperlyEncoded()
             break;
         default:
             value->convertDataEncoding(TagTextEncoding::Utf8);
+            m_modified = true;
         }
     }
 }
 
+/*!
+ * \brief Adds the memory held by the tag and its values to \a usage.
+ */
+void Id3v1Tag::addMemoryUsage(MemoryUsage &usage) const
+{
+    Tag::addMemoryUsage(usage);
+    for (const auto *value : initializer_list<const TagValue *>{ &m_title, &m_artist, &m_album, &m_year, &m_comment, &m_trackPos, &m_genre }) {
+        usage.tagValuesOfType(value->type()) += value->memoryUsage();
+    }
+}
+
 /*!
  * \brief Internally used to read values with the specified \a maxLength from the specified \a buffer.
  */
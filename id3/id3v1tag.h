@@ -24,6 +24,7 @@ public:
     std::size_t fieldCount() const override;
     bool supportsField(KnownField field) const override;
     void ensureTextValuesAreProperlyEncoded() override;
+    void addMemoryUsage(MemoryUsage &usage) const override;
 
     void parse(std::istream &sourceStream, Diagnostics &diag);
     void make(std::ostream &targetStream, Diagnostics &diag);
@@ -1,9 +1,11 @@
 #include "./id3v2frame.h"
 #include "./id3v2frameids.h"
 
+#include "../abstractattachment.h"
 #include "../diagnostics.h"
 #include "../exceptions.h"
 #include "../tagtype.h"
+#include "../textconversion.h"
 
 #include <c++utilities/conversion/stringbuilder.h>
 #include <c++utilities/conversion/stringconversion.h>
@@ -144,20 +146,95 @@ static std::uint64_t readPlayCounter(const char *begin, const char *end, const s
  * The position of the current character in the input stream is expected to be
  * at the beginning of the frame to be parsed.
  *
+ * If \a loadPicturesLazily is set, the data of (non-legacy) picture frames is only read when accessed. The stream
+ * of \a reader must remain valid until then.
+ *
  * \throws Throws std::ios_base::failure when an IO error occurs.
  * \throws Throws TagParser::Failure or a derived exception when a parsing
  *         error occurs.
+ * \sa parseHeader(), parseData()
+ */
+void Id3v2Frame::parse(BinaryReader &reader, std::uint32_t version, std::uint32_t maximalSize, Diagnostics &diag, bool loadPicturesLazily)
+{
+    parseHeader(reader, version, maximalSize, diag);
+    parseData(reader, version, diag, loadPicturesLazily);
+}
+
+/*!
+ * \brief Parses a frame from the specified \a buffer.
+ *
+ * The \a buffer is expected to start at the beginning of the frame to be parsed and to contain
+ * at least \a maximalSize bytes.
+ *
+ * \throws Throws TagParser::Failure or a derived exception when a parsing
+ *         error occurs.
+ * \sa parseHeader(), parseData()
+ */
+void Id3v2Frame::parse(const char *buffer, std::uint32_t version, std::uint32_t maximalSize, Diagnostics &diag)
+{
+    const auto *const data = parseHeader(buffer, version, maximalSize, diag);
+    parseData(data, version, maximalSize - static_cast<std::size_t>(data - buffer), diag);
+}
+
+/*!
+ * \brief Parses the header of a frame from the stream read using the specified \a reader.
+ *
+ * The position of the current character in the input stream is expected to be
+ * at the beginning of the frame to be parsed. Afterwards the stream is positioned at
+ * the frame's data which can either be parsed via parseData() or be skipped using totalSize().
+ *
+ * \throws Throws std::ios_base::failure when an IO error occurs.
+ * \throws Throws TagParser::Failure or a derived exception when a parsing
+ *         error occurs.
+ */
+void Id3v2Frame::parseHeader(BinaryReader &reader, std::uint32_t version, std::uint32_t maximalSize, Diagnostics &diag)
+{
+    // read the header without the group byte as its presence is only known from the flags
+    char header[11];
+    const auto headerSize = std::min(maximalSize, version < 3 ? 6u : 10u);
+    reader.read(header, headerSize);
+    internallyParseHeader(header, version, headerSize, maximalSize, diag);
+    if (version >= 3 && hasGroupInformation()) {
+        m_group = reader.readByte();
+    }
+}
+
+/*!
+ * \brief Parses the header of a frame from the specified \a buffer.
+ *
+ * The \a buffer is expected to start at the beginning of the frame to be parsed and to contain
+ * at least \a maximalSize bytes.
+ *
+ * \returns Returns a pointer to the frame's data within \a buffer which can either be parsed via
+ *          parseData() or be skipped using totalSize().
+ * \throws Throws TagParser::Failure or a derived exception when a parsing
+ *         error occurs.
  */
-void Id3v2Frame::parse(BinaryReader &reader, std::uint32_t version, std::uint32_t maximalSize, Diagnostics &diag)
+const char *Id3v2Frame::parseHeader(const char *buffer, std::uint32_t version, std::uint32_t maximalSize, Diagnostics &diag)
+{
+    const auto headerSize = std::min(maximalSize, version < 3 ? 6u : 11u);
+    internallyParseHeader(buffer, version, headerSize, maximalSize, diag);
+    return buffer + (version < 3 ? 6 : (hasGroupInformation() ? 11 : 10));
+}
+
+/*!
+ * \brief Parses the frame header from the first \a headerSize bytes of \a buffer.
+ * \remarks Missing bytes are treated as zero so a header cut off by the end of the tag is detected as padding
+ *          or truncated frame.
+ */
+void Id3v2Frame::internallyParseHeader(
+    const char *buffer, std::uint32_t version, std::uint32_t headerSize, std::uint32_t maximalSize, Diagnostics &diag)
 {
     static const string defaultContext("parsing ID3v2 frame");
     string context;
+    char header[11] = {};
+    std::memcpy(header, buffer, headerSize);
 
     // parse header
     if (version < 3) {
         // parse header for ID3v2.1 and ID3v2.2
         // -> read ID
-        setId(reader.readUInt24BE());
+        setId(BE::toUInt24(header));
         if (id() & 0xFFFF0000u) {
             m_padding = false;
         } else {
@@ -170,7 +247,7 @@ void Id3v2Frame::parse(BinaryReader &reader, std::uint32_t version, std::uint32_
         context = "parsing " % idToString() + " frame";
 
         // -> read size, check whether frame is truncated
-        m_dataSize = reader.readUInt24BE();
+        m_dataSize = BE::toUInt24(header + 3);
         m_totalSize = m_dataSize + 6;
         if (m_totalSize > maximalSize) {
             diag.emplace_back(DiagLevel::Warning, "The frame is truncated and will be ignored.", context);
@@ -184,7 +261,7 @@ void Id3v2Frame::parse(BinaryReader &reader, std::uint32_t version, std::uint32_
     } else {
         // parse header for ID3v2.3 and ID3v2.4
         // -> read ID
-        setId(reader.readUInt32BE());
+        setId(BE::toInt<std::uint32_t>(header));
         if (id() & 0xFF000000u) {
             m_padding = false;
         } else {
@@ -197,7 +274,8 @@ void Id3v2Frame::parse(BinaryReader &reader, std::uint32_t version, std::uint32_
         context = "parsing " % idToString() + " frame";
 
         // -> read size, check whether frame is truncated
-        m_dataSize = version >= 4 ? reader.readSynchsafeUInt32BE() : reader.readUInt32BE();
+        const auto size = BE::toInt<std::uint32_t>(header + 4);
+        m_dataSize = version >= 4 ? toNormalInt(size) : size;
         m_totalSize = m_dataSize + 10;
         if (m_totalSize > maximalSize) {
             diag.emplace_back(DiagLevel::Warning, "The frame is truncated and will be ignored.", context);
@@ -205,8 +283,8 @@ void Id3v2Frame::parse(BinaryReader &reader, std::uint32_t version, std::uint32_
         }
 
         // -> read flags and group
-        m_flag = reader.readUInt16BE();
-        m_group = hasGroupInformation() ? reader.readByte() : 0;
+        m_flag = BE::toInt<std::uint16_t>(header + 8);
+        m_group = hasGroupInformation() ? static_cast<std::uint8_t>(header[10]) : 0;
         if (isEncrypted()) {
             // encryption is not implemented
             diag.emplace_back(DiagLevel::Critical, "Encrypted frames aren't supported.", context);
@@ -228,22 +306,59 @@ void Id3v2Frame::parse(BinaryReader &reader, std::uint32_t version, std::uint32_
         diag.emplace_back(DiagLevel::Warning, "The frame size is 0.", context);
         throw InvalidDataException();
     }
+}
 
-    // parse the data
-    unique_ptr<char[]> buffer;
+/*!
+ * \brief Parses the data of a frame whose header has been parsed via parseHeader().
+ *
+ * If \a loadPicturesLazily is set, the data of (non-legacy) picture frames is only read when accessed. The stream
+ * of \a reader must remain valid until then.
+ *
+ * \throws Throws std::ios_base::failure when an IO error occurs.
+ * \throws Throws TagParser::Failure or a derived exception when a parsing
+ *         error occurs.
+ */
+void Id3v2Frame::parseData(BinaryReader &reader, std::uint32_t version, Diagnostics &diag, bool loadPicturesLazily)
+{
+    if (!isCompressed() && loadPicturesLazily && version >= 3 && id() == Id3v2FrameIds::lCover && parsePictureLazily(reader, diag)) {
+        return;
+    }
+    // read the data (preceded by the decompressed size if compressed) at once to parse it from the buffer
+    const auto size = static_cast<std::size_t>(m_dataSize) + (isCompressed() ? 4 : 0);
+    const auto buffer = make_unique<char[]>(size);
+    reader.read(buffer.get(), static_cast<std::streamsize>(size));
+    parseData(buffer.get(), version, size, diag);
+}
 
-    // -> decompress data if compressed; otherwise just read it
+/*!
+ * \brief Parses the data of a frame whose header has been parsed via parseHeader() from the specified \a buffer.
+ *
+ * The \a buffer is expected to start at the frame's data (as returned by parseHeader()) and to contain at least
+ * \a maximalSize bytes. Values are decoded directly from the \a buffer without copying the frame's data first.
+ *
+ * \throws Throws TagParser::Failure or a derived exception when a parsing
+ *         error occurs.
+ */
+void Id3v2Frame::parseData(const char *buffer, std::uint32_t version, std::size_t maximalSize, Diagnostics &diag)
+{
+    const auto context = "parsing " % idToString() + " frame";
+
+    // -> decompress data if compressed; otherwise just parse it in-place
+    unique_ptr<char[]> decompressedBuffer;
     if (isCompressed()) {
-        uLongf decompressedSize = version >= 4 ? reader.readSynchsafeUInt32BE() : reader.readUInt32BE();
+        if (maximalSize < 4 || maximalSize - 4 < m_dataSize) {
+            diag.emplace_back(DiagLevel::Critical, "The compressed data is truncated.", context);
+            throw TruncatedDataException();
+        }
+        const auto decompressedSizeField = BE::toInt<std::uint32_t>(buffer);
+        uLongf decompressedSize = version >= 4 ? toNormalInt(decompressedSizeField) : decompressedSizeField;
         if (decompressedSize < m_dataSize) {
             diag.emplace_back(DiagLevel::Critical, "The decompressed size is smaller than the compressed size.", context);
             throw InvalidDataException();
         }
-        const auto bufferCompressed = make_unique<char[]>(m_dataSize);
-        reader.read(bufferCompressed.get(), m_dataSize);
-        buffer = make_unique<char[]>(decompressedSize);
-        switch (
-            uncompress(reinterpret_cast<Bytef *>(buffer.get()), &decompressedSize, reinterpret_cast<Bytef *>(bufferCompressed.get()), m_dataSize)) {
+        decompressedBuffer = make_unique<char[]>(decompressedSize);
+        switch (uncompress(
+            reinterpret_cast<Bytef *>(decompressedBuffer.get()), &decompressedSize, reinterpret_cast<const Bytef *>(buffer + 4), m_dataSize)) {
         case Z_MEM_ERROR:
             diag.emplace_back(DiagLevel::Critical, "Decompressing failed. The source buffer was too small.", context);
             throw InvalidDataException();
@@ -264,9 +379,10 @@ void Id3v2Frame::parse(BinaryReader &reader, std::uint32_t version, std::uint32_
             throw InvalidDataException();
         }
         m_dataSize = static_cast<std::uint32_t>(decompressedSize);
-    } else {
-        buffer = make_unique<char[]>(m_dataSize);
-        reader.read(buffer.get(), m_dataSize);
+        buffer = decompressedBuffer.get();
+    } else if (maximalSize < m_dataSize) {
+        diag.emplace_back(DiagLevel::Critical, "The frame data is truncated.", context);
+        throw TruncatedDataException();
     }
 
     const auto isTextFrame = Id3v2FrameIds::isTextFrame(id());
@@ -274,7 +390,7 @@ void Id3v2Frame::parse(BinaryReader &reader, std::uint32_t version, std::uint32_
     // read tag value depending on frame ID/type
     if (isTextFrame || isUrlFrame) {
         // parse text encoding byte
-        const char *currentOffset = buffer.get();
+        const char *currentOffset = buffer;
         auto dataEncoding = isTextFrame ? parseTextEncodingByte(static_cast<std::uint8_t>(*(currentOffset++)), diag) : TagTextEncoding::Latin1;
 
         // parse string values (since ID3v2.4 a text frame may contain multiple strings)
@@ -287,7 +403,7 @@ void Id3v2Frame::parse(BinaryReader &reader, std::uint32_t version, std::uint32_
                 if (currentIndex == 1) {
                     value().clearDataAndMetadata();
                 }
-                currentIndex = static_cast<size_t>(get<2>(substr) - buffer.get());
+                currentIndex = static_cast<size_t>(get<2>(substr) - buffer);
                 currentOffset = get<2>(substr);
                 continue;
             }
@@ -320,11 +436,10 @@ void Id3v2Frame::parse(BinaryReader &reader, std::uint32_t version, std::uint32_
                 try {
                     const auto milliseconds = [&] {
                         if (dataEncoding == TagTextEncoding::Utf16BigEndian || dataEncoding == TagTextEncoding::Utf16LittleEndian) {
-                            const auto parsedStringRef = parseSubstring(buffer.get() + 1, m_dataSize - 1, dataEncoding, false, diag);
-                            const auto convertedStringData = dataEncoding == TagTextEncoding::Utf16BigEndian
-                                ? convertUtf16BEToUtf8(get<0>(parsedStringRef), get<1>(parsedStringRef))
-                                : convertUtf16LEToUtf8(get<0>(parsedStringRef), get<1>(parsedStringRef));
-                            return string(convertedStringData.first.get(), convertedStringData.second);
+                            const auto parsedStringRef = parseSubstring(buffer + 1, m_dataSize - 1, dataEncoding, false, diag);
+                            auto convertedString = string();
+                            transcodeText(dataEncoding, TagTextEncoding::Utf8, get<0>(parsedStringRef), get<1>(parsedStringRef), convertedString);
+                            return convertedString;
                         } else { // Latin-1 or UTF-8
                             return stringFromSubstring(substr);
                         }
@@ -355,7 +470,7 @@ void Id3v2Frame::parse(BinaryReader &reader, std::uint32_t version, std::uint32_
                 value->assignData(get<0>(substr), get<1>(substr), TagDataType::Text, dataEncoding);
             }
 
-            currentIndex = static_cast<size_t>(get<2>(substr) - buffer.get());
+            currentIndex = static_cast<size_t>(get<2>(substr) - buffer);
             currentOffset = get<2>(substr);
         }
 
@@ -368,30 +483,30 @@ void Id3v2Frame::parse(BinaryReader &reader, std::uint32_t version, std::uint32_
     } else if (version >= 3 && id() == Id3v2FrameIds::lCover) {
         // parse picture frame
         std::uint8_t type;
-        parsePicture(buffer.get(), m_dataSize, value(), type, diag);
+        parsePicture(buffer, m_dataSize, value(), type, diag);
         setTypeInfo(type);
 
     } else if (version < 3 && id() == Id3v2FrameIds::sCover) {
         // parse legacy picutre
         std::uint8_t type;
-        parseLegacyPicture(buffer.get(), m_dataSize, value(), type, diag);
+        parseLegacyPicture(buffer, m_dataSize, value(), type, diag);
         setTypeInfo(type);
 
     } else if (((version >= 3 && id() == Id3v2FrameIds::lComment) || (version < 3 && id() == Id3v2FrameIds::sComment))
         || ((version >= 3 && id() == Id3v2FrameIds::lUnsynchronizedLyrics) || (version < 3 && id() == Id3v2FrameIds::sUnsynchronizedLyrics))) {
         // parse comment frame or unsynchronized lyrics frame (these two frame types have the same structure)
-        parseComment(buffer.get(), m_dataSize, value(), diag);
+        parseComment(buffer, m_dataSize, value(), diag);
 
     } else if (((version >= 3 && id() == Id3v2FrameIds::lPlayCounter) || (version < 3 && id() == Id3v2FrameIds::sPlayCounter))) {
         // parse play counter frame
-        value().assignUnsignedInteger(readPlayCounter(buffer.get(), buffer.get() + m_dataSize, context, diag));
+        value().assignUnsignedInteger(readPlayCounter(buffer, buffer + m_dataSize, context, diag));
 
     } else if (((version >= 3 && id() == Id3v2FrameIds::lRating) || (version < 3 && id() == Id3v2FrameIds::sRating))) {
         // parse popularimeter frame
         auto popularity = Popularity{ .scale = TagType::Id3v2Tag };
         auto userEncoding = TagTextEncoding::Latin1;
-        auto substr = parseSubstring(buffer.get(), m_dataSize, userEncoding, true, diag);
-        auto end = buffer.get() + m_dataSize;
+        auto substr = parseSubstring(buffer, m_dataSize, userEncoding, true, diag);
+        auto end = buffer + m_dataSize;
         if (std::get<1>(substr)) {
             popularity.user.assign(std::get<0>(substr), std::get<1>(substr));
         }
@@ -406,7 +521,7 @@ void Id3v2Frame::parse(BinaryReader &reader, std::uint32_t version, std::uint32_
 
     } else {
         // parse unknown/unsupported frame
-        value().assignData(buffer.get(), m_dataSize, TagDataType::Undefined);
+        value().assignData(buffer, m_dataSize, TagDataType::Undefined);
     }
 }
 
@@ -932,16 +1047,11 @@ tuple<const char *, size_t, const char *> Id3v2Frame::parseSubstring(
             get<0>(res) += 3;
         }
         const char *pos = get<0>(res);
-        for (; *pos != 0x00; ++pos) {
-            if (pos < get<2>(res)) {
-                ++get<1>(res);
-            } else {
-                if (addWarnings) {
-                    diag.emplace_back(
-                        DiagLevel::Warning, "String in frame is not terminated properly.", "parsing termination of frame " + idToString());
-                }
-                break;
-            }
+        for (; pos < get<2>(res) && *pos != 0x00; ++pos) {
+            ++get<1>(res);
+        }
+        if (pos >= get<2>(res) && addWarnings) {
+            diag.emplace_back(DiagLevel::Warning, "String in frame is not terminated properly.", "parsing termination of frame " + idToString());
         }
         get<2>(res) = pos + 1;
         break;
@@ -964,19 +1074,15 @@ tuple<const char *, size_t, const char *> Id3v2Frame::parseSubstring(
                 get<0>(res) += 2;
             }
         }
-        const std::uint16_t *pos = reinterpret_cast<const std::uint16_t *>(get<0>(res));
-        for (; *pos != 0x0000; ++pos) {
-            if (pos < reinterpret_cast<const std::uint16_t *>(get<2>(res))) {
-                get<1>(res) += 2;
-            } else {
-                if (addWarnings) {
-                    diag.emplace_back(
-                        DiagLevel::Warning, "Wide string in frame is not terminated properly.", "parsing termination of frame " + idToString());
-                }
-                break;
-            }
+        const char *pos = get<0>(res);
+        for (; get<2>(res) - pos >= 2 && (pos[0] || pos[1]); pos += 2) {
+            get<1>(res) += 2;
+        }
+        if (get<2>(res) - pos < 2 && addWarnings) {
+            diag.emplace_back(
+                DiagLevel::Warning, "Wide string in frame is not terminated properly.", "parsing termination of frame " + idToString());
         }
-        get<2>(res) = reinterpret_cast<const char *>(pos + 1);
+        get<2>(res) = pos + 2;
         break;
     }
     }
@@ -1031,6 +1137,38 @@ void Id3v2Frame::parseBom(const char *buffer, std::size_t maxSize, TagTextEncodi
     }
 }
 
+/*!
+ * \brief Reverts the unsynchronisation scheme applied to the specified \a buffer in-place.
+ *
+ * Unsynchronisation inserts a zero byte after each 0xFF byte which is removed again by this function. The
+ * 0xFF bytes are located via std::memchr() which is vectorized by the standard library so data without
+ * any 0xFF bytes is only scanned and not moved at all.
+ *
+ * \returns Returns the size of the decoded data.
+ */
+std::size_t Id3v2Frame::decodeUnsynchronisation(char *buffer, std::size_t size)
+{
+    auto *const end = buffer + size;
+    auto *output = static_cast<char *>(std::memchr(buffer, 0xFF, size));
+    if (!output) {
+        return size;
+    }
+    for (const char *input = output; input != end;) {
+        // copy everything up to the next 0xFF byte (inclusive)
+        const auto *const marker = static_cast<const char *>(std::memchr(input, 0xFF, static_cast<std::size_t>(end - input)));
+        const auto *const chunkEnd = marker ? marker + 1 : end;
+        const auto chunkSize = static_cast<std::size_t>(chunkEnd - input);
+        std::memmove(output, input, chunkSize);
+        output += chunkSize;
+        input = chunkEnd;
+        // skip the zero byte inserted after it
+        if (marker && input != end && !*input) {
+            ++input;
+        }
+    }
+    return static_cast<std::size_t>(output - buffer);
+}
+
 /*!
  * \brief Parses the ID3v2.2 picture from the specified \a buffer.
  * \param buffer Specifies the buffer holding the picture.
@@ -1040,7 +1178,7 @@ void Id3v2Frame::parseBom(const char *buffer, std::size_t maxSize, TagTextEncodi
  */
 void Id3v2Frame::parseLegacyPicture(const char *buffer, std::size_t maxSize, TagValue &tagValue, std::uint8_t &typeInfo, Diagnostics &diag)
 {
-    static const string context("parsing ID3v2.2 picture frame");
+    static const auto context = DiagContext("parsing ID3v2.2 picture frame");
     if (maxSize < 6) {
         diag.emplace_back(DiagLevel::Critical, "Picture frame is incomplete.", context);
         throw TruncatedDataException();
@@ -1066,9 +1204,22 @@ void Id3v2Frame::parseLegacyPicture(const char *buffer, std::size_t maxSize, Tag
  */
 void Id3v2Frame::parsePicture(const char *buffer, std::size_t maxSize, TagValue &tagValue, std::uint8_t &typeInfo, Diagnostics &diag)
 {
-    static const string context("parsing ID3v2.3 picture frame");
+    auto dataEncoding = TagTextEncoding::Latin1;
+    const auto *const data = parsePictureHeader(buffer, maxSize, tagValue, typeInfo, dataEncoding, diag);
+    tagValue.assignData(data, static_cast<size_t>(buffer + maxSize - data), TagDataType::Picture, dataEncoding);
+}
+
+/*!
+ * \brief Parses the ID3v2.3 picture from the specified \a buffer except for the actual image data.
+ * \returns Returns a pointer to the start of the actual image data within \a buffer.
+ * \throws Throws TruncatedDataException if \a buffer ends before the actual image data starts.
+ */
+const char *Id3v2Frame::parsePictureHeader(
+    const char *buffer, std::size_t maxSize, TagValue &tagValue, std::uint8_t &typeInfo, TagTextEncoding &dataEncoding, Diagnostics &diag)
+{
+    static const auto context = DiagContext("parsing ID3v2.3 picture frame");
     const char *end = buffer + maxSize;
-    auto dataEncoding = parseTextEncodingByte(static_cast<std::uint8_t>(*buffer), diag); // the first byte stores the encoding
+    dataEncoding = parseTextEncodingByte(static_cast<std::uint8_t>(*buffer), diag); // the first byte stores the encoding
     auto mimeTypeEncoding = TagTextEncoding::Latin1;
     auto substr = parseSubstring(buffer + 1, maxSize - 1, mimeTypeEncoding, true, diag);
     if (get<1>(substr)) {
@@ -1089,7 +1240,49 @@ void Id3v2Frame::parsePicture(const char *buffer, std::size_t maxSize, TagValue
         diag.emplace_back(DiagLevel::Critical, "Picture frame is incomplete (actual data is missing).", context);
         throw TruncatedDataException();
     }
-    tagValue.assignData(get<2>(substr), static_cast<size_t>(end - get<2>(substr)), TagDataType::Picture, dataEncoding);
+    return get<2>(substr);
+}
+
+/*!
+ * \brief Parses the ID3v2.3 picture from the specified \a reader without reading the actual image data.
+ *
+ * Only the header of the picture is read assuming it fits into the first bytes of the frame. The image data is
+ * assigned via TagValue::assignLazyData() so it is only read when accessed.
+ *
+ * \returns Returns whether the picture could be parsed that way. If not, the stream is reset to the start of the
+ *          frame data so the frame can be parsed as usual.
+ */
+bool Id3v2Frame::parsePictureLazily(BinaryReader &reader, Diagnostics &diag)
+{
+    constexpr auto maxHeaderSize = std::uint32_t(0x400);
+    if (isUnsynchronized() || m_dataSize <= maxHeaderSize) {
+        return false;
+    }
+    auto &stream = *reader.stream();
+    const auto startOffset = static_cast<std::uint64_t>(stream.tellg());
+    char header[maxHeaderSize];
+    reader.read(header, maxHeaderSize);
+    auto headerDiag = Diagnostics();
+    headerDiag.setMinLevel(diag.minLevel());
+    auto type = std::uint8_t();
+    auto dataEncoding = TagTextEncoding::Latin1;
+    const char *data;
+    try {
+        data = parsePictureHeader(header, maxHeaderSize, value(), type, dataEncoding, headerDiag);
+    } catch (const TruncatedDataException &) {
+        // the header exceeds the bytes read so far; just read the whole frame
+        value().clearMetadata();
+        stream.seekg(static_cast<std::streamoff>(startOffset));
+        return false;
+    }
+    diag.insert(diag.end(), headerDiag.begin(), headerDiag.end());
+    setTypeInfo(type);
+    const auto endOffset = startOffset + m_dataSize;
+    value().assignLazyData(std::make_unique<StreamDataBlock>([&stream]() -> std::istream & { return stream; },
+                               startOffset + static_cast<std::uint64_t>(data - header), std::ios_base::beg, endOffset, std::ios_base::beg),
+        TagDataType::Picture, dataEncoding);
+    stream.seekg(static_cast<std::streamoff>(endOffset));
+    return true;
 }
 
 /*!
@@ -1100,7 +1293,7 @@ void Id3v2Frame::parsePicture(const char *buffer, std::size_t maxSize, TagValue
  */
 void Id3v2Frame::parseComment(const char *buffer, std::size_t dataSize, TagValue &tagValue, Diagnostics &diag)
 {
-    static const string context("parsing comment/unsynchronized lyrics frame");
+    static const auto context = DiagContext("parsing comment/unsynchronized lyrics frame");
     const char *end = buffer + dataSize;
     if (dataSize < 5) {
         diag.emplace_back(DiagLevel::Critical, "Comment frame is incomplete.", context);
@@ -1146,7 +1339,7 @@ void Id3v2Frame::makeLegacyPicture(
 {
     // determine description
     TagTextEncoding descriptionEncoding = picture.descriptionEncoding();
-    StringData convertedDescription;
+    string convertedDescription;
     string::size_type descriptionSize = picture.description().find(
         "\0\0", 0, descriptionEncoding == TagTextEncoding::Utf16BigEndian || descriptionEncoding == TagTextEncoding::Utf16LittleEndian ? 2 : 1);
     if (descriptionSize == string::npos) {
@@ -1155,8 +1348,9 @@ void Id3v2Frame::makeLegacyPicture(
     if (descriptionEncoding == TagTextEncoding::Utf8) {
         // UTF-8 is only supported by ID3v2.4, so convert back to UTF-16
         descriptionEncoding = TagTextEncoding::Utf16LittleEndian;
-        convertedDescription = convertUtf8ToUtf16LE(picture.description().data(), descriptionSize);
-        descriptionSize = convertedDescription.second;
+        transcodeText(
+            TagTextEncoding::Utf8, TagTextEncoding::Utf16LittleEndian, picture.description().data(), descriptionSize, convertedDescription);
+        descriptionSize = convertedDescription.size();
     }
 
     // calculate needed buffer size and create buffer
@@ -1194,8 +1388,8 @@ void Id3v2Frame::makeLegacyPicture(
 
     // write description
     offset += makeBom(offset + 1, descriptionEncoding);
-    if (convertedDescription.first) {
-        copy(convertedDescription.first.get(), convertedDescription.first.get() + descriptionSize, ++offset);
+    if (!convertedDescription.empty()) {
+        copy(convertedDescription.cbegin(), convertedDescription.cend(), ++offset);
     } else {
         picture.description().copy(++offset, descriptionSize);
     }
@@ -1221,7 +1415,7 @@ void Id3v2Frame::makePicture(std::unique_ptr<char[]> &buffer, std::uint32_t &buf
 
     // determine description
     TagTextEncoding descriptionEncoding = picture.descriptionEncoding();
-    StringData convertedDescription;
+    string convertedDescription;
     string::size_type descriptionSize = picture.description().find(
         "\0\0", 0, descriptionEncoding == TagTextEncoding::Utf16BigEndian || descriptionEncoding == TagTextEncoding::Utf16LittleEndian ? 2 : 1);
     if (descriptionSize == string::npos) {
@@ -1230,8 +1424,9 @@ void Id3v2Frame::makePicture(std::unique_ptr<char[]> &buffer, std::uint32_t &buf
     if (version < 4 && descriptionEncoding == TagTextEncoding::Utf8) {
         // UTF-8 is only supported by ID3v2.4, so convert back to UTF-16
         descriptionEncoding = TagTextEncoding::Utf16LittleEndian;
-        convertedDescription = convertUtf8ToUtf16LE(picture.description().data(), descriptionSize);
-        descriptionSize = convertedDescription.second;
+        transcodeText(
+            TagTextEncoding::Utf8, TagTextEncoding::Utf16LittleEndian, picture.description().data(), descriptionSize, convertedDescription);
+        descriptionSize = convertedDescription.size();
     }
     // determine mime-type
     string::size_type mimeTypeSize = picture.mimeType().find('\0');
@@ -1263,8 +1458,8 @@ void Id3v2Frame::makePicture(std::unique_ptr<char[]> &buffer, std::uint32_t &buf
 
     // write description
     offset += makeBom(offset + 1, descriptionEncoding);
-    if (convertedDescription.first) {
-        copy(convertedDescription.first.get(), convertedDescription.first.get() + descriptionSize, ++offset);
+    if (!convertedDescription.empty()) {
+        copy(convertedDescription.cbegin(), convertedDescription.cend(), ++offset);
     } else {
         picture.description().copy(++offset, descriptionSize);
     }
@@ -1282,7 +1477,7 @@ void Id3v2Frame::makePicture(std::unique_ptr<char[]> &buffer, std::uint32_t &buf
  */
 void Id3v2Frame::makeComment(unique_ptr<char[]> &buffer, std::uint32_t &bufferSize, const TagValue &comment, std::uint8_t version, Diagnostics &diag)
 {
-    static const string context("making comment frame");
+    static const auto context = DiagContext("making comment frame");
 
     // check whether type and other values are valid
     TagTextEncoding encoding = comment.dataEncoding();
@@ -1295,7 +1490,7 @@ void Id3v2Frame::makeComment(unique_ptr<char[]> &buffer, std::uint32_t &bufferSi
         diag.emplace_back(DiagLevel::Critical, "The language must be 3 bytes long (ISO-639-2).", context);
         throw InvalidDataException();
     }
-    StringData convertedDescription;
+    string convertedDescription;
     string::size_type descriptionSize = comment.description().find(
         "\0\0", 0, encoding == TagTextEncoding::Utf16BigEndian || encoding == TagTextEncoding::Utf16LittleEndian ? 2 : 1);
     if (descriptionSize == string::npos) {
@@ -1304,8 +1499,8 @@ void Id3v2Frame::makeComment(unique_ptr<char[]> &buffer, std::uint32_t &bufferSi
     if (version < 4 && encoding == TagTextEncoding::Utf8) {
         // UTF-8 is only supported by ID3v2.4, so convert back to UTF-16
         encoding = TagTextEncoding::Utf16LittleEndian;
-        convertedDescription = convertUtf8ToUtf16LE(comment.description().data(), descriptionSize);
-        descriptionSize = convertedDescription.second;
+        transcodeText(TagTextEncoding::Utf8, TagTextEncoding::Utf16LittleEndian, comment.description().data(), descriptionSize, convertedDescription);
+        descriptionSize = convertedDescription.size();
     }
 
     // calculate needed buffer size and create buffer
@@ -1330,8 +1525,8 @@ void Id3v2Frame::makeComment(unique_ptr<char[]> &buffer, std::uint32_t &bufferSi
 
     // write description
     offset += makeBom(offset + 1, encoding);
-    if (convertedDescription.first) {
-        copy(convertedDescription.first.get(), convertedDescription.first.get() + descriptionSize, ++offset);
+    if (!convertedDescription.empty()) {
+        copy(convertedDescription.cbegin(), convertedDescription.cend(), ++offset);
     } else {
         comment.description().copy(++offset, descriptionSize);
     }
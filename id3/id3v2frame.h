@@ -92,7 +92,13 @@ public:
     Id3v2Frame(const IdentifierType &id, const TagValue &value, std::uint8_t group = 0, std::uint16_t flag = 0);
 
     // parsing/making
-    void parse(CppUtilities::BinaryReader &reader, std::uint32_t version, std::uint32_t maximalSize, Diagnostics &diag);
+    void parse(CppUtilities::BinaryReader &reader, std::uint32_t version, std::uint32_t maximalSize, Diagnostics &diag,
+        bool loadPicturesLazily = false);
+    void parseHeader(CppUtilities::BinaryReader &reader, std::uint32_t version, std::uint32_t maximalSize, Diagnostics &diag);
+    void parseData(CppUtilities::BinaryReader &reader, std::uint32_t version, Diagnostics &diag, bool loadPicturesLazily = false);
+    void parse(const char *buffer, std::uint32_t version, std::uint32_t maximalSize, Diagnostics &diag);
+    const char *parseHeader(const char *buffer, std::uint32_t version, std::uint32_t maximalSize, Diagnostics &diag);
+    void parseData(const char *buffer, std::uint32_t version, std::size_t maximalSize, Diagnostics &diag);
     Id3v2FrameMaker prepareMaking(std::uint8_t version, Diagnostics &diag);
     void make(CppUtilities::BinaryWriter &writer, std::uint8_t version, Diagnostics &diag);
 
@@ -129,6 +135,7 @@ public:
     void parsePicture(const char *buffer, std::size_t maxSize, TagValue &tagValue, std::uint8_t &typeInfo, Diagnostics &diag);
     void parseComment(const char *buffer, std::size_t maxSize, TagValue &tagValue, Diagnostics &diag);
     void parseBom(const char *buffer, std::size_t maxSize, TagTextEncoding &encoding, Diagnostics &diag);
+    static std::size_t decodeUnsynchronisation(char *buffer, std::size_t size);
 
     // making helper
     static std::uint8_t makeTextEncodingByte(TagTextEncoding textEncoding);
@@ -147,6 +154,10 @@ private:
     void internallyClearValue();
     void internallyClearFurtherData();
     std::string ignoreAdditionalValuesDiagMsg() const;
+    void internallyParseHeader(const char *buffer, std::uint32_t version, std::uint32_t headerSize, std::uint32_t maximalSize, Diagnostics &diag);
+    const char *parsePictureHeader(
+        const char *buffer, std::size_t maxSize, TagValue &tagValue, std::uint8_t &typeInfo, TagTextEncoding &dataEncoding, Diagnostics &diag);
+    bool parsePictureLazily(CppUtilities::BinaryReader &reader, Diagnostics &diag);
 
     std::vector<TagValue> m_additionalValues;
     std::uint32_t m_parsedVersion;
@@ -1,14 +1,22 @@
 #include "./id3v2tag.h"
 #include "./id3v2frameids.h"
 
+#include "../abstractattachment.h"
 #include "../diagnostics.h"
 #include "../exceptions.h"
 #include "../mediafileinfo.h"
+#include "../memoryoutputbuffer.h"
+#include "../tagfieldfilter.h"
 
 #include <c++utilities/conversion/stringbuilder.h>
 #include <c++utilities/conversion/stringconversion.h>
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
+#include <memory>
+#include <sstream>
+#include <tuple>
 
 using namespace std;
 using namespace CppUtilities;
@@ -107,7 +115,6 @@ bool Id3v2Tag::internallySetValues(const IdentifierType &id, const std::vector<T
     // use existing frame or insert new text frame
     auto valuesIterator = values.cbegin();
     if (frameIterator != range.second) {
-        ++range.first;
         // add primary value to existing frame
         if (valuesIterator != values.cend()) {
             frameIterator->second.setValue(*valuesIterator);
@@ -115,6 +122,10 @@ bool Id3v2Tag::internallySetValues(const IdentifierType &id, const std::vector<T
         } else {
             frameIterator->second.value().clearDataAndMetadata();
         }
+        // remove remaining existing values (there are more existing values than specified ones)
+        for (++range.first; range.first != range.second; ++range.first) {
+            range.first->second.setValue(TagValue());
+        }
     } else {
         // skip if there is no existing frame but also no values to be assigned
         if (valuesIterator == values.cend()) {
@@ -127,11 +138,6 @@ bool Id3v2Tag::internallySetValues(const IdentifierType &id, const std::vector<T
 
     // add additional values to frame
     frameIterator->second.additionalValues() = vector<TagValue>(valuesIterator, values.cend());
-
-    // remove remaining existing values (there are more existing values than specified ones)
-    for (; range.first != range.second; ++range.first) {
-        range.first->second.setValue(TagValue());
-    }
     return true;
 }
 
@@ -469,12 +475,13 @@ TagDataType Id3v2Tag::internallyGetProposedDataType(const std::uint32_t &id) con
  * \brief Converts the lYear/lRecordingDates/lDate/lTime/sYear/sRecordingDates/sDate/sTime fields found in v2.3.0 to lRecordingTime.
  * \remarks
  * - Do not get rid of the "old" fields after the conversion so the raw fields can still be checked.
- * - The make function converts back if necessary and deletes unsupported fields.
+ * - The make function converts back if necessary and omits unsupported fields.
  */
 void Id3v2Tag::convertOldRecordDateFields(const std::string &diagContext, Diagnostics &diag)
 {
     // skip if it is a v2.4.0 tag and lRecordingTime is present
-    if (majorVersion() >= 4 && fields().find(Id3v2FrameIds::lRecordingTime) != fields().cend()) {
+    if (const auto &parsedFields = const_cast<const Id3v2Tag *>(this)->fields();
+        majorVersion() >= 4 && parsedFields.find(Id3v2FrameIds::lRecordingTime) != parsedFields.cend()) {
         return;
     }
 
@@ -543,14 +550,17 @@ void Id3v2Tag::convertOldRecordDateFields(const std::string &diagContext, Diagno
 /*!
  * \brief Parses tag information from the specified \a stream.
  *
+ * Frames not accepted by the specified \a fieldFilter are not decoded. They are only added to skippedFields() referring
+ * to the raw frame within \a stream which must therefore remain valid as long as the tag is used.
+ *
  * \throws Throws std::ios_base::failure when an IO error occurs.
  * \throws Throws TagParser::Failure or a derived exception when a parsing
  *         error occurs.
  */
-void Id3v2Tag::parse(istream &stream, const std::uint64_t maximalSize, Diagnostics &diag)
+void Id3v2Tag::parse(istream &stream, const std::uint64_t maximalSize, Diagnostics &diag, const TagFieldFilter *fieldFilter)
 {
     // prepare parsing
-    static const string context("parsing ID3v2 tag");
+    static const auto context = DiagContext("parsing ID3v2 tag");
     BinaryReader reader(&stream);
     const auto startOffset = static_cast<std::uint64_t>(stream.tellg());
 
@@ -569,11 +579,13 @@ void Id3v2Tag::parse(istream &stream, const std::uint64_t maximalSize, Diagnosti
     const std::uint8_t majorVersion = reader.readByte();
     const std::uint8_t revisionVersion = reader.readByte();
     setVersion(majorVersion, revisionVersion);
+    m_skippedFramesVersion = majorVersion;
     m_flags = reader.readByte();
     m_sizeExcludingHeader = reader.readSynchsafeUInt32BE();
     m_size = 10 + m_sizeExcludingHeader;
     if (m_sizeExcludingHeader == 0) {
         diag.emplace_back(DiagLevel::Warning, "ID3v2 tag seems to be empty.", context);
+        m_modified = false;
         return;
     }
 
@@ -604,37 +616,84 @@ void Id3v2Tag::parse(istream &stream, const std::uint64_t maximalSize, Diagnosti
         diag.emplace_back(DiagLevel::Critical, "Frames are truncated.", context);
     }
 
-    // read frames
-    auto pos = static_cast<std::uint64_t>(stream.tellg());
-    while (bytesRemaining) {
-        // seek to next frame
-        stream.seekg(static_cast<streamoff>(pos));
-        // parse frame
+    // read all frames at once to parse them from memory unless pictures are supposed to be loaded lazily
+    // note: Unsynchronisation applies to the whole tag before ID3v2.4 so it is reverted for all frames at once. Since
+    //       ID3v2.4 it is a per-frame property instead.
+    const auto framesOffset = static_cast<std::uint64_t>(stream.tellg());
+    const auto readFramesAtOnce = !(m_handlingFlags & Id3v2HandlingFlags::LoadPicturesLazily) || (majorVersion < 4 && isUnsynchronisationUsed());
+    auto frames = unique_ptr<char[]>();
+    auto framesSize = bytesRemaining;
+    auto unsynchronised = false;
+    if (readFramesAtOnce) {
+        // ensure not to allocate more memory than bytes are left in the stream (the denoted size might be bogus)
+        stream.seekg(0, ios_base::end);
+        const auto streamEnd = static_cast<std::uint64_t>(stream.tellg());
+        stream.seekg(static_cast<streamoff>(framesOffset));
+        if (const auto bytesLeft = streamEnd > framesOffset ? streamEnd - framesOffset : std::uint64_t(); bytesRemaining > bytesLeft) {
+            diag.emplace_back(DiagLevel::Critical,
+                argsToString("Frames are truncated: the tag denotes ", bytesRemaining, " bytes but only ", bytesLeft, " bytes are left in the stream."),
+                context);
+            framesSize = bytesRemaining = static_cast<std::uint32_t>(bytesLeft);
+        }
+        // note: The buffer is not zero-initialized as it is overwritten right away.
+        frames = unique_ptr<char[]>(new char[bytesRemaining]);
+        reader.read(frames.get(), bytesRemaining);
+        if (majorVersion < 4 && isUnsynchronisationUsed()) {
+            framesSize = static_cast<std::uint32_t>(Id3v2Frame::decodeUnsynchronisation(frames.get(), bytesRemaining));
+            unsynchronised = true;
+        }
+    }
+
+    // parse frames
+    for (auto offset = std::uint32_t(); offset < framesSize;) {
+        const auto remainingSize = framesSize - offset;
         Id3v2Frame frame;
         try {
-            frame.parse(reader, majorVersion, bytesRemaining, diag);
-            if (Id3v2FrameIds::isTextFrame(frame.id()) && fields().count(frame.id()) == 1) {
-                diag.emplace_back(DiagLevel::Warning, "The text frame " % frame.idToString() + " exists more than once.", context);
+            const char *data = nullptr;
+            if (frames) {
+                data = frame.parseHeader(frames.get() + offset, majorVersion, remainingSize, diag);
+            } else {
+                stream.seekg(static_cast<streamoff>(framesOffset + offset));
+                frame.parseHeader(reader, majorVersion, remainingSize, diag);
+            }
+            if (fieldFilter && !isFrameAccepted(*fieldFilter, frame.id())) {
+                // keep the raw frame so it is preserved when making the tag; refer to the stream unless the data has
+                // been altered by reverting the unsynchronisation
+                auto rawFrame = TagValue();
+                if (unsynchronised) {
+                    rawFrame.assignData(frames.get() + offset, frame.totalSize(), TagDataType::Binary);
+                } else {
+                    const auto pos = framesOffset + offset;
+                    rawFrame.assignLazyData(make_unique<StreamDataBlock>([&stream]() -> istream & { return stream; }, pos, ios_base::beg,
+                                                pos + frame.totalSize(), ios_base::beg),
+                        TagDataType::Binary);
+                }
+                skippedFields().emplace(frame.id(), std::move(rawFrame));
+            } else {
+                if (data) {
+                    frame.parseData(data, majorVersion, static_cast<std::size_t>(frames.get() + framesSize - data), diag);
+                } else {
+                    frame.parseData(reader, majorVersion, diag, m_handlingFlags & Id3v2HandlingFlags::LoadPicturesLazily);
+                }
+                if (Id3v2FrameIds::isTextFrame(frame.id()) && fields().count(frame.id()) == 1) {
+                    diag.emplace_back(DiagLevel::Warning, "The text frame " % frame.idToString() + " exists more than once.", context);
+                }
+                fields().emplace(frame.id(), std::move(frame));
             }
-            fields().emplace(frame.id(), std::move(frame));
         } catch (const NoDataFoundException &) {
             if (frame.hasPaddingReached()) {
-                m_paddingSize = startOffset + m_size - pos;
+                m_paddingSize = remainingSize;
                 break;
             }
         } catch (const Failure &) {
         }
 
         // calculate next frame offset
-        if (frame.totalSize() <= bytesRemaining) {
-            pos += frame.totalSize();
-            bytesRemaining -= frame.totalSize();
-        } else {
-            pos += bytesRemaining;
-            bytesRemaining = 0;
-        }
+        offset += frame.totalSize() <= remainingSize ? frame.totalSize() : remainingSize;
     }
 
+    // consider the tag only modified if record date fields are actually converted (as they would be written in converted form)
+    m_modified = false;
     if (m_handlingFlags & Id3v2HandlingFlags::ConvertRecordDateFields) {
         convertOldRecordDateFields(context, diag);
     }
@@ -690,10 +749,43 @@ void Id3v2Tag::make(ostream &stream, std::uint32_t padding, Diagnostics &diag)
  */
 void Id3v2Tag::setVersion(std::uint8_t majorVersion, std::uint8_t revisionVersion)
 {
+    if (m_majorVersion == majorVersion && m_revisionVersion == revisionVersion && !m_version.empty()) {
+        return;
+    }
     m_majorVersion = majorVersion;
     m_revisionVersion = revisionVersion;
     m_version = argsToString('2', '.', majorVersion, '.', revisionVersion);
+    m_modified = true;
+}
+
+/// \cond
+/*!
+ * \brief Returns the key FrameComparer orders the frame with the specified \a id by.
+ * \remarks Short IDs are converted to the corresponding long ID so both are considered equivalent. Short IDs which can not
+ *          be converted go before all long IDs.
+ */
+static std::tuple<bool, std::uint8_t, std::uint32_t> frameOrderKey(std::uint32_t id)
+{
+    auto isLong = Id3v2FrameIds::isLongId(id);
+    if (!isLong) {
+        if (const auto longId = Id3v2FrameIds::convertToLongId(id)) {
+            id = longId;
+            isLong = true;
+        }
+    }
+    auto rank = std::uint8_t(3);
+    if (id == Id3v2FrameIds::lUniqueFileId || id == Id3v2FrameIds::sUniqueFileId) {
+        rank = 0;
+    } else if (id == Id3v2FrameIds::lTitle || id == Id3v2FrameIds::sTitle) {
+        rank = 1;
+    } else if (Id3v2FrameIds::isTextFrame(id)) {
+        rank = 2;
+    } else if (id == Id3v2FrameIds::lCover || id == Id3v2FrameIds::sCover) {
+        rank = 4;
+    }
+    return std::make_tuple(isLong, rank, id);
 }
+/// \endcond
 
 /*!
  * \class TagParser::FrameComparer
@@ -704,60 +796,14 @@ void Id3v2Tag::setVersion(std::uint8_t majorVersion, std::uint8_t revisionVersio
 
 /*!
  * \brief Returns true if \a lhs goes before \a rhs; otherwise returns false.
- * \remarks Long and short IDs are treated equal if the short ID can be converted to
- *          the corresponding long ID. Otherwise short IDs go before long IDs.
+ * \remarks
+ * - Long and short IDs are treated equal if the short ID can be converted to the corresponding long ID. Short IDs which
+ *   can not be converted always go before long IDs.
+ * - This is a strict weak ordering as required by FlatMultiMap (and std::multimap).
  */
 bool FrameComparer::operator()(std::uint32_t lhs, std::uint32_t rhs) const
 {
-    if (lhs == rhs) {
-        return false;
-    }
-
-    const bool lhsLong = Id3v2FrameIds::isLongId(lhs);
-    const bool rhsLong = Id3v2FrameIds::isLongId(rhs);
-    if (lhsLong != rhsLong) {
-        if (!lhsLong) {
-            lhs = Id3v2FrameIds::convertToLongId(lhs);
-            if (!lhs) {
-                return true;
-            }
-        } else if (!rhsLong) {
-            rhs = Id3v2FrameIds::convertToLongId(rhs);
-            if (!rhs) {
-                return true;
-            }
-        }
-    }
-
-    if (lhs == Id3v2FrameIds::lUniqueFileId || lhs == Id3v2FrameIds::sUniqueFileId) {
-        return true;
-    }
-    if (rhs == Id3v2FrameIds::lUniqueFileId || rhs == Id3v2FrameIds::sUniqueFileId) {
-        return false;
-    }
-    if (lhs == Id3v2FrameIds::lTitle || lhs == Id3v2FrameIds::sTitle) {
-        return true;
-    }
-    if (rhs == Id3v2FrameIds::lTitle || rhs == Id3v2FrameIds::sTitle) {
-        return false;
-    }
-
-    const bool lhstextfield = Id3v2FrameIds::isTextFrame(lhs);
-    const bool rhstextfield = Id3v2FrameIds::isTextFrame(rhs);
-    if (lhstextfield && !rhstextfield) {
-        return true;
-    }
-    if (!lhstextfield && rhstextfield) {
-        return false;
-    }
-
-    if (lhs == Id3v2FrameIds::lCover || lhs == Id3v2FrameIds::sCover) {
-        return false;
-    }
-    if (rhs == Id3v2FrameIds::lCover || rhs == Id3v2FrameIds::sCover) {
-        return true;
-    }
-    return lhs < rhs;
+    return lhs != rhs && frameOrderKey(lhs) < frameOrderKey(rhs);
 }
 
 /*!
@@ -768,25 +814,24 @@ bool FrameComparer::operator()(std::uint32_t lhs, std::uint32_t rhs) const
  */
 
 /*!
- * \brief Removes all old (major version <= 3) record date related fields.
+ * \brief Determines how the record date needs to be saved according to the ID3v2 version.
+ * \param recordDateFrames Specifies the vector to add frames to which need to be written in addition to the fields of the tag.
+ * \param omittedFrameIds Specifies the vector to add the IDs of fields to which must not be written.
+ * \remarks Does not alter the fields of the tag so the tag is not considered modified by just making it.
  */
-void Id3v2Tag::removeOldRecordDateRelatedFields()
+void Id3v2Tag::prepareRecordDataForMaking(
+    std::vector<Id3v2Frame> &recordDateFrames, std::vector<std::uint32_t> &omittedFrameIds, const std::string &diagContext, Diagnostics &diag) const
 {
-    for (auto field : { Id3v2FrameIds::lYear, Id3v2FrameIds::lRecordingDates, Id3v2FrameIds::lDate, Id3v2FrameIds::lTime }) {
-        fields().erase(field);
-    }
-}
+    const auto omitOldRecordDateRelatedFields = [&omittedFrameIds] {
+        omittedFrameIds.insert(
+            omittedFrameIds.end(), { Id3v2FrameIds::lYear, Id3v2FrameIds::lRecordingDates, Id3v2FrameIds::lDate, Id3v2FrameIds::lTime });
+    };
 
-/*!
- * \brief Prepare the fields to save the record data according to the ID3v2 version.
- */
-void Id3v2Tag::prepareRecordDataForMaking(const std::string &diagContext, Diagnostics &diag)
-{
     // get rid of lYear/lRecordingDates/lDate/lTime/sYear/sRecordingDates/sDate/sTime if writing v2.4.0 or newer
     // note: If the tag was initially v2.3.0 or older the "old" fields have already been converted to lRecordingTime when
     //        parsing and the generic accessors propose using lRecordingTime in any case.
     if (majorVersion() >= 4) {
-        removeOldRecordDateRelatedFields();
+        omitOldRecordDateRelatedFields();
         return;
     }
 
@@ -797,31 +842,31 @@ void Id3v2Tag::prepareRecordDataForMaking(const std::string &diagContext, Diagno
     if (recordingTimeFieldIterator == fields().cend()) {
         return;
     }
-    // -> simply remove all old fields if lRecordingTime is set to an empty value
+    // -> simply omit all old fields if lRecordingTime is set to an empty value
     const auto &recordingTime = recordingTimeFieldIterator->second.value();
     if (recordingTime.isEmpty()) {
-        removeOldRecordDateRelatedFields();
+        omitOldRecordDateRelatedFields();
         return;
     }
     // -> convert lRecordingTime (which is supposed to be an ISO string) to a DateTime
     try {
         const auto dateTimeExpr = recordingTime.toDateTimeExpression();
         const auto &asDateTime = dateTimeExpr.value;
-        // -> remove any existing old fields to avoid any leftovers
-        removeOldRecordDateRelatedFields();
-        // -> assign old fields from parsed DateTime
+        // -> omit any existing old fields to avoid any leftovers
+        omitOldRecordDateRelatedFields();
+        // -> make old fields from parsed DateTime
         std::stringstream year, date, time;
         if (dateTimeExpr.parts & DateTimeParts::Year) {
             year << std::setfill('0') << std::setw(4) << asDateTime.year();
-            setValue(Id3v2FrameIds::lYear, TagValue(year.str()));
+            recordDateFrames.emplace_back(Id3v2FrameIds::lYear, TagValue(year.str()));
         }
         if (dateTimeExpr.parts & (DateTimeParts::Day | DateTimeParts::Month)) {
             date << std::setfill('0') << std::setw(2) << asDateTime.day() << std::setfill('0') << std::setw(2) << asDateTime.month();
-            setValue(Id3v2FrameIds::lDate, TagValue(date.str()));
+            recordDateFrames.emplace_back(Id3v2FrameIds::lDate, TagValue(date.str()));
         }
         if (dateTimeExpr.parts & DateTimeParts::Time) {
             time << std::setfill('0') << std::setw(2) << asDateTime.hour() << std::setfill('0') << std::setw(2) << asDateTime.minute();
-            setValue(Id3v2FrameIds::lTime, TagValue(time.str()));
+            recordDateFrames.emplace_back(Id3v2FrameIds::lTime, TagValue(time.str()));
         }
         if (dateTimeExpr.parts & (DateTimeParts::Second | DateTimeParts::SubSecond)) {
             diag.emplace_back(DiagLevel::Warning,
@@ -842,7 +887,51 @@ void Id3v2Tag::prepareRecordDataForMaking(const std::string &diagContext, Diagno
         }
     }
     // -> get rid of lRecordingTime
-    fields().erase(Id3v2FrameIds::lRecordingTime);
+    omittedFrameIds.emplace_back(Id3v2FrameIds::lRecordingTime);
+}
+
+/*!
+ * \brief Returns whether the frame with the specified \a id is accepted by the specified \a fieldFilter.
+ * \remarks The frames which are combined into the recording time frame when parsing are treated as KnownField::RecordDate.
+ */
+bool Id3v2Tag::isFrameAccepted(const TagFieldFilter &fieldFilter, std::uint32_t id) const
+{
+    if (fieldFilter.accepts(*this, id)) {
+        return true;
+    }
+    if (!fieldFilter.acceptsField(KnownField::RecordDate)) {
+        return false;
+    }
+    switch (Id3v2FrameIds::isShortId(id) ? Id3v2FrameIds::convertToLongId(id) : id) {
+    case Id3v2FrameIds::lRecordingDates:
+    case Id3v2FrameIds::lDate:
+    case Id3v2FrameIds::lTime:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/*!
+ * \brief Decodes the skipped frames so they can be made using a different version than they have been parsed with.
+ */
+void Id3v2Tag::parseSkippedFrames(Diagnostics &diag)
+{
+    static const auto context = DiagContext("parsing skipped ID3v2 frames");
+    for (const auto &[id, rawFrame] : skippedFields()) {
+        auto frame = Id3v2Frame();
+        try {
+            frame.parse(rawFrame.dataPointer(), m_skippedFramesVersion, static_cast<std::uint32_t>(rawFrame.dataSize()), diag);
+            fields().emplace(frame.id(), std::move(frame));
+        } catch (const Failure &) {
+            diag.emplace_back(
+                DiagLevel::Critical, "Unable to parse skipped frame " % Id3v2Frame::fieldIdToString(id) + "; it will be dropped.", context);
+        }
+    }
+    skippedFields().clear();
+    if (m_handlingFlags & Id3v2HandlingFlags::ConvertRecordDateFields) {
+        convertOldRecordDateFields(context, diag);
+    }
 }
 
 /*!
@@ -853,7 +942,7 @@ Id3v2TagMaker::Id3v2TagMaker(Id3v2Tag &tag, Diagnostics &diag)
     : m_tag(tag)
     , m_framesSize(0)
 {
-    static const string context("making ID3v2 tag");
+    static const auto context = DiagContext("making ID3v2 tag");
 
     // check if version is supported
     // (the version could have been changed using setVersion())
@@ -862,20 +951,61 @@ Id3v2TagMaker::Id3v2TagMaker(Id3v2Tag &tag, Diagnostics &diag)
         throw VersionNotSupportedException();
     }
 
+    // decode skipped frames if the version has been changed; otherwise they can be written as-is
+    if (!tag.internallyGetSkippedFields().empty() && tag.m_skippedFramesVersion != tag.majorVersion()) {
+        tag.parseSkippedFrames(diag);
+    }
+
+    // determine frames to be written additionally/omitted to save the record date according to the version
+    auto omittedFrameIds = std::vector<std::uint32_t>();
     if (m_tag.m_handlingFlags & Id3v2HandlingFlags::ConvertRecordDateFields) {
-        tag.prepareRecordDataForMaking(context, diag);
+        tag.prepareRecordDataForMaking(m_recordDateFrames, omittedFrameIds, context, diag);
+    }
+    const auto isOmitted = [&omittedFrameIds](std::uint32_t id) {
+        return std::any_of(omittedFrameIds.cbegin(), omittedFrameIds.cend(),
+            [id, compare = FrameComparer()](std::uint32_t omittedId) { return !compare(id, omittedId) && !compare(omittedId, id); });
+    };
+
+    // determine frames to be written preserving the order of the field map
+    // note: The fields are accessed via internallyGetFields() so the tag is not considered modified by just making it.
+    auto &fields = tag.internallyGetFields();
+    auto frames = std::vector<Id3v2Frame *>();
+    frames.reserve(fields.size() + m_recordDateFrames.size());
+    for (auto &pair : fields) {
+        if (!isOmitted(pair.first)) {
+            frames.emplace_back(&pair.second);
+        }
+    }
+    for (auto &frame : m_recordDateFrames) {
+        frames.emplace_back(&frame);
+    }
+    if (!m_recordDateFrames.empty()) {
+        std::stable_sort(frames.begin(), frames.end(),
+            [compare = FrameComparer()](const Id3v2Frame *lhs, const Id3v2Frame *rhs) { return compare(lhs->id(), rhs->id()); });
     }
 
     // prepare frames
-    m_maker.reserve(tag.fields().size());
-    for (auto &pair : tag.fields()) {
+    m_maker.reserve(frames.size());
+    for (auto *const frame : frames) {
         try {
-            m_maker.emplace_back(pair.second.prepareMaking(tag.majorVersion(), diag));
+            m_maker.emplace_back(frame->prepareMaking(tag.majorVersion(), diag));
             m_framesSize += m_maker.back().requiredSize();
         } catch (const Failure &) {
         }
     }
 
+    // read skipped frames now as the tag might be written to the stream they are read from
+    const auto &skippedFields = tag.internallyGetSkippedFields();
+    m_skippedFrames.reserve(skippedFields.size());
+    for (const auto &[id, rawFrame] : skippedFields) {
+        if (isOmitted(id)) {
+            continue;
+        }
+        rawFrame.loadData();
+        m_skippedFrames.emplace_back(&rawFrame);
+        m_framesSize += static_cast<std::uint32_t>(rawFrame.dataSize());
+    }
+
     // calculate required size
     // -> header + size of frames
     m_requiredSize = 10 + m_framesSize;
@@ -884,6 +1014,8 @@ Id3v2TagMaker::Id3v2TagMaker(Id3v2Tag &tag, Diagnostics &diag)
 /*!
  * \brief Saves the tag (specified when constructing the object) to the
  *        specified \a stream.
+ * \remarks The header and the frames are rendered into a contiguous buffer first so they are written using a single write. The
+ *          \a padding is streamed afterwards so it is never buffered.
  * \throws Throws std::ios_base::failure when an IO error occurs.
  * \throws Throws Assumes the data is already validated and thus does NOT
  *                throw TagParser::Failure or a derived exception.
@@ -892,6 +1024,41 @@ void Id3v2TagMaker::make(std::ostream &stream, std::uint32_t padding, Diagnostic
 {
     CPP_UTILITIES_UNUSED(diag)
 
+    const auto size = static_cast<std::size_t>(m_requiredSize);
+    const auto buffer = make_unique<char[]>(size);
+    MemoryOutputBuffer memoryBuffer(buffer.get(), size);
+    ostream bufferStream(&memoryBuffer);
+    bufferStream.exceptions(ios_base::failbit | ios_base::badbit);
+    internallyMake(bufferStream, padding);
+    stream.write(buffer.get(), static_cast<std::streamsize>(size));
+    MediaFileInfo::writePadding(stream, padding);
+}
+
+/*!
+ * \brief Saves the tag (specified when constructing the object) to the
+ *        specified \a buffer.
+ * \remarks The \a buffer must be at least requiredSize() + \a padding bytes long.
+ * \throws Throws std::ios_base::failure when the tag does not fit into requiredSize() bytes or
+ *         when an IO error occurs while copying lazily loaded data from its source.
+ * \throws Throws Assumes the data is already validated and thus does NOT
+ *                throw TagParser::Failure or a derived exception.
+ */
+void Id3v2TagMaker::make(char *buffer, std::uint32_t padding, Diagnostics &diag)
+{
+    CPP_UTILITIES_UNUSED(diag)
+
+    MemoryOutputBuffer memoryBuffer(buffer, m_requiredSize);
+    ostream stream(&memoryBuffer);
+    stream.exceptions(ios_base::failbit | ios_base::badbit);
+    internallyMake(stream, padding);
+    std::memset(buffer + m_requiredSize, 0, padding);
+}
+
+/*!
+ * \brief Writes the header and the frames (but not the \a padding itself) to the specified \a stream.
+ */
+void Id3v2TagMaker::internallyMake(std::ostream &stream, std::uint32_t padding)
+{
     BinaryWriter writer(&stream);
 
     // write header
@@ -900,8 +1067,8 @@ void Id3v2TagMaker::make(std::ostream &stream, std::uint32_t padding, Diagnostic
     // -> version
     writer.writeByte(m_tag.majorVersion());
     writer.writeByte(m_tag.revisionVersion());
-    // -> flags, but without extended header or compression bit set
-    writer.writeByte(m_tag.flags() & 0xBF);
+    // -> flags, but without unsynchronisation (never applied when making) or extended header bit set
+    writer.writeByte(m_tag.flags() & 0x3F);
     // -> size (excluding header)
     writer.writeSynchsafeUInt32BE(m_framesSize + padding);
 
@@ -909,8 +1076,9 @@ void Id3v2TagMaker::make(std::ostream &stream, std::uint32_t padding, Diagnostic
     for (auto &maker : m_maker) {
         maker.make(writer);
     }
-
-    MediaFileInfo::writePadding(stream, padding);
+    for (const auto *const rawFrame : m_skippedFrames) {
+        stream.write(rawFrame->dataPointer(), static_cast<std::streamsize>(rawFrame->dataSize()));
+    }
 }
 
 } // namespace TagParser
@@ -17,6 +17,7 @@ namespace TagParser {
 enum class Id3v2HandlingFlags : std::uint64_t {
     None = 0, /**< Regular parsing/making. */
     ConvertRecordDateFields = (1 << 1), /**< whether record date fields should be converted when parsing/making */
+    LoadPicturesLazily = (1 << 2), /**< whether the data of pictures should only be read when accessed, see TagValue::assignLazyData() */
     Defaults = ConvertRecordDateFields, /**< set of flags considered good defaults */
 };
 
@@ -27,6 +28,7 @@ CPP_UTILITIES_MARK_FLAG_ENUM_CLASS(TagParser, TagParser::Id3v2HandlingFlags)
 namespace TagParser {
 
 class Id3v2Tag;
+class TagFieldFilter;
 
 struct TAG_PARSER_EXPORT FrameComparer {
     bool operator()(std::uint32_t lhs, std::uint32_t rhs) const;
@@ -37,16 +39,20 @@ class TAG_PARSER_EXPORT Id3v2TagMaker {
 
 public:
     void make(std::ostream &stream, std::uint32_t padding, Diagnostics &diag);
+    void make(char *buffer, std::uint32_t padding, Diagnostics &diag);
     const Id3v2Tag &tag() const;
     std::uint64_t requiredSize() const;
 
 private:
     Id3v2TagMaker(Id3v2Tag &tag, Diagnostics &diag);
+    void internallyMake(std::ostream &stream, std::uint32_t padding);
 
     Id3v2Tag &m_tag;
     std::uint32_t m_framesSize;
     std::uint32_t m_requiredSize;
+    std::vector<Id3v2Frame> m_recordDateFrames;
     std::vector<Id3v2FrameMaker> m_maker;
+    std::vector<const TagValue *> m_skippedFrames;
 };
 
 /*!
@@ -73,6 +79,7 @@ template <> class TAG_PARSER_EXPORT FieldMapBasedTagTraits<Id3v2Tag> {
 public:
     using FieldType = Id3v2Frame;
     using Compare = FrameComparer;
+    template <typename Key, typename Value, typename KeyCompare> using Container = FlatMultiMap<Key, Value, KeyCompare>;
 };
 
 class TAG_PARSER_EXPORT Id3v2Tag final : public FieldMapBasedTag<Id3v2Tag> {
@@ -93,7 +100,7 @@ public:
     bool supportsMultipleValues(IdentifierType id) const;
     void ensureTextValuesAreProperlyEncoded() override;
 
-    void parse(std::istream &sourceStream, const std::uint64_t maximalSize, Diagnostics &diag);
+    void parse(std::istream &sourceStream, const std::uint64_t maximalSize, Diagnostics &diag, const TagFieldFilter *fieldFilter = nullptr);
     Id3v2TagMaker prepareMaking(Diagnostics &diag);
     void make(std::ostream &targetStream, std::uint32_t padding, Diagnostics &diag);
     Id3v2HandlingFlags handlingFlags() const;
@@ -120,8 +127,10 @@ protected:
 
 private:
     void convertOldRecordDateFields(const std::string &diagContext, Diagnostics &diag);
-    void removeOldRecordDateRelatedFields();
-    void prepareRecordDataForMaking(const std::string &diagContext, Diagnostics &diag);
+    void prepareRecordDataForMaking(std::vector<Id3v2Frame> &recordDateFrames, std::vector<std::uint32_t> &omittedFrameIds,
+        const std::string &diagContext, Diagnostics &diag) const;
+    bool isFrameAccepted(const TagFieldFilter &fieldFilter, std::uint32_t id) const;
+    void parseSkippedFrames(Diagnostics &diag);
 
 private:
     std::uint8_t m_majorVersion;
@@ -131,6 +140,7 @@ private:
     std::uint32_t m_extendedHeaderSize;
     std::uint64_t m_paddingSize;
     Id3v2HandlingFlags m_handlingFlags;
+    std::uint8_t m_skippedFramesVersion;
 };
 
 /*!
@@ -144,6 +154,7 @@ inline Id3v2Tag::Id3v2Tag()
     , m_extendedHeaderSize(0)
     , m_paddingSize(0)
     , m_handlingFlags(Id3v2HandlingFlags::Defaults)
+    , m_skippedFramesVersion(0)
 {
 }
 
@@ -0,0 +1,256 @@
+#include "./iostatistics.h"
+#include "./iostatisticsrecorder.h"
+
+using namespace std;
+
+namespace TagParser {
+
+/*!
+ * \brief Returns the name of the specified \a phase.
+ */
+std::string_view ioPhaseName(IoPhase phase)
+{
+    switch (phase) {
+    case IoPhase::Other:
+        return "other";
+    case IoPhase::ParseContainerFormat:
+        return "parse container format";
+    case IoPhase::ParseTracks:
+        return "parse tracks";
+    case IoPhase::ParseTags:
+        return "parse tags";
+    case IoPhase::ApplyChanges:
+        return "apply changes";
+    }
+    return std::string_view();
+}
+
+/*!
+ * \brief Adds the counters of \a other to the current instance.
+ */
+IoCounters &IoCounters::operator+=(const IoCounters &other)
+{
+    bytesRead += other.bytesRead;
+    bytesWritten += other.bytesWritten;
+    reads += other.reads;
+    writes += other.writes;
+    seeks += other.seeks;
+    ioTime += other.ioTime;
+    totalTime += other.totalTime;
+    return *this;
+}
+
+/*!
+ * \brief Returns the sum of the counters of all phases.
+ */
+IoCounters IoStatistics::total() const
+{
+    auto total = IoCounters();
+    for (const auto &counters : phases) {
+        total += counters;
+    }
+    return total;
+}
+
+/// \cond
+
+namespace {
+
+/*!
+ * \brief The IoTimer struct adds the time between its construction and destruction to the I/O time of \a counters.
+ */
+struct IoTimer {
+    explicit IoTimer(IoCounters &counters)
+        : counters(counters)
+        , start(std::chrono::steady_clock::now())
+    {
+    }
+    ~IoTimer()
+    {
+        counters.ioTime += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    }
+    IoCounters &counters;
+    const std::chrono::steady_clock::time_point start;
+};
+
+} // namespace
+
+IoCountingBuffer::IoCountingBuffer(std::streambuf *buffer, IoStatisticsRecorder &recorder)
+    : m_buffer(buffer)
+    , m_recorder(recorder)
+{
+}
+
+IoCountingBuffer::int_type IoCountingBuffer::underflow()
+{
+    // only peeks at the next character so it is not counted as read
+    return m_buffer->sgetc();
+}
+
+IoCountingBuffer::int_type IoCountingBuffer::uflow()
+{
+    auto &counters = m_recorder.counters();
+    const auto timer = IoTimer(counters);
+    const auto c = m_buffer->sbumpc();
+    ++counters.reads;
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+        ++counters.bytesRead;
+    }
+    return c;
+}
+
+std::streamsize IoCountingBuffer::xsgetn(char_type *s, std::streamsize count)
+{
+    auto &counters = m_recorder.counters();
+    const auto timer = IoTimer(counters);
+    const auto bytesRead = m_buffer->sgetn(s, count);
+    ++counters.reads;
+    counters.bytesRead += static_cast<std::uint64_t>(bytesRead);
+    return bytesRead;
+}
+
+std::streamsize IoCountingBuffer::showmanyc()
+{
+    return m_buffer->in_avail();
+}
+
+IoCountingBuffer::int_type IoCountingBuffer::pbackfail(int_type c)
+{
+    return traits_type::eq_int_type(c, traits_type::eof()) ? m_buffer->sungetc() : m_buffer->sputbackc(traits_type::to_char_type(c));
+}
+
+IoCountingBuffer::int_type IoCountingBuffer::overflow(int_type c)
+{
+    if (traits_type::eq_int_type(c, traits_type::eof())) {
+        return traits_type::not_eof(c);
+    }
+    auto &counters = m_recorder.counters();
+    const auto timer = IoTimer(counters);
+    const auto res = m_buffer->sputc(traits_type::to_char_type(c));
+    ++counters.writes;
+    if (!traits_type::eq_int_type(res, traits_type::eof())) {
+        ++counters.bytesWritten;
+    }
+    return res;
+}
+
+std::streamsize IoCountingBuffer::xsputn(const char_type *s, std::streamsize count)
+{
+    auto &counters = m_recorder.counters();
+    const auto timer = IoTimer(counters);
+    const auto bytesWritten = m_buffer->sputn(s, count);
+    ++counters.writes;
+    counters.bytesWritten += static_cast<std::uint64_t>(bytesWritten);
+    return bytesWritten;
+}
+
+IoCountingBuffer::pos_type IoCountingBuffer::seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which)
+{
+    // don't count querying the current position (tellg()/tellp()) as seek
+    if (!off && dir == std::ios_base::cur) {
+        return m_buffer->pubseekoff(off, dir, which);
+    }
+    auto &counters = m_recorder.counters();
+    const auto timer = IoTimer(counters);
+    ++counters.seeks;
+    return m_buffer->pubseekoff(off, dir, which);
+}
+
+IoCountingBuffer::pos_type IoCountingBuffer::seekpos(pos_type pos, std::ios_base::openmode which)
+{
+    auto &counters = m_recorder.counters();
+    const auto timer = IoTimer(counters);
+    ++counters.seeks;
+    return m_buffer->pubseekpos(pos, which);
+}
+
+int IoCountingBuffer::sync()
+{
+    auto &counters = m_recorder.counters();
+    const auto timer = IoTimer(counters);
+    return m_buffer->pubsync();
+}
+
+/*!
+ * \brief Constructs a new recorder for the specified \a stream and attaches to it.
+ */
+IoStatisticsRecorder::IoStatisticsRecorder(std::ios &stream)
+    : m_stream(stream)
+    , m_phase(IoPhase::Other)
+    , m_depth(0)
+{
+    attach();
+}
+
+/*!
+ * \brief Restores the original buffer of the stream passed to the constructor.
+ */
+IoStatisticsRecorder::~IoStatisticsRecorder()
+{
+    if (m_buffer && m_stream.rdbuf() == m_buffer.get()) {
+        const auto state = m_stream.rdstate();
+        m_stream.rdbuf(m_buffer->buffer());
+        m_stream.clear(state);
+    }
+}
+
+/*!
+ * \brief Attaches to the stream passed to the constructor again.
+ * \remarks Required when the stream has replaced its buffer (e.g. NativeFileStream does this when being reopened and
+ *          c++utilities has been built to use its own file buffer).
+ */
+void IoStatisticsRecorder::attach()
+{
+    attach(m_stream, m_buffer);
+}
+
+/*!
+ * \brief Attaches to the specified \a stream so I/O on it is accounted to the current phase as well.
+ * \remarks
+ * - Meant for backup files opened within a phase. Does nothing when called outside of a phase.
+ * - The buffer is released when the outermost phase ends without restoring it. So \a stream must not be used anymore
+ *   after the outermost phase has ended.
+ */
+void IoStatisticsRecorder::attachSecondary(std::ios &stream)
+{
+    if (!m_depth) {
+        return;
+    }
+    attach(stream, m_secondaryBuffers.emplace_back());
+}
+
+void IoStatisticsRecorder::attach(std::ios &stream, std::unique_ptr<IoCountingBuffer> &buffer)
+{
+    auto *const currentBuffer = stream.rdbuf();
+    if (!currentBuffer || (buffer && currentBuffer == buffer.get())) {
+        return;
+    }
+    buffer = std::make_unique<IoCountingBuffer>(currentBuffer, *this);
+    const auto state = stream.rdstate();
+    stream.rdbuf(buffer.get());
+    stream.clear(state);
+}
+
+void IoStatisticsRecorder::enterPhase(IoPhase phase)
+{
+    if (m_depth++) {
+        return;
+    }
+    attach();
+    m_phase = phase;
+    m_phaseStart = std::chrono::steady_clock::now();
+}
+
+void IoStatisticsRecorder::leavePhase()
+{
+    if (--m_depth) {
+        return;
+    }
+    counters().totalTime += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_phaseStart);
+    m_phase = IoPhase::Other;
+    m_secondaryBuffers.clear();
+}
+
+/// \endcond
+
+} // namespace TagParser
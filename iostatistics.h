@@ -0,0 +1,87 @@
+#ifndef TAG_PARSER_IOSTATISTICS_H
+#define TAG_PARSER_IOSTATISTICS_H
+
+#include "./global.h"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace TagParser {
+
+/*!
+ * \brief The IoPhase enum specifies the phases I/O operations are accounted to by IoStatistics.
+ */
+enum class IoPhase : std::uint8_t {
+    Other, /**< any I/O not happening within one of the other phases, e.g. within parseChapters() or planChanges() */
+    ParseContainerFormat, /**< I/O within MediaFileInfo::parseContainerFormat() */
+    ParseTracks, /**< I/O within MediaFileInfo::parseTracks() */
+    ParseTags, /**< I/O within MediaFileInfo::parseTags() */
+    ApplyChanges, /**< I/O within MediaFileInfo::applyChanges(), including I/O on the backup file */
+};
+
+/// \brief The number of phases within IoPhase.
+constexpr std::size_t ioPhaseCount = 5;
+
+TAG_PARSER_EXPORT std::string_view ioPhaseName(IoPhase phase);
+
+/*!
+ * \brief The IoCounters struct holds the I/O counters of a certain phase.
+ * \remarks
+ * - Reads, writes and seeks are the calls made on the stream buffer (e.g. one std::istream::read() or std::istream::get()
+ *   call is one read) and not the system calls made by the underlying file buffer.
+ * - Querying the current position (e.g. via std::istream::tellg()) is not counted as seek.
+ */
+struct TAG_PARSER_EXPORT IoCounters {
+    IoCounters &operator+=(const IoCounters &other);
+
+    /// \brief The number of bytes read.
+    std::uint64_t bytesRead = 0;
+    /// \brief The number of bytes written.
+    std::uint64_t bytesWritten = 0;
+    /// \brief The number of read calls.
+    std::uint64_t reads = 0;
+    /// \brief The number of write calls.
+    std::uint64_t writes = 0;
+    /// \brief The number of seek calls.
+    std::uint64_t seeks = 0;
+    /// \brief The time spent within read, write and seek calls.
+    std::chrono::nanoseconds ioTime = std::chrono::nanoseconds::zero();
+    /// \brief The time spent within the phase as a whole (always zero for IoPhase::Other).
+    std::chrono::nanoseconds totalTime = std::chrono::nanoseconds::zero();
+};
+
+/*!
+ * \brief The IoStatistics struct holds the I/O counters of a MediaFileInfo per phase.
+ * \sa MediaFileInfo::setIoStatisticsEnabled(), MediaFileInfo::ioStatistics()
+ */
+struct TAG_PARSER_EXPORT IoStatistics {
+    IoCounters &phase(IoPhase phase);
+    const IoCounters &phase(IoPhase phase) const;
+    IoCounters total() const;
+
+    /// \brief The counters of each phase; use phase() to access the counters of a certain phase.
+    std::array<IoCounters, ioPhaseCount> phases;
+};
+
+/*!
+ * \brief Returns the counters of the specified \a phase.
+ */
+inline IoCounters &IoStatistics::phase(IoPhase phase)
+{
+    return phases[static_cast<std::size_t>(phase)];
+}
+
+/*!
+ * \brief Returns the counters of the specified \a phase.
+ */
+inline const IoCounters &IoStatistics::phase(IoPhase phase) const
+{
+    return phases[static_cast<std::size_t>(phase)];
+}
+
+} // namespace TagParser
+
+#endif // TAG_PARSER_IOSTATISTICS_H
@@ -0,0 +1,140 @@
+#ifndef TAG_PARSER_IOSTATISTICSRECORDER_H
+#define TAG_PARSER_IOSTATISTICSRECORDER_H
+
+#include "./iostatistics.h"
+
+#include <chrono>
+#include <cstddef>
+#include <ios>
+#include <memory>
+#include <streambuf>
+#include <vector>
+
+namespace TagParser {
+
+/// \cond
+
+class IoStatisticsRecorder;
+
+/*!
+ * \brief The IoCountingBuffer class is a std::streambuf forwarding all operations to another buffer while counting them.
+ * \remarks The class has no buffer itself so each operation is forwarded and counted. The wrapped buffer keeps buffering
+ *          as usual.
+ */
+class IoCountingBuffer : public std::streambuf {
+public:
+    explicit IoCountingBuffer(std::streambuf *buffer, IoStatisticsRecorder &recorder);
+    std::streambuf *buffer() const;
+
+protected:
+    int_type underflow() override;
+    int_type uflow() override;
+    std::streamsize xsgetn(char_type *s, std::streamsize count) override;
+    std::streamsize showmanyc() override;
+    int_type pbackfail(int_type c) override;
+    int_type overflow(int_type c) override;
+    std::streamsize xsputn(const char_type *s, std::streamsize count) override;
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override;
+    pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+    int sync() override;
+
+private:
+    std::streambuf *m_buffer;
+    IoStatisticsRecorder &m_recorder;
+};
+
+/*!
+ * \brief Returns the wrapped buffer.
+ */
+inline std::streambuf *IoCountingBuffer::buffer() const
+{
+    return m_buffer;
+}
+
+/*!
+ * \brief The IoStatisticsRecorder class records IoStatistics for a stream by replacing its buffer with an IoCountingBuffer.
+ * \remarks Used by MediaFileInfo which only creates an instance when statistics are enabled.
+ */
+class IoStatisticsRecorder {
+public:
+    /*!
+     * \brief The PhaseScope class accounts I/O to a phase for its lifetime.
+     * \remarks When scopes are nested (e.g. parseTags() called within applyChanges()) the outermost phase wins.
+     */
+    class PhaseScope {
+    public:
+        explicit PhaseScope(IoStatisticsRecorder *recorder, IoPhase phase);
+        PhaseScope(const PhaseScope &) = delete;
+        PhaseScope &operator=(const PhaseScope &) = delete;
+        ~PhaseScope();
+
+    private:
+        IoStatisticsRecorder *m_recorder;
+    };
+
+    explicit IoStatisticsRecorder(std::ios &stream);
+    IoStatisticsRecorder(const IoStatisticsRecorder &) = delete;
+    IoStatisticsRecorder &operator=(const IoStatisticsRecorder &) = delete;
+    ~IoStatisticsRecorder();
+
+    void attach();
+    void attachSecondary(std::ios &stream);
+    IoStatistics &statistics();
+    IoCounters &counters();
+
+private:
+    void enterPhase(IoPhase phase);
+    void leavePhase();
+    void attach(std::ios &stream, std::unique_ptr<IoCountingBuffer> &buffer);
+
+    std::ios &m_stream;
+    std::unique_ptr<IoCountingBuffer> m_buffer;
+    std::vector<std::unique_ptr<IoCountingBuffer>> m_secondaryBuffers;
+    IoStatistics m_statistics;
+    IoPhase m_phase;
+    std::size_t m_depth;
+    std::chrono::steady_clock::time_point m_phaseStart;
+};
+
+/*!
+ * \brief Returns the statistics recorded so far.
+ */
+inline IoStatistics &IoStatisticsRecorder::statistics()
+{
+    return m_statistics;
+}
+
+/*!
+ * \brief Returns the counters of the current phase.
+ */
+inline IoCounters &IoStatisticsRecorder::counters()
+{
+    return m_statistics.phase(m_phase);
+}
+
+/*!
+ * \brief Enters the specified \a phase if \a recorder is not nullptr (so statistics are disabled).
+ */
+inline IoStatisticsRecorder::PhaseScope::PhaseScope(IoStatisticsRecorder *recorder, IoPhase phase)
+    : m_recorder(recorder)
+{
+    if (m_recorder) {
+        m_recorder->enterPhase(phase);
+    }
+}
+
+/*!
+ * \brief Leaves the phase entered by the constructor.
+ */
+inline IoStatisticsRecorder::PhaseScope::~PhaseScope()
+{
+    if (m_recorder) {
+        m_recorder->leavePhase();
+    }
+}
+
+/// \endcond
+
+} // namespace TagParser
+
+#endif // TAG_PARSER_IOSTATISTICSRECORDER_H
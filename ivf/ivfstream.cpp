@@ -24,7 +24,7 @@ void IvfStream::internalParseHeader(Diagnostics &diag, AbortableProgressFeedback
 {
     CPP_UTILITIES_UNUSED(progress)
 
-    static const string context("parsing IVF header");
+    static const auto context = DiagContext("parsing IVF header");
     if (!m_istream) {
         throw NoDataFoundException();
     }
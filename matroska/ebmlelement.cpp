@@ -10,12 +10,17 @@
 #include <c++utilities/io/binaryreader.h>
 #include <c++utilities/io/binarywriter.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <cstring>
 #include <memory>
 #include <sstream>
 #include <string>
 
+#if __has_include(<bit>)
+#include <bit>
+#endif
+
 using namespace std;
 using namespace CppUtilities;
 
@@ -31,6 +36,39 @@ namespace TagParser {
  */
 std::uint64_t EbmlElement::bytesToBeSkipped = 0x4000;
 
+/*!
+ * \brief Masks the data bits of size denotations by their length (the index is the length in byte).
+ */
+static constexpr std::uint64_t sizeDenotationMasks[] = { 0x0ul, 0x7Ful, 0x3FFFul, 0x1FFFFFul, 0xFFFFFFFul, 0x7FFFFFFFFul, 0x3FFFFFFFFFFul,
+    0x1FFFFFFFFFFFFul, 0xFFFFFFFFFFFFFFul };
+
+/*!
+ * \brief Returns the number of leading zero bits of the specified \a value.
+ */
+template <typename UnsignedType> static inline int countLeadingZeros(UnsignedType value)
+{
+#if defined(__cpp_lib_bitops)
+    return std::countl_zero(value);
+#elif defined(__GNUC__)
+    return value ? __builtin_clzll(value) - static_cast<int>((sizeof(unsigned long long) - sizeof(UnsignedType)) * 8)
+                 : static_cast<int>(sizeof(UnsignedType) * 8);
+#else
+    auto zeros = static_cast<int>(sizeof(UnsignedType) * 8);
+    for (; value; value >>= 1) {
+        --zeros;
+    }
+    return zeros;
+#endif
+}
+
+/*!
+ * \brief Returns the number of bits required to represent the specified \a value.
+ */
+static inline int bitWidth(std::uint64_t value)
+{
+    return 64 - countLeadingZeros(value);
+}
+
 /*!
  * \brief Constructs a new top level element with the specified \a container at the specified \a startOffset.
  */
@@ -68,7 +106,7 @@ string EbmlElement::parsingContext() const
  */
 void EbmlElement::internalParse(Diagnostics &diag)
 {
-    static const string context("parsing EBML element header");
+    static const auto context = DiagContext("parsing EBML element header");
 
     for (std::uint64_t skipped = 0; skipped < bytesToBeSkipped; ++m_startOffset, --m_maxSize, ++skipped) {
         // check whether max size is valid
@@ -78,14 +116,12 @@ void EbmlElement::internalParse(Diagnostics &diag)
         }
         stream().seekg(static_cast<streamoff>(startOffset()));
 
-        // read ID
-        char buf[maximumIdLengthSupported() > maximumSizeLengthSupported() ? maximumIdLengthSupported() : maximumSizeLengthSupported()] = { 0 };
-        std::uint8_t beg = static_cast<std::uint8_t>(stream().peek()), mask = 0x80;
-        m_idLength = 1;
-        while (m_idLength <= maximumIdLengthSupported() && (beg & mask) == 0) {
-            ++m_idLength;
-            mask >>= 1;
-        }
+        // read ID and size denotation at once (as far as available)
+        char buf[maximumIdLengthSupported() + maximumSizeLengthSupported()] = { 0 };
+        stream().read(buf, static_cast<streamsize>(min<std::uint64_t>(maxTotalSize(), sizeof(buf))));
+
+        // parse ID
+        m_idLength = calculateDenotationLength(static_cast<std::uint8_t>(*buf));
         if (m_idLength > maximumIdLengthSupported()) {
             if (!skipped) {
                 diag.emplace_back(
@@ -99,8 +135,7 @@ void EbmlElement::internalParse(Diagnostics &diag)
             }
             continue; // try again
         }
-        reader().read(buf + (maximumIdLengthSupported() - m_idLength), m_idLength);
-        m_id = BE::toInt<std::uint32_t>(buf);
+        m_id = decodeId(buf, m_idLength);
 
         // check whether this element is actually a sibling of one of its parents rather then a child
         // (might be the case if the parent's size is unknown and hence assumed to be the max file size)
@@ -142,19 +177,15 @@ void EbmlElement::internalParse(Diagnostics &diag)
             }
         }
 
-        // read size
-        beg = static_cast<std::uint8_t>(stream().peek());
-        mask = 0x80;
+        // parse size
+        const char *const sizeDenotation = buf + m_idLength;
         m_sizeLength = 1;
-        if ((m_sizeUnknown = (beg == 0xFF))) {
+        if ((m_sizeUnknown = (static_cast<std::uint8_t>(*sizeDenotation) == 0xFF))) {
             // this indicates that the element size is unknown
             // -> just assume the element takes the maximum available size
             m_dataSize = maxTotalSize() - headerSize();
         } else {
-            while (m_sizeLength <= maximumSizeLengthSupported() && (beg & mask) == 0) {
-                ++m_sizeLength;
-                mask >>= 1;
-            }
+            m_sizeLength = calculateDenotationLength(static_cast<std::uint8_t>(*sizeDenotation));
             if (m_sizeLength > maximumSizeLengthSupported()) {
                 if (!skipped) {
                     diag.emplace_back(DiagLevel::Critical, "EBML size length is not supported.", parsingContext());
@@ -167,12 +198,7 @@ void EbmlElement::internalParse(Diagnostics &diag)
                 }
                 continue; // try again
             }
-            // read size into buffer
-            memset(buf, 0, sizeof(DataSizeType)); // reset buffer
-            reader().read(buf + (maximumSizeLengthSupported() - m_sizeLength), m_sizeLength);
-            // xor the first byte in buffer which has been read from the file with mask
-            *(buf + (maximumSizeLengthSupported() - m_sizeLength)) ^= static_cast<char>(mask);
-            m_dataSize = BE::toInt<std::uint64_t>(buf);
+            m_dataSize = decodeSizeDenotation(sizeDenotation, m_sizeLength);
             // check if element is truncated
             if (totalSize() > maxTotalSize()) {
                 if (m_idLength + m_sizeLength > maxTotalSize()) { // header truncated
@@ -262,6 +288,37 @@ double EbmlElement::readFloat()
     }
 }
 
+/*!
+ * \brief Returns the length of the ID or size denotation starting with the specified \a firstByte in byte.
+ * \remarks Returns 9 if \a firstByte is zero which means the length is not valid.
+ */
+std::uint8_t EbmlElement::calculateDenotationLength(std::uint8_t firstByte)
+{
+    return static_cast<std::uint8_t>(countLeadingZeros(firstByte) + 1);
+}
+
+/*!
+ * \brief Decodes the ID with the specified \a idLength stored in \a buff.
+ * \param buff Specifies the buffer containing the ID. Must be at least 4 bytes long.
+ * \param idLength Specifies the length of the ID as returned by calculateDenotationLength(). Must be in the range of 1 and 4.
+ * \remarks All bytes of the buffer are read at once; bytes after the ID are ignored.
+ */
+EbmlElement::IdentifierType EbmlElement::decodeId(const char *buff, std::uint8_t idLength)
+{
+    return BE::toInt<std::uint32_t>(buff) >> ((4 - idLength) * 8);
+}
+
+/*!
+ * \brief Decodes the size denotation with the specified \a sizeLength stored in \a buff.
+ * \param buff Specifies the buffer containing the size denotation. Must be at least 8 bytes long.
+ * \param sizeLength Specifies the length of the size denotation as returned by calculateDenotationLength(). Must be in the range of 1 and 8.
+ * \remarks All bytes of the buffer are read at once; bytes after the size denotation are ignored.
+ */
+std::uint64_t EbmlElement::decodeSizeDenotation(const char *buff, std::uint8_t sizeLength)
+{
+    return (BE::toInt<std::uint64_t>(buff) >> ((8 - sizeLength) * 8)) & sizeDenotationMasks[sizeLength];
+}
+
 /*!
  * \brief Returns the length of the specified \a id in byte.
  * \throws Throws InvalidDataException() if \a id can not be represented.
@@ -287,25 +344,11 @@ std::uint8_t EbmlElement::calculateIdLength(GenericFileElement::IdentifierType i
  */
 std::uint8_t EbmlElement::calculateSizeDenotationLength(std::uint64_t size)
 {
-    if (size < 126) {
-        return 1;
-    } else if (size <= 16382ul) {
-        return 2;
-    } else if (size <= 2097150ul) {
-        return 3;
-    } else if (size <= 268435454ul) {
-        return 4;
-    } else if (size <= 34359738366ul) {
-        return 5;
-    } else if (size <= 4398046511102ul) {
-        return 6;
-    } else if (size <= 562949953421310ul) {
-        return 7;
-    } else if (size <= 72057594037927934ul) {
-        return 8;
-    } else {
+    if (size > 72057594037927934ul) {
         throw InvalidDataException();
     }
+    // note: 126 is denoted using 2 bytes (instead of 1) for compatibility with previous versions
+    return static_cast<std::uint8_t>((bitWidth(size + 1) + 6) / 7 + (size == 126));
 }
 
 /*!
@@ -342,32 +385,11 @@ std::uint8_t EbmlElement::makeId(GenericFileElement::IdentifierType id, char *bu
  */
 std::uint8_t EbmlElement::makeSizeDenotation(std::uint64_t size, char *buff)
 {
-    if (size < 126) {
-        *buff = static_cast<char>(size | 0x80);
-        return 1;
-    } else if (size <= 16382ul) {
-        BE::getBytes(static_cast<std::uint16_t>(size | 0x4000), buff);
-        return 2;
-    } else if (size <= 2097150ul) {
-        BE::getBytes(static_cast<std::uint32_t>((size | 0x200000) << 0x08), buff);
-        return 3;
-    } else if (size <= 268435454ul) {
-        BE::getBytes(static_cast<std::uint32_t>(size | 0x10000000), buff);
-        return 4;
-    } else if (size <= 34359738366ul) {
-        BE::getBytes(static_cast<std::uint64_t>((size | 0x800000000) << 0x18), buff);
-        return 5;
-    } else if (size <= 4398046511102ul) {
-        BE::getBytes(static_cast<std::uint64_t>((size | 0x40000000000) << 0x10), buff);
-        return 6;
-    } else if (size <= 562949953421310ul) {
-        BE::getBytes(static_cast<std::uint64_t>((size | 0x2000000000000) << 0x08), buff);
-        return 7;
-    } else if (size <= 72057594037927934ul) {
-        BE::getBytes(static_cast<std::uint64_t>(size | 0x100000000000000), buff);
-        return 8;
-    }
-    throw InvalidDataException();
+    const auto sizeLength = calculateSizeDenotationLength(size);
+    char denotation[8];
+    BE::getBytes(static_cast<std::uint64_t>(size | (sizeDenotationMasks[sizeLength] + 1)), denotation);
+    memcpy(buff, denotation + (8 - sizeLength), sizeLength);
+    return sizeLength;
 }
 
 /*!
@@ -381,32 +403,14 @@ std::uint8_t EbmlElement::makeSizeDenotation(std::uint64_t size, char *buff)
  */
 std::uint8_t EbmlElement::makeSizeDenotation(std::uint64_t size, char *buff, std::uint8_t minBytes)
 {
-    if (minBytes <= 1 && size < 126) {
-        *buff = static_cast<char>(size | 0x80);
-        return 1;
-    } else if (minBytes <= 2 && size <= 16382ul) {
-        BE::getBytes(static_cast<std::uint16_t>(size | 0x4000), buff);
-        return 2;
-    } else if (minBytes <= 3 && size <= 2097150ul) {
-        BE::getBytes(static_cast<std::uint32_t>((size | 0x200000) << 0x08), buff);
-        return 3;
-    } else if (minBytes <= 4 && size <= 268435454ul) {
-        BE::getBytes(static_cast<std::uint32_t>(size | 0x10000000), buff);
-        return 4;
-    } else if (minBytes <= 5 && size <= 34359738366ul) {
-        BE::getBytes(static_cast<std::uint64_t>((size | 0x800000000) << 0x18), buff);
-        return 5;
-    } else if (minBytes <= 6 && size <= 4398046511102ul) {
-        BE::getBytes(static_cast<std::uint64_t>((size | 0x40000000000) << 0x10), buff);
-        return 6;
-    } else if (minBytes <= 7 && size <= 562949953421310ul) {
-        BE::getBytes(static_cast<std::uint64_t>((size | 0x2000000000000) << 0x08), buff);
-        return 7;
-    } else if (minBytes <= 8 && size <= 72057594037927934ul) {
-        BE::getBytes(static_cast<std::uint64_t>(size | 0x100000000000000), buff);
-        return 8;
+    if (minBytes > 8) {
+        throw InvalidDataException();
     }
-    throw InvalidDataException();
+    const auto sizeLength = max(calculateSizeDenotationLength(size), minBytes);
+    char denotation[8];
+    BE::getBytes(static_cast<std::uint64_t>(size | (sizeDenotationMasks[sizeLength] + 1)), denotation);
+    memcpy(buff, denotation + (8 - sizeLength), sizeLength);
+    return sizeLength;
 }
 
 /*!
@@ -415,23 +419,7 @@ std::uint8_t EbmlElement::makeSizeDenotation(std::uint64_t size, char *buff, std
  */
 std::uint8_t EbmlElement::calculateUIntegerLength(std::uint64_t integer)
 {
-    if (integer <= 0xFFul) {
-        return 1;
-    } else if (integer <= 0xFFFFul) {
-        return 2;
-    } else if (integer <= 0xFFFFFFul) {
-        return 3;
-    } else if (integer <= 0xFFFFFFFFul) {
-        return 4;
-    } else if (integer <= 0xFFFFFFFFFFul) {
-        return 5;
-    } else if (integer <= 0xFFFFFFFFFFFFul) {
-        return 6;
-    } else if (integer <= 0xFFFFFFFFFFFFFFul) {
-        return 7;
-    } else {
-        return 8;
-    }
+    return static_cast<std::uint8_t>((bitWidth(integer | 1) + 7) / 8);
 }
 
 /*!
@@ -440,31 +428,11 @@ std::uint8_t EbmlElement::calculateUIntegerLength(std::uint64_t integer)
  */
 std::uint8_t EbmlElement::makeUInteger(std::uint64_t value, char *buff)
 {
-    if (value <= 0xFFul) {
-        *buff = static_cast<char>(value);
-        return 1;
-    } else if (value <= 0xFFFFul) {
-        BE::getBytes(static_cast<std::uint16_t>(value), buff);
-        return 2;
-    } else if (value <= 0xFFFFFFul) {
-        BE::getBytes(static_cast<std::uint32_t>(value << 0x08), buff);
-        return 3;
-    } else if (value <= 0xFFFFFFFFul) {
-        BE::getBytes(static_cast<std::uint32_t>(value), buff);
-        return 4;
-    } else if (value <= 0xFFFFFFFFFFul) {
-        BE::getBytes(static_cast<std::uint64_t>(value << 0x18), buff);
-        return 5;
-    } else if (value <= 0xFFFFFFFFFFFFul) {
-        BE::getBytes(static_cast<std::uint64_t>(value << 0x10), buff);
-        return 6;
-    } else if (value <= 0xFFFFFFFFFFFFFFul) {
-        BE::getBytes(static_cast<std::uint64_t>(value << 0x08), buff);
-        return 7;
-    } else {
-        BE::getBytes(static_cast<std::uint64_t>(value), buff);
-        return 8;
-    }
+    const auto length = calculateUIntegerLength(value);
+    char bytes[8];
+    BE::getBytes(value, bytes);
+    memcpy(buff, bytes + (8 - length), length);
+    return length;
 }
 
 /*!
@@ -478,31 +446,11 @@ std::uint8_t EbmlElement::makeUInteger(std::uint64_t value, char *buff)
  */
 std::uint8_t EbmlElement::makeUInteger(std::uint64_t value, char *buff, std::uint8_t minBytes)
 {
-    if (minBytes <= 1 && value <= 0xFFul) {
-        *buff = static_cast<char>(value);
-        return 1;
-    } else if (minBytes <= 2 && value <= 0xFFFFul) {
-        BE::getBytes(static_cast<std::uint16_t>(value), buff);
-        return 2;
-    } else if (minBytes <= 3 && value <= 0xFFFFFFul) {
-        BE::getBytes(static_cast<std::uint32_t>(value << 0x08), buff);
-        return 3;
-    } else if (minBytes <= 4 && value <= 0xFFFFFFFFul) {
-        BE::getBytes(static_cast<std::uint32_t>(value), buff);
-        return 4;
-    } else if (minBytes <= 5 && value <= 0xFFFFFFFFFFul) {
-        BE::getBytes(static_cast<std::uint64_t>(value << 0x18), buff);
-        return 5;
-    } else if (minBytes <= 6 && value <= 0xFFFFFFFFFFFFul) {
-        BE::getBytes(static_cast<std::uint64_t>(value << 0x10), buff);
-        return 6;
-    } else if (minBytes <= 7 && value <= 0xFFFFFFFFFFFFFFul) {
-        BE::getBytes(static_cast<std::uint64_t>(value << 0x08), buff);
-        return 7;
-    } else {
-        BE::getBytes(static_cast<std::uint64_t>(value), buff);
-        return 8;
-    }
+    const auto length = max(calculateUIntegerLength(value), min<std::uint8_t>(minBytes, 8));
+    char bytes[8];
+    BE::getBytes(value, bytes);
+    memcpy(buff, bytes + (8 - length), length);
+    return length;
 }
 
 /*!
@@ -43,6 +43,9 @@ public:
     std::uint64_t readUInteger();
     double readFloat();
 
+    static std::uint8_t calculateDenotationLength(std::uint8_t firstByte);
+    static IdentifierType decodeId(const char *buff, std::uint8_t idLength);
+    static std::uint64_t decodeSizeDenotation(const char *buff, std::uint8_t sizeLength);
     static std::uint8_t calculateIdLength(IdentifierType id);
     static std::uint8_t calculateSizeDenotationLength(std::uint64_t size);
     static std::uint8_t makeId(IdentifierType id, char *buff);
@@ -30,7 +30,7 @@ namespace TagParser {
 void MatroskaAttachment::parse(EbmlElement *attachedFileElement, Diagnostics &diag)
 {
     clear();
-    static const string context("parsing \"AttachedFile\"-element");
+    static const auto context = DiagContext("parsing \"AttachedFile\"-element");
     m_attachedFileElement = attachedFileElement;
     EbmlElement *subElement = attachedFileElement->firstChild();
     while (subElement) {
@@ -83,6 +83,7 @@ void MatroskaAttachment::parse(EbmlElement *attachedFileElement, Diagnostics &di
         }
         subElement = subElement->nextSibling();
     }
+    setModified(false);
 }
 
 /*!
@@ -180,7 +181,43 @@ void MatroskaAttachmentMaker::make(ostream &stream, Diagnostics &diag) const
     }
 }
 
+/*!
+ * \brief Buffers the children of the "AttachedFile"-element which are copied from the original file as well as the attachment data.
+ * \remarks This is required when the original file is going to be overwritten before the attachment is made.
+ * \sa See the other overload for buffering only the data which would actually be overwritten.
+ */
 void MatroskaAttachmentMaker::bufferCurrentAttachments(Diagnostics &diag)
+{
+    bufferCurrentChildren(diag);
+    if (attachment().data() && attachment().data()->size() && !attachment().isDataFromFile()) {
+        attachment().data()->makeBuffer();
+    }
+}
+
+/*!
+ * \brief Buffers the children of the "AttachedFile"-element which are copied from the original file and, if necessary, the attachment data.
+ *
+ * This is used when the original file is overwritten in-place and the "AttachedFile"-element is going to be written at the specified
+ * \a targetOffset. The file is written sequentially so the attachment data can be copied directly from the file (in chunks, see
+ * StreamDataBlock::copyTo()) as long as it is not located before the offset it is going to be written to. Only data which is located
+ * before that offset needs to be buffered because it would be overwritten before it is copied.
+ *
+ * This way the memory usage does not scale with the size of the attachments in the common case that attachments stay at the same
+ * position or move towards the beginning of the file.
+ */
+void MatroskaAttachmentMaker::bufferCurrentAttachments(std::uint64_t targetOffset, Diagnostics &diag)
+{
+    bufferCurrentChildren(diag);
+    const auto *const data = attachment().data();
+    if (data && data->size() && !attachment().isDataFromFile() && data->startOffset() < targetOffset + m_totalSize - data->size()) {
+        data->makeBuffer();
+    }
+}
+
+/*!
+ * \brief Buffers the children of the "AttachedFile"-element which are copied from the original file.
+ */
+void MatroskaAttachmentMaker::bufferCurrentChildren(Diagnostics &diag)
 {
     EbmlElement *child;
     if (attachment().attachedFileElement()) {
@@ -191,9 +228,6 @@ void MatroskaAttachmentMaker::bufferCurrentAttachments(Diagnostics &diag)
             }
         }
     }
-    if (attachment().data() && attachment().data()->size() && !attachment().isDataFromFile()) {
-        attachment().data()->makeBuffer();
-    }
 }
 
 } // namespace TagParser
@@ -16,9 +16,11 @@ public:
     const MatroskaAttachment &attachment() const;
     std::uint64_t requiredSize() const;
     void bufferCurrentAttachments(Diagnostics &diag);
+    void bufferCurrentAttachments(std::uint64_t targetOffset, Diagnostics &diag);
 
 private:
     MatroskaAttachmentMaker(MatroskaAttachment &attachment, Diagnostics &diag);
+    void bufferCurrentChildren(Diagnostics &diag);
 
     MatroskaAttachment &m_attachment;
     std::uint64_t m_attachedFileElementSize;
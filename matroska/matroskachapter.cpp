@@ -44,7 +44,7 @@ void MatroskaChapter::internalParse(Diagnostics &diag, AbortableProgressFeedback
     CPP_UTILITIES_UNUSED(progress)
 
     // clear previous values and status
-    static const string context("parsing \"ChapterAtom\"-element");
+    static const auto context = DiagContext("parsing \"ChapterAtom\"-element");
     clear();
     // iterate through children of "ChapterAtom"-element
     for (EbmlElement *chapterAtomChild = m_chapterAtomElement->firstChild(); chapterAtomChild; chapterAtomChild = chapterAtomChild->nextSibling()) {
@@ -6,8 +6,12 @@
 #include "./matroskaseekinfo.h"
 
 #include "../backuphelper.h"
+#include "../concurrentdiagnostics.h"
 #include "../exceptions.h"
 #include "../mediafileinfo.h"
+#include "../memoryusage.h"
+#include "../threadjoiner.h"
+#include "../tracing.h"
 
 #include "resources/config.h"
 
@@ -15,13 +19,20 @@
 #include <c++utilities/conversion/stringconversion.h>
 #include <c++utilities/io/path.h>
 
+#include <atomic>
 #include <chrono>
+#include <exception>
 #include <filesystem>
 #include <functional>
 #include <initializer_list>
 #include <limits>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <numeric>
 #include <random>
+#include <thread>
+#include <unordered_map>
 #include <unordered_set>
 
 using namespace std;
@@ -55,6 +66,18 @@ MatroskaContainer::~MatroskaContainer()
 {
 }
 
+/*!
+ * \brief Adds the memory held by the element trees, the tags, the tracks and the attachments to \a usage.
+ */
+void MatroskaContainer::addMemoryUsage(MemoryUsage &usage) const
+{
+    GenericContainer<MediaFileInfo, MatroskaTag, MatroskaTrack, EbmlElement>::addMemoryUsage(usage);
+    usage.attachments += MemoryUsage::ofVector(m_attachments) + m_attachments.size() * sizeof(MatroskaAttachment);
+    for (const auto &attachment : m_attachments) {
+        attachment->addMemoryUsage(usage);
+    }
+}
+
 void MatroskaContainer::reset()
 {
     GenericContainer<MediaFileInfo, MatroskaTag, MatroskaTrack, EbmlElement>::reset();
@@ -82,7 +105,7 @@ void MatroskaContainer::reset()
  */
 void MatroskaContainer::validateIndex(Diagnostics &diag, AbortableProgressFeedback &progress)
 {
-    static const auto context = std::string("validating Matroska file index (cues)");
+    static const auto context = DiagContext("validating Matroska file index (cues)");
     auto cuesElementsFound = false;
     if (m_firstElement) {
         auto ids = std::unordered_set<EbmlElement::IdentifierType>();
@@ -402,7 +425,7 @@ void MatroskaContainer::internalParseHeader(Diagnostics &diag, AbortableProgress
 {
     CPP_UTILITIES_UNUSED(progress)
 
-    static const string context("parsing header of Matroska container");
+    static const auto context = DiagContext("parsing header of Matroska container");
     // reset old results
     m_firstElement = make_unique<EbmlElement>(*this, startOffset());
     m_additionalElements.clear();
@@ -413,6 +436,8 @@ void MatroskaContainer::internalParseHeader(Diagnostics &diag, AbortableProgress
     m_segmentCount = 0;
     std::uint64_t currentOffset = 0;
     vector<MatroskaSeekInfo>::difference_type seekInfosIndex = 0;
+    std::size_t segmentSeekInfosIndex = 0;
+    bool tailScanned = false;
 
     // loop through all top level elements
     for (EbmlElement *topLevelElement = m_firstElement.get(); topLevelElement; topLevelElement = topLevelElement->nextSibling()) {
@@ -468,6 +493,8 @@ void MatroskaContainer::internalParseHeader(Diagnostics &diag, AbortableProgress
                 break;
             case MatroskaIds::Segment:
                 ++m_segmentCount;
+                segmentSeekInfosIndex = m_seekInfos.size();
+                tailScanned = false;
                 for (EbmlElement *subElement = topLevelElement->firstChild(); subElement; subElement = subElement->nextSibling()) {
                     try {
                         subElement->parse(diag);
@@ -561,6 +588,13 @@ void MatroskaContainer::internalParseHeader(Diagnostics &diag, AbortableProgress
                                     }
                                 }
                             }
+                            // -> search the end of the segment if no "Tags"-element has been found so far and the "SeekHead"-element is missing
+                            //    or apparently incomplete because it denotes neither "Tags"- nor "Cues"-elements (avoids walking through all
+                            //    "Cluster"-elements just to find elements at the end)
+                            if (!tailScanned && m_tagsElements.empty() && !isSeekHeadComplete(segmentSeekInfosIndex)) {
+                                tailScanned = true;
+                                scanSegmentTail(*topLevelElement, *subElement, diag);
+                            }
                             // -> stop if tracks and tags have been found or the file exceeds the max. size to fully process
                             if (((!m_tracksElements.empty() && !m_tagsElements.empty()) || fileInfo().size() > fileInfo().maxFullParseSize())
                                 && !m_segmentInfoElements.empty()) {
@@ -593,6 +627,153 @@ finish:
     }
 }
 
+/*!
+ * \brief Returns whether the "SeekHead"-elements parsed so far, starting from \a seekInfosIndex, seem complete.
+ *
+ * This private method is used to decide whether scanSegmentTail() is required. A "SeekHead"-element is considered complete if it
+ * denotes "Tags"- or "Cues"-elements. A file without tags usually still has a "SeekHead"-element denoting its "Cues"-element so
+ * the end of the segment does not need to be read in this case.
+ */
+bool MatroskaContainer::isSeekHeadComplete(std::size_t seekInfosIndex) const
+{
+    for (auto count = m_seekInfos.size(); seekInfosIndex < count; ++seekInfosIndex) {
+        for (const auto &infoPair : m_seekInfos[seekInfosIndex]->info()) {
+            if (infoPair.first == MatroskaIds::Tags || infoPair.first == MatroskaIds::Cues) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/// \brief Specifies the max. number of bytes at the end of a segment MatroskaContainer::scanSegmentTail() searches.
+constexpr std::uint64_t segmentTailScanSize = 0x400000;
+
+/*!
+ * \brief Returns the ID of the EBML element at \a data or 0 if there's no valid ID.
+ */
+static std::uint32_t readEbmlId(const char *data, const char *end)
+{
+    const auto beg = static_cast<std::uint8_t>(*data);
+    auto mask = std::uint8_t(0x80), idLength = std::uint8_t(1);
+    while (idLength <= EbmlElement::maximumIdLengthSupported() && (beg & mask) == 0) {
+        ++idLength;
+        mask >>= 1;
+    }
+    if (idLength > EbmlElement::maximumIdLengthSupported() || idLength > end - data) {
+        return 0;
+    }
+    auto id = std::uint32_t();
+    for (const auto *const idEnd = data + idLength; data != idEnd; ++data) {
+        id = (id << 8) | static_cast<std::uint8_t>(*data);
+    }
+    return id;
+}
+
+/*!
+ * \brief Searches the end of the specified \a segmentElement for "Tags"-, "Cues"-, "Chapters"- and "Attachments"-elements.
+ *
+ * This private method is called when parsing the header, no "Tags"-element has been found before the first "Cluster"-element and the
+ * "SeekHead"-element is missing or denotes neither "Tags"- nor "Cues"-elements (see isSeekHeadComplete()).
+ * It allows finding elements at the end of the segment by reading only the last bytes of the segment (see segmentTailScanSize) instead
+ * of walking through all "Cluster"-elements.
+ *
+ * Elements are found by searching for their IDs. A match is only considered if its size denotation is valid, the element does not
+ * exceed the segment and its first child has an ID which is expected within the element. Found "Tags"-, "Chapters"- and
+ * "Attachments"-elements are added like elements denoted by a "SeekHead"-element. "Cues"-elements are only located to skip them.
+ *
+ * \throws Throws std::ios_base::failure when an IO error occurs.
+ */
+void MatroskaContainer::scanSegmentTail(EbmlElement &segmentElement, const EbmlElement &firstClusterElement, Diagnostics &diag)
+{
+    static const auto context = DiagContext("scanning end of Matroska segment");
+    const auto segmentEnd = std::min<std::uint64_t>(segmentElement.endOffset(), fileInfo().size());
+    const auto minScanOffset = firstClusterElement.endOffset();
+    if (minScanOffset >= segmentEnd) {
+        return;
+    }
+    const auto scanOffset = segmentEnd - minScanOffset > segmentTailScanSize ? segmentEnd - segmentTailScanSize : minScanOffset;
+    const auto scanSize = static_cast<std::size_t>(segmentEnd - scanOffset);
+    auto buffer = make_unique<char[]>(scanSize);
+    stream().seekg(static_cast<std::streamoff>(scanOffset));
+    stream().read(buffer.get(), static_cast<std::streamsize>(scanSize));
+
+    const char *const bufferEnd = buffer.get() + scanSize;
+    for (const char *i = buffer.get(); bufferEnd - i > 5; ++i) {
+        // check whether the ID matches
+        auto expectedChildId = std::uint32_t();
+        auto *elements = static_cast<std::vector<EbmlElement *> *>(nullptr);
+        const auto id = BE::toInt<std::uint32_t>(i);
+        switch (id) {
+        case MatroskaIds::Tags:
+            expectedChildId = MatroskaIds::Tag;
+            elements = &m_tagsElements;
+            break;
+        case MatroskaIds::Cues:
+            expectedChildId = MatroskaIds::CuePoint;
+            break;
+        case MatroskaIds::Chapters:
+            expectedChildId = MatroskaIds::EditionEntry;
+            elements = &m_chaptersElements;
+            break;
+        case MatroskaIds::Attachments:
+            expectedChildId = MatroskaIds::AttachedFile;
+            elements = &m_attachmentsElements;
+            break;
+        default:
+            continue;
+        }
+
+        // check whether the size denotation is valid and the element does not exceed the segment
+        const auto *const sizeDenotation = i + 4;
+        const auto beg = static_cast<std::uint8_t>(*sizeDenotation);
+        auto mask = std::uint8_t(0x80), sizeLength = std::uint8_t(1);
+        while (sizeLength <= EbmlElement::maximumSizeLengthSupported() && (beg & mask) == 0) {
+            ++sizeLength;
+            mask >>= 1;
+        }
+        if (beg == 0xFF || sizeLength > EbmlElement::maximumSizeLengthSupported() || sizeLength > m_maxSizeLength
+            || sizeLength > bufferEnd - sizeDenotation) {
+            continue;
+        }
+        auto dataSize = static_cast<std::uint64_t>(beg ^ mask);
+        for (auto index = std::uint8_t(1); index < sizeLength; ++index) {
+            dataSize = (dataSize << 8) | static_cast<std::uint8_t>(sizeDenotation[index]);
+        }
+        const auto *const data = sizeDenotation + sizeLength;
+        if (!dataSize || dataSize > static_cast<std::uint64_t>(bufferEnd - data)) {
+            continue;
+        }
+
+        // check whether the first child is plausible
+        if (const auto childId = readEbmlId(data, bufferEnd);
+            childId != expectedChildId && childId != EbmlIds::Void && childId != EbmlIds::Crc32) {
+            continue;
+        }
+
+        // add the element unless it is already known
+        const auto offset = scanOffset + static_cast<std::uint64_t>(i - buffer.get());
+        if (elements && excludesOffset(*elements, offset)) {
+            auto element = make_unique<EbmlElement>(*this, offset);
+            try {
+                element->parse(diag);
+            } catch (const Failure &) {
+                continue;
+            }
+            if (element->id() != id) {
+                continue;
+            }
+            diag.emplaceFormatted(DiagLevel::Information, context, "Found ", element->idToString(), " at ", offset,
+                " which is not denoted by a \"SeekHead\"-element.");
+            m_additionalElements.emplace_back(std::move(element));
+            elements->emplace_back(m_additionalElements.back().get());
+        }
+
+        // skip the element's data; it can not contain further elements of interest
+        i = data + dataSize - 1;
+    }
+}
+
 /*!
  * \brief Parses the (segment) "Info"-element.
  *
@@ -662,11 +843,527 @@ void MatroskaContainer::readTrackStatisticsFromTags(Diagnostics &diag)
     }
 }
 
+/// \brief The private StatisticsCluster struct denotes a "Cluster"-element to be scanned by MatroskaContainer::generateTrackStatistics().
+struct StatisticsCluster {
+    /// \brief start offset of the "Cluster"-element
+    std::uint64_t startOffset;
+    /// \brief end offset of the "Cluster"-element (or the end of the segment if its size is unknown)
+    std::uint64_t endOffset;
+    /// \brief the timestamp scale of the segment containing the "Cluster"-element
+    std::uint64_t timestampScale;
+};
+
+/// \brief The private StatisticsElementHeader struct holds the header of an EBML element read by the StatisticsScanner.
+struct StatisticsElementHeader {
+    std::uint32_t id = 0;
+    std::uint64_t dataOffset = 0;
+    std::uint64_t dataSize = 0;
+};
+
+/*!
+ * \brief The private StatisticsScanner class scans "Cluster"-elements for MatroskaContainer::generateTrackStatistics().
+ * \remarks Each thread uses its own instance (and stream) so scanning different "Cluster"-elements in parallel is possible.
+ */
+class StatisticsScanner {
+public:
+    StatisticsScanner(std::istream &stream, const std::unordered_map<std::uint64_t, std::uint64_t> &defaultDurations);
+    void scanCluster(const StatisticsCluster &cluster, Diagnostics &diag);
+
+    /// \brief statistics by track number
+    std::unordered_map<std::uint64_t, MatroskaTrackStatistics> statistics;
+
+private:
+    bool readElementHeader(std::uint64_t offset, std::uint64_t endOffset, StatisticsElementHeader &header);
+    std::uint64_t readUInteger(const StatisticsElementHeader &header);
+    void scanClusterChildren(const StatisticsCluster &cluster, Diagnostics &diag);
+    void scanBlock(const StatisticsElementHeader &header, std::uint64_t clusterTimestamp, std::uint64_t timestampScale,
+        const std::uint64_t *blockDuration, Diagnostics &diag);
+
+    std::istream &m_stream;
+    const std::unordered_map<std::uint64_t, std::uint64_t> &m_defaultDurations;
+    std::vector<char> m_buffer;
+    std::vector<char> m_blockBuffer;
+    std::unordered_map<std::uint64_t, std::uint64_t> m_clusterScannedBytes;
+};
+
+/*!
+ * \brief Constructs a new scanner reading from the specified \a stream.
+ * \param defaultDurations Specifies the default durations of the tracks in nanoseconds by track number.
+ */
+StatisticsScanner::StatisticsScanner(std::istream &stream, const std::unordered_map<std::uint64_t, std::uint64_t> &defaultDurations)
+    : m_stream(stream)
+    , m_defaultDurations(defaultDurations)
+    , m_buffer(0x1000)
+{
+}
+
+/*!
+ * \brief Reads the header of the EBML element at the specified \a offset.
+ * \returns Returns whether a valid header could be read; elements with unknown size are assumed to end at \a endOffset.
+ */
+bool StatisticsScanner::readElementHeader(std::uint64_t offset, std::uint64_t endOffset, StatisticsElementHeader &header)
+{
+    char buff[12] = { 0 };
+    const auto bytesAvailable = std::min<std::uint64_t>(endOffset - offset, sizeof(buff));
+    if (bytesAvailable < 2) {
+        return false;
+    }
+    m_stream.seekg(static_cast<std::streamoff>(offset));
+    m_stream.read(buff, static_cast<std::streamsize>(bytesAvailable));
+    const auto idLength = EbmlElement::calculateDenotationLength(static_cast<std::uint8_t>(*buff));
+    if (idLength > EbmlElement::maximumIdLengthSupported()) {
+        return false;
+    }
+    const auto sizeLength = EbmlElement::calculateDenotationLength(static_cast<std::uint8_t>(buff[idLength]));
+    if (sizeLength > EbmlElement::maximumSizeLengthSupported() || idLength + sizeLength > bytesAvailable) {
+        return false;
+    }
+    header.id = EbmlElement::decodeId(buff, idLength);
+    header.dataOffset = offset + idLength + sizeLength;
+    header.dataSize = EbmlElement::decodeSizeDenotation(buff + idLength, sizeLength);
+    if (header.dataSize == (std::uint64_t(1) << (7 * sizeLength)) - 1 || header.dataSize > endOffset - header.dataOffset) {
+        // size is unknown (all data bits set) or exceeds the parent
+        header.dataSize = endOffset - header.dataOffset;
+    }
+    return true;
+}
+
+/*!
+ * \brief Reads the data of the element with the specified \a header as unsigned integer.
+ */
+std::uint64_t StatisticsScanner::readUInteger(const StatisticsElementHeader &header)
+{
+    char buff[8] = { 0 };
+    const auto bytesToRead = std::min<std::uint64_t>(header.dataSize, sizeof(buff));
+    m_stream.seekg(static_cast<std::streamoff>(header.dataOffset));
+    m_stream.read(buff + (sizeof(buff) - bytesToRead), static_cast<std::streamsize>(bytesToRead));
+    return BE::toInt<std::uint64_t>(buff);
+}
+
+/*!
+ * \brief Scans the children of the specified \a cluster for blocks and updates the statistics accordingly.
+ * \remarks
+ * - Further "Cluster"-elements are scanned as well if the size of \a cluster is unknown.
+ * - The time is only taken once per cluster and distributed across the tracks by the number of bytes scanned for them.
+ */
+void StatisticsScanner::scanCluster(const StatisticsCluster &cluster, Diagnostics &diag)
+{
+    const auto startTime = std::chrono::steady_clock::now();
+    m_clusterScannedBytes.clear();
+    scanClusterChildren(cluster, diag);
+    if (m_clusterScannedBytes.empty()) {
+        return;
+    }
+    const auto scanTime = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count();
+    auto totalScannedBytes = std::uint64_t();
+    for (const auto &[trackNumber, scannedBytes] : m_clusterScannedBytes) {
+        totalScannedBytes += scannedBytes;
+    }
+    for (const auto &[trackNumber, scannedBytes] : m_clusterScannedBytes) {
+        // note: the number of scanned bytes is never zero as at least the block header has been read
+        const auto trackScanTime = static_cast<double>(scanTime) * static_cast<double>(scannedBytes) / static_cast<double>(totalScannedBytes);
+        statistics[trackNumber].scanTime += TimeSpan(static_cast<std::int64_t>(trackScanTime / 100.0));
+    }
+}
+
+/*!
+ * \brief Scans the children of the specified \a cluster; called by scanCluster().
+ */
+void StatisticsScanner::scanClusterChildren(const StatisticsCluster &cluster, Diagnostics &diag)
+{
+    static const auto context = DiagContext("scanning cluster for track statistics");
+    auto clusterHeader = StatisticsElementHeader();
+    if (!readElementHeader(cluster.startOffset, cluster.endOffset, clusterHeader)) {
+        diag.emplace_back(DiagLevel::Warning, argsToString("Unable to parse \"Cluster\"-element at ", cluster.startOffset, '.'), context);
+        return;
+    }
+    auto clusterTimestamp = std::uint64_t();
+    auto header = StatisticsElementHeader();
+    for (auto offset = clusterHeader.dataOffset; offset < cluster.endOffset; offset = header.dataOffset + header.dataSize) {
+        if (!readElementHeader(offset, cluster.endOffset, header)) {
+            diag.emplace_back(DiagLevel::Warning,
+                argsToString("Unable to parse element at ", offset, " within \"Cluster\"-element at ", cluster.startOffset,
+                    "; the remaining blocks of the cluster are not considered."),
+                context);
+            return;
+        }
+        switch (header.id) {
+        case MatroskaIds::Cluster:
+            // another "Cluster"-element follows the one with unknown size; just continue with its children
+            clusterTimestamp = 0;
+            header.dataSize = 0;
+            break;
+        case MatroskaIds::Timecode:
+            clusterTimestamp = readUInteger(header);
+            break;
+        case MatroskaIds::SimpleBlock:
+            scanBlock(header, clusterTimestamp, cluster.timestampScale, nullptr, diag);
+            break;
+        case MatroskaIds::BlockGroup: {
+            auto blockHeader = StatisticsElementHeader(), childHeader = StatisticsElementHeader();
+            auto blockDuration = std::uint64_t();
+            auto hasBlockDuration = false;
+            const auto blockGroupEndOffset = header.dataOffset + header.dataSize;
+            for (auto childOffset = header.dataOffset; childOffset < blockGroupEndOffset;
+                childOffset = childHeader.dataOffset + childHeader.dataSize) {
+                if (!readElementHeader(childOffset, blockGroupEndOffset, childHeader)) {
+                    diag.emplace_back(DiagLevel::Warning, argsToString("Unable to parse element at ", childOffset, " within \"BlockGroup\"-element."),
+                        context);
+                    break;
+                }
+                switch (childHeader.id) {
+                case MatroskaIds::Block:
+                    blockHeader = childHeader;
+                    break;
+                case MatroskaIds::BlockDuration:
+                    blockDuration = readUInteger(childHeader);
+                    hasBlockDuration = true;
+                    break;
+                default:;
+                }
+            }
+            if (blockHeader.id == MatroskaIds::Block) {
+                scanBlock(blockHeader, clusterTimestamp, cluster.timestampScale, hasBlockDuration ? &blockDuration : nullptr, diag);
+            }
+            break;
+        }
+        default:;
+        }
+    }
+}
+
+/*!
+ * \brief Stores \a factor1 * \a factor2 in \a product unless the result does not fit into an std::int64_t.
+ * \returns Returns whether the product could be stored; \a product is not modified otherwise.
+ */
+static bool checkedMultiply(std::int64_t factor1, std::uint64_t factor2, std::int64_t &product)
+{
+    constexpr auto max = static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max());
+    const auto magnitude = factor1 < 0 ? static_cast<std::uint64_t>(-(factor1 + 1)) + 1 : static_cast<std::uint64_t>(factor1);
+    if (factor2 && magnitude > max / factor2) {
+        return false;
+    }
+    const auto productMagnitude = static_cast<std::int64_t>(magnitude * factor2);
+    product = factor1 < 0 ? -productMagnitude : productMagnitude;
+    return true;
+}
+
+/*!
+ * \brief Reads the header of the block with the specified \a header and updates the statistics of the track it belongs to.
+ * \remarks Laced frames are counted individually and the lacing headers are not considered part of the frame data.
+ */
+void StatisticsScanner::scanBlock(const StatisticsElementHeader &header, std::uint64_t clusterTimestamp, std::uint64_t timestampScale,
+    const std::uint64_t *blockDuration, Diagnostics &diag)
+{
+    static const auto context = DiagContext("scanning block for track statistics");
+    static constexpr auto maxBlockSizeToRead = std::uint64_t(0x1000000);
+
+    // read the block header which is usually small, except the lacing header (of Xiph lacing) might be longer than expected
+    // -> read the whole block into a separate buffer in that case (so the small buffer is still used for subsequent blocks)
+    const auto *buffer = m_buffer.data();
+    auto bytesRead = std::min<std::uint64_t>(header.dataSize, m_buffer.size() - 8);
+    auto scannedBytes = bytesRead;
+    m_stream.seekg(static_cast<std::streamoff>(header.dataOffset));
+    m_stream.read(m_buffer.data(), static_cast<std::streamsize>(bytesRead));
+    const auto invalidBlock = [&] {
+        diag.emplace_back(DiagLevel::Warning, argsToString("Block at ", header.dataOffset, " is invalid and therefore not considered."), context);
+    };
+    for (;;) {
+        const auto trackNumberLength = EbmlElement::calculateDenotationLength(static_cast<std::uint8_t>(*buffer));
+        if (trackNumberLength > EbmlElement::maximumSizeLengthSupported() || trackNumberLength + 3u > bytesRead) {
+            invalidBlock();
+            return;
+        }
+        const auto trackNumber = EbmlElement::decodeSizeDenotation(buffer, trackNumberLength);
+        const auto relativeTimestamp = BE::toInt<std::int16_t>(buffer + trackNumberLength);
+        const auto lacing = (static_cast<std::uint8_t>(buffer[trackNumberLength + 2]) >> 1) & 0x3;
+        auto headerSize = static_cast<std::uint64_t>(trackNumberLength + 3u);
+        auto frameCount = std::uint64_t(1);
+        auto needsMoreData = false;
+        if (lacing && headerSize < bytesRead) {
+            frameCount = static_cast<std::uint8_t>(buffer[headerSize++]) + 1u;
+            switch (lacing) {
+            case 0x1: // Xiph lacing
+                for (auto frame = std::uint64_t(1); frame < frameCount && !needsMoreData; ++frame) {
+                    do {
+                        if ((needsMoreData = headerSize >= bytesRead)) {
+                            break;
+                        }
+                    } while (static_cast<std::uint8_t>(buffer[headerSize++]) == 0xFF);
+                }
+                break;
+            case 0x3: // EBML lacing
+                for (auto frame = std::uint64_t(1); frame < frameCount && !(needsMoreData = headerSize >= bytesRead); ++frame) {
+                    headerSize += EbmlElement::calculateDenotationLength(static_cast<std::uint8_t>(buffer[headerSize]));
+                }
+                needsMoreData = needsMoreData || headerSize > bytesRead;
+                break;
+            default:; // fixed-size lacing has no further header
+            }
+        } else if (lacing) {
+            needsMoreData = true;
+        }
+        if (needsMoreData) {
+            if (bytesRead == header.dataSize || header.dataSize > maxBlockSizeToRead) {
+                invalidBlock();
+                return;
+            }
+            m_blockBuffer.resize(header.dataSize + 8);
+            buffer = m_blockBuffer.data();
+            bytesRead = header.dataSize;
+            scannedBytes += bytesRead;
+            m_stream.seekg(static_cast<std::streamoff>(header.dataOffset));
+            m_stream.read(m_blockBuffer.data(), static_cast<std::streamsize>(bytesRead));
+            continue;
+        }
+        if (headerSize > header.dataSize) {
+            invalidBlock();
+            return;
+        }
+
+        // compute timestamp and duration in nanoseconds; skip the block if crafted values would overflow
+        constexpr auto maxInt64 = static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max());
+        auto timestamp = std::int64_t(), duration = std::int64_t();
+        auto inRange = clusterTimestamp <= maxInt64 - 0x8000
+            && checkedMultiply(static_cast<std::int64_t>(clusterTimestamp) + relativeTimestamp, timestampScale, timestamp);
+        if (blockDuration) {
+            inRange = inRange && *blockDuration <= maxInt64 && checkedMultiply(static_cast<std::int64_t>(*blockDuration), timestampScale, duration);
+        } else if (const auto defaultDuration = m_defaultDurations.find(trackNumber); defaultDuration != m_defaultDurations.end()) {
+            inRange = inRange && defaultDuration->second <= maxInt64
+                && checkedMultiply(static_cast<std::int64_t>(defaultDuration->second), frameCount, duration);
+        }
+        if (!inRange || duration > std::numeric_limits<std::int64_t>::max() - std::max<std::int64_t>(timestamp, 0)) {
+            diag.emplace_back(DiagLevel::Warning,
+                argsToString("Timestamp or duration of block at ", header.dataOffset, " is out of range and therefore not considered."), context);
+            return;
+        }
+
+        // update statistics of the track
+        auto &trackStatistics = statistics[trackNumber];
+        trackStatistics.trackNumber = trackNumber;
+        trackStatistics.numberOfBytes += header.dataSize - headerSize;
+        trackStatistics.numberOfFrames += frameCount;
+        trackStatistics.startTimestamp = std::min(trackStatistics.startTimestamp, timestamp);
+        trackStatistics.endTimestamp = std::max(trackStatistics.endTimestamp, timestamp + duration);
+        trackStatistics.scannedBytes += scannedBytes;
+        m_clusterScannedBytes[trackNumber] += scannedBytes;
+        return;
+    }
+}
+
+/*!
+ * \brief Formats the specified \a nanoseconds like the "DURATION"-field is usually formatted (HH:MM:SS.nnnnnnnnn).
+ */
+static std::string formatStatisticsDuration(std::int64_t nanoseconds)
+{
+    const auto padded = [](std::int64_t value, std::size_t width) {
+        auto res = numberToString(value);
+        return res.size() < width ? std::string(width - res.size(), '0') + res : res;
+    };
+    nanoseconds = std::max<std::int64_t>(nanoseconds, 0);
+    const auto seconds = nanoseconds / 1000000000;
+    return argsToString(padded(seconds / 3600, 2), ':', padded(seconds / 60 % 60, 2), ':', padded(seconds % 60, 2), '.',
+        padded(nanoseconds % 1000000000, 9));
+}
+
+/*!
+ * \brief Generates track-specific statistics by scanning the blocks of all "Cluster"-elements.
+ * \param diag Specifies the diagnostics object to store warnings/errors to.
+ * \param progress Specifies the progress feedback object; scanning can be aborted via AbortableProgressFeedback::tryToAbort().
+ * \param threadCount Specifies the number of threads to use (the number of hardware threads if zero).
+ * \returns Returns the statistics of all tracks having at least one block ordered by track number. Besides the statistics
+ *          itself, the number of scanned bytes and the time taken for scanning the blocks of a track is provided.
+ *
+ * Track numbers, frame sizes and timestamps are read from the headers of the "SimpleBlock"- and "BlockGroup"-elements. Laced
+ * frames are counted individually. The frame data itself is not read.
+ *
+ * The "Cluster"-elements are distributed across \a threadCount threads. Additional threads use their own file stream so the
+ * file must be accessible under its path. The computed statistics are assigned to the tracks (see MatroskaTrack::readStatistics())
+ * and stored as track-specific tags (the same fields as written by mkvmerge, see MatroskaTrack::readStatisticsFromTags()) so
+ * they will be written when applying changes.
+ *
+ * \remarks The header must have been parsed before; tracks and tags are parsed if not done yet.
+ * \throws Throws std::ios_base::failure when an IO error occurs.
+ * \throws Throws TagParser::Failure or a derived exception when a parsing error occurs.
+ */
+std::vector<MatroskaTrackStatistics> MatroskaContainer::generateTrackStatistics(
+    Diagnostics &diag, AbortableProgressFeedback &progress, std::size_t threadCount)
+{
+    static const auto context = DiagContext("generating track statistics");
+    TAG_PARSER_TRACE_SPAN("MatroskaContainer::generateTrackStatistics");
+    parseTracks(diag, progress);
+    parseTags(diag, progress);
+
+    // determine the "Cluster"-elements to scan
+    progress.nextStepOrStop("Collecting clusters for generating track statistics ...");
+    auto clusters = std::vector<StatisticsCluster>();
+    for (EbmlElement *segmentElement = m_firstElement ? m_firstElement->siblingByIdIncludingThis(MatroskaIds::Segment, diag) : nullptr;
+        segmentElement; segmentElement = segmentElement->siblingById(MatroskaIds::Segment, diag)) {
+        const auto segmentClustersBegin = clusters.size();
+        auto timestampScale = std::uint64_t(1000000);
+        for (EbmlElement *level1Element = segmentElement->firstChild(); level1Element; level1Element = level1Element->nextSibling()) {
+            progress.stopIfAborted();
+            level1Element->parse(diag);
+            switch (level1Element->id()) {
+            case MatroskaIds::SegmentInfo:
+                if (EbmlElement *const timestampScaleElement = level1Element->childById(MatroskaIds::TimeCodeScale, diag)) {
+                    timestampScale = timestampScaleElement->readUInteger();
+                }
+                break;
+            case MatroskaIds::Cluster:
+                clusters.emplace_back(StatisticsCluster{ level1Element->startOffset(), level1Element->endOffset(), 0 });
+                break;
+            default:;
+            }
+        }
+        for (auto i = segmentClustersBegin; i != clusters.size(); ++i) {
+            clusters[i].timestampScale = timestampScale;
+        }
+    }
+
+    // determine default durations of tracks
+    auto defaultDurations = std::unordered_map<std::uint64_t, std::uint64_t>();
+    for (const auto &track : tracks()) {
+        if (!track->m_trackElement) {
+            continue;
+        }
+        if (EbmlElement *const defaultDurationElement = track->m_trackElement->childById(MatroskaIds::DefaultDuration, diag)) {
+            defaultDurations[track->trackNumber()] = defaultDurationElement->readUInteger();
+        }
+    }
+
+    // scan "Cluster"-elements in parallel
+    progress.nextStepOrStop("Scanning blocks for generating track statistics ...", 0);
+    if (!threadCount) {
+        threadCount = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    }
+    threadCount = std::max<std::size_t>(std::min(threadCount, clusters.size()), 1);
+    auto nextClusterIndex = std::atomic<std::size_t>(0);
+    auto scannedClusters = ProgressCounter(progress, clusters.size());
+    auto scanners = std::vector<std::unique_ptr<StatisticsScanner>>();
+    auto clusterDiags = ConcurrentDiagnostics(diag.minLevel());
+    auto workerExceptionMutex = std::mutex();
+    auto workerException = std::exception_ptr();
+    // note: Errors when scanning a cluster are reported as critical messages. Other exceptions (e.g. std::bad_alloc when
+    //       submitting the messages) stop all threads and are rethrown on the calling thread after all threads have been joined.
+    const auto scanClusters = [&](StatisticsScanner &scanner, bool reportProgress) {
+        TAG_PARSER_TRACE_SPAN("MatroskaContainer::scanClusters");
+        try {
+            for (auto index = nextClusterIndex++; index < clusters.size() && !progress.isAborted(); index = nextClusterIndex++) {
+                clusterDiags.collect(index, [&](Diagnostics &clusterDiag) {
+                    try {
+                        scanner.scanCluster(clusters[index], clusterDiag);
+                    } catch (const std::ios_base::failure &failure) {
+                        clusterDiag.emplace_back(DiagLevel::Critical,
+                            argsToString(
+                                "An IO error occurred when scanning \"Cluster\"-element at ", clusters[index].startOffset, ": ", failure.what()),
+                            context);
+                    } catch (const std::exception &exception) {
+                        clusterDiag.emplace_back(DiagLevel::Critical,
+                            argsToString("An unexpected error occurred when scanning \"Cluster\"-element at ", clusters[index].startOffset, ": ",
+                                exception.what()),
+                            context);
+                    } catch (...) {
+                        clusterDiag.emplace_back(DiagLevel::Critical,
+                            argsToString("An unknown error occurred when scanning \"Cluster\"-element at ", clusters[index].startOffset, '.'),
+                            context);
+                    }
+                });
+                scannedClusters.add();
+                if (reportProgress) {
+                    scannedClusters.report();
+                }
+            }
+        } catch (...) {
+            nextClusterIndex = clusters.size();
+            const auto lock = std::lock_guard<std::mutex>(workerExceptionMutex);
+            if (!workerException) {
+                workerException = std::current_exception();
+            }
+        }
+    };
+    auto streams = std::vector<std::unique_ptr<NativeFileStream>>();
+    auto workers = ThreadJoiner();
+    scanners.emplace_back(std::make_unique<StatisticsScanner>(fileInfo().stream(), defaultDurations));
+    for (auto i = std::size_t(1); i < threadCount; ++i) {
+        auto &stream = streams.emplace_back(std::make_unique<NativeFileStream>());
+        try {
+            stream->exceptions(ios_base::failbit | ios_base::badbit);
+            stream->open(BasicFileInfo::pathForOpen(fileInfo().path()).data(), ios_base::in | ios_base::binary);
+        } catch (const std::ios_base::failure &failure) {
+            diag.emplace_back(DiagLevel::Warning, argsToString("Unable to open file for additional thread: ", failure.what()), context);
+            streams.pop_back();
+            break;
+        }
+        auto &scanner = scanners.emplace_back(std::make_unique<StatisticsScanner>(*stream, defaultDurations));
+        if (!workers.tryToStart(scanClusters, std::ref(*scanner), false)) {
+            diag.emplace_back(DiagLevel::Warning, argsToString("Unable to start additional thread; scanning with ", i, " thread(s)."), context);
+            scanners.pop_back();
+            streams.pop_back();
+            break;
+        }
+    }
+    scanClusters(*scanners.front(), true);
+    workers.joinAll();
+    if (workerException) {
+        std::rethrow_exception(workerException);
+    }
+    scannedClusters.reportNow();
+    clusterDiags.mergeInto(diag);
+    progress.stopIfAborted();
+
+    // merge statistics of all threads
+    auto statisticsByTrack = std::map<std::uint64_t, MatroskaTrackStatistics>();
+    for (const auto &scanner : scanners) {
+        for (const auto &[trackNumber, trackStatistics] : scanner->statistics) {
+            auto &mergedStatistics = statisticsByTrack[trackNumber];
+            mergedStatistics.trackNumber = trackNumber;
+            mergedStatistics.add(trackStatistics);
+        }
+    }
+
+    // assign statistics to tracks and store them as tags
+    namespace StatisticsIds = MatroskaTagIds::TrackSpecific;
+    const auto writingAppName = fileInfo().writingApplication().empty() ? std::string_view(APP_NAME " v" APP_VERSION)
+                                                                          : std::string_view(fileInfo().writingApplication());
+    const auto writingDate = DateTime::gmtNow().toString(DateTimeOutputFormat::DateAndTime, true);
+    const auto statisticsFields = argsToString(
+        StatisticsIds::bitrate(), ' ', StatisticsIds::duration(), ' ', StatisticsIds::numberOfFrames(), ' ', StatisticsIds::numberOfBytes());
+    auto result = std::vector<MatroskaTrackStatistics>();
+    result.reserve(statisticsByTrack.size());
+    for (const auto &[trackNumber, trackStatistics] : statisticsByTrack) {
+        result.emplace_back(trackStatistics);
+        const auto track = find_if(
+            tracks().cbegin(), tracks().cend(), [trackNumber = trackNumber](const auto &track) { return track->trackNumber() == trackNumber; });
+        if (track == tracks().cend()) {
+            diag.emplace_back(DiagLevel::Warning, argsToString("Blocks refer to track ", trackNumber, " which does not exist."), context);
+            continue;
+        }
+        (*track)->readStatistics(trackStatistics);
+        auto *const tag = createTag(TagTarget(50, { (*track)->id() }));
+        tag->setValue(std::string(StatisticsIds::bitrate()), TagValue(numberToString(trackStatistics.bitrate())));
+        tag->setValue(std::string(StatisticsIds::duration()),
+            TagValue(formatStatisticsDuration(trackStatistics.endTimestamp - trackStatistics.startTimestamp)));
+        tag->setValue(std::string(StatisticsIds::numberOfFrames()), TagValue(numberToString(trackStatistics.numberOfFrames)));
+        tag->setValue(std::string(StatisticsIds::numberOfBytes()), TagValue(numberToString(trackStatistics.numberOfBytes)));
+        tag->setValue(std::string(StatisticsIds::writingApp()), TagValue(writingAppName, TagTextEncoding::Utf8));
+        tag->setValue(std::string(StatisticsIds::writingDate()), TagValue(writingDate));
+        tag->setValue(std::string(StatisticsIds::statisticsTags()), TagValue(statisticsFields));
+        if (diag.isEnabled(DiagLevel::Information)) {
+            diag.emplace_back(DiagLevel::Information,
+                argsToString("Generated statistics of track ", trackNumber, " by scanning ", trackStatistics.scannedBytes, " bytes in ",
+                    trackStatistics.scanTime.toString(TimeSpanOutputFormat::WithMeasures), '.'),
+                context);
+        }
+    }
+    return result;
+}
+
 void MatroskaContainer::internalParseTags(Diagnostics &diag, AbortableProgressFeedback &progress)
 {
     CPP_UTILITIES_UNUSED(progress)
 
-    static const string context("parsing tags of Matroska container");
+    static const auto context = DiagContext("parsing tags of Matroska container");
     auto flags = MatroskaTagFlags::None;
     if (fileInfo().fileHandlingFlags() & MediaFileHandlingFlags::NormalizeKnownTagFieldIds) {
         flags += MatroskaTagFlags::NormalizeKnownFieldIds;
@@ -680,7 +1377,7 @@ void MatroskaContainer::internalParseTags(Diagnostics &diag, AbortableProgressFe
                 case MatroskaIds::Tag:
                     m_tags.emplace_back(make_unique<MatroskaTag>());
                     try {
-                        m_tags.back()->parse2(*subElement, flags, diag);
+                        m_tags.back()->parse2(*subElement, flags, diag, &fileInfo().tagFieldFilter());
                     } catch (const NoDataFoundException &) {
                         m_tags.pop_back();
                     } catch (const Failure &) {
@@ -705,7 +1402,7 @@ void MatroskaContainer::internalParseTags(Diagnostics &diag, AbortableProgressFe
 
 void MatroskaContainer::internalParseTracks(Diagnostics &diag, AbortableProgressFeedback &progress)
 {
-    static const string context("parsing tracks of Matroska container");
+    static const auto context = DiagContext("parsing tracks of Matroska container");
     for (EbmlElement *element : m_tracksElements) {
         try {
             element->parse(diag);
@@ -741,7 +1438,7 @@ void MatroskaContainer::internalParseTracks(Diagnostics &diag, AbortableProgress
 
 void MatroskaContainer::internalParseChapters(Diagnostics &diag, AbortableProgressFeedback &progress)
 {
-    static const string context("parsing editions/chapters of Matroska container");
+    static const auto context = DiagContext("parsing editions/chapters of Matroska container");
     for (EbmlElement *element : m_chaptersElements) {
         try {
             element->parse(diag);
@@ -777,7 +1474,7 @@ void MatroskaContainer::internalParseAttachments(Diagnostics &diag, AbortablePro
 {
     CPP_UTILITIES_UNUSED(progress)
 
-    static const string context("parsing attachments of Matroska container");
+    static const auto context = DiagContext("parsing attachments of Matroska container");
     for (EbmlElement *element : m_attachmentsElements) {
         try {
             element->parse(diag);
@@ -809,6 +1506,41 @@ void MatroskaContainer::internalParseAttachments(Diagnostics &diag, AbortablePro
     }
 }
 
+/// \brief The private ClusterChildType enum specifies how a child of a "Cluster"-element is treated when making the file.
+enum class ClusterChildType : std::uint8_t {
+    Copied, /**< the child is copied as-is (only cached if a "CueRelativePosition"-element refers to it) */
+    Omitted, /**< the child is a "Void"- or "CRC-32"-element which is omitted */
+    Position, /**< the child is a "Position"-element which is updated */
+};
+
+/// \brief The private ClusterChildLayout struct is used in MatroskaContainer::internalMakeFile() to cache relevant children of a "Cluster"-element.
+struct ClusterChildLayout {
+    /// \brief offset of the child relative to the data offset of the "Cluster"-element (original file)
+    std::uint64_t relativeOffset;
+    /// \brief total size of the child (original file)
+    std::uint64_t totalSize;
+    /// \brief how the child is treated when making the file
+    ClusterChildType type;
+};
+
+/// \brief The private ClusterLayout struct is used in MatroskaContainer::internalMakeFile() to cache the layout of a "Cluster"-element.
+struct ClusterLayout {
+    /// \brief the "Cluster"-element (original file)
+    EbmlElement *element;
+    /// \brief start offset (original file)
+    std::uint64_t startOffset;
+    /// \brief data offset (original file)
+    std::uint64_t dataOffset;
+    /// \brief end offset (original file)
+    std::uint64_t endOffset;
+    /// \brief accumulated total size of all children (original file)
+    std::uint64_t childrenSize;
+    /// \brief index of the first relevant child within SegmentData::clusterChildren
+    std::size_t firstChild;
+    /// \brief number of relevant children within SegmentData::clusterChildren
+    std::size_t childCount;
+};
+
 /// \brief The private SegmentData struct is used in MatroskaContainer::internalMakeFile() to store segment specific data.
 struct SegmentData {
     /// \brief Constructs a new segment data object.
@@ -824,10 +1556,15 @@ struct SegmentData {
         , totalSize(0)
         , newDataOffset(0)
         , sizeDenotationLength(0)
+        , attachmentsOffset(0)
+        , clusterChildrenCached(false)
     {
     }
     SegmentData(SegmentData &&) = default;
 
+    void cacheClusters(Diagnostics &diag, AbortableProgressFeedback &progress);
+    void cacheClusterChildren(const EbmlElement &segmentElement, std::uint64_t readOffset, Diagnostics &diag, AbortableProgressFeedback &progress);
+
     /// \brief whether CRC-32 checksum is present
     bool hasCrc32;
     /// \brief used to make "SeekHead"-element
@@ -856,11 +1593,123 @@ struct SegmentData {
     std::uint64_t newDataOffset;
     /// \brief header size (in the new file)
     std::uint8_t sizeDenotationLength;
+    /// \brief offset of the "Attachments"-element relative to the segment data (in the new file)
+    std::uint64_t attachmentsOffset;
+    /// \brief whether clusterChildren has been populated
+    bool clusterChildrenCached;
+    /// \brief layout of the "Cluster"-elements (original file), populated by cacheClusters()
+    std::vector<ClusterLayout> clusters;
+    /// \brief children of "Cluster"-elements which need to be considered when computing cluster sizes, populated by cacheClusterChildren()
+    std::vector<ClusterChildLayout> clusterChildren;
 };
 
+/// \brief The private TagsAppendingLayout struct is used in MatroskaContainer::internalMakeFile() to store where tags are appended.
+struct MatroskaContainer::TagsAppendingLayout {
+    /// \brief Constructs a new tags appending layout.
+    TagsAppendingLayout()
+        : segmentElement(nullptr)
+        , seekHeadElement(nullptr)
+        , seekHeadSpace(0)
+        , appendOffset(0)
+        , newPadding(0)
+    {
+    }
+
+    /// \brief the "Segment"-element (original file)
+    EbmlElement *segmentElement;
+    /// \brief the "SeekHead"-element (original file)
+    EbmlElement *seekHeadElement;
+    /// \brief space available for the "SeekHead"-element (its total size and the total size of subsequent "Void"- and "Tags"-elements)
+    std::uint64_t seekHeadSpace;
+    /// \brief used to make the new "SeekHead"-element
+    MatroskaSeekInfo seekInfo;
+    /// \brief offset to write the new "Tags"-element at
+    std::uint64_t appendOffset;
+    /// \brief "Tags"-elements which need to be turned into "Void"-elements (original file)
+    std::vector<EbmlElement *> voidedTagsElements;
+    /// \brief padding before the first "Cluster"-element after appending the tags
+    std::uint64_t newPadding;
+};
+
+/*!
+ * \brief Caches the layout of all "Cluster"-elements of the segment.
+ * \remarks Does nothing if the layout has already been cached. So the element tree is only walked once, no matter how
+ *          often MatroskaContainer::internalMakeFile() needs to recompute the segment layout.
+ */
+void SegmentData::cacheClusters(Diagnostics &diag, AbortableProgressFeedback &progress)
+{
+    if (!clusters.empty()) {
+        return;
+    }
+    for (auto *clusterElement = firstClusterElement; clusterElement; clusterElement = clusterElement->siblingById(MatroskaIds::Cluster, diag)) {
+        progress.stopIfAborted();
+        clusters.emplace_back(ClusterLayout{ clusterElement, clusterElement->startOffset(), clusterElement->dataOffset(), clusterElement->endOffset(),
+            0, 0, 0 });
+    }
+}
+
+/*!
+ * \brief Caches the children of all "Cluster"-elements of the segment which need to be considered when computing the new cluster sizes.
+ * \remarks
+ * - Only children which are not copied as-is or which are referenced by a "CueRelativePosition"-element are stored. The size
+ *   of all other children is only taken into account via ClusterLayout::childrenSize.
+ * - The "Cues"-element must have been parsed via cuesUpdater before.
+ * - The specified \a readOffset is the offset of \a segmentElement the "CueClusterPosition"-elements are relative to.
+ * - Does nothing if the children have already been cached.
+ */
+void SegmentData::cacheClusterChildren(
+    const EbmlElement &segmentElement, std::uint64_t readOffset, Diagnostics &diag, AbortableProgressFeedback &progress)
+{
+    if (clusterChildrenCached) {
+        return;
+    }
+    cacheClusters(diag, progress);
+    for (auto &cluster : clusters) {
+        progress.stopIfAborted();
+        cluster.firstChild = clusterChildren.size();
+        const auto clusterReadOffset = cluster.startOffset - segmentElement.dataOffset() + readOffset;
+        for (auto *childElement = cluster.element->firstChild(); childElement; childElement = childElement->nextSibling()) {
+            childElement->parse(diag);
+            auto type = ClusterChildType::Copied;
+            switch (childElement->id()) {
+            case EbmlIds::Void:
+            case EbmlIds::Crc32:
+                type = ClusterChildType::Omitted;
+                break;
+            case MatroskaIds::Position:
+                type = ClusterChildType::Position;
+                break;
+            default:
+                if (!cuesElement || !cuesUpdater.hasRelativeOffset(clusterReadOffset, cluster.childrenSize)) {
+                    cluster.childrenSize += childElement->totalSize();
+                    continue;
+                }
+            }
+            clusterChildren.emplace_back(ClusterChildLayout{ cluster.childrenSize, childElement->totalSize(), type });
+            cluster.childrenSize += childElement->totalSize();
+        }
+        cluster.childCount = clusterChildren.size() - cluster.firstChild;
+    }
+    clusterChildrenCached = true;
+}
+
 void MatroskaContainer::internalMakeFile(Diagnostics &diag, AbortableProgressFeedback &progress)
 {
-    static const string context("making Matroska container");
+    makeOrPlanFile(diag, progress, nullptr);
+}
+
+void MatroskaContainer::internalPlanChanges(ChangePlan &plan, Diagnostics &diag, AbortableProgressFeedback &progress)
+{
+    makeOrPlanFile(diag, progress, &plan);
+}
+
+/*!
+ * \brief Makes the file or only determines how the file would be made if \a plan is not nullptr.
+ * \remarks When planning, the function returns after the layout has been computed and before the file is touched.
+ */
+void MatroskaContainer::makeOrPlanFile(Diagnostics &diag, AbortableProgressFeedback &progress, ChangePlan *plan)
+{
+    static const auto context = DiagContext("making Matroska container");
     progress.updateStep("Calculating element sizes ...");
 
     // basic validation of original file
@@ -932,6 +1781,10 @@ void MatroskaContainer::internalMakeFile(Diagnostics &diag, AbortableProgressFee
     std::uint64_t newPadding;
     // -> whether rewrite is required (always required when forced to rewrite)
     bool rewriteRequired = fileInfo().isForcingRewrite() || !fileInfo().saveFilePath().empty();
+    // -> whether appending the tags to the end of the segment has already been considered to avoid rewriting
+    bool appendingTagsConsidered = rewriteRequired;
+    // -> where to append the tags (if appending the tags has been determined to be possible)
+    TagsAppendingLayout tagsAppendingLayout;
 
     // calculate EBML header size
     // -> sub element ID sizes
@@ -1053,6 +1906,16 @@ void MatroskaContainer::internalMakeFile(Diagnostics &diag, AbortableProgressFee
 
         progress.nextStepOrStop("Calculating offsets of elements before cluster ...");
     calculateSegmentData:
+        // try to avoid rewriting the file by appending the tags to the end of the segment
+        if (rewriteRequired && !appendingTagsConsidered) {
+            appendingTagsConsidered = true;
+            if ((!fileInfo().forceTagPosition() || fileInfo().tagPosition() == ElementPosition::AfterData
+                    || (fileInfo().tagPosition() == ElementPosition::Keep && currentTagPos != ElementPosition::BeforeData))
+                && determineTagsAppendingLayout(tagsSize, tagsAppendingLayout, diag)) {
+                goto appendTagsToSegment;
+            }
+        }
+
         // define variables to store sizes, offsets and other information required to make a header and "Segment"-elements
         // -> current "pretent" write offset
         std::uint64_t currentOffset = ebmlHeaderSize;
@@ -1207,6 +2070,7 @@ void MatroskaContainer::internalMakeFile(Diagnostics &diag, AbortableProgressFee
                             goto calculateSegmentSize;
                         } else {
                             // add size of "Attachments"-element
+                            segment.attachmentsOffset = segment.totalDataSize;
                             segment.totalDataSize += attachmentsSize;
                         }
                     }
@@ -1259,23 +2123,26 @@ void MatroskaContainer::internalMakeFile(Diagnostics &diag, AbortableProgressFee
                                 goto calculateSegmentSize;
                             }
                             // -> update offset of "Cluster"-element in "Cues"-element and get end offset of last "Cluster"-element
+                            //    (using the cached layout so recalculations don't need to walk the element tree again)
+                            segment.cacheClusters(diag, progress);
                             bool cuesInvalidated = false;
-                            for (index = 0; level1Element; level1Element = level1Element->siblingById(MatroskaIds::Cluster, diag), ++index) {
-                                clusterReadOffset = level1Element->startOffset() - level0Element->dataOffset() + readOffset;
-                                segment.clusterEndOffset = level1Element->endOffset();
+                            auto clusterProgress = ProgressCounter(progress, fileInfo().size());
+                            for (const auto &cluster : segment.clusters) {
+                                clusterReadOffset = cluster.startOffset - level0Element->dataOffset() + readOffset;
+                                segment.clusterEndOffset = cluster.endOffset;
                                 if (segment.cuesElement
                                     && segment.cuesUpdater.updateOffsets(
-                                        clusterReadOffset, level1Element->startOffset() - 4 - segment.sizeDenotationLength - ebmlHeaderSize)
+                                        clusterReadOffset, cluster.startOffset - 4 - segment.sizeDenotationLength - ebmlHeaderSize)
                                     && newCuesPos == ElementPosition::BeforeData) {
                                     cuesInvalidated = true;
                                 }
                                 // check whether aborted (because this loop might take some seconds to process)
                                 progress.stopIfAborted();
                                 // update the progress percentage (using offset / file size should be accurate enough)
-                                if (index % 50 == 0) {
-                                    progress.updateStepPercentage(static_cast<std::uint8_t>(level1Element->dataOffset() * 100 / fileInfo().size()));
-                                }
+                                clusterProgress.set(cluster.dataOffset);
+                                clusterProgress.report();
                             }
+                            clusterProgress.reportNow();
                             if (cuesInvalidated) {
                                 segment.totalDataSize = offset;
                                 goto addCuesElementSize;
@@ -1312,6 +2179,7 @@ void MatroskaContainer::internalMakeFile(Diagnostics &diag, AbortableProgressFee
                                         goto calculateSegmentSize;
                                     } else {
                                         // add size of "Attachments"-element
+                                        segment.attachmentsOffset = segment.totalDataSize;
                                         segment.totalDataSize += attachmentsSize;
                                     }
                                 }
@@ -1370,17 +2238,21 @@ void MatroskaContainer::internalMakeFile(Diagnostics &diag, AbortableProgressFee
                     // if rewrite is required, pretend writing the remaining elements to compute total segment size and cluster sizes
 
                     // pretend writing "Void"-element (only if there is at least one "Cluster"-element in the segment)
-                    if (!segmentIndex && rewriteRequired && (level1Element = level0Element->childById(MatroskaIds::Cluster, diag))) {
+                    if (!segmentIndex && rewriteRequired && segment.firstClusterElement) {
                         // simply use the preferred padding
                         segment.totalDataSize += (segment.newPadding = newPadding = fileInfo().preferredPadding());
                     }
 
                     // pretend writing "Cluster"-element
+                    // -> walk the element tree only once and use the cached layout when recalculating
+                    segment.cacheClusterChildren(*level0Element, readOffset, diag, progress);
                     segment.clusterSizes.clear();
                     bool cuesInvalidated = false;
-                    for (index = 0; level1Element; level1Element = level1Element->siblingById(MatroskaIds::Cluster, diag), ++index) {
+                    auto clusterProgress = ProgressCounter(progress, fileInfo().size());
+                    index = 0;
+                    for (const auto &cluster : segment.clusters) {
                         // update offset of "Cluster"-element in "Cues"-element
-                        clusterReadOffset = level1Element->startOffset() - level0Element->dataOffset() + readOffset;
+                        clusterReadOffset = cluster.startOffset - level0Element->dataOffset() + readOffset;
                         if (segment.cuesElement && segment.cuesUpdater.updateOffsets(clusterReadOffset, currentPosition + segment.totalDataSize)
                             && newCuesPos == ElementPosition::BeforeData) {
                             cuesInvalidated = true;
@@ -1389,26 +2261,29 @@ void MatroskaContainer::internalMakeFile(Diagnostics &diag, AbortableProgressFee
                                 goto calculateSegmentSize;
                             } else {
                                 // add size of "Cluster"-element
+                                // -> children which are not cached are copied as-is and not referenced by the "Cues"-element
                                 clusterSize = clusterReadSize = 0;
-                                for (level2Element = level1Element->firstChild(); level2Element; level2Element = level2Element->nextSibling()) {
-                                    level2Element->parse(diag);
+                                const auto *const firstChild = segment.clusterChildren.data() + cluster.firstChild;
+                                for (const auto *child = firstChild, *const end = firstChild + cluster.childCount; child != end; ++child) {
+                                    clusterSize += child->relativeOffset - clusterReadSize;
+                                    clusterReadSize = child->relativeOffset;
                                     if (segment.cuesElement
                                         && segment.cuesUpdater.updateRelativeOffsets(clusterReadOffset, clusterReadSize, clusterSize)
                                         && newCuesPos == ElementPosition::BeforeData) {
                                         cuesInvalidated = true;
                                     }
-                                    switch (level2Element->id()) {
-                                    case EbmlIds::Void:
-                                    case EbmlIds::Crc32:
+                                    switch (child->type) {
+                                    case ClusterChildType::Omitted:
                                         break;
-                                    case MatroskaIds::Position:
+                                    case ClusterChildType::Position:
                                         clusterSize += 1u + 1u + EbmlElement::calculateUIntegerLength(currentPosition + segment.totalDataSize);
                                         break;
-                                    default:
-                                        clusterSize += level2Element->totalSize();
+                                    case ClusterChildType::Copied:
+                                        clusterSize += child->totalSize;
                                     }
-                                    clusterReadSize += level2Element->totalSize();
+                                    clusterReadSize += child->totalSize;
                                 }
+                                clusterSize += cluster.childrenSize - clusterReadSize;
                                 segment.clusterSizes.push_back(clusterSize);
                                 segment.totalDataSize += 4u + EbmlElement::calculateSizeDenotationLength(clusterSize) + clusterSize;
                             }
@@ -1416,11 +2291,12 @@ void MatroskaContainer::internalMakeFile(Diagnostics &diag, AbortableProgressFee
                         // check whether aborted (because this loop might take some seconds to process)
                         progress.stopIfAborted();
                         // update the progress percentage (using offset / file size should be accurate enough)
-                        if ((index % 50 == 0) && fileInfo().size()) {
-                            progress.updateStepPercentage(static_cast<std::uint8_t>(level1Element->dataOffset() * 100 / fileInfo().size()));
-                        }
+                        ++index;
+                        clusterProgress.set(cluster.dataOffset);
+                        clusterProgress.report();
                         // TODO: reduce code duplication for aborting and progress updates
                     }
+                    clusterProgress.reportNow();
                     // check whether the total size of the "Cues"-element has been invalidated and recompute cluster if required
                     if (cuesInvalidated) {
                         // reset element size to previously saved offset of "Cues"-element
@@ -1461,6 +2337,7 @@ void MatroskaContainer::internalMakeFile(Diagnostics &diag, AbortableProgressFee
                                 goto calculateSegmentSize;
                             } else {
                                 // add size of "Attachments"-element
+                                segment.attachmentsOffset = segment.totalDataSize;
                                 segment.totalDataSize += attachmentsSize;
                             }
                         }
@@ -1498,6 +2375,25 @@ void MatroskaContainer::internalMakeFile(Diagnostics &diag, AbortableProgressFee
             }
         }
 
+        // return the plan if only planning
+        if (plan) {
+            plan->strategy = rewriteRequired ? ChangeStrategy::Rewrite : ChangeStrategy::InPlace;
+            plan->newPadding = newPadding;
+            plan->newSize = plan->bytesToWrite = currentOffset;
+            plan->tagPosition = newTagPos;
+            plan->indexPosition = newCuesPos;
+            for (const auto &segment : segmentData) {
+                if (rewriteRequired) {
+                    // the clusters are copied
+                    plan->bytesToCopy = std::accumulate(segment.clusterSizes.cbegin(), segment.clusterSizes.cend(), plan->bytesToCopy);
+                } else if (segment.firstClusterElement) {
+                    // the clusters are kept at their offsets
+                    plan->bytesToWrite -= segment.clusterEndOffset - segment.firstClusterElement->startOffset();
+                }
+            }
+            return;
+        }
+
     } catch (const OperationAbortedException &) {
         diag.emplace_back(DiagLevel::Information, "Applying new tag information has been aborted.", context);
         throw;
@@ -1509,6 +2405,26 @@ void MatroskaContainer::internalMakeFile(Diagnostics &diag, AbortableProgressFee
         throw;
     }
 
+    // append the tags to the end of the segment if that has been determined to be possible (instead of rewriting the file)
+appendTagsToSegment:
+    if (tagsAppendingLayout.segmentElement) {
+        if (plan) {
+            // only the "Tags"-element, the "SeekHead"-element and the voided "Tags"-elements are written
+            plan->strategy = ChangeStrategy::InPlace;
+            plan->newPadding = tagsAppendingLayout.newPadding;
+            plan->newSize = tagsAppendingLayout.appendOffset + tagsSize;
+            plan->bytesToWrite = tagsSize + tagsAppendingLayout.seekHeadSpace;
+            for (const auto *const tagsElement : tagsAppendingLayout.voidedTagsElements) {
+                plan->bytesToWrite += tagsElement->totalSize();
+            }
+            plan->tagPosition = ElementPosition::AfterData;
+            plan->indexPosition = currentCuesPos;
+            return;
+        }
+        appendTags(tagMaker, tagElementsSize, tagsAppendingLayout, diag, progress);
+        return;
+    }
+
     // setup stream(s) for writing
     // -> update status
     progress.nextStepOrStop("Preparing streams ...");
@@ -1547,13 +2463,21 @@ void MatroskaContainer::internalMakeFile(Diagnostics &diag, AbortableProgressFee
 
         // set backup stream as associated input stream since we need the original elements to write the new file
         setStream(backupStream);
+        fileInfo().attachIoStatistics(&backupStream);
 
         // TODO: reduce code duplication
 
     } else { // !rewriteRequired
-        // buffer currently assigned attachments
-        for (auto &maker : attachmentMaker) {
-            maker.bufferCurrentAttachments(diag);
+        // buffer currently assigned attachments which would be overwritten before being copied
+        // note: attachments located at or after the offset they are written to are copied directly from the file when writing
+        if (attachmentsSize) {
+            const auto &segment = segmentData[newTagPos == ElementPosition::BeforeData ? 0 : lastSegmentIndex];
+            auto attachedFileOffset = segment.startOffset + 4 + EbmlElement::calculateSizeDenotationLength(segment.totalDataSize)
+                + segment.attachmentsOffset + 4 + EbmlElement::calculateSizeDenotationLength(attachedFileElementsSize);
+            for (auto &maker : attachmentMaker) {
+                maker.bufferCurrentAttachments(attachedFileOffset, diag);
+                attachedFileOffset += maker.requiredSize();
+            }
         }
 
         // reopen original file to ensure it is opened for writing
@@ -1564,6 +2488,7 @@ void MatroskaContainer::internalMakeFile(Diagnostics &diag, AbortableProgressFee
             diag.emplace_back(DiagLevel::Critical, argsToString("Opening the file with write permissions failed: ", failure.what()), context);
             throw;
         }
+        fileInfo().attachIoStatistics();
     }
 
     // start actual writing
@@ -1721,8 +2646,8 @@ void MatroskaContainer::internalMakeFile(Diagnostics &diag, AbortableProgressFee
                         static_cast<std::uint8_t>((static_cast<std::uint64_t>(outputStream.tellp()) - offset) * 100 / segment.totalDataSize));
                     // write "Cluster"-element
                     auto clusterSizesIterator = segment.clusterSizes.cbegin();
-                    unsigned int index = 0;
-                    for (; level1Element; level1Element = level1Element->siblingById(MatroskaIds::Cluster, diag), ++clusterSizesIterator, ++index) {
+                    auto clusterProgress = ProgressCounter(progress, segment.totalDataSize);
+                    for (; level1Element; level1Element = level1Element->siblingById(MatroskaIds::Cluster, diag), ++clusterSizesIterator) {
                         // calculate position of cluster in segment
                         clusterSize = currentPosition + (static_cast<std::uint64_t>(outputStream.tellp()) - offset);
                         // write header; checking whether clusterSizesIterator is valid shouldn't be necessary
@@ -1744,11 +2669,10 @@ void MatroskaContainer::internalMakeFile(Diagnostics &diag, AbortableProgressFee
                         }
                         // update percentage, check whether the operation has been aborted
                         progress.stopIfAborted();
-                        if (index % 50 == 0) {
-                            progress.updateStepPercentage(
-                                static_cast<std::uint8_t>((static_cast<std::uint64_t>(outputStream.tellp()) - offset) * 100 / segment.totalDataSize));
-                        }
+                        clusterProgress.set(static_cast<std::uint64_t>(outputStream.tellp()) - offset);
+                        clusterProgress.report();
                     }
+                    clusterProgress.reportNow();
                 } else {
                     // can't just skip existing "Cluster"-elements: "Position"-elements must be updated
                     progress.nextStepOrStop("Updating cluster ...",
@@ -1888,4 +2812,388 @@ void MatroskaContainer::internalMakeFile(Diagnostics &diag, AbortableProgressFee
     }
 }
 
+/*!
+ * \brief Returns whether the tags are the only thing that has been changed since the file has been parsed.
+ *
+ * This is determined by comparing the values internalMakeFile() would write for tracks, titles and attachments with the
+ * values of the corresponding elements in the original file. Chapters are always copied as-is so they are not compared.
+ *
+ * \remarks Only considers the first segment as this private method is only used for files containing a single segment.
+ * \throws Throws std::ios_base::failure when an IO error occurs.
+ * \throws Throws TagParser::Failure or a derived exception when a parsing error occurs.
+ */
+bool MatroskaContainer::hasOnlyTagChanges(Diagnostics &diag)
+{
+    // compare title
+    if (!m_segmentInfoElements.empty()) {
+        auto *const titleElement = m_segmentInfoElements.front()->childById(MatroskaIds::Title, diag);
+        const auto originalTitle = titleElement ? titleElement->readString() : std::string();
+        if (originalTitle != (m_titles.empty() ? std::string() : m_titles.front())) {
+            return false;
+        }
+    }
+
+    // compare track headers
+    auto trackEntryCount = std::size_t();
+    for (auto *const tracksElement : m_tracksElements) {
+        for (auto *trackEntryElement = tracksElement->childById(MatroskaIds::TrackEntry, diag); trackEntryElement;
+            trackEntryElement = trackEntryElement->siblingById(MatroskaIds::TrackEntry, diag)) {
+            ++trackEntryCount;
+        }
+    }
+    if (trackEntryCount != tracks().size()) {
+        return false;
+    }
+    for (const auto &track : tracks()) {
+        // read the values the "TrackEntry"-element currently has (using defaults from the specification for absent elements)
+        auto id = std::uint64_t(), trackNumber = std::uint64_t(), isEnabled = std::uint64_t(1), isDefault = std::uint64_t(1),
+             isForced = std::uint64_t();
+        auto name = std::string(), language = std::string("eng"), languageIETF = std::string();
+        for (auto *trackInfoElement = track->m_trackElement->firstChild(); trackInfoElement; trackInfoElement = trackInfoElement->nextSibling()) {
+            trackInfoElement->parse(diag);
+            switch (trackInfoElement->id()) {
+            case MatroskaIds::TrackUID:
+                id = trackInfoElement->readUInteger();
+                break;
+            case MatroskaIds::TrackNumber:
+                trackNumber = trackInfoElement->readUInteger();
+                break;
+            case MatroskaIds::TrackFlagEnabled:
+                isEnabled = trackInfoElement->readUInteger();
+                break;
+            case MatroskaIds::TrackFlagDefault:
+                isDefault = trackInfoElement->readUInteger();
+                break;
+            case MatroskaIds::TrackFlagForced:
+                isForced = trackInfoElement->readUInteger();
+                break;
+            case MatroskaIds::TrackName:
+                name = trackInfoElement->readString();
+                break;
+            case MatroskaIds::TrackLanguage:
+                language = trackInfoElement->readString();
+                break;
+            case MatroskaIds::TrackLanguageIETF:
+                languageIETF = trackInfoElement->readString();
+                break;
+            default:;
+            }
+        }
+        // compare with the values MatroskaTrackHeaderMaker would write
+        const auto &newLanguage = track->locale().abbreviatedName(LocaleFormat::ISO_639_2_B, LocaleFormat::Unknown);
+        if (id != track->id() || trackNumber != track->trackNumber() || (isEnabled != 0) != track->isEnabled()
+            || (isDefault != 0) != track->isDefault() || (isForced != 0) != track->isForced() || name != track->name()
+            || language != (newLanguage.empty() ? std::string_view("und") : std::string_view(newLanguage))
+            || languageIETF != track->locale().abbreviatedName(LocaleFormat::BCP_47)) {
+            return false;
+        }
+    }
+
+    // compare attachments
+    auto attachedFileCount = std::size_t();
+    for (auto *const attachmentsElement : m_attachmentsElements) {
+        for (auto *attachedFileElement = attachmentsElement->childById(MatroskaIds::AttachedFile, diag); attachedFileElement;
+            attachedFileElement = attachedFileElement->siblingById(MatroskaIds::AttachedFile, diag)) {
+            ++attachedFileCount;
+        }
+    }
+    for (const auto &attachment : m_attachments) {
+        if (attachment->isIgnored()) {
+            if (attachment->attachedFileElement()) {
+                return false; // attachment has been removed
+            }
+            continue;
+        }
+        if (!attachment->attachedFileElement() || !attachment->data()) {
+            return false; // attachment has been added
+        }
+        // parse the "AttachedFile"-element again to compare with its original values
+        auto originalAttachment = MatroskaAttachment();
+        auto originalDiag = Diagnostics();
+        originalDiag.setMinLevel(worstDiagLevel); // messages are discarded anyway
+        originalAttachment.parse(attachment->attachedFileElement(), originalDiag);
+        const auto *const data = attachment->data(), *const originalData = originalAttachment.data();
+        if (!originalData || attachment->name() != originalAttachment.name() || attachment->description() != originalAttachment.description()
+            || attachment->mimeType() != originalAttachment.mimeType() || attachment->id() != originalAttachment.id()
+            || &data->stream() != &originalData->stream() || data->startOffset() != originalData->startOffset()
+            || data->endOffset() != originalData->endOffset()) {
+            return false;
+        }
+        --attachedFileCount;
+    }
+    return attachedFileCount == 0;
+}
+
+/*!
+ * \brief Determines whether the tags can be applied by appending them to the end of the segment and if so, where.
+ *
+ * This is used by internalMakeFile() to avoid rewriting the entire file when the tags do not fit before the first "Cluster"-element. The
+ * tags can be appended if the file consists of a single segment which is the last top-level element, the segment has no CRC-32 checksum,
+ * the "SeekHead"-element does not refer to other "SeekHead"-elements, nothing but the tags has been changed (see hasOnlyTagChanges()) and
+ * the size denotation of the segment is long enough to denote the new size. Besides, the "SeekHead"-element must have enough space to denote
+ * the new "Tags"-element. It may use the space of subsequent "Void"-elements and "Tags"-elements for that. The resulting padding before the
+ * first "Cluster"-element must still be within the bounds specified via MediaFileInfo::minPadding() and MediaFileInfo::maxPadding().
+ *
+ * \param tagsSize Specifies the total size of the new "Tags"-element (0 if there are no tags to be written).
+ * \param layout Specifies the layout to populate. Its segmentElement is only set if the tags can be appended.
+ * \returns Returns whether the tags can be appended.
+ * \remarks Does not throw; errors when reading the original file just make the tags not appendable.
+ */
+bool MatroskaContainer::determineTagsAppendingLayout(std::uint64_t tagsSize, TagsAppendingLayout &layout, Diagnostics &diag)
+{
+    static const auto context = DiagContext("determining whether Matroska tags can be appended");
+
+    try {
+        // check whether the file consists of a single segment which is the last top-level element
+        if (m_segmentCount != 1 || m_seekInfos.size() != 1 || m_seekInfos.front()->seekHeadElements().empty()) {
+            return false;
+        }
+        auto *segmentElement = firstElement();
+        while (segmentElement && segmentElement->id() != MatroskaIds::Segment) {
+            segmentElement = segmentElement->nextSibling();
+        }
+        if (!segmentElement || segmentElement->endOffset() != fileInfo().size()) {
+            return false;
+        }
+
+        // check whether the segment has a checksum (would be invalidated)
+        auto *const firstSegmentChild = segmentElement->firstChild();
+        if (!firstSegmentChild) {
+            return false;
+        }
+        firstSegmentChild->parse(diag);
+        if (firstSegmentChild->id() == EbmlIds::Crc32) {
+            return false;
+        }
+
+        // check whether the "SeekHead"-element is within the segment and refers to no other "SeekHead"-elements
+        const auto &seekInfo = *m_seekInfos.front();
+        auto *const seekHeadElement = seekInfo.seekHeadElements().front();
+        if (seekInfo.seekHeadElements().size() != 1 || seekHeadElement->parent() != segmentElement) {
+            return false;
+        }
+        for (const auto &info : seekInfo.info()) {
+            if (info.first == MatroskaIds::SeekHead) {
+                return false;
+            }
+        }
+
+        // check whether there are changes besides the tags
+        if (!hasOnlyTagChanges(diag)) {
+            return false;
+        }
+
+        // determine where to append the tags: overwrite "Tags"-element at the end of the segment or append after the last element
+        layout.appendOffset = segmentElement->endOffset();
+        layout.voidedTagsElements.clear();
+        for (auto *const tagsElement : m_tagsElements) {
+            if (tagsElement->endOffset() == segmentElement->endOffset()) {
+                layout.appendOffset = tagsElement->startOffset();
+            }
+        }
+
+        // check whether the size denotation of the segment is long enough to denote the new size
+        const auto newSegmentDataSize = layout.appendOffset + tagsSize - segmentElement->dataOffset();
+        if (EbmlElement::calculateSizeDenotationLength(newSegmentDataSize) > segmentElement->sizeLength()) {
+            return false;
+        }
+
+        // determine the space available for the "SeekHead"-element
+        // note: subsequent "Void"-elements and "Tags"-elements which are turned into "Void"-elements anyways can be used
+        layout.seekHeadSpace = seekHeadElement->totalSize();
+        const auto isAppendOffset = [&layout](const EbmlElement *element) { return element->startOffset() == layout.appendOffset; };
+        for (auto *element = seekHeadElement->nextSibling(); element; element = element->nextSibling()) {
+            element->parse(diag);
+            if (element->id() != EbmlIds::Void && (element->id() != MatroskaIds::Tags || isAppendOffset(element))) {
+                break;
+            }
+            layout.seekHeadSpace += element->totalSize();
+        }
+        const auto isWithinSeekHeadSpace = [seekHeadElement, &layout](const EbmlElement *element) {
+            return element->startOffset() >= seekHeadElement->startOffset()
+                && element->startOffset() < seekHeadElement->startOffset() + layout.seekHeadSpace;
+        };
+        for (auto *const tagsElement : m_tagsElements) {
+            if (!isAppendOffset(tagsElement) && !isWithinSeekHeadSpace(tagsElement)) {
+                layout.voidedTagsElements.emplace_back(tagsElement);
+            }
+        }
+
+        // compute the new "SeekHead"-element and check whether it fits (a remaining gap of 1 byte can not be filled by a "Void"-element)
+        layout.seekInfo.clear();
+        for (const auto &info : seekInfo.info()) {
+            if (info.first != MatroskaIds::Tags) {
+                layout.seekInfo.info().emplace_back(info);
+            }
+        }
+        if (tagsSize) {
+            layout.seekInfo.push(0, MatroskaIds::Tags, layout.appendOffset - segmentElement->dataOffset());
+        }
+        const auto seekHeadSize = layout.seekInfo.actualSize();
+        if (seekHeadSize > layout.seekHeadSpace || seekHeadSize + 1 == layout.seekHeadSpace) {
+            diag.emplace_back(DiagLevel::Information,
+                "The tags can not be appended to the end of the segment because there is not enough space to update the \"SeekHead\"-element.",
+                context);
+            return false;
+        }
+
+        // check whether the padding before the first "Cluster"-element is ok according to specifications
+        // note: all "Tags"-elements before the first "Cluster"-element are turned into padding
+        auto newPadding = layout.seekHeadSpace - seekHeadSize;
+        for (auto *element = firstSegmentChild; element && element->id() != MatroskaIds::Cluster; element = element->nextSibling()) {
+            element->parse(diag);
+            if ((element->id() == EbmlIds::Void || element->id() == MatroskaIds::Tags) && !isAppendOffset(element)
+                && !isWithinSeekHeadSpace(element)) {
+                newPadding += element->totalSize();
+            }
+        }
+        if (newPadding > fileInfo().maxPadding() || newPadding < fileInfo().minPadding()) {
+            return false;
+        }
+
+        layout.newPadding = newPadding;
+        layout.segmentElement = segmentElement;
+        layout.seekHeadElement = seekHeadElement;
+        return true;
+
+    } catch (const Failure &) {
+    } catch (const std::ios_base::failure &) {
+    }
+    diag.emplace_back(DiagLevel::Warning, "Unable to determine whether the tags can be appended to the end of the segment.", context);
+    return false;
+}
+
+/*!
+ * \brief Writes the "Void"-element header for an element of the specified \a totalSize to \a stream and zeroes its data.
+ * \remarks The \a totalSize must be at least 2 bytes.
+ */
+static void makeVoidElement(std::ostream &stream, std::uint64_t totalSize)
+{
+    char buff[9];
+    std::uint8_t headerSize;
+    *buff = static_cast<char>(EbmlIds::Void);
+    if (totalSize < 64) {
+        *(buff + 1) = static_cast<char>(totalSize - 2) | static_cast<char>(0x80);
+        headerSize = 2;
+    } else {
+        BE::getBytes(static_cast<std::uint64_t>((totalSize - 9) | 0x100000000000000), buff + 1);
+        headerSize = 9;
+    }
+    stream.write(buff, headerSize);
+    MediaFileInfo::writePadding(stream, totalSize - headerSize);
+}
+
+/*!
+ * \brief Applies the tags by appending them to the end of the segment instead of rewriting the entire file.
+ *
+ * The new "Tags"-element is written at the end of the segment and the old "Tags"-elements are turned into "Void"-elements. The
+ * size denotation of the "Segment"-element and the "SeekHead"-element are updated in-place. So only a few kilobytes are written
+ * even if the file is huge.
+ *
+ * The elements are written in an order which keeps the file readable if the process is interrupted in the middle:
+ * 1. The new "Tags"-element is written behind the end of the segment. Until the next step it is just trailing data.
+ * 2. The size denotation of the "Segment"-element is updated to include the new "Tags"-element.
+ * 3. The "SeekHead"-element is updated to refer to the new "Tags"-element instead of the old ones.
+ * 4. The old "Tags"-elements which are no longer referred to are turned into "Void"-elements.
+ * 5. The file is truncated if it has become smaller.
+ *
+ * \remarks
+ * - The \a layout must have been determined via determineTagsAppendingLayout().
+ * - This is not crash-safe if the "Tags"-element at the end of the segment is overwritten (instead of appending a new one after
+ *   it). In this case an interruption while writing the new "Tags"-element leaves a corrupted "Tags"-element behind. The same
+ *   goes for "Tags"-elements which are overwritten by the "SeekHead"-element and its padding (only the "SeekHead"-element is
+ *   updated in this case).
+ * - The "MuxingApp"- and "WritingApp"-elements are not updated.
+ * \throws Throws std::ios_base::failure when an IO error occurs.
+ * \throws Throws TagParser::Failure or a derived exception when a making error occurs.
+ */
+void MatroskaContainer::appendTags(const std::vector<MatroskaTagMaker> &tagMaker, std::uint64_t tagElementsSize, TagsAppendingLayout &layout,
+    Diagnostics &diag, AbortableProgressFeedback &progress)
+{
+    static const auto context = DiagContext("appending Matroska tags");
+    progress.nextStepOrStop("Appending tags to the end of the segment ...");
+
+    // reopen original file to ensure it is opened for writing
+    const auto originalPath = fileInfo().path();
+    auto &outputStream = fileInfo().stream();
+    auto backupStream = NativeFileStream(); // not used; no backup is created when appending tags
+    try {
+        fileInfo().close();
+        outputStream.open(originalPath, ios_base::in | ios_base::out | ios_base::binary);
+    } catch (const std::ios_base::failure &failure) {
+        diag.emplace_back(DiagLevel::Critical, argsToString("Opening the file with write permissions failed: ", failure.what()), context);
+        throw;
+    }
+
+    try {
+        auto outputWriter = BinaryWriter(&outputStream);
+        char buff[8];
+        std::uint8_t sizeLength;
+
+        // write "Tags"-element
+        outputStream.seekp(static_cast<streamoff>(layout.appendOffset));
+        if (tagElementsSize) {
+            outputWriter.writeUInt32BE(MatroskaIds::Tags);
+            sizeLength = EbmlElement::makeSizeDenotation(tagElementsSize, buff);
+            outputStream.write(buff, sizeLength);
+            for (auto &maker : tagMaker) {
+                maker.make(outputStream);
+            }
+        }
+        const auto newSize = static_cast<std::uint64_t>(outputStream.tellp());
+
+        // update size denotation of "Segment"-element (keeping its length)
+        auto *const segmentElement = layout.segmentElement;
+        sizeLength = EbmlElement::makeSizeDenotation(
+            newSize - segmentElement->dataOffset(), buff, static_cast<std::uint8_t>(segmentElement->sizeLength()));
+        outputStream.seekp(static_cast<streamoff>(segmentElement->startOffset() + segmentElement->idLength()));
+        outputStream.write(buff, sizeLength);
+
+        // update "SeekHead"-element and fill the remaining space with a "Void"-element
+        outputStream.seekp(static_cast<streamoff>(layout.seekHeadElement->startOffset()));
+        layout.seekInfo.make(outputStream, diag);
+        if (const auto remainingSpace = layout.seekHeadSpace - layout.seekInfo.actualSize()) {
+            makeVoidElement(outputStream, remainingSpace);
+        }
+
+        // turn old "Tags"-elements into "Void"-elements (only after the "SeekHead"-element no longer refers to them)
+        for (const auto *const tagsElement : layout.voidedTagsElements) {
+            outputStream.seekp(static_cast<streamoff>(tagsElement->startOffset()));
+            makeVoidElement(outputStream, tagsElement->totalSize());
+        }
+
+        // truncate the file if the new "Tags"-element is smaller than the one which has been overwritten
+        if (newSize < fileInfo().size()) {
+            outputStream.close();
+            auto ec = std::error_code();
+            std::filesystem::resize_file(makeNativePath(originalPath), newSize, ec);
+            if (ec) {
+                diag.emplace_back(DiagLevel::Critical, "Unable to truncate the file: " + ec.message(), context);
+                throw std::ios_base::failure("Unable to truncate the file.");
+            }
+            outputStream.open(originalPath, ios_base::in | ios_base::out | ios_base::binary);
+        }
+        fileInfo().reportSizeChanged(newSize);
+        diag.emplace_back(DiagLevel::Information, "The tags have been appended to the end of the segment to avoid rewriting the file.", context);
+
+        // reparse what has been written
+        progress.updateStep("Reparsing output file ...");
+        reset();
+        try {
+            parseHeader(diag, progress);
+        } catch (const OperationAbortedException &) {
+            throw;
+        } catch (const Failure &) {
+            diag.emplace_back(DiagLevel::Critical, "Unable to reparse the header of the new file.", context);
+            throw;
+        }
+
+        // prevent deferring final write operations (to catch and handle possible errors here)
+        outputStream.flush();
+
+    } catch (...) {
+        BackupHelper::handleFailureAfterFileModifiedCanonical(fileInfo(), originalPath, std::string(), outputStream, backupStream, diag, context);
+    }
+}
+
 } // namespace TagParser
@@ -40,10 +40,12 @@ public:
     ElementPosition determineElementPosition(std::uint64_t elementId, Diagnostics &diag) const;
     ElementPosition determineTagPosition(Diagnostics &diag) const override;
     ElementPosition determineIndexPosition(Diagnostics &diag) const override;
+    std::vector<MatroskaTrackStatistics> generateTrackStatistics(Diagnostics &diag, AbortableProgressFeedback &progress, std::size_t threadCount = 0);
 
     virtual bool supportsTitle() const override;
     virtual std::size_t segmentCount() const override;
 
+    void addMemoryUsage(MemoryUsage &usage) const override;
     void reset() override;
 
 protected:
@@ -53,10 +55,20 @@ protected:
     void internalParseChapters(Diagnostics &diag, AbortableProgressFeedback &progress) override;
     void internalParseAttachments(Diagnostics &diag, AbortableProgressFeedback &progress) override;
     void internalMakeFile(Diagnostics &diag, AbortableProgressFeedback &progress) override;
+    void internalPlanChanges(ChangePlan &plan, Diagnostics &diag, AbortableProgressFeedback &progress) override;
 
 private:
+    void makeOrPlanFile(Diagnostics &diag, AbortableProgressFeedback &progress, ChangePlan *plan);
+    struct TagsAppendingLayout;
+
     void parseSegmentInfo(Diagnostics &diag);
+    bool isSeekHeadComplete(std::size_t seekInfosIndex) const;
+    void scanSegmentTail(EbmlElement &segmentElement, const EbmlElement &firstClusterElement, Diagnostics &diag);
     void readTrackStatisticsFromTags(Diagnostics &diag);
+    bool hasOnlyTagChanges(Diagnostics &diag);
+    bool determineTagsAppendingLayout(std::uint64_t tagsSize, TagsAppendingLayout &layout, Diagnostics &diag);
+    void appendTags(const std::vector<MatroskaTagMaker> &tagMaker, std::uint64_t tagElementsSize, TagsAppendingLayout &layout, Diagnostics &diag,
+        AbortableProgressFeedback &progress);
 
     std::uint64_t m_maxIdLength;
     std::uint64_t m_maxSizeLength;
@@ -53,7 +53,7 @@ std::uint64_t MatroskaCuePositionUpdater::totalSize() const
  */
 void MatroskaCuePositionUpdater::parse(EbmlElement *cuesElement, Diagnostics &diag)
 {
-    static const string context("parsing \"Cues\"-element");
+    static const auto context = DiagContext("parsing \"Cues\"-element");
     clear();
     std::uint64_t cuesElementSize = 0, cuePointElementSize, cueTrackPositionsElementSize, cueReferenceElementSize, pos, relPos, statePos;
     EbmlElement *cueRelativePositionElement, *cueClusterPositionElement;
@@ -261,7 +261,7 @@ bool MatroskaCuePositionUpdater::updateSize(EbmlElement *element, int shift)
  */
 void MatroskaCuePositionUpdater::make(ostream &stream, Diagnostics &diag)
 {
-    static const string context("making \"Cues\"-element");
+    static const auto context = DiagContext("making \"Cues\"-element");
     if (!m_cuesElement) {
         diag.emplace_back(DiagLevel::Warning, "No cues written; the cues of the source file could not be parsed correctly.", context);
         return;
@@ -71,6 +71,7 @@ public:
     void parse(EbmlElement *cuesElement, Diagnostics &diag);
     bool updateOffsets(std::uint64_t originalOffset, std::uint64_t newOffset);
     bool updateRelativeOffsets(std::uint64_t referenceOffset, std::uint64_t originalRelativeOffset, std::uint64_t newRelativeOffset);
+    bool hasRelativeOffset(std::uint64_t referenceOffset, std::uint64_t originalRelativeOffset) const;
     void make(std::ostream &stream, Diagnostics &diag);
     void clear();
 
@@ -115,6 +116,16 @@ inline EbmlElement *MatroskaCuePositionUpdater::cuesElement() const
     return m_cuesElement;
 }
 
+/*!
+ * \brief Returns whether there are entries with the specified \a originalRelativeOffset and the specified \a referenceOffset.
+ * \remarks Calling updateRelativeOffsets() for offsets this method returns false for is a no-op.
+ */
+inline bool MatroskaCuePositionUpdater::hasRelativeOffset(std::uint64_t referenceOffset, std::uint64_t originalRelativeOffset) const
+{
+    return m_cueRelativePositionElementByOriginalOffsets.find(std::make_pair(referenceOffset, originalRelativeOffset))
+        != m_cueRelativePositionElementByOriginalOffsets.cend();
+}
+
 /*!
  * \brief Resets the object to its initial state. Parsing results and updates are cleared.
  */
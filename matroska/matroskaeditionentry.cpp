@@ -57,7 +57,7 @@ string MatroskaEditionEntry::label() const
 void MatroskaEditionEntry::parse(Diagnostics &diag)
 {
     // clear previous values and status
-    static const string context("parsing \"EditionEntry\"-element");
+    static const auto context = DiagContext("parsing \"EditionEntry\"-element");
     clear();
     // iterate through children of "EditionEntry"-element
     EbmlElement *entryChild = m_editionEntryElement->firstChild();
@@ -50,7 +50,7 @@ void MatroskaSeekInfo::shift(std::uint64_t start, std::int64_t amount)
  */
 void MatroskaSeekInfo::parse(EbmlElement *seekHeadElement, Diagnostics &diag, size_t maxIndirection)
 {
-    static const string context("parsing \"SeekHead\"-element");
+    static const auto context = DiagContext("parsing \"SeekHead\"-element");
 
     m_seekHeadElements.emplace_back(seekHeadElement);
 
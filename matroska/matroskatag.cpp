@@ -1,11 +1,17 @@
 #include "./matroskatag.h"
 #include "./ebmlelement.h"
+#include "./matroskacontainer.h"
 
+#include "../abstractattachment.h"
 #include "../diagnostics.h"
+#include "../fieldidtable.h"
+#include "../memoryoutputbuffer.h"
+#include "../tagfieldfilter.h"
 
+#include <functional>
 #include <initializer_list>
+#include <memory>
 #include <stdexcept>
-#include <unordered_map>
 
 using namespace std;
 using namespace CppUtilities;
@@ -17,294 +23,122 @@ namespace TagParser {
  * \brief Implementation of TagParser::Tag for the Matroska container.
  */
 
+/// \cond
+// mappings between KnownField and tag names used to create the tables for both directions; the tag names are sorted at
+// compile-time and the first mapping of "ACTOR" takes precedence when looking up the KnownField
+// clang-format off
+constexpr FieldIdMapping<std::string_view> matroskaTagFieldMappings[] = {
+    { MatroskaTagIds::artist(), KnownField::Artist },
+    { MatroskaTagIds::album(), KnownField::Album },
+    { MatroskaTagIds::comment(), KnownField::Comment },
+    { MatroskaTagIds::dateRecorded(), KnownField::RecordDate },
+    { MatroskaTagIds::dateRelease(), KnownField::ReleaseDate },
+    { MatroskaTagIds::title(), KnownField::Title },
+    { MatroskaTagIds::genre(), KnownField::Genre },
+    { MatroskaTagIds::partNumber(), KnownField::PartNumber },
+    { MatroskaTagIds::totalParts(), KnownField::TotalParts },
+    { MatroskaTagIds::encoder(), KnownField::Encoder },
+    { MatroskaTagIds::encoderSettings(), KnownField::EncoderSettings },
+    { MatroskaTagIds::bpm(), KnownField::Bpm },
+    { MatroskaTagIds::bps(), KnownField::Bps },
+    { MatroskaTagIds::rating(), KnownField::Rating },
+    { MatroskaTagIds::description(), KnownField::Description },
+    { MatroskaTagIds::lyrics(), KnownField::Lyrics },
+    { MatroskaTagIds::label(), KnownField::RecordLabel },
+    { MatroskaTagIds::actor(), KnownField::Performers },
+    { MatroskaTagIds::lyricist(), KnownField::Lyricist },
+    { MatroskaTagIds::composer(), KnownField::Composer },
+    { MatroskaTagIds::duration(), KnownField::Length },
+    { MatroskaTagIds::language(), KnownField::Language },
+    { MatroskaTagIds::accompaniment(), KnownField::AlbumArtist },
+    { MatroskaTagIds::subtitle(), KnownField::Subtitle },
+    { MatroskaTagIds::leadPerformer(), KnownField::LeadPerformer },
+    { MatroskaTagIds::arranger(), KnownField::Arranger },
+    { MatroskaTagIds::conductor(), KnownField::Conductor },
+    { MatroskaTagIds::director(), KnownField::Director },
+    { MatroskaTagIds::assistantDirector(), KnownField::AssistantDirector },
+    { MatroskaTagIds::directorOfPhotography(), KnownField::DirectorOfPhotography },
+    { MatroskaTagIds::soundEngineer(), KnownField::SoundEngineer },
+    { MatroskaTagIds::artDirector(), KnownField::ArtDirector },
+    { MatroskaTagIds::productionDesigner(), KnownField::ProductionDesigner },
+    { MatroskaTagIds::choregrapher(), KnownField::Choregrapher },
+    { MatroskaTagIds::costumeDesigner(), KnownField::CostumeDesigner },
+    { MatroskaTagIds::actor(), KnownField::Actor },
+    { MatroskaTagIds::character(), KnownField::Character },
+    { MatroskaTagIds::writtenBy(), KnownField::WrittenBy },
+    { MatroskaTagIds::screenplayBy(), KnownField::ScreenplayBy },
+    { MatroskaTagIds::editedBy(), KnownField::EditedBy },
+    { MatroskaTagIds::producer(), KnownField::Producer },
+    { MatroskaTagIds::coproducer(), KnownField::Coproducer },
+    { MatroskaTagIds::executiveProducer(), KnownField::ExecutiveProducer },
+    { MatroskaTagIds::distributedBy(), KnownField::DistributedBy },
+    { MatroskaTagIds::masteredBy(), KnownField::MasteredBy },
+    { MatroskaTagIds::encodedBy(), KnownField::EncodedBy },
+    { MatroskaTagIds::mixedBy(), KnownField::MixedBy },
+    { MatroskaTagIds::remixedBy(), KnownField::RemixedBy },
+    { MatroskaTagIds::productionStudio(), KnownField::ProductionStudio },
+    { MatroskaTagIds::thanksTo(), KnownField::ThanksTo },
+    { MatroskaTagIds::publisher(), KnownField::Publisher },
+    { MatroskaTagIds::mood(), KnownField::Mood },
+    { MatroskaTagIds::originalMediaType(), KnownField::OriginalMediaType },
+    { MatroskaTagIds::contentType(), KnownField::ContentType },
+    { MatroskaTagIds::subject(), KnownField::Subject },
+    { MatroskaTagIds::keywords(), KnownField::Keywords },
+    { MatroskaTagIds::summary(), KnownField::Summary },
+    { MatroskaTagIds::synopsis(), KnownField::Synopsis },
+    { MatroskaTagIds::initialKey(), KnownField::InitialKey },
+    { MatroskaTagIds::period(), KnownField::Period },
+    { MatroskaTagIds::lawRating(), KnownField::LawRating },
+    { MatroskaTagIds::dateEncoded(), KnownField::EncodingDate },
+    { MatroskaTagIds::dateTagged(), KnownField::TaggingDate },
+    { MatroskaTagIds::dateDigitized(), KnownField::DigitalizationDate },
+    { MatroskaTagIds::dateWritten(), KnownField::WritingDate },
+    { MatroskaTagIds::datePurchased(), KnownField::PurchasingDate },
+    { MatroskaTagIds::recordingLocation(), KnownField::RecordingLocation },
+    { MatroskaTagIds::compositionLocation(), KnownField::CompositionLocation },
+    { MatroskaTagIds::composerNationality(), KnownField::ComposerNationality },
+    { MatroskaTagIds::playCounter(), KnownField::PlayCounter },
+    { MatroskaTagIds::measure(), KnownField::Measure },
+    { MatroskaTagIds::tuning(), KnownField::Tuning },
+    { MatroskaTagIds::isrc(), KnownField::ISRC },
+    { MatroskaTagIds::mcdi(), KnownField::MCDI },
+    { MatroskaTagIds::isbn(), KnownField::ISBN },
+    { MatroskaTagIds::barcode(), KnownField::Barcode },
+    { MatroskaTagIds::catalogNumber(), KnownField::CatalogNumber },
+    { MatroskaTagIds::labelCode(), KnownField::LabelCode },
+    { MatroskaTagIds::lccn(), KnownField::LCCN },
+    { MatroskaTagIds::imdb(), KnownField::IMDB },
+    { MatroskaTagIds::tmdb(), KnownField::TMDB },
+    { MatroskaTagIds::tvdb(), KnownField::TVDB },
+    { MatroskaTagIds::purchaseItem(), KnownField::PurchaseItem },
+    { MatroskaTagIds::purchaseInfo(), KnownField::PurchaseInfo },
+    { MatroskaTagIds::purchaseOwner(), KnownField::PurchaseOwner },
+    { MatroskaTagIds::purchasePrice(), KnownField::PurchasePrice },
+    { MatroskaTagIds::purchaseCurrency(), KnownField::PurchaseCurrency },
+    { MatroskaTagIds::copyright(), KnownField::Copyright },
+    { MatroskaTagIds::productionCopyright(), KnownField::ProductionCopyright },
+    { MatroskaTagIds::license(), KnownField::License },
+    { MatroskaTagIds::termsOfUse(), KnownField::TermsOfUse },
+};
+// clang-format on
+// exceptions only applying when looking up the KnownField for a tag name
+// note: "GENRE" is not mapped back to KnownField::Genre (it never has been, so this is kept for compatibility)
+constexpr FieldIdMapping<std::string_view> matroskaTagKnownFieldExceptions[] = {
+    { MatroskaTagIds::genre(), KnownField::Invalid },
+};
+constexpr auto matroskaTagFieldIds = makeFieldIdTable(matroskaTagFieldMappings);
+constexpr auto matroskaTagKnownFields
+    = makeKnownFieldTable(matroskaTagFieldMappings, matroskaTagKnownFieldExceptions, std::less<std::string_view>());
+/// \endcond
+
 MatroskaTag::IdentifierType MatroskaTag::internallyGetFieldId(KnownField field) const
 {
-    using namespace MatroskaTagIds;
-    switch (field) {
-    case KnownField::Artist:
-        return std::string(artist());
-    case KnownField::Album:
-        return std::string(album());
-    case KnownField::Comment:
-        return std::string(comment());
-    case KnownField::RecordDate:
-        return std::string(dateRecorded());
-    case KnownField::ReleaseDate:
-        return std::string(dateRelease());
-    case KnownField::Title:
-        return std::string(title());
-    case KnownField::Genre:
-        return std::string(genre());
-    case KnownField::PartNumber:
-        return std::string(partNumber());
-    case KnownField::TotalParts:
-        return std::string(totalParts());
-    case KnownField::Encoder:
-        return std::string(encoder());
-    case KnownField::EncoderSettings:
-        return std::string(encoderSettings());
-    case KnownField::Bpm:
-        return std::string(bpm());
-    case KnownField::Bps:
-        return std::string(bps());
-    case KnownField::Rating:
-        return std::string(rating());
-    case KnownField::Description:
-        return std::string(description());
-    case KnownField::Lyrics:
-        return std::string(lyrics());
-    case KnownField::RecordLabel:
-        return std::string(label());
-    case KnownField::Performers:
-        return std::string(actor());
-    case KnownField::Lyricist:
-        return std::string(lyricist());
-    case KnownField::Composer:
-        return std::string(composer());
-    case KnownField::Length:
-        return std::string(duration());
-    case KnownField::Language:
-        return std::string(language());
-    case KnownField::AlbumArtist:
-        return std::string(accompaniment());
-    case KnownField::Subtitle:
-        return std::string(subtitle());
-    case KnownField::LeadPerformer:
-        return std::string(leadPerformer());
-    case KnownField::Arranger:
-        return std::string(arranger());
-    case KnownField::Conductor:
-        return std::string(conductor());
-    case KnownField::Director:
-        return std::string(director());
-    case KnownField::AssistantDirector:
-        return std::string(assistantDirector());
-    case KnownField::DirectorOfPhotography:
-        return std::string(directorOfPhotography());
-    case KnownField::SoundEngineer:
-        return std::string(soundEngineer());
-    case KnownField::ArtDirector:
-        return std::string(artDirector());
-    case KnownField::ProductionDesigner:
-        return std::string(productionDesigner());
-    case KnownField::Choregrapher:
-        return std::string(choregrapher());
-    case KnownField::CostumeDesigner:
-        return std::string(costumeDesigner());
-    case KnownField::Actor:
-        return std::string(actor());
-    case KnownField::Character:
-        return std::string(character());
-    case KnownField::WrittenBy:
-        return std::string(writtenBy());
-    case KnownField::ScreenplayBy:
-        return std::string(screenplayBy());
-    case KnownField::EditedBy:
-        return std::string(editedBy());
-    case KnownField::Producer:
-        return std::string(producer());
-    case KnownField::Coproducer:
-        return std::string(coproducer());
-    case KnownField::ExecutiveProducer:
-        return std::string(executiveProducer());
-    case KnownField::DistributedBy:
-        return std::string(distributedBy());
-    case KnownField::MasteredBy:
-        return std::string(masteredBy());
-    case KnownField::EncodedBy:
-        return std::string(encodedBy());
-    case KnownField::MixedBy:
-        return std::string(mixedBy());
-    case KnownField::RemixedBy:
-        return std::string(remixedBy());
-    case KnownField::ProductionStudio:
-        return std::string(productionStudio());
-    case KnownField::ThanksTo:
-        return std::string(thanksTo());
-    case KnownField::Publisher:
-        return std::string(publisher());
-    case KnownField::Mood:
-        return std::string(mood());
-    case KnownField::OriginalMediaType:
-        return std::string(originalMediaType());
-    case KnownField::ContentType:
-        return std::string(contentType());
-    case KnownField::Subject:
-        return std::string(subject());
-    case KnownField::Keywords:
-        return std::string(keywords());
-    case KnownField::Summary:
-        return std::string(summary());
-    case KnownField::Synopsis:
-        return std::string(synopsis());
-    case KnownField::InitialKey:
-        return std::string(initialKey());
-    case KnownField::Period:
-        return std::string(period());
-    case KnownField::LawRating:
-        return std::string(lawRating());
-    case KnownField::EncodingDate:
-        return std::string(dateEncoded());
-    case KnownField::TaggingDate:
-        return std::string(dateTagged());
-    case KnownField::DigitalizationDate:
-        return std::string(dateDigitized());
-    case KnownField::WritingDate:
-        return std::string(dateWritten());
-    case KnownField::PurchasingDate:
-        return std::string(datePurchased());
-    case KnownField::RecordingLocation:
-        return std::string(recordingLocation());
-    case KnownField::CompositionLocation:
-        return std::string(compositionLocation());
-    case KnownField::ComposerNationality:
-        return std::string(composerNationality());
-    case KnownField::PlayCounter:
-        return std::string(playCounter());
-    case KnownField::Measure:
-        return std::string(measure());
-    case KnownField::Tuning:
-        return std::string(tuning());
-    case KnownField::ISRC:
-        return std::string(isrc());
-    case KnownField::MCDI:
-        return std::string(mcdi());
-    case KnownField::ISBN:
-        return std::string(isbn());
-    case KnownField::Barcode:
-        return std::string(barcode());
-    case KnownField::CatalogNumber:
-        return std::string(catalogNumber());
-    case KnownField::LabelCode:
-        return std::string(labelCode());
-    case KnownField::LCCN:
-        return std::string(lccn());
-    case KnownField::IMDB:
-        return std::string(imdb());
-    case KnownField::TMDB:
-        return std::string(tmdb());
-    case KnownField::TVDB:
-        return std::string(tvdb());
-    case KnownField::PurchaseItem:
-        return std::string(purchaseItem());
-    case KnownField::PurchaseInfo:
-        return std::string(purchaseInfo());
-    case KnownField::PurchaseOwner:
-        return std::string(purchaseOwner());
-    case KnownField::PurchasePrice:
-        return std::string(purchasePrice());
-    case KnownField::PurchaseCurrency:
-        return std::string(purchaseCurrency());
-    case KnownField::Copyright:
-        return std::string(copyright());
-    case KnownField::ProductionCopyright:
-        return std::string(productionCopyright());
-    case KnownField::License:
-        return std::string(license());
-    case KnownField::TermsOfUse:
-        return std::string(termsOfUse());
-    default:
-        return std::string();
-    }
+    return std::string(fieldIdFromTable(matroskaTagFieldIds, field));
 }
 
 KnownField MatroskaTag::internallyGetKnownField(const IdentifierType &id) const
 {
-    using namespace MatroskaTagIds;
-    static const std::unordered_map<std::string_view, KnownField> fieldMap({
-        { artist(), KnownField::Artist },
-        { album(), KnownField::Album },
-        { comment(), KnownField::Comment },
-        { dateRecorded(), KnownField::RecordDate },
-        { dateRelease(), KnownField::ReleaseDate },
-        { title(), KnownField::Title },
-        { partNumber(), KnownField::PartNumber },
-        { totalParts(), KnownField::TotalParts },
-        { encoder(), KnownField::Encoder },
-        { encoderSettings(), KnownField::EncoderSettings },
-        { bpm(), KnownField::Bpm },
-        { bps(), KnownField::Bps },
-        { rating(), KnownField::Rating },
-        { description(), KnownField::Description },
-        { lyrics(), KnownField::Lyrics },
-        { label(), KnownField::RecordLabel },
-        { actor(), KnownField::Performers },
-        { lyricist(), KnownField::Lyricist },
-        { composer(), KnownField::Composer },
-        { duration(), KnownField::Length },
-        { language(), KnownField::Language },
-        { accompaniment(), KnownField::AlbumArtist },
-        { subtitle(), KnownField::Subtitle },
-        { leadPerformer(), KnownField::LeadPerformer },
-        { arranger(), KnownField::Arranger },
-        { conductor(), KnownField::Conductor },
-        { director(), KnownField::Director },
-        { assistantDirector(), KnownField::AssistantDirector },
-        { directorOfPhotography(), KnownField::DirectorOfPhotography },
-        { soundEngineer(), KnownField::SoundEngineer },
-        { artDirector(), KnownField::ArtDirector },
-        { productionDesigner(), KnownField::ProductionDesigner },
-        { choregrapher(), KnownField::Choregrapher },
-        { costumeDesigner(), KnownField::CostumeDesigner },
-        { actor(), KnownField::Actor },
-        { character(), KnownField::Character },
-        { writtenBy(), KnownField::WrittenBy },
-        { screenplayBy(), KnownField::ScreenplayBy },
-        { editedBy(), KnownField::EditedBy },
-        { producer(), KnownField::Producer },
-        { coproducer(), KnownField::Coproducer },
-        { executiveProducer(), KnownField::ExecutiveProducer },
-        { distributedBy(), KnownField::DistributedBy },
-        { masteredBy(), KnownField::MasteredBy },
-        { encodedBy(), KnownField::EncodedBy },
-        { mixedBy(), KnownField::MixedBy },
-        { remixedBy(), KnownField::RemixedBy },
-        { productionStudio(), KnownField::ProductionStudio },
-        { thanksTo(), KnownField::ThanksTo },
-        { publisher(), KnownField::Publisher },
-        { mood(), KnownField::Mood },
-        { originalMediaType(), KnownField::OriginalMediaType },
-        { contentType(), KnownField::ContentType },
-        { subject(), KnownField::Subject },
-        { keywords(), KnownField::Keywords },
-        { summary(), KnownField::Summary },
-        { synopsis(), KnownField::Synopsis },
-        { initialKey(), KnownField::InitialKey },
-        { period(), KnownField::Period },
-        { lawRating(), KnownField::LawRating },
-        { dateEncoded(), KnownField::EncodingDate },
-        { dateTagged(), KnownField::TaggingDate },
-        { dateDigitized(), KnownField::DigitalizationDate },
-        { dateWritten(), KnownField::WritingDate },
-        { datePurchased(), KnownField::PurchasingDate },
-        { recordingLocation(), KnownField::RecordingLocation },
-        { compositionLocation(), KnownField::CompositionLocation },
-        { composerNationality(), KnownField::ComposerNationality },
-        { playCounter(), KnownField::PlayCounter },
-        { measure(), KnownField::Measure },
-        { tuning(), KnownField::Tuning },
-        { isrc(), KnownField::ISRC },
-        { mcdi(), KnownField::MCDI },
-        { isbn(), KnownField::ISBN },
-        { barcode(), KnownField::Barcode },
-        { catalogNumber(), KnownField::CatalogNumber },
-        { labelCode(), KnownField::LabelCode },
-        { lccn(), KnownField::LCCN },
-        { imdb(), KnownField::IMDB },
-        { tmdb(), KnownField::TMDB },
-        { tvdb(), KnownField::TVDB },
-        { purchaseItem(), KnownField::PurchaseItem },
-        { purchaseInfo(), KnownField::PurchaseInfo },
-        { purchaseOwner(), KnownField::PurchaseOwner },
-        { purchasePrice(), KnownField::PurchasePrice },
-        { purchaseCurrency(), KnownField::PurchaseCurrency },
-        { copyright(), KnownField::Copyright },
-        { productionCopyright(), KnownField::ProductionCopyright },
-        { license(), KnownField::License },
-        { termsOfUse(), KnownField::TermsOfUse },
-    });
-    const auto knownField(fieldMap.find(id));
-    return knownField != fieldMap.cend() ? knownField->second : KnownField::Invalid;
+    return knownFieldFromTable(matroskaTagKnownFields, std::string_view(id), std::less<std::string_view>());
 }
 
 /*!
@@ -322,13 +156,16 @@ void MatroskaTag::parse(EbmlElement &tagElement, Diagnostics &diag)
 /*!
  * \brief Parses tag information from the specified \a tagElement.
  *
+ * "SimpleTag"-elements not accepted by the specified \a fieldFilter are not decoded. They are only added to skippedFields()
+ * referring to the raw element within the container's stream.
+ *
  * \throws Throws std::ios_base::failure when an IO error occurs.
  * \throws Throws TagParser::Failure or a derived exception when a parsing
  *         error occurs.
  */
-void MatroskaTag::parse2(EbmlElement &tagElement, MatroskaTagFlags flags, Diagnostics &diag)
+void MatroskaTag::parse2(EbmlElement &tagElement, MatroskaTagFlags flags, Diagnostics &diag, const TagFieldFilter *fieldFilter)
 {
-    static const string context("parsing Matroska tag");
+    static const auto context = DiagContext("parsing Matroska tag");
     m_size = tagElement.totalSize();
     tagElement.parse(diag);
     if (tagElement.totalSize() > numeric_limits<std::uint32_t>::max()) {
@@ -337,18 +174,40 @@ void MatroskaTag::parse2(EbmlElement &tagElement, MatroskaTagFlags flags, Diagno
         throw NotImplementedException();
     }
     const auto normalize = flags & MatroskaTagFlags::NormalizeKnownFieldIds;
+    auto idsNormalized = false;
     for (EbmlElement *child = tagElement.firstChild(); child; child = child->nextSibling()) {
         child->parse(diag);
         switch (child->id()) {
         case MatroskaIds::SimpleTag:
             try {
+                if (fieldFilter && fieldFilter->isActive()) {
+                    auto id = readSimpleTagName(*child, diag);
+                    if (normalize) {
+                        auto normalizedId = id;
+                        MatroskaTagField::normalizeId(normalizedId);
+                        if (internallyGetKnownField(normalizedId) != KnownField::Invalid && normalizedId != id) {
+                            id = std::move(normalizedId);
+                            idsNormalized = true;
+                        }
+                    }
+                    if (!id.empty() && !fieldFilter->accepts(*this, id)) {
+                        // keep a reference to the raw element so it is preserved when making the tag
+                        auto rawElement = TagValue();
+                        rawElement.assignLazyData(make_unique<StreamDataBlock>(std::bind(&EbmlElement::stream, child), child->startOffset(),
+                                                      ios_base::beg, child->startOffset() + child->totalSize(), ios_base::beg),
+                            TagDataType::Binary);
+                        skippedFields().emplace(std::move(id), std::move(rawElement));
+                        break;
+                    }
+                }
                 auto field = MatroskaTagField();
                 field.reparse(*child, diag, true);
                 if (normalize) {
                     auto normalizedId = field.id();
                     MatroskaTagField::normalizeId(normalizedId);
-                    if (internallyGetKnownField(normalizedId) != KnownField::Invalid) {
+                    if (internallyGetKnownField(normalizedId) != KnownField::Invalid && normalizedId != field.id()) {
                         field.id() = std::move(normalizedId);
+                        idsNormalized = true;
                     }
                 }
                 fields().emplace(field.id(), std::move(field));
@@ -361,6 +220,23 @@ void MatroskaTag::parse2(EbmlElement &tagElement, MatroskaTagFlags flags, Diagno
             break;
         }
     }
+    // consider the tag only modified if IDs have been normalized (as they would be written in normalized form)
+    m_modified = idsNormalized;
+}
+
+/*!
+ * \brief Returns the value of the "TagName"-element of the specified \a simpleTagElement without decoding the rest of it.
+ * \remarks Returns an empty string if there is no "TagName"-element.
+ */
+std::string MatroskaTag::readSimpleTagName(EbmlElement &simpleTagElement, Diagnostics &diag)
+{
+    for (EbmlElement *child = simpleTagElement.firstChild(); child; child = child->nextSibling()) {
+        child->parse(diag);
+        if (child->id() == MatroskaIds::TagName) {
+            return child->readString();
+        }
+    }
+    return std::string();
 }
 
 /*!
@@ -372,7 +248,7 @@ void MatroskaTag::parse2(EbmlElement &tagElement, MatroskaTagFlags flags, Diagno
  */
 void MatroskaTag::parseTargets(EbmlElement &targetsElement, Diagnostics &diag)
 {
-    static const string context("parsing targets of Matroska tag");
+    static const auto context = DiagContext("parsing targets of Matroska tag");
     m_target.clear();
     bool targetTypeValueFound = false;
     bool targetTypeFound = false;
@@ -440,16 +316,16 @@ MatroskaTagMaker::MatroskaTagMaker(MatroskaTag &tag, Diagnostics &diag)
 {
     // calculate size of "Targets" element
     m_targetsSize = 0; // NOT including ID and size
-    if (m_tag.target().level() != 50) {
+    const auto &target = const_cast<const MatroskaTag &>(m_tag).target();
+    if (target.level() != 50) {
         // size of "TargetTypeValue"
-        m_targetsSize += 2u + 1u + EbmlElement::calculateUIntegerLength(m_tag.target().level());
+        m_targetsSize += 2u + 1u + EbmlElement::calculateUIntegerLength(target.level());
     }
-    if (!m_tag.target().levelName().empty()) {
+    if (!target.levelName().empty()) {
         // size of "TargetType"
-        m_targetsSize += 2u + EbmlElement::calculateSizeDenotationLength(m_tag.target().levelName().size()) + m_tag.target().levelName().size();
+        m_targetsSize += 2u + EbmlElement::calculateSizeDenotationLength(target.levelName().size()) + target.levelName().size();
     }
-    for (const auto &v : initializer_list<vector<std::uint64_t>>{
-             m_tag.target().tracks(), m_tag.target().editions(), m_tag.target().chapters(), m_tag.target().attachments() }) {
+    for (const auto &v : initializer_list<vector<std::uint64_t>>{ target.tracks(), target.editions(), target.chapters(), target.attachments() }) {
         for (auto uid : v) {
             // size of UID denotation
             m_targetsSize += 2u + 1u + EbmlElement::calculateUIntegerLength(uid);
@@ -457,9 +333,11 @@ MatroskaTagMaker::MatroskaTagMaker(MatroskaTag &tag, Diagnostics &diag)
     }
     m_tagSize = 2u + EbmlElement::calculateSizeDenotationLength(m_targetsSize) + m_targetsSize;
     // calculate size of "SimpleTag" elements
-    m_maker.reserve(m_tag.fields().size());
+    // note: The fields are accessed via internallyGetFields() so the tag is not considered modified by just making it.
+    auto &fields = m_tag.internallyGetFields();
+    m_maker.reserve(fields.size());
     m_simpleTagsSize = 0; // including ID and size
-    for (auto &pair : m_tag.fields()) {
+    for (auto &pair : fields) {
         if (pair.second.value().isNull()) {
             continue;
         }
@@ -469,6 +347,13 @@ MatroskaTagMaker::MatroskaTagMaker(MatroskaTag &tag, Diagnostics &diag)
         } catch (const Failure &) {
         }
     }
+    // take over "SimpleTag" elements which have been skipped when parsing; load them now as the file might be rewritten in-place
+    const auto &skippedFields = m_tag.internallyGetSkippedFields();
+    m_skippedSimpleTags.reserve(skippedFields.size());
+    for (const auto &[id, rawElement] : skippedFields) {
+        rawElement.loadData();
+        m_simpleTagsSize += m_skippedSimpleTags.emplace_back(&rawElement)->dataSize();
+    }
     m_tagSize += m_simpleTagsSize;
     m_totalSize = 2u + EbmlElement::calculateSizeDenotationLength(m_tagSize) + m_tagSize;
 }
@@ -476,11 +361,40 @@ MatroskaTagMaker::MatroskaTagMaker(MatroskaTag &tag, Diagnostics &diag)
 /*!
  * \brief Saves the tag (specified when constructing the object) to the
  *        specified \a stream (makes a "Tag"-element).
+ * \remarks The tag is rendered into a contiguous buffer first so it is written using a single write.
  * \throws Throws std::ios_base::failure when an IO error occurs.
  * \throws Throws Assumes the data is already validated and thus does NOT
  *                throw TagParser::Failure or a derived exception.
  */
 void MatroskaTagMaker::make(ostream &stream) const
+{
+    const auto size = static_cast<std::size_t>(m_totalSize);
+    const auto buffer = make_unique<char[]>(size);
+    make(buffer.get());
+    stream.write(buffer.get(), static_cast<std::streamsize>(size));
+}
+
+/*!
+ * \brief Saves the tag (specified when constructing the object) to the
+ *        specified \a buffer (makes a "Tag"-element).
+ * \remarks The \a buffer must be at least requiredSize() bytes long.
+ * \throws Throws std::ios_base::failure when the tag does not fit into requiredSize() bytes or
+ *         when an IO error occurs while copying lazily loaded data from its source.
+ * \throws Throws Assumes the data is already validated and thus does NOT
+ *                throw TagParser::Failure or a derived exception.
+ */
+void MatroskaTagMaker::make(char *buffer) const
+{
+    MemoryOutputBuffer memoryBuffer(buffer, static_cast<std::size_t>(m_totalSize));
+    ostream stream(&memoryBuffer);
+    stream.exceptions(ios_base::failbit | ios_base::badbit);
+    internallyMake(stream);
+}
+
+/*!
+ * \brief Writes the "Tag"-element to the specified \a stream.
+ */
+void MatroskaTagMaker::internallyMake(ostream &stream) const
 {
     // write header
     char buff[11];
@@ -493,7 +407,7 @@ void MatroskaTagMaker::make(ostream &stream) const
     stream.write(buff, 2);
     len = EbmlElement::makeSizeDenotation(m_targetsSize, buff);
     stream.write(buff, len);
-    const TagTarget &t = m_tag.target();
+    const TagTarget &t = const_cast<const MatroskaTag &>(m_tag).target();
     if (t.level() != 50) {
         // write "TargetTypeValue"
         BE::getBytes(static_cast<std::uint16_t>(MatroskaIds::TargetTypeValue), buff);
@@ -527,6 +441,10 @@ void MatroskaTagMaker::make(ostream &stream) const
     for (const auto &maker : m_maker) {
         maker.make(stream);
     }
+    // write skipped "SimpleTag" elements as-is
+    for (const auto *const rawElement : m_skippedSimpleTags) {
+        rawElement->copyDataTo(stream);
+    }
 }
 
 } // namespace TagParser
@@ -10,6 +10,7 @@ namespace TagParser {
 
 class EbmlElement;
 class MatroskaTag;
+class TagFieldFilter;
 
 /*!
  * \brief The MatroskaTagFlags enum specifies flags which controls parsing and making of Matroska tags.
@@ -30,16 +31,19 @@ class TAG_PARSER_EXPORT MatroskaTagMaker {
 
 public:
     void make(std::ostream &stream) const;
+    void make(char *buffer) const;
     const MatroskaTag &tag() const;
     std::uint64_t requiredSize() const;
 
 private:
     MatroskaTagMaker(MatroskaTag &tag, Diagnostics &diag);
+    void internallyMake(std::ostream &stream) const;
 
     MatroskaTag &m_tag;
     std::uint64_t m_targetsSize;
     std::uint64_t m_simpleTagsSize;
     std::vector<MatroskaTagFieldMaker> m_maker;
+    std::vector<const TagValue *> m_skippedSimpleTags;
     std::uint64_t m_tagSize;
     std::uint64_t m_totalSize;
 };
@@ -67,10 +71,12 @@ template <> class TAG_PARSER_EXPORT FieldMapBasedTagTraits<MatroskaTag> {
 public:
     using FieldType = MatroskaTagField;
     using Compare = std::less<typename FieldType::IdentifierType>;
+    template <typename Key, typename Value, typename KeyCompare> using Container = FlatMultiMap<Key, Value, KeyCompare>;
 };
 
 class TAG_PARSER_EXPORT MatroskaTag final : public FieldMapBasedTag<MatroskaTag> {
     friend class FieldMapBasedTag<MatroskaTag>;
+    friend class MatroskaTagMaker;
 
 public:
     MatroskaTag();
@@ -84,7 +90,7 @@ public:
     TagTargetLevel targetLevel() const override;
 
     void parse(EbmlElement &tagElement, Diagnostics &diag);
-    void parse2(EbmlElement &tagElement, MatroskaTagFlags flags, Diagnostics &diag);
+    void parse2(EbmlElement &tagElement, MatroskaTagFlags flags, Diagnostics &diag, const TagFieldFilter *fieldFilter = nullptr);
     MatroskaTagMaker prepareMaking(Diagnostics &diag);
     void make(std::ostream &stream, Diagnostics &diag);
 
@@ -94,6 +100,7 @@ protected:
 
 private:
     void parseTargets(EbmlElement &targetsElement, Diagnostics &diag);
+    static std::string readSimpleTagName(EbmlElement &simpleTagElement, Diagnostics &diag);
 };
 
 /*!
@@ -161,7 +161,7 @@ void MatroskaTagField::reparse(EbmlElement &simpleTagElement, Diagnostics &diag,
  */
 MatroskaTagFieldMaker MatroskaTagField::prepareMaking(Diagnostics &diag)
 {
-    static const string context("making Matroska \"SimpleTag\" element.");
+    static const auto context = DiagContext("making Matroska \"SimpleTag\" element.");
     // check whether ID is empty
     if (id().empty()) {
         diag.emplace_back(DiagLevel::Critical, "Can not make \"SimpleTag\" element with empty \"TagName\".", context);
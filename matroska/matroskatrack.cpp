@@ -268,7 +268,7 @@ void MatroskaTrack::readStatisticsFromTags(const std::vector<std::unique_ptr<Mat
     using namespace std::placeholders;
     using namespace MatroskaTagIds::TrackSpecific;
     for (const auto &tag : tags) {
-        const TagTarget &target = tag->target();
+        const TagTarget &target = const_cast<const MatroskaTag *>(tag.get())->target();
         if (find(target.tracks().cbegin(), target.tracks().cend(), id()) == target.tracks().cend()) {
             continue;
         }
@@ -283,11 +283,23 @@ void MatroskaTrack::readStatisticsFromTags(const std::vector<std::unique_ptr<Mat
     }
 }
 
+/*!
+ * \brief Assigns the specified \a statistics computed by MatroskaContainer::generateTrackStatistics().
+ * \remarks Only the number of bytes, the number of frames, the duration and the bitrate are assigned.
+ */
+void MatroskaTrack::readStatistics(const MatroskaTrackStatistics &statistics)
+{
+    m_size = statistics.numberOfBytes;
+    m_sampleCount = statistics.numberOfFrames;
+    m_duration = statistics.duration();
+    m_bitrate = static_cast<double>(statistics.bitrate()) / 1000.0;
+}
+
 void MatroskaTrack::internalParseHeader(Diagnostics &diag, AbortableProgressFeedback &progress)
 {
     CPP_UTILITIES_UNUSED(progress)
 
-    static const string context("parsing header of Matroska track");
+    static const auto context = DiagContext("parsing header of Matroska track");
     try {
         m_trackElement->parse(diag);
     } catch (const Failure &) {
@@ -3,6 +3,9 @@
 
 #include "../abstracttrack.h"
 
+#include <algorithm>
+#include <limits>
+
 namespace TagParser {
 
 class EbmlElement;
@@ -45,6 +48,76 @@ inline std::uint64_t MatroskaTrackHeaderMaker::requiredSize() const
     return m_requiredSize;
 }
 
+/*!
+ * \brief The MatroskaTrackStatistics struct holds statistics of a Matroska track computed by scanning its blocks.
+ * \sa MatroskaContainer::generateTrackStatistics()
+ */
+struct TAG_PARSER_EXPORT MatroskaTrackStatistics {
+    constexpr MatroskaTrackStatistics();
+    CppUtilities::TimeSpan duration() const;
+    std::uint64_t bitrate() const;
+    void add(const MatroskaTrackStatistics &other);
+
+    /// \brief The number of the track the statistics are about.
+    std::uint64_t trackNumber;
+    /// \brief The number of bytes of all frames (not including block and lacing headers).
+    std::uint64_t numberOfBytes;
+    /// \brief The number of frames (laced frames are counted individually).
+    std::uint64_t numberOfFrames;
+    /// \brief The timestamp of the first frame in nanoseconds.
+    std::int64_t startTimestamp;
+    /// \brief The timestamp of the end of the last frame in nanoseconds.
+    std::int64_t endTimestamp;
+    /// \brief The number of bytes read from the file to compute the statistics.
+    std::uint64_t scannedBytes;
+    /// \brief The time spent reading and parsing the blocks of the track (the time taken per cluster split by the scanned bytes).
+    CppUtilities::TimeSpan scanTime;
+};
+
+/*!
+ * \brief Constructs empty statistics.
+ */
+constexpr MatroskaTrackStatistics::MatroskaTrackStatistics()
+    : trackNumber(0)
+    , numberOfBytes(0)
+    , numberOfFrames(0)
+    , startTimestamp(std::numeric_limits<std::int64_t>::max())
+    , endTimestamp(std::numeric_limits<std::int64_t>::min())
+    , scannedBytes(0)
+{
+}
+
+/*!
+ * \brief Returns the duration from the start of the first frame to the end of the last frame.
+ */
+inline CppUtilities::TimeSpan MatroskaTrackStatistics::duration() const
+{
+    return numberOfFrames && endTimestamp > startTimestamp ? CppUtilities::TimeSpan((endTimestamp - startTimestamp) / 100) : CppUtilities::TimeSpan();
+}
+
+/*!
+ * \brief Returns the average bitrate in bits per second or zero if the duration is unknown.
+ */
+inline std::uint64_t MatroskaTrackStatistics::bitrate() const
+{
+    return numberOfFrames && endTimestamp > startTimestamp
+        ? static_cast<std::uint64_t>(static_cast<double>(numberOfBytes) * 8.0 * 1000000000.0 / static_cast<double>(endTimestamp - startTimestamp))
+        : 0;
+}
+
+/*!
+ * \brief Adds the specified statistics (computed for another range of the same track) to these statistics.
+ */
+inline void MatroskaTrackStatistics::add(const MatroskaTrackStatistics &other)
+{
+    numberOfBytes += other.numberOfBytes;
+    numberOfFrames += other.numberOfFrames;
+    startTimestamp = std::min(startTimestamp, other.startTimestamp);
+    endTimestamp = std::max(endTimestamp, other.endTimestamp);
+    scannedBytes += other.scannedBytes;
+    scanTime += other.scanTime;
+}
+
 class TAG_PARSER_EXPORT MatroskaTrack : public AbstractTrack {
     friend class MatroskaContainer;
     friend class MatroskaTrackHeaderMaker;
@@ -57,6 +130,7 @@ public:
 
     static MediaFormat codecIdToMediaFormat(const std::string &codecId);
     void readStatisticsFromTags(const std::vector<std::unique_ptr<MatroskaTag>> &tags, Diagnostics &diag);
+    void readStatistics(const MatroskaTrackStatistics &statistics);
     MatroskaTrackHeaderMaker prepareMakingHeader(Diagnostics &diag) const;
     void makeHeader(std::ostream &stream, Diagnostics &diag) const;
 
@@ -1,12 +1,16 @@
 #include "./mediafileinfo.h"
+#include "./abstractattachment.h"
 #include "./abstracttrack.h"
 #include "./backuphelper.h"
 #include "./diagnostics.h"
 #include "./exceptions.h"
+#include "./iostatisticsrecorder.h"
 #include "./locale.h"
 #include "./progressfeedback.h"
 #include "./signature.h"
 #include "./tag.h"
+#include "./tagfieldfilter.h"
+#include "./tracing.h"
 
 #include "./id3/id3v1tag.h"
 #include "./id3/id3v2tag.h"
@@ -46,11 +50,11 @@
 #include <functional>
 #include <iomanip>
 #include <ios>
+#include <limits>
 #include <memory>
 #include <system_error>
 
 using namespace std;
-using namespace std::placeholders;
 using namespace CppUtilities;
 
 /*!
@@ -61,7 +65,12 @@ using namespace CppUtilities;
 namespace TagParser {
 
 /// \brief The MediaFileInfoPrivate struct contains private fields of the MediaFileInfo class.
-struct MediaFileInfoPrivate {};
+struct MediaFileInfoPrivate {
+    TagFieldFilter tagFieldFilter;
+    std::size_t parsedTagCount = 0, parsedTrackCount = 0, parsedAttachmentCount = 0;
+    bool paddingSizeDetermined = false;
+    std::unique_ptr<IoStatisticsRecorder> ioStatisticsRecorder;
+};
 
 /*!
  * \class TagParser::MediaFileInfo
@@ -98,6 +107,7 @@ MediaFileInfo::MediaFileInfo(std::string &&path)
     , m_fileHandlingFlags(MediaFileHandlingFlags::ForceRewrite | MediaFileHandlingFlags::ForceTagPosition | MediaFileHandlingFlags::ForceIndexPosition
           | MediaFileHandlingFlags::NormalizeKnownTagFieldIds | MediaFileHandlingFlags::PreserveRawTimingValues)
     , m_maxFullParseSize(0x3200000)
+    , m_p(make_unique<MediaFileInfoPrivate>())
 {
 }
 
@@ -146,12 +156,15 @@ void MediaFileInfo::parseContainerFormat(Diagnostics &diag, AbortableProgressFee
         return;
     }
 
-    static const string context("parsing file header");
+    static const auto context = DiagContext("parsing file header");
     open(); // ensure the file is open
+    const auto ioPhase = IoStatisticsRecorder::PhaseScope(m_p->ioStatisticsRecorder.get(), IoPhase::ParseContainerFormat);
+    TAG_PARSER_TRACE_SPAN("MediaFileInfo::parseContainerFormat");
     m_containerFormat = ContainerFormat::Unknown;
 
     // file size
     m_paddingSize = 0;
+    m_p->paddingSizeDetermined = false;
     m_containerOffset = 0;
     std::size_t bytesSkippedBeforeContainer = 0;
     std::streamoff id3v2Size = 0;
@@ -223,6 +236,7 @@ startParsingSignature:
             m_container = make_unique<Mp4Container>(*this, m_containerOffset);
             try {
                 static_cast<Mp4Container *>(m_container.get())->validateElementStructure(diag, progress, &m_paddingSize);
+                m_p->paddingSizeDetermined = true;
             } catch (const OperationAbortedException &) {
                 diag.emplace_back(DiagLevel::Information, "Validating the MP4 element structure has been aborted.", context);
             } catch (const Failure &) {
@@ -244,6 +258,7 @@ startParsingSignature:
                     // validating the element structure of Matroska files takes too long when
                     // parsing big files so do this only when explicitly desired
                     container->validateElementStructure(diag, progress, &m_paddingSize);
+                    m_p->paddingSizeDetermined = true;
                     container->validateIndex(diag, progress);
                 }
             } catch (const OperationAbortedException &) {
@@ -327,13 +342,16 @@ void MediaFileInfo::parseTracks(Diagnostics &diag, AbortableProgressFeedback &pr
     if (tracksParsingStatus() != ParsingStatus::NotParsedYet) {
         return;
     }
-    static const string context("parsing tracks");
+    static const auto context = DiagContext("parsing tracks");
+    const auto ioPhase = IoStatisticsRecorder::PhaseScope(m_p->ioStatisticsRecorder.get(), IoPhase::ParseTracks);
+    TAG_PARSER_TRACE_SPAN("MediaFileInfo::parseTracks");
 
     try {
         // parse tracks via container object
         if (m_container) {
             m_container->parseTracks(diag, progress);
             m_tracksParsingStatus = ParsingStatus::Ok;
+            m_p->parsedTrackCount = m_container->trackCount();
             return;
         }
 
@@ -375,6 +393,7 @@ void MediaFileInfo::parseTracks(Diagnostics &diag, AbortableProgressFeedback &pr
         }
 
         m_tracksParsingStatus = ParsingStatus::Ok;
+        m_p->parsedTrackCount = 1;
 
     } catch (const NotImplementedException &) {
         diag.emplace_back(DiagLevel::Information, "Parsing tracks is not implemented for the container format of the file.", context);
@@ -405,7 +424,9 @@ void MediaFileInfo::parseTags(Diagnostics &diag, AbortableProgressFeedback &prog
     if (tagsParsingStatus() != ParsingStatus::NotParsedYet) {
         return;
     }
-    static const string context("parsing tag");
+    static const auto context = DiagContext("parsing tag");
+    const auto ioPhase = IoStatisticsRecorder::PhaseScope(m_p->ioStatisticsRecorder.get(), IoPhase::ParseTags);
+    TAG_PARSER_TRACE_SPAN("MediaFileInfo::parseTags");
 
     // check for ID3v1 tag
     auto effectiveSize = static_cast<std::streamoff>(size());
@@ -456,9 +477,12 @@ void MediaFileInfo::parseTags(Diagnostics &diag, AbortableProgressFeedback &prog
     m_id3v2Tags.clear();
     for (const auto offset : m_actualId3v2TagOffsets) {
         auto id3v2Tag = make_unique<Id3v2Tag>();
+        if (m_fileHandlingFlags & MediaFileHandlingFlags::LoadPicturesLazily) {
+            id3v2Tag->setHandlingFlags(id3v2Tag->handlingFlags() | Id3v2HandlingFlags::LoadPicturesLazily);
+        }
         stream().seekg(offset, ios_base::beg);
         try {
-            id3v2Tag->parse(stream(), size() - static_cast<std::uint64_t>(offset), diag);
+            id3v2Tag->parse(stream(), size() - static_cast<std::uint64_t>(offset), diag, &m_p->tagFieldFilter);
             m_paddingSize += id3v2Tag->paddingSize();
         } catch (const NoDataFoundException &) {
             continue;
@@ -482,6 +506,7 @@ void MediaFileInfo::parseTags(Diagnostics &diag, AbortableProgressFeedback &prog
             if (m_tagsParsingStatus == ParsingStatus::NotParsedYet) {
                 m_tagsParsingStatus = m_tracksParsingStatus;
             }
+            m_p->parsedTagCount = tags().size();
             return;
         } else if (m_container) {
             m_container->parseTags(diag, progress);
@@ -493,12 +518,14 @@ void MediaFileInfo::parseTags(Diagnostics &diag, AbortableProgressFeedback &prog
         if (m_tagsParsingStatus == ParsingStatus::NotParsedYet) {
             m_tagsParsingStatus = ParsingStatus::Ok;
         }
+        m_p->parsedTagCount = tags().size();
 
     } catch (const NotImplementedException &) {
         // set status to not supported, but do not override parsing status from ID3 tags here
         if (m_tagsParsingStatus == ParsingStatus::NotParsedYet) {
             m_tagsParsingStatus = ParsingStatus::NotSupported;
         }
+        m_p->parsedTagCount = tags().size();
         diag.emplace_back(DiagLevel::Information, "Parsing tags is not implemented for the container format of the file.", context);
     } catch (const OperationAbortedException &) {
         diag.emplace_back(DiagLevel::Information, "Parsing tags from container/streams has been aborted.", context);
@@ -524,7 +551,8 @@ void MediaFileInfo::parseChapters(Diagnostics &diag, AbortableProgressFeedback &
     if (chaptersParsingStatus() != ParsingStatus::NotParsedYet) {
         return;
     }
-    static const string context("parsing chapters");
+    static const auto context = DiagContext("parsing chapters");
+    TAG_PARSER_TRACE_SPAN("MediaFileInfo::parseChapters");
 
     try {
         // parse chapters via container object
@@ -557,7 +585,8 @@ void MediaFileInfo::parseAttachments(Diagnostics &diag, AbortableProgressFeedbac
     if (attachmentsParsingStatus() != ParsingStatus::NotParsedYet) {
         return;
     }
-    static const string context("parsing attachments");
+    static const auto context = DiagContext("parsing attachments");
+    TAG_PARSER_TRACE_SPAN("MediaFileInfo::parseAttachments");
 
     try {
         // parse attachments via container object
@@ -566,6 +595,7 @@ void MediaFileInfo::parseAttachments(Diagnostics &diag, AbortableProgressFeedbac
         }
         m_container->parseAttachments(diag, progress);
         m_attachmentsParsingStatus = ParsingStatus::Ok;
+        m_p->parsedAttachmentCount = m_container->attachmentCount();
     } catch (const NotImplementedException &) {
         m_attachmentsParsingStatus = ParsingStatus::NotSupported;
         diag.emplace_back(DiagLevel::Information, "Parsing attachments is not implemented for the container format of the file.", context);
@@ -737,33 +767,23 @@ bool MediaFileInfo::createAppropriateTags(const TagCreationSettings &settings)
  *          All previous parsing results are cleared (using clearParsingResults()). Hence
  *          the file must be reparsed. All related objects (tags, tracks, ...) might get invalidated.
  *          This includes notifications of these objects as well.
+ * \remarks If there are no pending changes (see hasPendingChanges()) the file is left untouched. The parsing results
+ *          are cleared nevertheless.
  *
  * \sa clearParsingResults()
  */
 void MediaFileInfo::applyChanges(Diagnostics &diag, AbortableProgressFeedback &progress)
 {
-    static const string context("making file");
+    static const auto context = DiagContext("making file");
     diag.emplace_back(DiagLevel::Information, "Changes are about to be applied.", context);
-    bool previousParsingSuccessful = true;
-    switch (tagsParsingStatus()) {
-    case ParsingStatus::Ok:
-    case ParsingStatus::NotSupported:
-        break;
-    default:
-        previousParsingSuccessful = false;
-        diag.emplace_back(DiagLevel::Critical, "Tags have to be parsed without critical errors before changes can be applied.", context);
-    }
-    switch (tracksParsingStatus()) {
-    case ParsingStatus::Ok:
-    case ParsingStatus::NotSupported:
-        break;
-    default:
-        previousParsingSuccessful = false;
-        diag.emplace_back(DiagLevel::Critical, "Tracks have to be parsed without critical errors before changes can be applied.", context);
-    }
-    if (!previousParsingSuccessful) {
-        throw InvalidDataException();
+    validateParsingResultsForMaking(context, diag);
+    if (!hasPendingChanges()) {
+        diag.emplace_back(DiagLevel::Information, "There are no changes to be applied; the file is left untouched.", context);
+        clearParsingResults();
+        return;
     }
+    const auto ioPhase = IoStatisticsRecorder::PhaseScope(m_p->ioStatisticsRecorder.get(), IoPhase::ApplyChanges);
+    TAG_PARSER_TRACE_SPAN("MediaFileInfo::applyChanges");
     if (m_container) { // container object takes care
         // ID3 tags can not be applied in this case -> add warnings if ID3 tags have been assigned
         if (hasId3v1Tag()) {
@@ -784,7 +804,7 @@ void MediaFileInfo::applyChanges(Diagnostics &diag, AbortableProgressFeedback &p
     } else { // implementation if no container object is present
         // assume the file is a MP3 file
         try {
-            makeMp3File(diag, progress);
+            makeMp3File(diag, progress, nullptr);
         } catch (...) {
             // since the file might be messed up, invalidate the parsing results
             clearParsingResults();
@@ -794,6 +814,131 @@ void MediaFileInfo::applyChanges(Diagnostics &diag, AbortableProgressFeedback &p
     clearParsingResults();
 }
 
+/*!
+ * \brief Determines how applyChanges() would apply the pending changes without altering the file.
+ *
+ * The returned plan is computed from the same size and padding calculations applyChanges() uses. It tells whether the
+ * file would be updated in-place or rewritten, how many bytes would be copied and written in total, the resulting padding
+ * and where tags and index would be placed. The media data is not read and neither a backup file nor write permissions
+ * are required. So it is cheap enough to be called for every file of a batch, e.g. to schedule expensive rewrites.
+ *
+ * \remarks
+ * - The same requirements as for applyChanges() apply, so tags and tracks need to be parsed.
+ * - The pending changes are kept as they are and the parsing results are not invalidated. Making tags to compute their
+ *   size does not cause them to be considered modified (see Tag::isModified()).
+ * - Ogg files are always rewritten and the numbers are only estimated (see ChangePlan::isEstimated).
+ * \throws Throws std::ios_base::failure when an IO error occurs.
+ * \throws Throws TagParser::Failure or a derived exception when a parsing error occurs or when planning is not
+ *         supported for the container format.
+ */
+ChangePlan MediaFileInfo::planChanges(Diagnostics &diag, AbortableProgressFeedback &progress)
+{
+    static const auto context = DiagContext("planning changes");
+    TAG_PARSER_TRACE_SPAN("MediaFileInfo::planChanges");
+    validateParsingResultsForMaking(context, diag);
+    if (!hasPendingChanges()) {
+        return ChangePlan();
+    }
+    if (m_container) {
+        return m_container->planChanges(diag, progress);
+    }
+    auto plan = ChangePlan();
+    makeMp3File(diag, progress, &plan);
+    return plan;
+}
+
+/*!
+ * \brief Returns whether applyChanges() would actually alter the file.
+ *
+ * This is the case if tags, tracks or attachments have been added, removed or modified since they have been parsed, if
+ * a rewrite is forced (see isForcingRewrite()), if the changes are supposed to be saved to a different file (see
+ * saveFilePath()) or if the present padding or element positions do not satisfy the settings.
+ *
+ * \remarks
+ * - The padding is considered not satisfying the settings if it is not within minPadding() and maxPadding(). The
+ *   preferredPadding() is only used when the file is rewritten anyways so it is not taken into account here.
+ * - The padding of Matroska files is only known if the file has been parsed with isForcingFullParse() enabled. Otherwise
+ *   the padding settings are only considered satisfied if any padding is acceptable (minPadding() is zero and maxPadding()
+ *   is the max. value of std::size_t).
+ * - Element positions are only taken into account if they are enforced (see forceTagPosition() and
+ *   forceIndexPosition()) and if the current position can be determined (see AbstractContainer::determineTagPosition()
+ *   and AbstractContainer::determineIndexPosition()).
+ * - Rewriting is forced by default. Use setForceRewrite() to disable it so applyChanges() skips files without pending
+ *   changes.
+ * - The check is conservative: Obtaining mutable access to the fields of a tag (e.g. via FieldMapBasedTag::fields())
+ *   is considered a modification. See Tag::isModified(), AbstractTrack::isModified(), AbstractAttachment::isModified()
+ *   and AbstractContainer::isModified() for details.
+ * - Returns true if tags or tracks have not been parsed yet as it can not be determined in this case.
+ */
+bool MediaFileInfo::hasPendingChanges() const
+{
+    if (isForcingRewrite() || !m_saveFilePath.empty() || m_tagsParsingStatus == ParsingStatus::NotParsedYet
+        || m_tracksParsingStatus == ParsingStatus::NotParsedYet) {
+        return true;
+    }
+
+    // check whether tags, tracks or attachments have been added or removed
+    const auto tags = this->tags();
+    const auto tracks = this->tracks();
+    const auto attachments = this->attachments();
+    if (tags.size() != m_p->parsedTagCount || tracks.size() != m_p->parsedTrackCount || attachments.size() != m_p->parsedAttachmentCount) {
+        return true;
+    }
+
+    // check whether the objects themselves have been modified
+    const auto isModified = [](const auto *object) { return object->isModified(); };
+    if ((m_container && m_container->isModified()) || std::any_of(tags.cbegin(), tags.cend(), isModified)
+        || std::any_of(tracks.cbegin(), tracks.cend(), isModified) || std::any_of(attachments.cbegin(), attachments.cend(), isModified)) {
+        return true;
+    }
+
+    // check whether padding and element positions satisfy the settings
+    return isViolatingLayoutSettings();
+}
+
+/*!
+ * \brief Internally used by hasPendingChanges() to check whether the present padding or element positions do not satisfy
+ *        the settings and would therefore be altered when applying changes.
+ */
+bool MediaFileInfo::isViolatingLayoutSettings() const
+{
+    // check padding
+    // note: Ogg files are always rewritten without padding. Files without container are only altered at the beginning if
+    //       ID3v2 tags or FLAC metadata are involved (see makeMp3File()).
+    const auto isPaddingRelevant = m_container
+        ? m_containerFormat != ContainerFormat::Ogg
+        : (!m_id3v2Tags.empty() || !m_actualId3v2TagOffsets.empty() || m_containerFormat == ContainerFormat::Flac);
+    if (isPaddingRelevant) {
+        if (m_container && !m_p->paddingSizeDetermined) {
+            // assume the padding is not acceptable if it could not be determined unless any padding is acceptable
+            if (m_minPadding || m_maxPadding != std::numeric_limits<std::size_t>::max()) {
+                return true;
+            }
+        } else if (m_paddingSize < m_minPadding || m_paddingSize > m_maxPadding) {
+            return true;
+        }
+    }
+
+    // check element positions
+    if (!m_container) {
+        return false;
+    }
+    auto diag = Diagnostics();
+    const auto isViolated = [](bool forced, ElementPosition expected, ElementPosition actual) {
+        return forced && expected != ElementPosition::Keep && actual != ElementPosition::Keep && expected != actual;
+    };
+    switch (m_containerFormat) {
+    case ContainerFormat::Mp4:
+    case ContainerFormat::QuickTime:
+        // tags and index are both stored within the "moov"-atom; the tag position has priority (see Mp4Container::internalMakeFile())
+        return forceTagPosition() ? isViolated(true, m_tagPosition, m_container->determineIndexPosition(diag))
+                                  : isViolated(forceIndexPosition(), m_indexPosition, m_container->determineIndexPosition(diag));
+    default:
+        return (m_container->tagCount() && isViolated(forceTagPosition(), m_tagPosition, m_container->determineTagPosition(diag)))
+            || isViolated(forceIndexPosition(), m_indexPosition, m_container->determineIndexPosition(diag));
+    }
+}
+
 /*!
  * \brief Returns the abbreviation of the container format.
  *
@@ -1391,6 +1536,131 @@ void MediaFileInfo::clearParsingResults()
     m_fileStructureFlags = MediaFileStructureFlags::None;
     m_container.reset();
     m_singleTrack.reset();
+    m_p->parsedTagCount = m_p->parsedTrackCount = m_p->parsedAttachmentCount = 0;
+    m_p->paddingSizeDetermined = false;
+}
+
+/*!
+ * \brief Returns the filter specifying which tag fields are decoded when parsing tags.
+ * \sa setTagFieldFilter()
+ */
+const TagFieldFilter &MediaFileInfo::tagFieldFilter() const
+{
+    return m_p->tagFieldFilter;
+}
+
+/*!
+ * \brief Sets the filter specifying which tag fields are decoded when parsing tags.
+ *
+ * Fields not accepted by the filter are skipped without decoding their values (see TagFieldFilter). They are still
+ * preserved when applying changes. By default all fields are parsed.
+ *
+ * \remarks
+ * - Only takes effect when tags are parsed afterwards.
+ * - Currently considered for ID3v2 tags, MP4 tags, Vorbis comments (in Ogg and FLAC files) and Matroska tags.
+ */
+void MediaFileInfo::setTagFieldFilter(const TagFieldFilter &filter)
+{
+    m_p->tagFieldFilter = filter;
+}
+
+/*!
+ * \brief Returns whether I/O statistics are recorded.
+ * \sa setIoStatisticsEnabled()
+ */
+bool MediaFileInfo::isIoStatisticsEnabled() const
+{
+    return m_p->ioStatisticsRecorder != nullptr;
+}
+
+/*!
+ * \brief Sets whether I/O statistics are recorded.
+ *
+ * When enabled, the bytes read and written as well as the number of reads, writes and seeks on stream() are counted
+ * per phase (see IoPhase) along with the time spent. When applying changes, I/O on the backup file is counted as well.
+ * The statistics can be obtained via ioStatistics().
+ *
+ * \remarks
+ * - Statistics are disabled by default. Then stream() is not altered at all so there is no overhead.
+ * - To record statistics, the buffer of stream() is wrapped so reads, writes and seeks are passed through one additional
+ *   virtual call each. The buffering of the file itself is not altered.
+ * - Disabling discards the statistics recorded so far.
+ * - Streams opened for additional threads (e.g. by MatroskaContainer::generateTrackStatistics()) are not counted.
+ */
+void MediaFileInfo::setIoStatisticsEnabled(bool enabled)
+{
+    if (!enabled) {
+        m_p->ioStatisticsRecorder.reset();
+    } else if (!m_p->ioStatisticsRecorder) {
+        m_p->ioStatisticsRecorder = std::make_unique<IoStatisticsRecorder>(stream());
+    }
+}
+
+/*!
+ * \brief Returns the I/O statistics recorded so far.
+ * \remarks Returns zeroed statistics if statistics are disabled.
+ * \sa setIoStatisticsEnabled()
+ */
+IoStatistics MediaFileInfo::ioStatistics() const
+{
+    return m_p->ioStatisticsRecorder ? m_p->ioStatisticsRecorder->statistics() : IoStatistics();
+}
+
+/*!
+ * \brief Resets the I/O statistics recorded so far to zero.
+ */
+void MediaFileInfo::resetIoStatistics()
+{
+    if (m_p->ioStatisticsRecorder) {
+        m_p->ioStatisticsRecorder->statistics() = IoStatistics();
+    }
+}
+
+/*!
+ * \brief Ensures I/O on stream() and the specified \a backupStream is accounted to the I/O statistics of the current instance.
+ * \remarks
+ * - Called by the container implementations (which are friends for this reason) after (re)opening streams within
+ *   applyChanges(). Re-attaching to stream() is required in case its buffer has been replaced when reopening it
+ *   (NativeFileStream does this when c++utilities has been built to use its own file buffer).
+ * - Does nothing if statistics are disabled. \a backupStream is only considered when called within applyChanges() and
+ *   must not be used anymore after applyChanges() has returned.
+ */
+void MediaFileInfo::attachIoStatistics(std::ios *backupStream)
+{
+    if (auto &recorder = m_p->ioStatisticsRecorder) {
+        recorder->attach();
+        if (backupStream) {
+            recorder->attachSecondary(*backupStream);
+        }
+    }
+}
+
+/*!
+ * \brief Returns an estimation of the memory held by the parsing results of the current instance.
+ * \remarks
+ * - Breaks down the memory held by element trees, tracks and their sample tables, tags and their values, attachments
+ *   and Ogg pages. See MemoryUsage for details about how the numbers are determined.
+ * - The objects of the container and the single track themselves are not included (only the memory they hold).
+ * - Useful to find out what causes high memory usage when processing big files or many files at once.
+ */
+MemoryUsage MediaFileInfo::memoryUsage() const
+{
+    auto usage = MemoryUsage();
+    if (m_container) {
+        m_container->addMemoryUsage(usage);
+    }
+    if (m_singleTrack) {
+        m_singleTrack->addMemoryUsage(usage);
+    }
+    if (m_id3v1Tag) {
+        usage.tags += sizeof(Id3v1Tag);
+        m_id3v1Tag->addMemoryUsage(usage);
+    }
+    usage.tags += MemoryUsage::ofVector(m_id3v2Tags) + m_id3v2Tags.size() * sizeof(Id3v2Tag);
+    for (const auto &tag : m_id3v2Tags) {
+        tag->addMemoryUsage(usage);
+    }
+    return usage;
 }
 
 /*!
@@ -1653,20 +1923,61 @@ void MediaFileInfo::invalidated()
     clearParsingResults();
 }
 
+/*!
+ * \brief Ensures tags and tracks have been parsed without critical errors so changes can be applied.
+ * \throws Throws InvalidDataException if that is not the case.
+ */
+void MediaFileInfo::validateParsingResultsForMaking(const std::string &context, Diagnostics &diag) const
+{
+    bool previousParsingSuccessful = true;
+    switch (tagsParsingStatus()) {
+    case ParsingStatus::Ok:
+    case ParsingStatus::NotSupported:
+        break;
+    default:
+        previousParsingSuccessful = false;
+        diag.emplace_back(DiagLevel::Critical, "Tags have to be parsed without critical errors before changes can be applied.", context);
+    }
+    switch (tracksParsingStatus()) {
+    case ParsingStatus::Ok:
+    case ParsingStatus::NotSupported:
+        break;
+    default:
+        previousParsingSuccessful = false;
+        diag.emplace_back(DiagLevel::Critical, "Tracks have to be parsed without critical errors before changes can be applied.", context);
+    }
+    if (!previousParsingSuccessful) {
+        throw InvalidDataException();
+    }
+}
+
 /*!
  * \brief Internally used to save chanings of MP3/FLAC files and any other files which might have ID3 tags.
+ * \remarks Only determines how the file would be made if \a plan is not nullptr. In this case the function returns after
+ *          the padding has been computed and before the file is touched.
  */
-void MediaFileInfo::makeMp3File(Diagnostics &diag, AbortableProgressFeedback &progress)
+void MediaFileInfo::makeMp3File(Diagnostics &diag, AbortableProgressFeedback &progress, ChangePlan *plan)
 {
-    static const string context("making MP3/FLAC file");
+    static const auto context = DiagContext("making MP3/FLAC file");
 
     // don't rewrite the complete file if there are no ID3v2/FLAC tags present or to be written
     if (!isForcingRewrite() && m_id3v2Tags.empty() && m_actualId3v2TagOffsets.empty() && m_saveFilePath.empty()
         && m_containerFormat != ContainerFormat::Flac) {
         // alter ID3v1 tag
+        const auto hasExistingId3v1Tag = static_cast<bool>(m_fileStructureFlags & MediaFileStructureFlags::ActualExistingId3v1Tag);
+        if (plan) {
+            // only the ID3v1 tag at the end of the file is updated, added or removed
+            if (m_id3v1Tag || hasExistingId3v1Tag) {
+                plan->strategy = ChangeStrategy::InPlace;
+                plan->newPadding = m_paddingSize;
+                plan->bytesToWrite = m_id3v1Tag ? 128 : 0;
+                plan->newSize = size() - (hasExistingId3v1Tag ? 128 : 0) + plan->bytesToWrite;
+            }
+            return;
+        }
         if (!m_id3v1Tag) {
             // remove ID3v1 tag
-            if (!(m_fileStructureFlags & MediaFileStructureFlags::ActualExistingId3v1Tag)) {
+            if (!hasExistingId3v1Tag) {
                 diag.emplace_back(DiagLevel::Information, "Nothing to be changed.", context);
                 return;
             }
@@ -1683,7 +1994,7 @@ void MediaFileInfo::makeMp3File(Diagnostics &diag, AbortableProgressFeedback &pr
             return;
         } else {
             // add or update ID3v1 tag
-            if (m_fileStructureFlags & MediaFileStructureFlags::ActualExistingId3v1Tag) {
+            if (hasExistingId3v1Tag) {
                 progress.updateStep("Updating existing ID3v1 tag ...");
                 // ensure the file is still open / not readonly
                 open();
@@ -1776,6 +2087,23 @@ void MediaFileInfo::makeMp3File(Diagnostics &diag, AbortableProgressFeedback &pr
         // can not be used for additional meta data
         padding += 4;
     }
+
+    // determine media data size
+    auto mediaDataSize = size() - streamOffset;
+    if (m_fileStructureFlags & MediaFileStructureFlags::ActualExistingId3v1Tag) {
+        mediaDataSize -= 128;
+    }
+
+    // return the plan if only planning
+    if (plan) {
+        plan->strategy = rewriteRequired ? ChangeStrategy::Rewrite : ChangeStrategy::InPlace;
+        plan->newPadding = padding;
+        plan->bytesToCopy = rewriteRequired ? mediaDataSize : 0;
+        plan->bytesToWrite = tagsSize + padding + plan->bytesToCopy + (m_id3v1Tag ? 128 : 0);
+        plan->newSize = tagsSize + padding + mediaDataSize + (m_id3v1Tag ? 128 : 0);
+        plan->tagPosition = ElementPosition::BeforeData;
+        return;
+    }
     progress.updateStep(rewriteRequired ? "Preparing streams for rewriting ..." : "Preparing streams for updating ...");
 
     // setup stream(s) for writing
@@ -1819,6 +2147,7 @@ void MediaFileInfo::makeMp3File(Diagnostics &diag, AbortableProgressFeedback &pr
             throw;
         }
     }
+    attachIoStatistics(rewriteRequired ? &backupStream : nullptr);
     // TODO: fix code duplication
 
     // start actual writing
@@ -1863,12 +2192,6 @@ void MediaFileInfo::makeMp3File(Diagnostics &diag, AbortableProgressFeedback &pr
         }
 
         // copy / skip actual stream data
-        // -> determine media data size
-        std::uint64_t mediaDataSize = size() - streamOffset;
-        if (m_fileStructureFlags & MediaFileStructureFlags::ActualExistingId3v1Tag) {
-            mediaDataSize -= 128;
-        }
-
         if (rewriteRequired) {
             // copy data from original file
             switch (m_containerFormat) {
@@ -1880,8 +2203,14 @@ void MediaFileInfo::makeMp3File(Diagnostics &diag, AbortableProgressFeedback &pr
             }
             backupStream.seekg(static_cast<streamoff>(streamOffset));
             CopyHelper<0x4000> copyHelper;
-            copyHelper.callbackCopy(backupStream, stream(), mediaDataSize, std::bind(&AbortableProgressFeedback::isAborted, std::ref(progress)),
-                std::bind(&AbortableProgressFeedback::updateStepPercentage, std::ref(progress), _1));
+            auto counter = ProgressCounter(progress, mediaDataSize);
+            copyHelper.callbackCopy(
+                backupStream, stream(), mediaDataSize, [&counter] { return counter.isAborted(); },
+                [&counter](double fraction) {
+                    counter.set(static_cast<std::uint64_t>(fraction * static_cast<double>(counter.total())));
+                    counter.report();
+                });
+            counter.reportNow();
         } else {
             // just skip actual stream data
             outputStream.seekp(static_cast<std::streamoff>(mediaDataSize), ios_base::cur);
@@ -3,6 +3,8 @@
 
 #include "./abstractcontainer.h"
 #include "./basicfileinfo.h"
+#include "./iostatistics.h"
+#include "./memoryusage.h"
 #include "./settings.h"
 #include "./signature.h"
 
@@ -27,6 +29,7 @@ class EbmlElement;
 class MatroskaTag;
 class AbstractTrack;
 class VorbisComment;
+class TagFieldFilter;
 class Diagnostics;
 class AbortableProgressFeedback;
 
@@ -69,6 +72,8 @@ enum class MediaFileHandlingFlags : std::uint64_t {
     ConvertTotalFields = (1 << 11), /**< ensures fields usually holding PositionInSet values such as KnownField::TrackPosition are actually
         stored as such (and *not* as two separate fields for the position and total values); currently only relevant for Vorbis Comments
         \sa VorbisCommentFlags::ConvertTotalFields  */
+    LoadPicturesLazily = (1 << 12), /**< defers reading the data of pictures from ID3v2 tags, FLAC "METADATA_BLOCK_PICTURE" and MP4 tags
+        until it is accessed; the MediaFileInfo must be kept alive as long as such data is accessed \sa TagValue::assignLazyData() */
 };
 
 } // namespace TagParser
@@ -81,6 +86,10 @@ namespace TagParser {
 struct MediaFileInfoPrivate;
 
 class TAG_PARSER_EXPORT MediaFileInfo : public BasicFileInfo {
+    friend class MatroskaContainer;
+    friend class Mp4Container;
+    friend class OggContainer;
+
 public:
     // constructor, destructor
     explicit MediaFileInfo();
@@ -100,6 +109,8 @@ public:
 
     // methods to apply changes
     void applyChanges(Diagnostics &diag, AbortableProgressFeedback &progress);
+    bool hasPendingChanges() const;
+    ChangePlan planChanges(Diagnostics &diag, AbortableProgressFeedback &progress);
 
     // methods to get parsed information regarding ...
     // ... the container
@@ -195,6 +206,13 @@ public:
     void setForceIndexPosition(bool forceTagPosition);
     std::uint64_t maxFullParseSize() const;
     void setMaxFullParseSize(std::uint64_t maxFullParseSize);
+    const TagFieldFilter &tagFieldFilter() const;
+    void setTagFieldFilter(const TagFieldFilter &filter);
+    bool isIoStatisticsEnabled() const;
+    void setIoStatisticsEnabled(bool enabled);
+    IoStatistics ioStatistics() const;
+    void resetIoStatistics();
+    MemoryUsage memoryUsage() const;
 
     // helper functions
     static void writePadding(std::ostream &outputStream, uint64_t size);
@@ -203,10 +221,15 @@ protected:
     void invalidated() override;
 
 private:
+    // private methods internally used by the container implementations when applying changes
+    void attachIoStatistics(std::ios *backupStream = nullptr);
+
     // private methods internally used when rewriting the file to apply new tag information
     // currently only the makeMp3File() methods is present; corresponding methods for
     // other formats are outsourced to container classes
-    void makeMp3File(Diagnostics &diag, AbortableProgressFeedback &progress);
+    void validateParsingResultsForMaking(const std::string &context, Diagnostics &diag) const;
+    bool isViolatingLayoutSettings() const;
+    void makeMp3File(Diagnostics &diag, AbortableProgressFeedback &progress, ChangePlan *plan);
 
     // fields related to the container
     ParsingStatus m_containerParsingStatus;
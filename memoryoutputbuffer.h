@@ -0,0 +1,81 @@
+#ifndef TAG_PARSER_MEMORYOUTPUTBUFFER_H
+#define TAG_PARSER_MEMORYOUTPUTBUFFER_H
+
+#include <cstddef>
+#include <ios>
+#include <streambuf>
+
+namespace TagParser {
+
+/// \cond
+
+/*!
+ * \brief The MemoryOutputBuffer class is a std::streambuf writing into a fixed, caller-supplied memory range.
+ * \remarks Used by the tag makers to render a tag into contiguous memory by reusing their stream-based code. Writing beyond
+ *          the end of the range fails (so a std::ostream with exceptions enabled throws std::ios_base::failure). Seeking
+ *          within the range is supported.
+ */
+class MemoryOutputBuffer : public std::streambuf {
+public:
+    explicit MemoryOutputBuffer(char *buffer, std::size_t size);
+    std::size_t writtenSize() const;
+
+protected:
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override;
+    pos_type seekpos(pos_type pos, std::ios_base::openmode which) override;
+};
+
+/*!
+ * \brief Constructs a new buffer writing into the \a size bytes starting at \a buffer.
+ */
+inline MemoryOutputBuffer::MemoryOutputBuffer(char *buffer, std::size_t size)
+{
+    setp(buffer, buffer + size);
+}
+
+/*!
+ * \brief Returns the number of bytes between the begin of the memory range and the current write position.
+ */
+inline std::size_t MemoryOutputBuffer::writtenSize() const
+{
+    return static_cast<std::size_t>(pptr() - pbase());
+}
+
+inline MemoryOutputBuffer::pos_type MemoryOutputBuffer::seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which)
+{
+    if (!(which & std::ios_base::out)) {
+        return pos_type(off_type(-1));
+    }
+    switch (dir) {
+    case std::ios_base::cur:
+        off += pptr() - pbase();
+        break;
+    case std::ios_base::end:
+        off += epptr() - pbase();
+        break;
+    default:;
+    }
+    return seekpos(pos_type(off), which);
+}
+
+inline MemoryOutputBuffer::pos_type MemoryOutputBuffer::seekpos(pos_type pos, std::ios_base::openmode which)
+{
+    const auto off = static_cast<off_type>(pos);
+    if (!(which & std::ios_base::out) || off < 0 || off > epptr() - pbase()) {
+        return pos_type(off_type(-1));
+    }
+    // pbump() takes an int so advance in steps to support ranges exceeding INT_MAX
+    setp(pbase(), epptr());
+    for (auto remaining = off; remaining;) {
+        const auto step = static_cast<int>(remaining > 0x40000000 ? 0x40000000 : remaining);
+        pbump(step);
+        remaining -= step;
+    }
+    return pos;
+}
+
+/// \endcond
+
+} // namespace TagParser
+
+#endif // TAG_PARSER_MEMORYOUTPUTBUFFER_H
@@ -0,0 +1,50 @@
+#include "./memoryusage.h"
+
+#include <functional>
+#include <numeric>
+
+using namespace std;
+
+namespace TagParser {
+
+/*!
+ * \brief Returns the sum of all categories (excluding elementCount which is not a number of bytes).
+ */
+std::size_t MemoryUsage::total() const
+{
+    return elementNodes + elementBuffers + tracks + sampleTables + tags + tagValuesTotal() + attachments + oggPages;
+}
+
+/*!
+ * \brief Returns the memory held by the data of tag values of all types.
+ */
+std::size_t MemoryUsage::tagValuesTotal() const
+{
+    return std::accumulate(tagValues.cbegin(), tagValues.cend(), std::size_t());
+}
+
+/*!
+ * \brief Returns the heap memory held by the specified \a string.
+ * \remarks Returns zero if the string is stored inline (small string optimization).
+ */
+std::size_t MemoryUsage::ofString(const std::string &string)
+{
+    const auto *const data = string.data();
+    const auto *const object = reinterpret_cast<const char *>(&string);
+    const auto isInline = std::less_equal<const char *>()(object, data) && std::less<const char *>()(data, object + sizeof(std::string));
+    return isInline ? 0 : string.capacity() + 1;
+}
+
+/*!
+ * \brief Returns the heap memory held by the specified \a locale.
+ */
+std::size_t MemoryUsage::ofLocale(const Locale &locale)
+{
+    auto usage = ofVector(locale);
+    for (const auto &detail : locale) {
+        usage += ofString(detail);
+    }
+    return usage;
+}
+
+} // namespace TagParser
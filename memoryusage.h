@@ -0,0 +1,111 @@
+#ifndef TAG_PARSER_MEMORYUSAGE_H
+#define TAG_PARSER_MEMORYUSAGE_H
+
+#include "./tagvalue.h"
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace TagParser {
+
+/// \cond
+/*!
+ * \brief Returns the position of \a dataType within TagDataType.
+ * \remarks Lists every value without a default case so -Wswitch flags values added to TagDataType but not here. Such
+ *          values need to be taken into account by tagDataTypeCount and the static_assert below as well.
+ */
+constexpr std::size_t tagDataTypeIndex(TagDataType dataType)
+{
+    switch (dataType) {
+    case TagDataType::Text:
+    case TagDataType::Integer:
+    case TagDataType::PositionInSet:
+    case TagDataType::StandardGenreIndex:
+    case TagDataType::TimeSpan:
+    case TagDataType::DateTime:
+    case TagDataType::Picture:
+    case TagDataType::Binary:
+    case TagDataType::Undefined:
+    case TagDataType::Popularity:
+    case TagDataType::UnsignedInteger:
+    case TagDataType::DateTimeExpression:
+        return static_cast<std::size_t>(dataType);
+    }
+    return static_cast<std::size_t>(-1);
+}
+/// \endcond
+
+/// \brief The number of values within TagDataType.
+constexpr std::size_t tagDataTypeCount = static_cast<std::size_t>(TagDataType::DateTimeExpression) + 1;
+
+static_assert(tagDataTypeIndex(TagDataType::DateTimeExpression) == tagDataTypeCount - 1 && tagDataTypeCount == 12,
+    "tagDataTypeCount must be updated when values are added to TagDataType");
+
+/*!
+ * \brief The MemoryUsage struct breaks down the memory held by a MediaFileInfo and the objects it owns.
+ *
+ * The numbers are estimations in bytes based on the sizes of the objects, the capacities of containers and strings and
+ * the sizes of heap-allocated buffers. Overhead of the allocator is not taken into account.
+ *
+ * \sa MediaFileInfo::memoryUsage()
+ */
+struct TAG_PARSER_EXPORT MemoryUsage {
+    std::size_t total() const;
+    std::size_t tagValuesTotal() const;
+    std::size_t &tagValuesOfType(TagDataType type);
+    std::size_t tagValuesOfType(TagDataType type) const;
+
+    static std::size_t ofString(const std::string &string);
+    static std::size_t ofLocale(const Locale &locale);
+    template <typename Element> static std::size_t ofVector(const std::vector<Element> &vector);
+
+    /// \brief The number of nodes within element trees (e.g. EbmlElement and Mp4Atom objects).
+    std::size_t elementCount = 0;
+    /// \brief The memory held by the nodes of element trees themselves.
+    std::size_t elementNodes = 0;
+    /// \brief The memory held by buffered elements (see GenericFileElement::makeBuffer()).
+    std::size_t elementBuffers = 0;
+    /// \brief The memory held by track objects (excluding sample tables).
+    std::size_t tracks = 0;
+    /// \brief The memory held by sample tables of tracks (e.g. the sample sizes of Mp4Track).
+    std::size_t sampleTables = 0;
+    /// \brief The memory held by tag objects and their fields (excluding the data of the values).
+    std::size_t tags = 0;
+    /// \brief The memory held by the data of tag values (including descriptions and MIME types) by TagDataType.
+    /// \remarks Data which is loaded lazily (see TagValue::loadData()) is only accounted once it has been loaded.
+    std::array<std::size_t, tagDataTypeCount> tagValues = {};
+    /// \brief The memory held by attachments, including their data if it has been buffered.
+    std::size_t attachments = 0;
+    /// \brief The memory held by the pages of Ogg files and their segment tables.
+    std::size_t oggPages = 0;
+};
+
+/*!
+ * \brief Returns the memory held by values of the specified \a type.
+ */
+inline std::size_t &MemoryUsage::tagValuesOfType(TagDataType type)
+{
+    return tagValues[static_cast<std::size_t>(type)];
+}
+
+/*!
+ * \brief Returns the memory held by values of the specified \a type.
+ */
+inline std::size_t MemoryUsage::tagValuesOfType(TagDataType type) const
+{
+    return tagValues[static_cast<std::size_t>(type)];
+}
+
+/*!
+ * \brief Returns the heap memory held by the specified \a vector (not including memory held by the elements themselves).
+ */
+template <typename Element> inline std::size_t MemoryUsage::ofVector(const std::vector<Element> &vector)
+{
+    return vector.capacity() * sizeof(Element);
+}
+
+} // namespace TagParser
+
+#endif // TAG_PARSER_MEMORYUSAGE_H
@@ -60,7 +60,7 @@ string Mp4Atom::parsingContext() const
  */
 void Mp4Atom::internalParse(Diagnostics &diag)
 {
-    static const string context("parsing MP4 atom");
+    static const auto context = DiagContext("parsing MP4 atom");
     if (maxTotalSize() < minimumElementSize()) {
         diag.emplace_back(DiagLevel::Critical,
             argsToString("Atom is smaller than 8 byte and hence invalid. The remaining size within the parent atom is ", maxTotalSize(), '.'),
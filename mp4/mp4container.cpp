@@ -93,7 +93,7 @@ void Mp4Container::internalParseHeader(Diagnostics &diag, AbortableProgressFeedb
 void Mp4Container::internalParseTags(Diagnostics &diag, AbortableProgressFeedback &progress)
 {
     CPP_UTILITIES_UNUSED(progress)
-    const string context("parsing tags of MP4 container");
+    static const auto context = DiagContext("parsing tags of MP4 container");
     auto *const udtaAtom = firstElement()->subelementByPath(diag, Mp4AtomIds::Movie, Mp4AtomIds::UserData);
     if (!udtaAtom) {
         return;
@@ -104,7 +104,7 @@ void Mp4Container::internalParseTags(Diagnostics &diag, AbortableProgressFeedbac
         metaAtom->parse(diag);
         m_tags.emplace_back(make_unique<Mp4Tag>());
         try {
-            m_tags.back()->parse(*metaAtom, diag);
+            m_tags.back()->parse(*metaAtom, diag, &fileInfo().tagFieldFilter());
         } catch (const NoDataFoundException &) {
             m_tags.pop_back();
         }
@@ -122,7 +122,7 @@ void Mp4Container::internalParseTags(Diagnostics &diag, AbortableProgressFeedbac
 
 void Mp4Container::internalParseTracks(Diagnostics &diag, AbortableProgressFeedback &progress)
 {
-    static const string context("parsing tracks of MP4 container");
+    static const auto context = DiagContext("parsing tracks of MP4 container");
     try {
         // get moov atom which holds track information
         if (Mp4Atom *moovAtom = firstElement()->siblingByIdIncludingThis(Mp4AtomIds::Movie, diag)) {
@@ -222,7 +222,22 @@ void Mp4Container::internalParseTracks(Diagnostics &diag, AbortableProgressFeedb
 
 void Mp4Container::internalMakeFile(Diagnostics &diag, AbortableProgressFeedback &progress)
 {
-    static const string context("making MP4 container");
+    makeOrPlanFile(diag, progress, nullptr);
+}
+
+void Mp4Container::internalPlanChanges(ChangePlan &plan, Diagnostics &diag, AbortableProgressFeedback &progress)
+{
+    makeOrPlanFile(diag, progress, &plan);
+}
+
+/*!
+ * \brief Makes the file or only determines how the file would be made if \a plan is not nullptr.
+ * \remarks When planning, the function returns after the layout has been computed and before the file is touched. Changes
+ *          made to the chunk offset tables in order to compute the layout are reverted in this case.
+ */
+void Mp4Container::makeOrPlanFile(Diagnostics &diag, AbortableProgressFeedback &progress, ChangePlan *plan)
+{
+    static const auto context = DiagContext("making MP4 container");
     progress.updateStep("Calculating atom sizes and padding ...");
 
     // basic validation of original file
@@ -266,6 +281,8 @@ void Mp4Container::internalMakeFile(Diagnostics &diag, AbortableProgressFeedback
     const auto trackCount = this->trackCount();
     // -> media size of original file
     auto mediaSize = std::uint64_t();
+    // -> tracks which chunk offset tables have been converted to 64-bit (to revert this when only planning)
+    auto convertedChunkOffsetTables = std::vector<std::pair<Mp4Track *, unsigned int>>();
 
     // find relevant atoms in original file and determine media size
     Mp4Atom *fileTypeAtom, *progressiveDownloadInfoAtom, *movieAtom, *firstMediaDataAtom, *firstMovieFragmentAtom /*, *userDataAtom*/;
@@ -518,10 +535,9 @@ calculatePadding:
     if (auto changedChunkOffsetSize = false; currentOffset > std::numeric_limits<std::uint32_t>::max()) {
         for (auto &track : tracks()) {
             if (track->chunkOffsetSize() < 8) {
-                diag.emplace_back(DiagLevel::Information,
-                    argsToString("Chunk offset table of track ", track->id(), " will not fit new offsets (up to ", currentOffset,
-                        "). It will be converted to 64-bit."),
-                    context);
+                diag.emplaceFormatted(DiagLevel::Information, context, "Chunk offset table of track ", track->id(),
+                    " will not fit new offsets (up to ", currentOffset, "). It will be converted to 64-bit.");
+                convertedChunkOffsetTables.emplace_back(track.get(), track->chunkOffsetSize());
                 track->setChunkOffsetSize(8);
                 changedChunkOffsetSize = true;
             }
@@ -531,6 +547,31 @@ calculatePadding:
         }
     }
 
+    // return the plan if only planning
+    if (plan) {
+        const auto tagsAfterData = newTagPos == ElementPosition::AfterData;
+        if (rewriteRequired) {
+            plan->strategy = ChangeStrategy::Rewrite;
+            plan->newPadding = newPadding;
+            plan->bytesToCopy = mediaSize;
+            plan->newSize = currentOffset + (tagsAfterData ? movieAtomSize : 0);
+            plan->bytesToWrite = plan->newSize;
+        } else {
+            // media data is kept at its offset; everything before it and the movie atom (if placed after it) is written
+            const auto mediaDataOffset = currentOffset - mediaSize;
+            const auto mediaDataEndOffset = lastAtomToBeWritten ? lastAtomToBeWritten->endOffset() : mediaDataOffset;
+            plan->strategy = ChangeStrategy::InPlace;
+            plan->newPadding = newPadding + newPaddingEnd;
+            plan->newSize = mediaDataEndOffset + (tagsAfterData ? movieAtomSize : 0);
+            plan->bytesToWrite = mediaDataOffset + (tagsAfterData ? movieAtomSize : 0);
+        }
+        plan->tagPosition = plan->indexPosition = newTagPos;
+        for (const auto &[track, chunkOffsetSize] : convertedChunkOffsetTables) {
+            track->setChunkOffsetSize(chunkOffsetSize);
+        }
+        return;
+    }
+
     // setup stream(s) for writing
     // -> update status
     progress.nextStepOrStop("Preparing streams ...");
@@ -568,6 +609,7 @@ calculatePadding:
 
         // set backup stream as associated input stream since we need the original elements to write the new file
         setStream(backupStream);
+        fileInfo().attachIoStatistics(&backupStream);
 
         // TODO: reduce code duplication
 
@@ -576,6 +618,18 @@ calculatePadding:
         for (const auto &track : tracks()) {
             track->bufferTrackAtoms(diag);
         }
+        // ensure lazily loaded pictures and skipped fields are read before altering the source file as well
+        for (const auto &tag : m_tags) {
+            for (const auto &field : tag->fields()) {
+                field.second.value().loadData();
+                for (const auto &additionalData : field.second.additionalData()) {
+                    additionalData.value.loadData();
+                }
+            }
+            for (const auto &skippedField : tag->skippedFields()) {
+                skippedField.second.loadData();
+            }
+        }
 
         // reopen original file to ensure it is opened for writing
         try {
@@ -585,6 +639,7 @@ calculatePadding:
             diag.emplace_back(DiagLevel::Critical, argsToString("Opening the file with write permissions failed: ", failure.what()), context);
             throw;
         }
+        fileInfo().attachIoStatistics();
     }
 
     // start actual writing
@@ -776,7 +831,8 @@ calculatePadding:
 
                         // -> copy chunks
                         CopyHelper<0x2000> copyHelper;
-                        std::uint64_t chunkIndexWithinTrack = 0, totalChunksCopied = 0;
+                        std::uint64_t chunkIndexWithinTrack = 0;
+                        auto copiedChunks = ProgressCounter(progress, totalChunkCount);
                         bool anyChunksCopied;
                         do {
                             progress.stopIfAborted();
@@ -799,16 +855,16 @@ calculatePadding:
 
                                     // update counter / status
                                     anyChunksCopied = true;
-                                    ++totalChunksCopied;
+                                    copiedChunks.add();
                                 }
                             }
 
                             // incrase chunk index within track, update progress percentage
-                            if (!(++chunkIndexWithinTrack % 10)) {
-                                progress.updateStepPercentage(static_cast<std::uint8_t>(totalChunksCopied * 100 / totalChunkCount));
-                            }
+                            ++chunkIndexWithinTrack;
+                            copiedChunks.report();
 
                         } while (anyChunksCopied);
+                        copiedChunks.reportNow();
                     }
 
                 } else {
@@ -937,7 +993,7 @@ void Mp4Container::updateOffsets(const std::vector<std::int64_t> &oldMdatOffsets
     AbortableProgressFeedback &progress)
 {
     // do NOT invalidate the status here since this method is internally called by internalMakeFile(), just update the status
-    const string context("updating MP4 container chunk offset table");
+    static const auto context = DiagContext("updating MP4 container chunk offset table");
     if (!firstElement()) {
         diag.emplace_back(DiagLevel::Critical, "No MP4 atoms could be found.", context);
         throw InvalidDataException();
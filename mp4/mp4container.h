@@ -33,8 +33,10 @@ protected:
     void internalParseTags(Diagnostics &diag, AbortableProgressFeedback &progress) override;
     void internalParseTracks(Diagnostics &diag, AbortableProgressFeedback &progress) override;
     void internalMakeFile(Diagnostics &diag, AbortableProgressFeedback &progress) override;
+    void internalPlanChanges(ChangePlan &plan, Diagnostics &diag, AbortableProgressFeedback &progress) override;
 
 private:
+    void makeOrPlanFile(Diagnostics &diag, AbortableProgressFeedback &progress, ChangePlan *plan);
     void updateOffsets(const std::vector<std::int64_t> &oldMdatOffsets, const std::vector<std::int64_t> &newMdatOffsets, Diagnostics &diag,
         AbortableProgressFeedback &progress);
 
@@ -3,11 +3,16 @@
 #include "./mp4container.h"
 #include "./mp4ids.h"
 
+#include "../abstractattachment.h"
 #include "../exceptions.h"
+#include "../memoryoutputbuffer.h"
+#include "../tagfieldfilter.h"
 
 #include <c++utilities/conversion/stringconversion.h>
 #include <c++utilities/io/binarywriter.h>
 
+#include <memory>
+
 using namespace std;
 using namespace CppUtilities;
 
@@ -291,9 +296,11 @@ bool Mp4Tag::setValue(KnownField field, const TagValue &value)
         switch (value.type()) {
         case TagDataType::StandardGenreIndex:
             fields().erase(Mp4TagAtomIds::Genre);
+            skippedFields().erase(Mp4TagAtomIds::Genre);
             return FieldMapBasedTag<Mp4Tag>::setValue(Mp4TagAtomIds::PreDefinedGenre, value);
         default:
             fields().erase(Mp4TagAtomIds::PreDefinedGenre);
+            skippedFields().erase(Mp4TagAtomIds::PreDefinedGenre);
             return FieldMapBasedTag<Mp4Tag>::setValue(Mp4TagAtomIds::Genre, value);
         }
     case KnownField::EncoderSettings:
@@ -329,15 +336,15 @@ bool Mp4Tag::setValues(KnownField field, const std::vector<TagValue> &values)
                 ++valuesIterator;
             }
         }
+        for (; range.first != range.second; ++range.first) {
+            range.first->second.clearValue();
+        }
         for (; valuesIterator != values.cend(); ++valuesIterator) {
             if (valuesIterator->isEmpty()) {
                 fields().emplace(std::piecewise_construct, std::forward_as_tuple(Mp4TagAtomIds::Extended),
                     std::forward_as_tuple(extendedId.mean, extendedId.name, *valuesIterator));
             }
         }
-        for (; range.first != range.second; ++range.first) {
-            range.first->second.clearValue();
-        }
     }
     return FieldMapBasedTag<Mp4Tag>::setValues(field, values);
 }
@@ -372,16 +379,34 @@ bool Mp4Tag::hasField(KnownField field) const
     }
 }
 
+/*!
+ * \brief Adds the memory held by the tag, its fields and their values (including additional data atoms) to \a usage.
+ */
+void Mp4Tag::addMemoryUsage(MemoryUsage &usage) const
+{
+    FieldMapBasedTag<Mp4Tag>::addMemoryUsage(usage);
+    for (const auto &[id, field] : fields()) {
+        usage.tags += MemoryUsage::ofString(field.mean()) + MemoryUsage::ofString(field.name()) + MemoryUsage::ofVector(field.additionalData());
+        for (const auto &additionalData : field.additionalData()) {
+            usage.tagValuesOfType(additionalData.value.type()) += additionalData.value.memoryUsage();
+        }
+    }
+}
+
 /*!
  * \brief Parses tag information from the specified \a metaAtom.
  *
+ * Atoms not accepted by the specified \a fieldFilter are not decoded. They are only added to skippedFields() referring
+ * to the raw atom within the container's stream. Extended fields ("----" atoms) are always decoded because their meaning
+ * depends on their "mean" and "name" child atoms.
+ *
  * \throws Throws std::ios_base::failure when an IO error occurs.
  * \throws Throws TagParser::Failure or a derived exception when a parsing
  *         error occurs.
  */
-void Mp4Tag::parse(Mp4Atom &metaAtom, Diagnostics &diag)
+void Mp4Tag::parse(Mp4Atom &metaAtom, Diagnostics &diag, const TagFieldFilter *fieldFilter)
 {
-    static const string context("parsing MP4 tag");
+    static const auto context = DiagContext("parsing MP4 tag");
     m_size = metaAtom.totalSize();
     istream &stream = metaAtom.container().stream();
     BinaryReader &reader = metaAtom.container().reader();
@@ -428,11 +453,21 @@ void Mp4Tag::parse(Mp4Atom &metaAtom, Diagnostics &diag)
         Mp4TagField tagField;
         try {
             child->parse(diag);
+            if (fieldFilter && child->id() != Mp4TagAtomIds::Extended && !fieldFilter->accepts(*this, child->id())) {
+                // keep a reference to the raw atom so it is preserved when making the tag
+                auto rawAtom = TagValue();
+                rawAtom.assignLazyData(make_unique<StreamDataBlock>(std::bind(&Mp4Atom::stream, child), child->startOffset(), ios_base::beg,
+                                           child->startOffset() + child->totalSize(), ios_base::beg),
+                    TagDataType::Binary);
+                skippedFields().emplace(child->id(), std::move(rawAtom));
+                continue;
+            }
             tagField.reparse(*child, diag);
             fields().emplace(child->id(), std::move(tagField));
         } catch (const Failure &) {
         }
     }
+    m_modified = false;
 }
 
 /*!
@@ -482,10 +517,12 @@ Mp4TagMaker::Mp4TagMaker(Mp4Tag &tag, Diagnostics &diag)
     m_ilstSize(8)
     ,
     // ensure there only one genre atom is written (prefer genre as string)
-    m_omitPreDefinedGenre(m_tag.fields().count(m_tag.hasField(Mp4TagAtomIds::Genre)))
+    m_omitPreDefinedGenre(m_tag.internallyGetFields().count(m_tag.hasField(Mp4TagAtomIds::Genre)))
 {
-    m_maker.reserve(m_tag.fields().size());
-    for (auto &field : m_tag.fields()) {
+    // note: The fields are accessed via internallyGetFields() so the tag is not considered modified by just making it.
+    auto &fields = m_tag.internallyGetFields();
+    m_maker.reserve(fields.size());
+    for (auto &field : fields) {
         if (!field.second.value().isEmpty() && (!m_omitPreDefinedGenre || field.first != Mp4TagAtomIds::PreDefinedGenre)) {
             try {
                 m_ilstSize += m_maker.emplace_back(field.second.prepareMaking(diag)).requiredSize();
@@ -493,6 +530,13 @@ Mp4TagMaker::Mp4TagMaker(Mp4Tag &tag, Diagnostics &diag)
             }
         }
     }
+    const auto &skippedFields = m_tag.internallyGetSkippedFields();
+    m_skippedFields.reserve(skippedFields.size());
+    for (const auto &[id, rawAtom] : skippedFields) {
+        if (!m_omitPreDefinedGenre || id != Mp4TagAtomIds::PreDefinedGenre) {
+            m_ilstSize += m_skippedFields.emplace_back(&rawAtom)->dataSize();
+        }
+    }
     if (m_ilstSize != 8) {
         m_metaSize += m_ilstSize;
     }
@@ -505,11 +549,40 @@ Mp4TagMaker::Mp4TagMaker(Mp4Tag &tag, Diagnostics &diag)
 /*!
  * \brief Saves the tag (specified when constructing the object) to the
  *        specified \a stream.
+ * \remarks The tag is rendered into a contiguous buffer first so it is written using a single write.
  * \throws Throws std::ios_base::failure when an IO error occurs.
  * \throws Throws Assumes the data is already validated and thus does NOT
  *                throw TagParser::Failure or a derived exception.
  */
 void Mp4TagMaker::make(ostream &stream, Diagnostics &diag)
+{
+    const auto size = static_cast<std::size_t>(m_metaSize);
+    const auto buffer = make_unique<char[]>(size);
+    make(buffer.get(), diag);
+    stream.write(buffer.get(), static_cast<std::streamsize>(size));
+}
+
+/*!
+ * \brief Saves the tag (specified when constructing the object) to the
+ *        specified \a buffer.
+ * \remarks The \a buffer must be at least requiredSize() bytes long.
+ * \throws Throws std::ios_base::failure when the tag does not fit into requiredSize() bytes or
+ *         when an IO error occurs while copying lazily loaded data from its source.
+ * \throws Throws Assumes the data is already validated and thus does NOT
+ *                throw TagParser::Failure or a derived exception.
+ */
+void Mp4TagMaker::make(char *buffer, Diagnostics &diag)
+{
+    MemoryOutputBuffer memoryBuffer(buffer, static_cast<std::size_t>(m_metaSize));
+    ostream stream(&memoryBuffer);
+    stream.exceptions(ios_base::failbit | ios_base::badbit);
+    internallyMake(stream, diag);
+}
+
+/*!
+ * \brief Writes the "meta" atom to the specified \a stream.
+ */
+void Mp4TagMaker::internallyMake(ostream &stream, Diagnostics &diag)
 {
     // write meta head
     BinaryWriter writer(&stream);
@@ -527,6 +600,9 @@ void Mp4TagMaker::make(ostream &stream, Diagnostics &diag)
         for (auto &maker : m_maker) {
             maker.make(stream);
         }
+        for (const auto *const rawAtom : m_skippedFields) {
+            rawAtom->copyDataTo(stream);
+        }
     } else {
         // no fields to be written -> no ilst to be written
         diag.emplace_back(DiagLevel::Warning, "Tag is empty.", "making MP4 tag");
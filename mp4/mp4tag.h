@@ -9,6 +9,7 @@ namespace TagParser {
 
 class Mp4Atom;
 class Mp4Tag;
+class TagFieldFilter;
 
 struct TAG_PARSER_EXPORT Mp4ExtendedFieldId {
     Mp4ExtendedFieldId(std::string_view mean, std::string_view name, bool updateOnly = false);
@@ -56,14 +57,17 @@ class TAG_PARSER_EXPORT Mp4TagMaker {
 
 public:
     void make(std::ostream &stream, Diagnostics &diag);
+    void make(char *buffer, Diagnostics &diag);
     const Mp4Tag &tag() const;
     std::uint64_t requiredSize() const;
 
 private:
     Mp4TagMaker(Mp4Tag &tag, Diagnostics &diag);
+    void internallyMake(std::ostream &stream, Diagnostics &diag);
 
     Mp4Tag &m_tag;
     std::vector<Mp4TagFieldMaker> m_maker;
+    std::vector<const TagValue *> m_skippedFields;
     std::uint64_t m_metaSize;
     std::uint64_t m_ilstSize;
     bool m_omitPreDefinedGenre;
@@ -92,10 +96,12 @@ template <> class TAG_PARSER_EXPORT FieldMapBasedTagTraits<Mp4Tag> {
 public:
     using FieldType = Mp4TagField;
     using Compare = std::less<typename FieldType::IdentifierType>;
+    template <typename Key, typename Value, typename KeyCompare> using Container = FlatMultiMap<Key, Value, KeyCompare>;
 };
 
 class TAG_PARSER_EXPORT Mp4Tag final : public FieldMapBasedTag<Mp4Tag> {
     friend class FieldMapBasedTag<Mp4Tag>;
+    friend class Mp4TagMaker;
 
 public:
     Mp4Tag();
@@ -119,8 +125,9 @@ public:
     using FieldMapBasedTag<Mp4Tag>::hasField;
     bool hasField(KnownField value) const override;
     bool supportsMultipleValues(KnownField) const override;
+    void addMemoryUsage(MemoryUsage &usage) const override;
 
-    void parse(Mp4Atom &metaAtom, Diagnostics &diag);
+    void parse(Mp4Atom &metaAtom, Diagnostics &diag, const TagFieldFilter *fieldFilter = nullptr);
     Mp4TagMaker prepareMaking(Diagnostics &diag);
     void make(std::ostream &stream, Diagnostics &diag);
 
@@ -3,7 +3,9 @@
 #include "./mp4container.h"
 #include "./mp4ids.h"
 
+#include "../abstractattachment.h"
 #include "../exceptions.h"
+#include "../mediafileinfo.h"
 
 #include <c++utilities/conversion/stringbuilder.h>
 #include <c++utilities/io/binaryreader.h>
@@ -112,6 +114,18 @@ void Mp4TagField::reparse(Mp4Atom &ilstChild, Diagnostics &diag)
     context = "parsing MP4 tag field " + ilstChild.idToString();
     iostream &stream = ilstChild.stream();
     BinaryReader &reader = ilstChild.container().reader();
+    const auto loadPicturesLazily = ilstChild.container().fileInfo().fileHandlingFlags() & MediaFileHandlingFlags::LoadPicturesLazily;
+    const auto assignPicture = [&](Mp4Atom &dataAtom, TagValue &value) {
+        const auto pictureOffset = dataAtom.dataOffset() + 8, pictureSize = dataAtom.dataSize() - 8;
+        if (loadPicturesLazily) {
+            value.assignLazyData(make_unique<StreamDataBlock>(
+                std::bind(&Mp4Atom::stream, &dataAtom), pictureOffset, ios_base::beg, pictureOffset + pictureSize, ios_base::beg));
+            return;
+        }
+        auto data = make_unique<char[]>(static_cast<size_t>(pictureSize));
+        stream.read(data.get(), static_cast<streamsize>(pictureSize));
+        value.assignData(std::move(data), static_cast<size_t>(pictureSize), TagDataType::Picture);
+    };
     int dataAtomFound = 0, meanAtomFound = 0, nameAtomFound = 0;
     for (Mp4Atom *dataAtom = ilstChild.firstChild(); dataAtom; dataAtom = dataAtom->nextSibling()) {
         try {
@@ -181,10 +195,7 @@ void Mp4TagField::reparse(Mp4Atom &ilstChild, Diagnostics &diag)
                         break;
                     default:;
                     }
-                    const auto coverSize = static_cast<streamoff>(dataAtom->dataSize() - 8);
-                    auto coverData = make_unique<char[]>(static_cast<size_t>(coverSize));
-                    stream.read(coverData.get(), coverSize);
-                    val->assignData(std::move(coverData), static_cast<size_t>(coverSize), TagDataType::Picture);
+                    assignPicture(*dataAtom, *val);
                     break;
                 }
                 case RawDataType::BeSignedInt: {
@@ -251,14 +262,14 @@ void Mp4TagField::reparse(Mp4Atom &ilstChild, Diagnostics &diag)
                         }
                         break;
                     default: // no supported data type, read raw data
+                        if (ilstChild.id() == Mp4TagAtomIds::Cover) {
+                            assignPicture(*dataAtom, *val);
+                            break;
+                        }
                         const auto dataSize = static_cast<streamsize>(dataAtom->dataSize() - 8);
                         auto data = make_unique<char[]>(static_cast<size_t>(dataSize));
                         stream.read(data.get(), dataSize);
-                        if (ilstChild.id() == Mp4TagAtomIds::Cover) {
-                            val->assignData(std::move(data), static_cast<size_t>(dataSize), TagDataType::Picture);
-                        } else {
-                            val->assignData(std::move(data), static_cast<size_t>(dataSize), TagDataType::Undefined);
-                        }
+                        val->assignData(std::move(data), static_cast<size_t>(dataSize), TagDataType::Undefined);
                     }
                 }
             } else if (dataAtom->id() == Mp4AtomIds::Mean) {
@@ -707,7 +718,8 @@ std::uint64_t Mp4TagFieldMaker::prepareDataAtom(
     } else if (data.convertedData.tellp()) {
         data.size = static_cast<std::size_t>(data.convertedData.tellp());
     } else {
-        data.rawData = std::string_view(value.dataPointer(), data.size = value.dataSize());
+        data.rawValue = &value;
+        data.size = value.dataSize();
     }
     return data.size += 16;
 }
@@ -755,8 +767,8 @@ void Mp4TagFieldMaker::make(ostream &stream)
             // write converted data
             stream << data.convertedData.rdbuf();
         } else {
-            // no conversion was needed, write data directly from tag value
-            stream.write(data.rawData.data(), static_cast<std::streamoff>(data.rawData.size()));
+            // no conversion was needed, write data directly from tag value (copies lazily loaded data directly from its source)
+            data.rawValue->copyDataTo(stream);
         }
     }
 }
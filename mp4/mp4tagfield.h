@@ -74,7 +74,7 @@ private:
     struct Data {
         Data();
         Data(Data &&) = default;
-        std::string_view rawData;
+        const TagValue *rawValue = nullptr;
         std::stringstream convertedData;
         std::uint64_t size = 0;
         std::uint32_t rawType = 0;
@@ -14,6 +14,7 @@
 #include "../exceptions.h"
 #include "../mediafileinfo.h"
 #include "../mediaformat.h"
+#include "../memoryusage.h"
 
 #include <c++utilities/conversion/stringbuilder.h>
 #include <c++utilities/io/binaryreader.h>
@@ -189,6 +190,15 @@ TrackType Mp4Track::type() const
     return TrackType::Mp4Track;
 }
 
+/*!
+ * \brief Adds the memory held by the track including its sample table to \a usage.
+ */
+void Mp4Track::addMemoryUsage(MemoryUsage &usage) const
+{
+    AbstractTrack::addMemoryUsage(usage);
+    usage.sampleTables += MemoryUsage::ofVector(m_sampleSizes);
+}
+
 /*!
  * \brief Reads the chunk offsets from the stco atom and fragments if \a parseFragments is true.
  * \returns Returns the chunk offset table for the track.
@@ -201,7 +211,7 @@ TrackType Mp4Track::type() const
  */
 std::vector<std::uint64_t> Mp4Track::readChunkOffsets(bool parseFragments, Diagnostics &diag)
 {
-    static const auto context = std::string("reading chunk offset table of MP4 track");
+    static const auto context = DiagContext("reading chunk offset table of MP4 track");
     if (!isHeaderValid() || !m_istream) {
         diag.emplace_back(DiagLevel::Critical, "Track has not been parsed.", context);
         throw InvalidDataException();
@@ -514,7 +524,7 @@ Mp4Timings Mp4Track::computeTimings() const
  */
 vector<tuple<std::uint32_t, std::uint32_t, std::uint32_t>> Mp4Track::readSampleToChunkTable(Diagnostics &diag)
 {
-    static const string context("reading sample to chunk table of MP4 track");
+    static const auto context = DiagContext("reading sample to chunk table of MP4 track");
     if (!isHeaderValid() || !m_istream || !m_stscAtom) {
         diag.emplace_back(DiagLevel::Critical, "Track has not been parsed or is invalid.", context);
         throw InvalidDataException();
@@ -563,7 +573,7 @@ vector<tuple<std::uint32_t, std::uint32_t, std::uint32_t>> Mp4Track::readSampleT
  */
 vector<std::uint64_t> Mp4Track::readChunkSizes(Diagnostics &diag)
 {
-    static const string context("reading chunk sizes of MP4 track");
+    static const auto context = DiagContext("reading chunk sizes of MP4 track");
     if (!isHeaderValid() || !m_istream || !m_stcoAtom) {
         diag.emplace_back(DiagLevel::Critical, "Track has not been parsed or is invalid.", context);
         throw InvalidDataException();
@@ -614,7 +624,7 @@ vector<std::uint64_t> Mp4Track::readChunkSizes(Diagnostics &diag)
 std::unique_ptr<Mpeg4ElementaryStreamInfo> Mp4Track::parseMpeg4ElementaryStreamInfo(
     CppUtilities::BinaryReader &reader, Mp4Atom *esDescAtom, Diagnostics &diag)
 {
-    static const string context("parsing MPEG-4 elementary stream descriptor");
+    static const auto context = DiagContext("parsing MPEG-4 elementary stream descriptor");
     using namespace Mpeg4ElementaryStreamObjectIds;
     unique_ptr<Mpeg4ElementaryStreamInfo> esInfo;
     if (esDescAtom->dataSize() >= 12) {
@@ -706,7 +716,7 @@ std::unique_ptr<Mpeg4ElementaryStreamInfo> Mp4Track::parseMpeg4ElementaryStreamI
 unique_ptr<Mpeg4AudioSpecificConfig> Mp4Track::parseAudioSpecificConfig(
     istream &stream, std::uint64_t startOffset, std::uint64_t size, Diagnostics &diag)
 {
-    static const string context("parsing MPEG-4 audio specific config from elementary stream descriptor");
+    static const auto context = DiagContext("parsing MPEG-4 audio specific config from elementary stream descriptor");
     using namespace Mpeg4AudioObjectIds;
     // read config into buffer and construct BitReader for bitwise reading
     stream.seekg(static_cast<streamoff>(startOffset));
@@ -871,7 +881,7 @@ unique_ptr<Mpeg4AudioSpecificConfig> Mp4Track::parseAudioSpecificConfig(
 std::unique_ptr<Mpeg4VideoSpecificConfig> Mp4Track::parseVideoSpecificConfig(
     BinaryReader &reader, std::uint64_t startOffset, std::uint64_t size, Diagnostics &diag)
 {
-    static const string context("parsing MPEG-4 video specific config from elementary stream descriptor");
+    static const auto context = DiagContext("parsing MPEG-4 video specific config from elementary stream descriptor");
     using namespace Mpeg4AudioObjectIds;
     auto videoCfg = make_unique<Mpeg4VideoSpecificConfig>();
     // seek to start
@@ -1566,7 +1576,7 @@ void Mp4Track::internalParseHeader(Diagnostics &diag, AbortableProgressFeedback
 {
     CPP_UTILITIES_UNUSED(progress)
 
-    static const string context("parsing MP4 track");
+    static const auto context = DiagContext("parsing MP4 track");
     using namespace Mp4AtomIds;
     if (!m_trakAtom) {
         diag.emplace_back(DiagLevel::Critical, "\"trak\"-atom is null.", context);
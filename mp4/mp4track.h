@@ -122,6 +122,7 @@ public:
     Mp4Track(Mp4Atom &trakAtom);
     ~Mp4Track() override;
     TrackType type() const override;
+    void addMemoryUsage(MemoryUsage &usage) const override;
 
     // getter methods specific for MP4 tracks
     Mp4Atom &trakAtom();
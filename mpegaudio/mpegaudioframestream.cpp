@@ -33,7 +33,7 @@ void MpegAudioFrameStream::internalParseHeader(Diagnostics &diag, AbortableProgr
 {
     CPP_UTILITIES_UNUSED(progress)
 
-    static const string context("parsing MPEG audio frame header");
+    static const auto context = DiagContext("parsing MPEG audio frame header");
     if (!m_istream) {
         throw NoDataFoundException();
     }
@@ -4,6 +4,7 @@
 
 #include "../backuphelper.h"
 #include "../mediafileinfo.h"
+#include "../memoryusage.h"
 #include "../progressfeedback.h"
 #include "../tagtarget.h"
 
@@ -56,6 +57,19 @@ OggContainer::~OggContainer()
 {
 }
 
+/*!
+ * \brief Adds the memory held by the tags, the tracks and the pages (including their segment tables) to \a usage.
+ */
+void OggContainer::addMemoryUsage(MemoryUsage &usage) const
+{
+    GenericContainer<MediaFileInfo, OggVorbisComment, OggStream, OggPage>::addMemoryUsage(usage);
+    const auto &pages = m_iterator.pages();
+    usage.oggPages += MemoryUsage::ofVector(pages);
+    for (const auto &page : pages) {
+        usage.oggPages += MemoryUsage::ofVector(page.segmentSizes());
+    }
+}
+
 void OggContainer::reset()
 {
     m_iterator.reset();
@@ -76,13 +90,15 @@ OggVorbisComment *OggContainer::createTag(const TagTarget &target)
     if (!target.tracks().empty()) {
         // return the tag for the first matching track ID
         for (auto &tag : m_tags) {
-            if (!tag->target().tracks().empty() && tag->target().tracks().front() == target.tracks().front() && !tag->oggParams().removed) {
+            const auto &tagTarget = const_cast<const OggVorbisComment *>(tag.get())->target();
+            if (!tagTarget.tracks().empty() && tagTarget.tracks().front() == target.tracks().front() && !tag->oggParams().removed) {
                 return tag.get();
             }
         }
         // not tag found -> try to re-use a tag which has been flagged as removed
         for (auto &tag : m_tags) {
-            if (!tag->target().tracks().empty() && tag->target().tracks().front() == target.tracks().front()) {
+            const auto &tagTarget = const_cast<const OggVorbisComment *>(tag.get())->target();
+            if (!tagTarget.tracks().empty() && tagTarget.tracks().front() == target.tracks().front()) {
                 tag->oggParams().removed = false;
                 return tag.get();
             }
@@ -189,7 +205,7 @@ void OggContainer::internalParseHeader(Diagnostics &diag, AbortableProgressFeedb
 {
     CPP_UTILITIES_UNUSED(progress)
 
-    static const auto context = std::string("parsing Ogg bitstream header");
+    static const auto context = DiagContext("parsing Ogg bitstream header");
     auto pagesSkipped = false, continueFromHere = false;
 
     // iterate through pages using OggIterator helper class
@@ -241,11 +257,13 @@ void OggContainer::internalParseHeader(Diagnostics &diag, AbortableProgressFeedb
                         trackStream->m_size = 0;
                     }
                     pagesSkipped = continueFromHere = true;
-                    diag.emplace_back(DiagLevel::Information,
-                        argsToString("Pages in the middle of the file (", dataSizeToString(resyncedPage.startOffset() - page.startOffset()),
-                            ") have been skipped to improve parsing speed. Hence track sizes can not be computed. Maybe not even all tracks could be "
-                            "detected. Force a full parse to prevent this."),
-                        context);
+                    if (diag.isEnabled(DiagLevel::Information)) {
+                        diag.emplace_back(DiagLevel::Information,
+                            argsToString("Pages in the middle of the file (", dataSizeToString(resyncedPage.startOffset() - page.startOffset()),
+                                ") have been skipped to improve parsing speed. Hence track sizes can not be computed. Maybe not even all tracks "
+                                "could be detected. Force a full parse to prevent this."),
+                            context);
+                    }
                 } else {
                     // abort if skipping pages didn't work
                     diag.emplace_back(DiagLevel::Critical,
@@ -294,16 +312,18 @@ void OggContainer::internalParseTags(Diagnostics &diag, AbortableProgressFeedbac
         auto padding = std::uint64_t();
         switch (params.streamFormat) {
         case GeneralMediaFormat::Vorbis:
-            comment->parse(m_iterator, flags, padding, diag);
+            comment->parse(m_iterator, flags, padding, diag, &fileInfo().tagFieldFilter());
             break;
         case GeneralMediaFormat::Opus:
             // skip header (has already been detected by OggStream)
             m_iterator.ignore(8);
-            comment->parse(m_iterator, flags | VorbisCommentFlags::NoSignature | VorbisCommentFlags::NoFramingByte, padding, diag);
+            comment->parse(
+                m_iterator, flags | VorbisCommentFlags::NoSignature | VorbisCommentFlags::NoFramingByte, padding, diag, &fileInfo().tagFieldFilter());
             break;
         case GeneralMediaFormat::Flac:
             m_iterator.ignore(4);
-            comment->parse(m_iterator, flags | VorbisCommentFlags::NoSignature | VorbisCommentFlags::NoFramingByte, padding, diag);
+            comment->parse(
+                m_iterator, flags | VorbisCommentFlags::NoSignature | VorbisCommentFlags::NoFramingByte, padding, diag, &fileInfo().tagFieldFilter());
             break;
         default:
             diag.emplace_back(DiagLevel::Critical, "Stream format not supported.", context);
@@ -359,7 +379,7 @@ void OggContainer::announceComment(std::size_t pageIndex, std::size_t segmentInd
 
 void OggContainer::internalParseTracks(Diagnostics &diag, AbortableProgressFeedback &progress)
 {
-    static const string context("parsing Ogg stream");
+    static const auto context = DiagContext("parsing Ogg stream");
     for (auto &stream : m_tracks) {
         if (progress.isAborted()) {
             throw OperationAbortedException();
@@ -421,9 +441,23 @@ void OggContainer::makeVorbisCommentSegment(stringstream &buffer, CopyHelper<653
     newSegmentSizes.push_back(static_cast<std::uint32_t>(buffer.tellp() - offset));
 }
 
+/*!
+ * \brief Determines how internalMakeFile() would apply the changes.
+ * \remarks Ogg files are always rewritten. The page layout is only determined when writing so the numbers are estimated
+ *          assuming the size of the file does not change.
+ */
+void OggContainer::internalPlanChanges(ChangePlan &plan, Diagnostics &diag, AbortableProgressFeedback &progress)
+{
+    CPP_UTILITIES_UNUSED(diag)
+    CPP_UTILITIES_UNUSED(progress)
+    plan.strategy = ChangeStrategy::Rewrite;
+    plan.bytesToCopy = plan.bytesToWrite = plan.newSize = fileInfo().size();
+    plan.isEstimated = true;
+}
+
 void OggContainer::internalMakeFile(Diagnostics &diag, AbortableProgressFeedback &progress)
 {
-    const auto context = std::string("making Ogg file");
+    static const auto context = DiagContext("making Ogg file");
     progress.nextStepOrStop("Prepare for rewriting Ogg file ...");
     parseTags(diag, progress); // tags need to be parsed before the file can be rewritten
     auto originalPath = fileInfo().path(), backupPath = std::string();
@@ -453,6 +487,7 @@ void OggContainer::internalMakeFile(Diagnostics &diag, AbortableProgressFeedback
             throw;
         }
     }
+    fileInfo().attachIoStatistics(&backupStream);
 
     const auto totalFileSize = fileInfo().size();
     try {
@@ -479,13 +514,12 @@ void OggContainer::internalMakeFile(Diagnostics &diag, AbortableProgressFeedback
         auto pageSequenceNumberBySerialNo = std::unordered_map<std::uint32_t, std::uint32_t>();
 
         // iterate through all pages of the original file
-        auto updateTick = 0u;
-        for (m_iterator.setStream(backupStream), m_iterator.removeFilter(), m_iterator.reset(); m_iterator; m_iterator.nextPage(), ++updateTick) {
+        auto pageProgress = ProgressCounter(progress, totalFileSize);
+        for (m_iterator.setStream(backupStream), m_iterator.removeFilter(), m_iterator.reset(); m_iterator; m_iterator.nextPage()) {
             const OggPage &currentPage = m_iterator.currentPage();
-            if (updateTick % 10) {
-                progress.updateStepPercentage(static_cast<std::uint8_t>(currentPage.startOffset() * 100ul / totalFileSize));
-                progress.stopIfAborted();
-            }
+            pageProgress.set(currentPage.startOffset());
+            pageProgress.report();
+            pageProgress.stopIfAborted();
 
             // check for gaps
             // note: This is not just to print diag messages but also for taking into account that the parser might skip pages
@@ -690,7 +724,8 @@ void OggContainer::internalMakeFile(Diagnostics &diag, AbortableProgressFeedback
 
         // report new size
         fileInfo().reportSizeChanged(static_cast<std::uint64_t>(stream().tellp()));
-        progress.updateStepPercentage(100);
+        pageProgress.set(pageProgress.total());
+        pageProgress.reportNow();
 
         // "save as path" is now the regular path
         if (!fileInfo().saveFilePath().empty()) {
@@ -717,18 +752,18 @@ void OggContainer::internalMakeFile(Diagnostics &diag, AbortableProgressFeedback
 
         // update checksums of modified pages
         progress.nextStepOrStop("Updating checksums ...");
-        updateTick = 0u;
+        auto checksumProgress = ProgressCounter(progress, fileInfo().size());
         for (auto offset : updatedPageOffsets) {
-            if (updateTick++ % 10) {
-                progress.updateStepPercentage(static_cast<std::uint8_t>(offset * 100ul / fileInfo().size()));
-                progress.stopIfAborted();
-            }
+            checksumProgress.set(offset);
+            checksumProgress.report();
+            checksumProgress.stopIfAborted();
             OggPage::updateChecksum(stream, offset);
         }
 
         // prevent deferring final write operations (to catch and handle possible errors here)
         stream.flush();
-        progress.updateStepPercentage(100);
+        checksumProgress.set(checksumProgress.total());
+        checksumProgress.reportNow();
 
         // clear iterator
         m_iterator.clear(stream, startOffset(), fileInfo().size());
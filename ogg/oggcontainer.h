@@ -140,6 +140,7 @@ public:
 
     bool isChecksumValidationEnabled() const;
     void setChecksumValidationEnabled(bool enabled);
+    void addMemoryUsage(MemoryUsage &usage) const override;
     void reset() override;
 
     OggVorbisComment *createTag(const TagTarget &target) override;
@@ -153,6 +154,7 @@ protected:
     void internalParseTags(Diagnostics &diag, AbortableProgressFeedback &progress) override;
     void internalParseTracks(Diagnostics &diag, AbortableProgressFeedback &progress) override;
     void internalMakeFile(Diagnostics &diag, AbortableProgressFeedback &progress) override;
+    void internalPlanChanges(ChangePlan &plan, Diagnostics &diag, AbortableProgressFeedback &progress) override;
 
 private:
     void announceComment(
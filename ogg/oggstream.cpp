@@ -50,7 +50,7 @@ void OggStream::internalParseHeader(Diagnostics &diag, AbortableProgressFeedback
 {
     CPP_UTILITIES_UNUSED(progress)
 
-    static const string context("parsing Ogg page header");
+    static const auto context = DiagContext("parsing Ogg page header");
 
     // read basic information from first page
     OggIterator &iterator = m_container.m_iterator;
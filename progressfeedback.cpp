@@ -21,4 +21,15 @@ namespace TagParser {
  *        It also allows to abort the operation.
  */
 
+/*!
+ * \class TagParser::ProgressCounter
+ * \brief The ProgressCounter class allows reporting progress from tight loops and multiple threads with little overhead.
+ *
+ * The workers only bump an atomic counter via add() or set(). The feedback is only updated when report() is called and
+ * only if the percentage has changed and the last update is at least a certain interval (by default 50 ms) ago. This
+ * way the callbacks of the AbortableProgressFeedback are not invoked more often than a UI can display the progress
+ * anyway, no matter how often the loop iterates. Call reportNow() after the loop so the final percentage is not throttled
+ * away.
+ */
+
 } // namespace TagParser
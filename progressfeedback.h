@@ -2,8 +2,11 @@
 #define TAGPARSER_PROGRESS_FEEDBACK_H
 
 #include "./exceptions.h"
+#include "./tracing.h"
 
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <functional>
 #include <string>
@@ -22,6 +25,7 @@ public:
     std::uint8_t overallPercentage() const;
     void updateStep(const std::string &step, std::uint8_t stepPercentage = 0);
     void updateStep(std::string &&step, std::uint8_t stepPercentage = 0);
+    void updateStep(const char *step, std::uint8_t stepPercentage = 0);
     void updateStepPercentage(std::uint8_t stepPercentage);
     void updateStepPercentageFromFraction(double stepPercentage);
     void updateOverallPercentage(std::uint8_t overallPercentage);
@@ -90,13 +94,16 @@ template <typename ActualProgressFeedback> inline std::uint8_t BasicProgressFeed
 
 /*!
  * \brief Updates the current step and invokes the first callback specified on construction.
- * \remarks Supposed to be called only by the operation itself.
+ * \remarks
+ * - Supposed to be called only by the operation itself.
+ * - Starts a new step within the current TraceSpan when tracing is enabled.
  */
 template <typename ActualProgressFeedback>
 inline void BasicProgressFeedback<ActualProgressFeedback>::updateStep(const std::string &step, std::uint8_t stepPercentage)
 {
     m_step = step;
     m_stepPercentage = stepPercentage;
+    TAG_PARSER_TRACE_STEP(m_step);
     if (m_callback) {
         m_callback(*static_cast<ActualProgressFeedback *>(this));
     }
@@ -109,8 +116,27 @@ inline void BasicProgressFeedback<ActualProgressFeedback>::updateStep(const std:
 template <typename ActualProgressFeedback>
 inline void BasicProgressFeedback<ActualProgressFeedback>::updateStep(std::string &&step, std::uint8_t stepPercentage)
 {
-    m_step = step;
+    m_step = std::move(step);
+    m_stepPercentage = stepPercentage;
+    TAG_PARSER_TRACE_STEP(m_step);
+    if (m_callback) {
+        m_callback(*static_cast<ActualProgressFeedback *>(this));
+    }
+}
+
+/*!
+ * \brief Updates the current step and invokes the first callback specified on construction.
+ * \remarks
+ * - Supposed to be called only by the operation itself.
+ * - Preferable for static step names as no temporary std::string needs to be constructed and the buffer for the step
+ *   name is reused.
+ */
+template <typename ActualProgressFeedback>
+inline void BasicProgressFeedback<ActualProgressFeedback>::updateStep(const char *step, std::uint8_t stepPercentage)
+{
+    m_step.assign(step);
     m_stepPercentage = stepPercentage;
+    TAG_PARSER_TRACE_STEP(m_step);
     if (m_callback) {
         m_callback(*static_cast<ActualProgressFeedback *>(this));
     }
@@ -194,6 +220,7 @@ public:
     void stopIfAborted() const;
     void nextStepOrStop(const std::string &step, std::uint8_t stepPercentage = 0);
     void nextStepOrStop(std::string &&step, std::uint8_t stepPercentage = 0);
+    void nextStepOrStop(const char *step, std::uint8_t stepPercentage = 0);
 
 private:
     std::atomic_bool m_aborted;
@@ -276,6 +303,18 @@ inline void AbortableProgressFeedback::nextStepOrStop(const std::string &status,
  * \remarks Supposed to be called only by the operation itself.
  */
 inline void AbortableProgressFeedback::nextStepOrStop(std::string &&status, std::uint8_t percentage)
+{
+    if (isAborted()) {
+        throw OperationAbortedException();
+    }
+    updateStep(std::move(status), percentage);
+}
+
+/*!
+ * \brief Throws an OperationAbortedException if aborted; otherwise the data for the next step is set.
+ * \remarks Supposed to be called only by the operation itself.
+ */
+inline void AbortableProgressFeedback::nextStepOrStop(const char *status, std::uint8_t percentage)
 {
     if (isAborted()) {
         throw OperationAbortedException();
@@ -283,6 +322,147 @@ inline void AbortableProgressFeedback::nextStepOrStop(std::string &&status, std:
     updateStep(status, percentage);
 }
 
+class ProgressCounter {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit ProgressCounter(AbortableProgressFeedback &feedback, std::uint64_t total, Clock::duration minInterval = std::chrono::milliseconds(50));
+    ProgressCounter(const ProgressCounter &) = delete;
+    ProgressCounter &operator=(const ProgressCounter &) = delete;
+
+    AbortableProgressFeedback &feedback();
+    std::uint64_t total() const;
+    std::uint64_t value() const;
+    std::uint8_t percentage() const;
+    void add(std::uint64_t amount = 1);
+    void set(std::uint64_t value);
+    bool isAborted() const;
+    void stopIfAborted() const;
+    bool report();
+    void reportNow();
+
+private:
+    AbortableProgressFeedback &m_feedback;
+    const std::uint64_t m_total;
+    std::atomic<std::uint64_t> m_value;
+    const Clock::duration m_minInterval;
+    Clock::time_point m_nextReport;
+    std::uint8_t m_reportedPercentage;
+};
+
+/*!
+ * \brief Constructs a new ProgressCounter reporting to \a feedback with the specified \a total.
+ * \remarks The step percentage of \a feedback is updated at most once per \a minInterval.
+ */
+inline ProgressCounter::ProgressCounter(AbortableProgressFeedback &feedback, std::uint64_t total, Clock::duration minInterval)
+    : m_feedback(feedback)
+    , m_total(total)
+    , m_value(0)
+    , m_minInterval(minInterval)
+    , m_reportedPercentage(feedback.stepPercentage())
+{
+}
+
+/*!
+ * \brief Returns the feedback the progress is reported to.
+ */
+inline AbortableProgressFeedback &ProgressCounter::feedback()
+{
+    return m_feedback;
+}
+
+/*!
+ * \brief Returns the value which corresponds to 100 %.
+ */
+inline std::uint64_t ProgressCounter::total() const
+{
+    return m_total;
+}
+
+/*!
+ * \brief Returns the current value.
+ */
+inline std::uint64_t ProgressCounter::value() const
+{
+    return m_value.load(std::memory_order_relaxed);
+}
+
+/*!
+ * \brief Returns the percentage the current value corresponds to.
+ */
+inline std::uint8_t ProgressCounter::percentage() const
+{
+    return m_total ? static_cast<std::uint8_t>(std::min<std::uint64_t>(value(), m_total) * 100 / m_total) : 0;
+}
+
+/*!
+ * \brief Increases the current value by \a amount.
+ * \remarks This function is thread-safe. It only updates the counter; call report() to pass the progress to the feedback.
+ */
+inline void ProgressCounter::add(std::uint64_t amount)
+{
+    m_value.fetch_add(amount, std::memory_order_relaxed);
+}
+
+/*!
+ * \brief Sets the current value to \a value.
+ * \remarks This function is thread-safe. It only updates the counter; call report() to pass the progress to the feedback.
+ */
+inline void ProgressCounter::set(std::uint64_t value)
+{
+    m_value.store(value, std::memory_order_relaxed);
+}
+
+/*!
+ * \brief Returns whether the operation has been aborted.
+ * \remarks This function is thread-safe.
+ */
+inline bool ProgressCounter::isAborted() const
+{
+    return m_feedback.isAborted();
+}
+
+/*!
+ * \brief Throws an OperationAbortedException if aborted.
+ * \remarks This function is thread-safe.
+ */
+inline void ProgressCounter::stopIfAborted() const
+{
+    m_feedback.stopIfAborted();
+}
+
+/*!
+ * \brief Updates the step percentage of the feedback if it has changed and the last update is at least the min. interval ago.
+ * \returns Returns whether the feedback has been updated.
+ * \remarks
+ * - Cheap enough to be called in tight loops: the clock is only read if the percentage has actually changed.
+ * - Must only be called by one thread at a time (usually the thread which has started the operation).
+ */
+inline bool ProgressCounter::report()
+{
+    const auto currentPercentage = percentage();
+    if (currentPercentage == m_reportedPercentage) {
+        return false;
+    }
+    const auto now = Clock::now();
+    if (now < m_nextReport) {
+        return false;
+    }
+    m_nextReport = now + m_minInterval;
+    m_feedback.updateStepPercentage(m_reportedPercentage = currentPercentage);
+    return true;
+}
+
+/*!
+ * \brief Updates the step percentage of the feedback regardless of the min. interval.
+ * \remarks Must only be called by one thread at a time (usually the thread which has started the operation).
+ */
+inline void ProgressCounter::reportNow()
+{
+    m_nextReport = Clock::now() + m_minInterval;
+    m_feedback.updateStepPercentage(m_reportedPercentage = percentage());
+}
+
 } // namespace TagParser
 
 #endif // TAGPARSER_PROGRESS_FEEDBACK_H
@@ -1,4 +1,5 @@
 #include "./tag.h"
+#include "./memoryusage.h"
 
 using namespace std;
 
@@ -23,6 +24,7 @@ struct TagPrivate {};
  */
 Tag::Tag()
     : m_size(0)
+    , m_modified(true)
 {
 }
 
@@ -102,6 +104,18 @@ std::size_t Tag::insertValues(const Tag &from, bool overwrite)
     return count;
 }
 
+/*!
+ * \brief Adds the memory held by the tag (except the object itself) to \a usage.
+ * \remarks
+ * - Accounts the version and the target. Subclasses need to account their fields and values.
+ * - The object itself is supposed to be accounted by the owner as only it knows the actual type.
+ */
+void Tag::addMemoryUsage(MemoryUsage &usage) const
+{
+    usage.tags += MemoryUsage::ofString(m_version) + MemoryUsage::ofString(m_target.levelName()) + MemoryUsage::ofVector(m_target.tracks())
+        + MemoryUsage::ofVector(m_target.chapters()) + MemoryUsage::ofVector(m_target.editions()) + MemoryUsage::ofVector(m_target.attachments());
+}
+
 /*!
  * \fn Tag::type()
  * \brief Returns the type of the tag as TagParser::TagType.
@@ -203,6 +217,7 @@ std::size_t Tag::insertValues(const Tag &from, bool overwrite)
 /*!
  * \fn Tag::target()
  * \brief Returns the target of tag.
+ * \remarks Obtaining the target this way is considered a modification, see isModified().
  *
  * \sa supportsTarget()
  * \sa setTarget()
@@ -219,6 +234,17 @@ std::size_t Tag::insertValues(const Tag &from, bool overwrite)
  * \sa target()
  */
 
+/*!
+ * \fn Tag::isModified()
+ * \brief Returns whether the tag has been modified since it has been parsed.
+ * \remarks
+ * - A tag which has not been parsed (e.g. one created via MediaFileInfo::createAppropriateTags()) is always considered modified.
+ * - Assigning a value equal to the present one via setValue() or setValues() is not considered a modification.
+ * - Obtaining mutable access to the fields or the target of the tag (e.g. via FieldMapBasedTag::fields()) is considered a
+ *   modification because changes made via the returned reference can not be tracked.
+ * \sa MediaFileInfo::hasPendingChanges()
+ */
+
 /*!
  * \fn Tag::value()
  * \brief Returns the value of the specified \a field.
@@ -174,6 +174,7 @@ constexpr KnownField nextKnownField(KnownField field)
     return isKnownFieldDeprecated(next) ? nextKnownField(next) : next;
 }
 
+struct MemoryUsage;
 struct TagPrivate;
 
 class TAG_PARSER_EXPORT Tag {
@@ -209,6 +210,8 @@ public:
     virtual bool supportsMultipleValues(KnownField field) const;
     virtual std::size_t insertValues(const Tag &from, bool overwrite);
     virtual void ensureTextValuesAreProperlyEncoded() = 0;
+    virtual void addMemoryUsage(MemoryUsage &usage) const;
+    bool isModified() const;
 
 protected:
     Tag();
@@ -217,6 +220,7 @@ protected:
     std::uint64_t m_size;
     std::unique_ptr<TagPrivate> m_p;
     TagTarget m_target;
+    bool m_modified;
 };
 
 inline TagType Tag::type() const
@@ -261,12 +265,21 @@ inline const TagTarget &Tag::target() const
 
 inline TagTarget &Tag::target()
 {
+    m_modified = true;
     return m_target;
 }
 
 inline void Tag::setTarget(const TagTarget &target)
 {
-    m_target = target;
+    if (!(m_target == target)) {
+        m_target = target;
+        m_modified = true;
+    }
+}
+
+inline bool Tag::isModified() const
+{
+    return m_modified;
 }
 
 inline TagTargetLevel Tag::targetLevel() const
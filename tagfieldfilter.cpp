@@ -0,0 +1,78 @@
+#include "./tagfieldfilter.h"
+
+#include "./id3/id3v2frame.h"
+#include "./mp4/mp4tagfield.h"
+
+#include <c++utilities/conversion/conversionexception.h>
+
+using namespace std;
+using namespace CppUtilities;
+
+namespace TagParser {
+
+/*!
+ * \class TagParser::TagFieldFilter
+ * \brief The TagFieldFilter class specifies which tag fields are supposed to be parsed.
+ *
+ * Fields can be selected via KnownField and via raw IDs (e.g. "TXXX", "©nam", "REPLAYGAIN_TRACK_GAIN"). Fields not
+ * selected are skipped when parsing without decoding their values. Their raw data is kept so they are still preserved
+ * when applying changes (see FieldMapBasedTag::skippedFields()). Note that skipped fields are written after the decoded
+ * fields so the order of the fields within the tag might change when applying changes.
+ *
+ * A filter can be assigned via MediaFileInfo::setTagFieldFilter() and is currently considered for ID3v2 tags, MP4 tags,
+ * Vorbis comments and Matroska tags.
+ */
+
+/*!
+ * \brief Constructs a new filter accepting the specified \a fields.
+ */
+TagFieldFilter::TagFieldFilter(std::initializer_list<KnownField> fields)
+{
+    for (const auto field : fields) {
+        addField(field);
+    }
+}
+
+/*!
+ * \brief Adds the specified \a field to the set of accepted fields.
+ */
+TagFieldFilter &TagFieldFilter::addField(KnownField field)
+{
+    if (const auto index = static_cast<std::size_t>(field); index < knownFieldArraySize) {
+        m_fields.set(index);
+    }
+    return *this;
+}
+
+/*!
+ * \brief Adds the specified raw \a id to the set of accepted IDs.
+ * \remarks The \a id is converted to the ID types of the supported tag formats via the field's fieldIdFromString()
+ *          function right away. It is ignored for tag formats it can not be converted for (e.g. "REPLAYGAIN_TRACK_GAIN"
+ *          is not considered for ID3v2 tags).
+ */
+TagFieldFilter &TagFieldFilter::addRawId(std::string_view id)
+{
+    m_rawIds.emplace_back(id);
+    try {
+        m_id3v2Ids.emplace_back(Id3v2Frame::fieldIdFromString(id));
+    } catch (const ConversionException &) {
+    }
+    try {
+        m_mp4Ids.emplace_back(Mp4TagField::fieldIdFromString(id));
+    } catch (const ConversionException &) {
+    }
+    return *this;
+}
+
+/*!
+ * \brief Removes all fields and raw IDs so the filter accepts everything again.
+ */
+void TagFieldFilter::clear()
+{
+    m_fields.reset();
+    m_rawIds.clear();
+    m_id3v2Ids.clear();
+    m_mp4Ids.clear();
+}
+
+} // namespace TagParser
@@ -0,0 +1,103 @@
+#ifndef TAG_PARSER_TAGFIELDFILTER_H
+#define TAG_PARSER_TAGFIELDFILTER_H
+
+#include "./tag.h"
+
+#include <bitset>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace TagParser {
+
+class TAG_PARSER_EXPORT TagFieldFilter {
+public:
+    TagFieldFilter() = default;
+    TagFieldFilter(std::initializer_list<KnownField> fields);
+
+    bool isActive() const;
+    TagFieldFilter &addField(KnownField field);
+    TagFieldFilter &addRawId(std::string_view id);
+    void clear();
+    bool acceptsField(KnownField field) const;
+    const std::vector<std::string> &rawIds() const;
+    template <class TagType> bool accepts(const TagType &tag, const typename TagType::IdentifierType &id) const;
+
+private:
+    template <class TagType> const auto &convertedRawIds() const;
+
+    std::bitset<knownFieldArraySize> m_fields;
+    std::vector<std::string> m_rawIds;
+    std::vector<std::uint32_t> m_id3v2Ids;
+    std::vector<std::uint32_t> m_mp4Ids;
+};
+
+/*!
+ * \brief Returns whether the filter restricts the fields to be parsed at all.
+ * \remarks A filter without any fields and raw IDs accepts everything.
+ */
+inline bool TagFieldFilter::isActive() const
+{
+    return m_fields.any() || !m_rawIds.empty();
+}
+
+/*!
+ * \brief Returns whether the specified \a field has been added to the filter.
+ */
+inline bool TagFieldFilter::acceptsField(KnownField field) const
+{
+    const auto index = static_cast<std::size_t>(field);
+    return index < knownFieldArraySize && m_fields.test(index);
+}
+
+/*!
+ * \brief Returns the raw IDs which have been added to the filter.
+ */
+inline const std::vector<std::string> &TagFieldFilter::rawIds() const
+{
+    return m_rawIds;
+}
+
+/*!
+ * \brief Returns the raw IDs converted to the ID type of the specified tag type.
+ * \remarks The conversion is done once when adding a raw ID (see addRawId()) so it is not repeated for every field.
+ */
+template <class TagType> inline const auto &TagFieldFilter::convertedRawIds() const
+{
+    if constexpr (std::is_same_v<typename TagType::IdentifierType, std::string>) {
+        return m_rawIds; // Vorbis comment and Matroska field IDs are just the raw IDs
+    } else if constexpr (TagType::tagType == TagParser::TagType::Mp4Tag) {
+        return m_mp4Ids;
+    } else {
+        static_assert(TagType::tagType == TagParser::TagType::Id3v2Tag, "tag type not supported by TagFieldFilter");
+        return m_id3v2Ids;
+    }
+}
+
+/*!
+ * \brief Returns whether the field with the specified \a id of the specified \a tag is supposed to be parsed.
+ *
+ * The field is accepted if the filter is not active, if the KnownField the \a id maps to has been added or if
+ * the \a id equals one of the raw IDs. Raw IDs are compared using the tag's compare function, so e.g. Vorbis
+ * comment field names are matched case-insensitively and short ID3v2 frame IDs match their long equivalents.
+ */
+template <class TagType> bool TagFieldFilter::accepts(const TagType &tag, const typename TagType::IdentifierType &id) const
+{
+    if (!isActive() || acceptsField(tag.knownField(id))) {
+        return true;
+    }
+    const auto compare = typename TagType::Compare();
+    for (const auto &otherId : convertedRawIds<TagType>()) {
+        if (!compare(id, otherId) && !compare(otherId, id)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace TagParser
+
+#endif // TAG_PARSER_TAGFIELDFILTER_H
@@ -1,7 +1,10 @@
 #include "./tagvalue.h"
 
+#include "./abstractattachment.h"
 #include "./caseinsensitivecomparer.h"
+#include "./memoryusage.h"
 #include "./tag.h"
+#include "./textconversion.h"
 
 #include "./id3/id3genres.h"
 
@@ -58,25 +61,6 @@ std::string_view tagDataTypeString(TagDataType dataType)
     }
 }
 
-/*!
- * \brief Returns the encoding parameter (name of the character set and bytes per character) for the specified \a tagTextEncoding.
- */
-pair<const char *, float> encodingParameter(TagTextEncoding tagTextEncoding)
-{
-    switch (tagTextEncoding) {
-    case TagTextEncoding::Latin1:
-        return make_pair("ISO-8859-1", 1.0f);
-    case TagTextEncoding::Utf8:
-        return make_pair("UTF-8", 1.0f);
-    case TagTextEncoding::Utf16LittleEndian:
-        return make_pair("UTF-16LE", 2.0f);
-    case TagTextEncoding::Utf16BigEndian:
-        return make_pair("UTF-16BE", 2.0f);
-    default:
-        return make_pair(nullptr, 0.0f);
-    }
-}
-
 /*!
  * \class TagParser::Popularity
  * \brief The Popularity class contains a value for ID3v2's "Popularimeter" field.
@@ -142,9 +126,10 @@ TagValue::TagValue(const TagValue &other)
     , m_descEncoding(other.m_descEncoding)
     , m_flags(TagValueFlags::None)
 {
-    if (!other.isEmpty()) {
-        m_ptr = make_unique<char[]>(m_size);
-        std::copy(other.m_ptr.get(), other.m_ptr.get() + other.m_size, m_ptr.get());
+    if (const auto &source = other.m_ptr.source()) {
+        m_ptr.assignSource(source);
+    } else if (!other.isEmpty()) {
+        std::copy(other.m_ptr.get(), other.m_ptr.get() + other.m_size, m_ptr.allocate(m_size));
     }
 }
 
@@ -253,8 +238,7 @@ TagValue::TagValue(const char *data, std::size_t length, TagDataType type, TagTe
         if (type == TagDataType::Text) {
             stripBom(data, m_size, encoding);
         }
-        m_ptr = std::make_unique<char[]>(m_size);
-        std::copy(data, data + m_size, m_ptr.get());
+        std::copy(data, data + m_size, m_ptr.allocate(m_size));
     }
 }
 
@@ -278,7 +262,7 @@ TagValue::TagValue(std::unique_ptr<char[]> &&data, std::size_t length, TagDataTy
     , m_flags(TagValueFlags::None)
 {
     if (length) {
-        m_ptr = std::move(data);
+        m_ptr.adopt(std::move(data));
     }
 }
 
@@ -298,11 +282,12 @@ TagValue &TagValue::operator=(const TagValue &other)
     m_flags = other.m_flags;
     m_encoding = other.m_encoding;
     m_descEncoding = other.m_descEncoding;
-    if (other.isEmpty()) {
+    if (const auto &source = other.m_ptr.source()) {
+        m_ptr.assignSource(source);
+    } else if (other.isEmpty()) {
         m_ptr.reset();
     } else {
-        m_ptr = make_unique<char[]>(m_size);
-        std::copy(other.m_ptr.get(), other.m_ptr.get() + other.m_size, m_ptr.get());
+        std::copy(other.m_ptr.get(), other.m_ptr.get() + other.m_size, m_ptr.allocate(m_size));
     }
     return *this;
 }
@@ -347,12 +332,26 @@ TagTextEncoding pickUtfEncoding(TagTextEncoding encoding1, TagTextEncoding encod
  * - If the type is TagDataType::Text and the encoding differs values might still be considered equal if they
  *   represent the same characters. The same counts for the description.
  * - This might be a costly operation due to possible conversions.
+ * - Data assigned via assignLazyData() is read to compare it (so this might throw std::ios_base::failure and must not be
+ *   called concurrently for the same instance unless loadData() has been called before).
+ * - With TagValueComparisionFlags::Exact none of the implicit conversions mentioned above are done. This is useful to check
+ *   whether assigning \a other would actually alter the value.
  * \sa
  * - TagValue::compareData() to compare raw data without any conversions
  * - TagValueTests::testEqualityOperator() for examples
  */
 bool TagValue::compareTo(const TagValue &other, TagValueComparisionFlags options) const
 {
+    // check whether the representation is equal as well if an exact comparison is requested
+    if (options & TagValueComparisionFlags::Exact) {
+        if (m_type != other.m_type || m_encoding != other.m_encoding || m_nativeData != other.m_nativeData) {
+            return false;
+        }
+        if (!(options & TagValueComparisionFlags::IgnoreMetaData) && m_descEncoding != other.m_descEncoding) {
+            return false;
+        }
+    }
+
     // check whether meta-data is equal (except description)
     if (!(options & TagValueComparisionFlags::IgnoreMetaData)) {
         // check meta-data which always uses UTF-8 (everything but description)
@@ -368,30 +367,15 @@ bool TagValue::compareTo(const TagValue &other, TagValueComparisionFlags options
             }
         } else {
             const auto utfEncodingToUse = pickUtfEncoding(m_descEncoding, other.m_descEncoding);
-            StringData str1, str2;
-            const char *data1, *data2;
-            size_t size1, size2;
+            string str1, str2;
             if (m_descEncoding != utfEncodingToUse) {
-                const auto inputParameter = encodingParameter(m_descEncoding), outputParameter = encodingParameter(utfEncodingToUse);
-                str1 = convertString(
-                    inputParameter.first, outputParameter.first, m_desc.data(), m_desc.size(), outputParameter.second / inputParameter.second);
-                data1 = str1.first.get();
-                size1 = str1.second;
-            } else {
-                data1 = m_desc.data();
-                size1 = m_desc.size();
+                transcodeText(m_descEncoding, utfEncodingToUse, m_desc.data(), m_desc.size(), str1);
             }
             if (other.m_descEncoding != utfEncodingToUse) {
-                const auto inputParameter = encodingParameter(other.m_descEncoding), outputParameter = encodingParameter(utfEncodingToUse);
-                str2 = convertString(inputParameter.first, outputParameter.first, other.m_desc.data(), other.m_desc.size(),
-                    outputParameter.second / inputParameter.second);
-                data2 = str2.first.get();
-                size2 = str2.second;
-            } else {
-                data2 = other.m_desc.data();
-                size2 = other.m_desc.size();
+                transcodeText(other.m_descEncoding, utfEncodingToUse, other.m_desc.data(), other.m_desc.size(), str2);
             }
-            if (!compareData(data1, size1, data2, size2, options & TagValueComparisionFlags::CaseInsensitive)) {
+            if (!compareData(m_descEncoding != utfEncodingToUse ? str1 : m_desc, other.m_descEncoding != utfEncodingToUse ? str2 : other.m_desc,
+                    options & TagValueComparisionFlags::CaseInsensitive)) {
                 return false;
             }
         }
@@ -924,34 +908,13 @@ void TagValue::convertDataEncoding(TagTextEncoding encoding)
         return;
     }
     if (type() == TagDataType::Text) {
-        StringData encodedData;
-        switch (encoding) {
-        case TagTextEncoding::Utf8:
-            // use pre-defined methods when encoding to UTF-8
-            switch (dataEncoding()) {
-            case TagTextEncoding::Latin1:
-                encodedData = convertLatin1ToUtf8(m_ptr.get(), m_size);
-                break;
-            case TagTextEncoding::Utf16LittleEndian:
-                encodedData = convertUtf16LEToUtf8(m_ptr.get(), m_size);
-                break;
-            case TagTextEncoding::Utf16BigEndian:
-                encodedData = convertUtf16BEToUtf8(m_ptr.get(), m_size);
-                break;
-            default:;
-            }
-            break;
-        default: {
-            // otherwise, determine input and output parameter to use general covertString method
-            const auto inputParameter = encodingParameter(dataEncoding());
-            const auto outputParameter = encodingParameter(encoding);
-            encodedData
-                = convertString(inputParameter.first, outputParameter.first, m_ptr.get(), m_size, outputParameter.second / inputParameter.second);
-        }
-        }
-        // can't just move the encoded data because it needs to be deleted with free
-        m_ptr = make_unique<char[]>(m_size = encodedData.second);
-        copy(encodedData.first.get(), encodedData.first.get() + encodedData.second, m_ptr.get());
+        // convert into a separate buffer as the current data is read while writing the converted data
+        auto encodedData = Buffer();
+        const auto *const data = m_ptr.get();
+        const auto encodedSize
+            = transcodeText(dataEncoding(), encoding, data, m_size, encodedData.allocate(maxTranscodedTextSize(dataEncoding(), encoding, m_size)));
+        m_ptr = std::move(encodedData);
+        m_size = encodedSize;
     }
     m_encoding = encoding;
 }
@@ -979,32 +942,9 @@ void TagValue::convertDescriptionEncoding(TagTextEncoding encoding)
         m_descEncoding = encoding;
         return;
     }
-    StringData encodedData;
-    switch (encoding) {
-    case TagTextEncoding::Utf8:
-        // use pre-defined methods when encoding to UTF-8
-        switch (descriptionEncoding()) {
-        case TagTextEncoding::Latin1:
-            encodedData = convertLatin1ToUtf8(m_desc.data(), m_desc.size());
-            break;
-        case TagTextEncoding::Utf16LittleEndian:
-            encodedData = convertUtf16LEToUtf8(m_desc.data(), m_desc.size());
-            break;
-        case TagTextEncoding::Utf16BigEndian:
-            encodedData = convertUtf16BEToUtf8(m_desc.data(), m_desc.size());
-            break;
-        default:;
-        }
-        break;
-    default: {
-        // otherwise, determine input and output parameter to use general covertString method
-        const auto inputParameter = encodingParameter(m_descEncoding);
-        const auto outputParameter = encodingParameter(encoding);
-        encodedData = convertString(
-            inputParameter.first, outputParameter.first, m_desc.data(), m_desc.size(), outputParameter.second / inputParameter.second);
-    }
-    }
-    m_desc.assign(encodedData.first.get(), encodedData.second);
+    auto encodedDesc = string();
+    transcodeText(m_descEncoding, encoding, m_desc.data(), m_desc.size(), encodedDesc);
+    m_desc.swap(encodedDesc);
     m_descEncoding = encoding;
 }
 
@@ -1033,32 +973,7 @@ void TagValue::toString(string &result, TagTextEncoding encoding) const
         if (encoding == TagTextEncoding::Unspecified || dataEncoding() == TagTextEncoding::Unspecified || encoding == dataEncoding()) {
             result.assign(m_ptr.get(), m_size);
         } else {
-            StringData encodedData;
-            switch (encoding) {
-            case TagTextEncoding::Utf8:
-                // use pre-defined methods when encoding to UTF-8
-                switch (dataEncoding()) {
-                case TagTextEncoding::Latin1:
-                    encodedData = convertLatin1ToUtf8(m_ptr.get(), m_size);
-                    break;
-                case TagTextEncoding::Utf16LittleEndian:
-                    encodedData = convertUtf16LEToUtf8(m_ptr.get(), m_size);
-                    break;
-                case TagTextEncoding::Utf16BigEndian:
-                    encodedData = convertUtf16BEToUtf8(m_ptr.get(), m_size);
-                    break;
-                default:;
-                }
-                break;
-            default: {
-                // otherwise, determine input and output parameter to use general covertString method
-                const auto inputParameter = encodingParameter(dataEncoding());
-                const auto outputParameter = encodingParameter(encoding);
-                encodedData
-                    = convertString(inputParameter.first, outputParameter.first, m_ptr.get(), m_size, outputParameter.second / inputParameter.second);
-            }
-            }
-            result.assign(encodedData.first.get(), encodedData.second);
+            transcodeText(dataEncoding(), encoding, m_ptr.get(), m_size, result);
         }
         return;
     case TagDataType::Integer:
@@ -1097,9 +1012,8 @@ void TagValue::toString(string &result, TagTextEncoding encoding) const
         throw ConversionException(argsToString("Can not convert ", tagDataTypeString(m_type), " to string."));
     }
     if (encoding == TagTextEncoding::Utf16LittleEndian || encoding == TagTextEncoding::Utf16BigEndian) {
-        auto encodedData = encoding == TagTextEncoding::Utf16LittleEndian ? convertUtf8ToUtf16LE(result.data(), result.size())
-                                                                          : convertUtf8ToUtf16BE(result.data(), result.size());
-        result.assign(encodedData.first.get(), encodedData.second);
+        const auto utf8Result = std::move(result);
+        transcodeText(TagTextEncoding::Utf8, encoding, utf8Result.data(), utf8Result.size(), result);
     }
 }
 
@@ -1126,32 +1040,7 @@ void TagValue::toWString(std::u16string &result, TagTextEncoding encoding) const
         if (encoding == TagTextEncoding::Unspecified || encoding == dataEncoding()) {
             result.assign(reinterpret_cast<const char16_t *>(m_ptr.get()), m_size / sizeof(char16_t));
         } else {
-            StringData encodedData;
-            switch (encoding) {
-            case TagTextEncoding::Utf8:
-                // use pre-defined methods when encoding to UTF-8
-                switch (dataEncoding()) {
-                case TagTextEncoding::Latin1:
-                    encodedData = convertLatin1ToUtf8(m_ptr.get(), m_size);
-                    break;
-                case TagTextEncoding::Utf16LittleEndian:
-                    encodedData = convertUtf16LEToUtf8(m_ptr.get(), m_size);
-                    break;
-                case TagTextEncoding::Utf16BigEndian:
-                    encodedData = convertUtf16BEToUtf8(m_ptr.get(), m_size);
-                    break;
-                default:;
-                }
-                break;
-            default: {
-                // otherwise, determine input and output parameter to use general covertString method
-                const auto inputParameter = encodingParameter(dataEncoding());
-                const auto outputParameter = encodingParameter(encoding);
-                encodedData
-                    = convertString(inputParameter.first, outputParameter.first, m_ptr.get(), m_size, outputParameter.second / inputParameter.second);
-            }
-            }
-            result.assign(reinterpret_cast<const char16_t *>(encodedData.first.get()), encodedData.second / sizeof(char16_t));
+            transcodeText(dataEncoding(), encoding, m_ptr.get(), m_size, result);
         }
         return;
     case TagDataType::Integer:
@@ -1190,9 +1079,7 @@ void TagValue::toWString(std::u16string &result, TagTextEncoding encoding) const
         throw ConversionException(argsToString("Can not convert ", tagDataTypeString(m_type), " to string."));
     }
     if (encoding == TagTextEncoding::Utf16LittleEndian || encoding == TagTextEncoding::Utf16BigEndian) {
-        auto encodedData = encoding == TagTextEncoding::Utf16LittleEndian ? convertUtf8ToUtf16LE(regularStrRes.data(), result.size())
-                                                                          : convertUtf8ToUtf16BE(regularStrRes.data(), result.size());
-        result.assign(reinterpret_cast<const char16_t *>(encodedData.first.get()), encodedData.second / sizeof(const char16_t));
+        transcodeText(TagTextEncoding::Utf8, encoding, regularStrRes.data(), regularStrRes.size(), result);
     }
 }
 
@@ -1219,38 +1106,14 @@ void TagValue::assignText(const char *text, std::size_t textSize, TagTextEncodin
     }
 
     if (convertTo == TagTextEncoding::Unspecified || textEncoding == convertTo) {
-        m_ptr = make_unique<char[]>(m_size = textSize);
-        copy(text, text + textSize, m_ptr.get());
+        copy(text, text + textSize, m_ptr.allocate(m_size = textSize));
         return;
     }
 
-    StringData encodedData;
-    switch (textEncoding) {
-    case TagTextEncoding::Utf8:
-        // use pre-defined methods when encoding to UTF-8
-        switch (convertTo) {
-        case TagTextEncoding::Latin1:
-            encodedData = convertUtf8ToLatin1(text, textSize);
-            break;
-        case TagTextEncoding::Utf16LittleEndian:
-            encodedData = convertUtf8ToUtf16LE(text, textSize);
-            break;
-        case TagTextEncoding::Utf16BigEndian:
-            encodedData = convertUtf8ToUtf16BE(text, textSize);
-            break;
-        default:;
-        }
-        break;
-    default: {
-        // otherwise, determine input and output parameter to use general covertString method
-        const auto inputParameter = encodingParameter(textEncoding);
-        const auto outputParameter = encodingParameter(convertTo);
-        encodedData = convertString(inputParameter.first, outputParameter.first, text, textSize, outputParameter.second / inputParameter.second);
-    }
-    }
-    // can't just move the encoded data because it needs to be deleted with free
-    m_ptr = make_unique<char[]>(m_size = encodedData.second);
-    copy(encodedData.first.get(), encodedData.first.get() + encodedData.second, m_ptr.get());
+    // convert into a separate buffer as the specified text might point into the current data
+    auto encodedData = Buffer();
+    m_size = transcodeText(textEncoding, convertTo, text, textSize, encodedData.allocate(maxTranscodedTextSize(textEncoding, convertTo, textSize)));
+    m_ptr = std::move(encodedData);
 }
 
 /*!
@@ -1260,8 +1123,7 @@ void TagValue::assignText(const char *text, std::size_t textSize, TagTextEncodin
 void TagValue::assignInteger(int value)
 {
     m_size = sizeof(value);
-    m_ptr = make_unique<char[]>(m_size);
-    std::copy(reinterpret_cast<const char *>(&value), reinterpret_cast<const char *>(&value) + m_size, m_ptr.get());
+    std::copy(reinterpret_cast<const char *>(&value), reinterpret_cast<const char *>(&value) + m_size, m_ptr.allocate(m_size));
     m_type = TagDataType::Integer;
     m_encoding = TagTextEncoding::Latin1;
 }
@@ -1273,8 +1135,7 @@ void TagValue::assignInteger(int value)
 void TagValue::assignUnsignedInteger(std::uint64_t value)
 {
     m_size = sizeof(value);
-    m_ptr = make_unique<char[]>(m_size);
-    std::copy(reinterpret_cast<const char *>(&value), reinterpret_cast<const char *>(&value) + m_size, m_ptr.get());
+    std::copy(reinterpret_cast<const char *>(&value), reinterpret_cast<const char *>(&value) + m_size, m_ptr.allocate(m_size));
     m_type = TagDataType::UnsignedInteger;
     m_encoding = TagTextEncoding::Latin1;
 }
@@ -1292,11 +1153,9 @@ void TagValue::assignData(const char *data, size_t length, TagDataType type, Tag
     if (type == TagDataType::Text) {
         stripBom(data, length, encoding);
     }
-    if (length > m_size) {
-        m_ptr = make_unique<char[]>(length);
-    }
     if (length) {
-        std::copy(data, data + length, m_ptr.get());
+        const auto reuseBuffer = length <= m_size && !m_ptr.isNull() && !m_ptr.source();
+        std::copy(data, data + length, reuseBuffer ? m_ptr.get() : m_ptr.allocate(length));
     } else {
         m_ptr.reset();
     }
@@ -1322,7 +1181,71 @@ void TagValue::assignData(unique_ptr<char[]> &&data, size_t length, TagDataType
     m_size = length;
     m_type = type;
     m_encoding = encoding;
-    m_ptr = std::move(data);
+    m_ptr.adopt(std::move(data));
+}
+
+/*!
+ * \brief Assigns the data of the specified block without reading it yet.
+ *
+ * The data is only read when it is accessed, e.g. via dataPointer(), data() or loadData(). Copies of the TagValue share
+ * the block until the data has been read. Use lazyData() to check whether the data has been read yet and copyDataTo() to
+ * write the data to another stream without buffering it.
+ *
+ * \param data Specifies the block to read the data from.
+ * \param type Specifies the type of the data as TagDataType.
+ * \param encoding Specifies the encoding of the data as TagTextEncoding. The
+ *                 encoding will only be considered if a text is assigned.
+ * \remarks
+ * - The stream of the block must remain valid and unaltered until the data has been read. Hence functions accessing the data
+ *   might throw std::ios_base::failure, even const ones like data() and operator==().
+ * - Reading the data modifies the instance internally and uses the stream of the block. So const accessors must not be used
+ *   concurrently (on the instance or copies of it) until loadData() has been called.
+ * - Does not strip the BOM so for consistency the caller must ensure there is no BOM present.
+ */
+void TagValue::assignLazyData(std::unique_ptr<StreamDataBlock> &&data, TagDataType type, TagTextEncoding encoding)
+{
+    m_type = type;
+    m_encoding = encoding;
+    if ((m_size = data ? static_cast<std::size_t>(data->size()) : 0)) {
+        m_ptr.assignSource(std::move(data));
+    } else {
+        m_ptr.reset();
+    }
+}
+
+/*!
+ * \brief Writes the assigned data to the specified \a stream.
+ * \remarks Data assigned via assignLazyData() is copied directly from its source if it has not been read yet. This does not
+ *          modify the instance but uses the stream of the source so it must not be called concurrently with other reads from it.
+ * \throws Throws std::ios_base::failure when an IO error occurs.
+ */
+void TagValue::copyDataTo(std::ostream &stream) const
+{
+    if (const auto &source = m_ptr.source()) {
+        source->copyTo(stream);
+    } else if (m_size) {
+        stream.write(m_ptr.get(), static_cast<std::streamsize>(m_size));
+    }
+}
+
+/*!
+ * \brief Reads the data from the source assigned to the specified \a buffer.
+ * \remarks The \a buffer is left unaltered if reading the data fails.
+ */
+void TagValue::loadSource(Buffer &buffer)
+{
+    const auto &source = *buffer.source();
+    const auto size = static_cast<std::size_t>(source.size());
+    auto loadedBuffer = Buffer();
+    auto *const data = loadedBuffer.allocate(size);
+    if (const auto &sourceBuffer = source.buffer()) {
+        std::copy(sourceBuffer.get(), sourceBuffer.get() + size, data);
+    } else {
+        auto &stream = source.stream();
+        stream.seekg(static_cast<std::streamoff>(source.startOffset()));
+        stream.read(data, static_cast<std::streamsize>(size));
+    }
+    buffer = std::move(loadedBuffer);
 }
 
 /*!
@@ -1338,10 +1261,11 @@ void TagValue::assignPopularity(const Popularity &value)
         writer.writeFloat64LE(value.rating);
         writer.writeUInt64LE(value.playCounter);
         writer.writeUInt64LE(static_cast<std::uint64_t>(value.scale));
-        auto size = static_cast<std::size_t>(s.tellp());
-        auto ptr = std::make_unique<char[]>(size);
-        s.read(ptr.get(), s.tellp());
-        assignData(std::move(ptr), size, TagDataType::Popularity);
+        const auto size = static_cast<std::size_t>(s.tellp());
+        s.read(m_ptr.allocate(size), s.tellp());
+        m_size = size;
+        m_type = TagDataType::Popularity;
+        m_encoding = TagTextEncoding::Latin1;
     } catch (const std::ios_base::failure &) {
         throw ConversionException("Unable to serialize specified Popularity");
     }
@@ -1390,10 +1314,32 @@ void TagValue::ensureHostByteOrder(u16string &u16str, TagTextEncoding currentEnc
 #error "Host byte order not supported"
 #endif
     ) {
-        for (auto &c : u16str) {
-            c = swapOrder(static_cast<std::uint16_t>(c));
+        swapUtf16ByteOrder(reinterpret_cast<char *>(u16str.data()), u16str.size() * sizeof(char16_t));
+    }
+}
+
+/*!
+ * \brief Returns the memory held by the data, the description, the MIME type, the locale and the native data of the value.
+ * \remarks
+ * - The object itself (sizeof(TagValue)) is not included. So data stored inline does not count.
+ * - Data which has not been loaded yet (see loadData()) does not count, only the block it will be loaded from.
+ */
+std::size_t TagValue::memoryUsage() const
+{
+    auto usage = std::size_t();
+    if (m_ptr.isOnHeap()) {
+        usage += m_size;
+    } else if (m_ptr.source()) {
+        usage += sizeof(StreamDataBlock);
+    }
+    usage += MemoryUsage::ofString(m_desc) + MemoryUsage::ofString(m_mimeType) + MemoryUsage::ofLocale(m_locale);
+    if (!m_nativeData.empty()) {
+        usage += m_nativeData.bucket_count() * sizeof(void *);
+        for (const auto &[key, value] : m_nativeData) {
+            usage += sizeof(std::pair<const std::string, std::string>) + sizeof(void *) + MemoryUsage::ofString(key) + MemoryUsage::ofString(value);
         }
     }
+    return usage;
 }
 
 /*!
@@ -22,6 +22,7 @@ namespace TagParser {
 
 class Tag;
 class Id3v2Frame;
+class StreamDataBlock;
 
 /*!
  * \brief Specifies the text encoding.
@@ -115,6 +116,7 @@ inline Popularity Popularity::scaled(TagType targetScale) const
 
 /*!
  * \brief Specifies the data type.
+ * \remarks New values must be appended and TagParser::tagDataTypeCount (see memoryusage.h) must be updated accordingly.
  */
 enum class TagDataType : unsigned int {
     Text, /**< text/string */
@@ -140,6 +142,7 @@ enum class TagValueComparisionFlags : unsigned int {
     None, /**< no special behavior */
     CaseInsensitive = 0x1, /**< string-comparisons are case-insensitive (does *not* affect non-string comparisons) */
     IgnoreMetaData = 0x2, /**< do *not* take meta-data like description and MIME-types into account */
+    Exact = 0x4, /**< do *not* consider values of different types, encodings or native data equal (no implicit conversions) */
 };
 
 struct TagValuePrivate;
@@ -203,6 +206,10 @@ public:
     char *dataPointer();
     const char *dataPointer() const;
     std::string_view data() const;
+    const StreamDataBlock *lazyData() const;
+    void loadData() const;
+    void copyDataTo(std::ostream &stream) const;
+    std::size_t memoryUsage() const;
     const std::string &description() const;
     void setDescription(std::string_view value, TagTextEncoding encoding = TagTextEncoding::Latin1);
     const std::string &mimeType() const;
@@ -235,6 +242,8 @@ public:
     void assignData(const char *data, std::size_t length, TagDataType type = TagDataType::Binary, TagTextEncoding encoding = TagTextEncoding::Latin1);
     void assignData(std::unique_ptr<char[]> &&data, std::size_t length, TagDataType type = TagDataType::Binary,
         TagTextEncoding encoding = TagTextEncoding::Latin1);
+    void assignLazyData(
+        std::unique_ptr<StreamDataBlock> &&data, TagDataType type = TagDataType::Picture, TagTextEncoding encoding = TagTextEncoding::Latin1);
     void assignPosition(PositionInSet value);
     void assignTimeSpan(CppUtilities::TimeSpan value);
     void assignDateTime(CppUtilities::DateTime value);
@@ -254,7 +263,37 @@ public:
     static bool compareData(const char *data1, std::size_t size1, const char *data2, std::size_t size2, bool ignoreCase = false);
 
 private:
-    std::unique_ptr<char[]> m_ptr;
+    /// \brief The Buffer class holds the assigned data inline if it is small enough and on the heap otherwise.
+    /// \remarks Data from a StreamDataBlock is only read when accessed via get().
+    class Buffer {
+    public:
+        static constexpr std::size_t inlineCapacity = 32;
+
+        explicit Buffer() noexcept;
+        Buffer(Buffer &&other) noexcept;
+        Buffer &operator=(Buffer &&other) noexcept;
+
+        char *get();
+        bool isNull() const;
+        bool isOnHeap() const;
+        const std::shared_ptr<StreamDataBlock> &source() const;
+        char *allocate(std::size_t size);
+        void adopt(std::unique_ptr<char[]> &&data);
+        void assignSource(const std::shared_ptr<StreamDataBlock> &source);
+        void reset();
+
+    private:
+        void takeFrom(Buffer &other);
+
+        std::unique_ptr<char[]> m_heap;
+        std::shared_ptr<StreamDataBlock> m_source;
+        char *m_data;
+        alignas(std::uint64_t) char m_inline[inlineCapacity];
+    };
+
+    static void loadSource(Buffer &buffer);
+
+    mutable Buffer m_ptr;
     std::size_t m_size;
     std::string m_desc;
     std::string m_mimeType;
@@ -267,6 +306,128 @@ private:
     std::unique_ptr<TagValuePrivate> m_p;
 };
 
+/*!
+ * \brief Constructs an empty buffer.
+ */
+inline TagValue::Buffer::Buffer() noexcept
+    : m_data(nullptr)
+{
+}
+
+/*!
+ * \brief Constructs a buffer taking over the data of \a other which is reset afterwards.
+ */
+inline TagValue::Buffer::Buffer(Buffer &&other) noexcept
+{
+    takeFrom(other);
+}
+
+/*!
+ * \brief Takes over the data of \a other which is reset afterwards.
+ */
+inline TagValue::Buffer &TagValue::Buffer::operator=(Buffer &&other) noexcept
+{
+    if (this != &other) {
+        takeFrom(other);
+    }
+    return *this;
+}
+
+/*!
+ * \brief Returns a pointer to the data or nullptr if no data has been assigned.
+ * \remarks Reads the data from the assigned source if not done yet.
+ */
+inline char *TagValue::Buffer::get()
+{
+    if (!m_data && m_source) {
+        TagValue::loadSource(*this);
+    }
+    return m_data;
+}
+
+/*!
+ * \brief Returns whether neither data nor a source has been assigned.
+ */
+inline bool TagValue::Buffer::isNull() const
+{
+    return !m_data && !m_source;
+}
+
+/*!
+ * \brief Returns whether the data is stored on the heap (and not inline or within a source).
+ */
+inline bool TagValue::Buffer::isOnHeap() const
+{
+    return m_heap != nullptr;
+}
+
+/*!
+ * \brief Returns the source the data has not been read from yet or nullptr if there is no such source.
+ */
+inline const std::shared_ptr<StreamDataBlock> &TagValue::Buffer::source() const
+{
+    return m_source;
+}
+
+/*!
+ * \brief Discards the current data and returns a pointer to \a size bytes of uninitialized memory.
+ * \remarks Only allocates memory on the heap if \a size exceeds the inline capacity.
+ */
+inline char *TagValue::Buffer::allocate(std::size_t size)
+{
+    m_source.reset();
+    if (size <= inlineCapacity) {
+        m_heap.reset();
+        return m_data = m_inline;
+    }
+    m_heap = std::make_unique<char[]>(size);
+    return m_data = m_heap.get();
+}
+
+/*!
+ * \brief Takes ownership of the specified heap-allocated \a data.
+ */
+inline void TagValue::Buffer::adopt(std::unique_ptr<char[]> &&data)
+{
+    m_source.reset();
+    m_heap = std::move(data);
+    m_data = m_heap.get();
+}
+
+/*!
+ * \brief Discards the current data and assigns the \a source to read the data from when accessed the next time.
+ */
+inline void TagValue::Buffer::assignSource(const std::shared_ptr<StreamDataBlock> &source)
+{
+    m_heap.reset();
+    m_data = nullptr;
+    m_source = source;
+}
+
+/*!
+ * \brief Discards the current data.
+ */
+inline void TagValue::Buffer::reset()
+{
+    m_heap.reset();
+    m_source.reset();
+    m_data = nullptr;
+}
+
+inline void TagValue::Buffer::takeFrom(Buffer &other)
+{
+    if (other.m_data == other.m_inline) {
+        m_heap.reset();
+        std::memcpy(m_inline, other.m_inline, inlineCapacity);
+        m_data = m_inline;
+    } else {
+        m_heap = std::move(other.m_heap);
+        m_data = other.m_data;
+    }
+    m_source = std::move(other.m_source);
+    other.m_data = nullptr;
+}
+
 /*!
  * \brief Constructs a new TagValue holding the given integer \a value.
  */
@@ -326,6 +487,7 @@ inline TagValue::TagValue(const Popularity &value)
 
 /*!
  * \brief Returns whether both instances are equal.
+ * \remarks Reads the data of values assigned via assignLazyData() (see compareTo() for the implications).
  * \sa The same as TagValue::compareTo() with TagValueComparisionOption::None so see TagValue::compareTo() for details.
  */
 inline bool TagValue::operator==(const TagValue &other) const
@@ -476,7 +638,7 @@ inline std::u16string TagValue::toWString(TagTextEncoding encoding) const
  */
 inline bool TagValue::isNull() const
 {
-    return m_ptr == nullptr;
+    return m_ptr.isNull();
 }
 
 /*!
@@ -489,7 +651,7 @@ inline bool TagValue::isNull() const
  */
 inline bool TagValue::isEmpty() const
 {
-    return m_ptr == nullptr || m_size == 0;
+    return m_ptr.isNull() || m_size == 0;
 }
 
 /*!
@@ -529,12 +691,22 @@ inline std::size_t TagValue::dataSize() const
  * \remarks The instance keeps ownership over the data which will be invalidated when the
  *          TagValue gets destroyed or another value is assigned.
  * \remarks The raw data is not null terminated. See dataSize().
+ * \remarks Reads the data first if it has been assigned via assignLazyData(). Hence this might do I/O and must not be
+ *          called concurrently for the same instance (or copies sharing the same block) then.
+ * \throws Throws std::ios_base::failure when reading data assigned via assignLazyData() fails, e.g. because the file
+ *         has been closed in the meantime.
  */
 inline char *TagValue::dataPointer()
 {
     return m_ptr.get();
 }
 
+/*!
+ * \brief Returns a pointer to the raw data assigned to the current instance.
+ * \remarks Despite being const, this reads the data if it has been assigned via assignLazyData(); call loadData() before
+ *          to make this side-effect-free (e.g. before sharing the instance between threads).
+ * \throws Throws std::ios_base::failure when reading data assigned via assignLazyData() fails.
+ */
 inline const char *TagValue::dataPointer() const
 {
     return m_ptr.get();
@@ -542,12 +714,40 @@ inline const char *TagValue::dataPointer() const
 
 /*!
  * \brief Returns the currently assigned raw data.
+ * \remarks Despite being const, this reads the data if it has been assigned via assignLazyData(); call loadData() before
+ *          to make this side-effect-free (e.g. before sharing the instance between threads).
+ * \throws Throws std::ios_base::failure when reading data assigned via assignLazyData() fails.
  */
 inline std::string_view TagValue::data() const
 {
     return std::string_view(m_ptr.get(), m_size);
 }
 
+/*!
+ * \brief Returns the block the assigned data will be read from when accessed or nullptr if the data is already present.
+ * \remarks Never reads the data.
+ * \sa assignLazyData()
+ */
+inline const StreamDataBlock *TagValue::lazyData() const
+{
+    return m_ptr.source().get();
+}
+
+/*!
+ * \brief Reads the data assigned via assignLazyData() if not done yet.
+ *
+ * After this call all const accessors of the instance are free of side-effects again (until further lazy data is
+ * assigned) and can be used from multiple threads.
+ *
+ * \remarks The file the data is read from must still be open. The instance is left unaltered if reading fails so
+ *          loading can be tried again, e.g. after reopening the file via MediaFileInfo::reopen().
+ * \throws Throws std::ios_base::failure when an IO error occurs, e.g. because the file has been closed in the meantime.
+ */
+inline void TagValue::loadData() const
+{
+    m_ptr.get();
+}
+
 /*!
  * \brief Returns the description.
  * \remarks
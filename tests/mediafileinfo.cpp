@@ -1,9 +1,22 @@
 #include "./helper.h"
 
+#include "../abstractattachment.h"
 #include "../abstracttrack.h"
+#include "../batchscanner.h"
+#include "../batchwriter.h"
 #include "../mediafileinfo.h"
 #include "../progressfeedback.h"
 #include "../tag.h"
+#include "../tagfieldfilter.h"
+
+#include "../id3/id3v2tag.h"
+#include "../matroska/ebmlelement.h"
+#include "../matroska/matroskacontainer.h"
+#include "../matroska/matroskatag.h"
+#include "../matroska/matroskatagid.h"
+#include "../mp4/mp4tag.h"
+#include "../mp4/mp4track.h"
+#include "../vorbis/vorbiscomment.h"
 
 #include <c++utilities/tests/testutils.h>
 using namespace CppUtilities;
@@ -11,7 +24,17 @@ using namespace CppUtilities;
 #include <cppunit/TestFixture.h>
 #include <cppunit/extensions/HelperMacros.h>
 
+#include <algorithm>
+#include <chrono>
 #include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
 
 using namespace std;
 using namespace CppUtilities::Literals;
@@ -29,6 +52,16 @@ class MediaFileInfoTests : public TestFixture {
     CPPUNIT_TEST(testFileSystemMethods);
     CPPUNIT_TEST(testParsingUnsupportedFile);
     CPPUNIT_TEST(testFullParseAndFurtherProperties);
+    CPPUNIT_TEST(testGeneratingMatroskaTrackStatistics);
+    CPPUNIT_TEST(testScanningMatroskaSegmentTail);
+    CPPUNIT_TEST(testLoadingPicturesLazily);
+    CPPUNIT_TEST(testTagFieldFilter);
+    CPPUNIT_TEST(testPendingChanges);
+    CPPUNIT_TEST(testPlanningChanges);
+    CPPUNIT_TEST(testIoStatistics);
+    CPPUNIT_TEST(testMemoryUsage);
+    CPPUNIT_TEST(testBatchScanning);
+    CPPUNIT_TEST(testBatchWriting);
     CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -41,6 +74,16 @@ public:
     void testPartialParsingAndTagCreationOfMp4File();
 
     void testFullParseAndFurtherProperties();
+    void testGeneratingMatroskaTrackStatistics();
+    void testScanningMatroskaSegmentTail();
+    void testLoadingPicturesLazily();
+    void testTagFieldFilter();
+    void testPendingChanges();
+    void testPlanningChanges();
+    void testIoStatistics();
+    void testMemoryUsage();
+    void testBatchScanning();
+    void testBatchWriting();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(MediaFileInfoTests);
@@ -193,3 +236,785 @@ void MediaFileInfoTests::testFullParseAndFurtherProperties()
     CPPUNIT_ASSERT_EQUAL("ID: 3653291187, type: Audio, language: English"s, file.tracks()[1]->label());
     CPPUNIT_ASSERT_EQUAL("MS-MPEG-4-480p / MP3-2ch-eng"s, file.technicalSummary());
 }
+
+void MediaFileInfoTests::testGeneratingMatroskaTrackStatistics()
+{
+    Diagnostics diag;
+    AbortableProgressFeedback progress;
+    MediaFileInfo file(testFilePath("matroska_wave1/test1.mkv"));
+    file.open(true);
+    file.parseContainerFormat(diag, progress);
+    file.parseTracks(diag, progress);
+    file.parseTags(diag, progress);
+    CPPUNIT_ASSERT_EQUAL(ContainerFormat::Matroska, file.containerFormat());
+    auto *const container = static_cast<MatroskaContainer *>(file.container());
+
+    // scanning with one thread and with multiple threads leads to the same statistics
+    const auto statistics = container->generateTrackStatistics(diag, progress, 1);
+    const auto statisticsFromMultipleThreads = container->generateTrackStatistics(diag, progress, 4);
+    CPPUNIT_ASSERT_EQUAL(2_st, statistics.size());
+    CPPUNIT_ASSERT_EQUAL(statistics.size(), statisticsFromMultipleThreads.size());
+    for (auto i = 0_st; i != statistics.size(); ++i) {
+        CPPUNIT_ASSERT_EQUAL(statistics[i].trackNumber, statisticsFromMultipleThreads[i].trackNumber);
+        CPPUNIT_ASSERT_EQUAL(statistics[i].numberOfBytes, statisticsFromMultipleThreads[i].numberOfBytes);
+        CPPUNIT_ASSERT_EQUAL(statistics[i].numberOfFrames, statisticsFromMultipleThreads[i].numberOfFrames);
+        CPPUNIT_ASSERT_EQUAL(statistics[i].startTimestamp, statisticsFromMultipleThreads[i].startTimestamp);
+        CPPUNIT_ASSERT_EQUAL(statistics[i].endTimestamp, statisticsFromMultipleThreads[i].endTimestamp);
+        CPPUNIT_ASSERT_EQUAL(statistics[i].scannedBytes, statisticsFromMultipleThreads[i].scannedBytes);
+    }
+
+    // statistics are plausible and assigned to the tracks
+    for (const auto &trackStatistics : statistics) {
+        CPPUNIT_ASSERT(trackStatistics.numberOfFrames > 0);
+        CPPUNIT_ASSERT(trackStatistics.numberOfBytes > 0);
+        CPPUNIT_ASSERT(trackStatistics.scannedBytes > 0);
+        CPPUNIT_ASSERT(trackStatistics.duration() > TimeSpan::fromMinutes(1.0));
+        CPPUNIT_ASSERT(trackStatistics.duration() < file.duration() + TimeSpan::fromSeconds(1.0));
+        CPPUNIT_ASSERT(trackStatistics.bitrate() > 0);
+    }
+    for (const auto &track : container->tracks()) {
+        const auto &trackStatistics = track->trackNumber() == statistics.front().trackNumber ? statistics.front() : statistics.back();
+        CPPUNIT_ASSERT_EQUAL(trackStatistics.numberOfFrames, track->sampleCount());
+        CPPUNIT_ASSERT_EQUAL(trackStatistics.numberOfBytes, track->size());
+        CPPUNIT_ASSERT_EQUAL(trackStatistics.duration(), track->duration());
+    }
+
+    // statistics are stored as tags (which are read again as usual)
+    const auto tagCount = container->tags().size();
+    const auto *const tag = container->createTag(TagTarget(50, { container->tracks().front()->id() }));
+    CPPUNIT_ASSERT_EQUAL(tagCount, container->tags().size());
+    CPPUNIT_ASSERT_EQUAL(
+        numberToString(container->tracks().front()->sampleCount()), tag->value(string(MatroskaTagIds::TrackSpecific::numberOfFrames())).toString());
+    CPPUNIT_ASSERT_EQUAL(
+        "BPS DURATION NUMBER_OF_FRAMES NUMBER_OF_BYTES"s, tag->value(string(MatroskaTagIds::TrackSpecific::statisticsTags())).toString());
+    const auto expectedSampleCount = container->tracks().front()->sampleCount();
+    container->tracks().front()->readStatisticsFromTags(container->tags(), diag);
+    CPPUNIT_ASSERT_EQUAL(expectedSampleCount, container->tracks().front()->sampleCount());
+}
+
+void MediaFileInfoTests::testScanningMatroskaSegmentTail()
+{
+    Diagnostics diag;
+    AbortableProgressFeedback progress;
+    MediaFileInfo file(workingCopyPath("matroska_wave1/test1.mkv"));
+    file.setIoStatisticsEnabled(true);
+    const auto reparse = [&] {
+        file.clearParsingResults();
+        file.resetIoStatistics();
+        file.open();
+        file.parseContainerFormat(diag, progress);
+        file.parseTracks(diag, progress);
+        file.parseTags(diag, progress);
+        CPPUNIT_ASSERT_EQUAL(ContainerFormat::Matroska, file.containerFormat());
+        CPPUNIT_ASSERT_EQUAL(ParsingStatus::Ok, file.tagsParsingStatus());
+        return file.ioStatistics().phase(IoPhase::ParseContainerFormat).bytesRead;
+    };
+    static constexpr auto tailScanSize = std::uint64_t(0x400000);
+
+    // move the tags to the end of the file so they are only found via the "SeekHead"-element or by scanning the end of the segment
+    reparse();
+    CPPUNIT_ASSERT_MESSAGE("file big enough to tell whether its end has been scanned", file.size() > 2 * tailScanSize);
+    const auto tagCount = file.tags().size();
+    CPPUNIT_ASSERT(tagCount > 0);
+    file.setTagPosition(ElementPosition::AfterData);
+    file.applyChanges(diag, progress);
+    file.setMaxFullParseSize(0);
+
+    // tagged file with complete "SeekHead"-element: tags are found via the "SeekHead"-element, the end is not scanned
+    auto bytesRead = reparse();
+    CPPUNIT_ASSERT_EQUAL(ElementPosition::AfterData, file.container()->determineTagPosition(diag));
+    CPPUNIT_ASSERT_EQUAL(tagCount, file.tags().size());
+    CPPUNIT_ASSERT_MESSAGE("end of segment not scanned", bytesRead < tailScanSize);
+
+    // no "SeekHead"-element: tags are found by scanning the end of the segment (not by walking through the clusters as the
+    // max. full parse size is exceeded)
+    auto *const segment = file.container()->firstElement()->siblingByIdIncludingThis(MatroskaIds::Segment, diag);
+    CPPUNIT_ASSERT(segment);
+    auto *const seekHead = segment->childById(MatroskaIds::SeekHead, diag);
+    CPPUNIT_ASSERT(seekHead);
+    const auto seekHeadOffset = static_cast<std::streamoff>(seekHead->startOffset());
+    const auto seekHeadSize = seekHead->totalSize();
+    CPPUNIT_ASSERT(seekHeadSize >= 9);
+    file.close();
+    {
+        auto voidElement = std::string(seekHeadSize, '\0');
+        voidElement[0] = static_cast<char>(EbmlIds::Void);
+        EbmlElement::makeSizeDenotation(seekHeadSize - 9, voidElement.data() + 1, 8);
+        auto stream = std::fstream(file.path(), std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+        stream.seekp(seekHeadOffset);
+        stream.write(voidElement.data(), static_cast<std::streamsize>(voidElement.size()));
+    }
+    bytesRead = reparse();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("tags found at the end of the segment", tagCount, file.tags().size());
+    CPPUNIT_ASSERT_MESSAGE("end of segment scanned", bytesRead >= tailScanSize);
+
+    // untagged file with complete "SeekHead"-element: the "SeekHead"-element denotes the "Cues"-element, the end is not scanned
+    file.removeAllTags();
+    file.applyChanges(diag, progress);
+    bytesRead = reparse();
+    CPPUNIT_ASSERT_EQUAL(0_st, file.tags().size());
+    CPPUNIT_ASSERT_MESSAGE("end of segment not scanned", bytesRead < tailScanSize);
+
+    file.close();
+    remove(file.path().data());
+    remove((file.path() + ".bak").data());
+}
+
+void MediaFileInfoTests::testLoadingPicturesLazily()
+{
+    Diagnostics diag;
+    AbortableProgressFeedback progress;
+    const auto path = testFilePath("mtx-test-data/alac/othertest-itunes.m4a");
+    MediaFileInfo eagerFile(path), lazyFile(path);
+    lazyFile.setFileHandlingFlags(lazyFile.fileHandlingFlags() | MediaFileHandlingFlags::LoadPicturesLazily);
+    for (auto *const file : { &eagerFile, &lazyFile }) {
+        file->open(true);
+        file->parseContainerFormat(diag, progress);
+        file->parseTags(diag, progress);
+        CPPUNIT_ASSERT_EQUAL(ParsingStatus::Ok, file->tagsParsingStatus());
+        CPPUNIT_ASSERT_EQUAL(1_st, file->tags().size());
+    }
+
+    const auto &eagerCover = eagerFile.tags().front()->value(KnownField::Cover);
+    const auto &lazyCover = lazyFile.tags().front()->value(KnownField::Cover);
+    CPPUNIT_ASSERT_MESSAGE("cover read when parsing by default", !eagerCover.lazyData());
+    CPPUNIT_ASSERT_MESSAGE("cover not read when parsing lazily", lazyCover.lazyData());
+    CPPUNIT_ASSERT_EQUAL(TagDataType::Picture, lazyCover.type());
+    CPPUNIT_ASSERT_EQUAL(0x58f3_st, lazyCover.dataSize());
+    CPPUNIT_ASSERT(!lazyCover.isEmpty());
+
+    // copies share the data block until the data is read
+    const auto copiedCover = lazyCover;
+    CPPUNIT_ASSERT_EQUAL(lazyCover.lazyData(), copiedCover.lazyData());
+
+    // writing the data copies it directly from the file
+    auto copiedData = std::stringstream(std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+    copiedCover.copyDataTo(copiedData);
+    CPPUNIT_ASSERT_MESSAGE("cover still not read", copiedCover.lazyData());
+    CPPUNIT_ASSERT_EQUAL(eagerCover.data(), std::string_view(copiedData.str()));
+
+    // accessing the data reads it
+    CPPUNIT_ASSERT_EQUAL(0xFFD8FFE000104A46ul, BE::toInt<std::uint64_t>(lazyCover.dataPointer()));
+    CPPUNIT_ASSERT_MESSAGE("cover read when accessed", !lazyCover.lazyData());
+    CPPUNIT_ASSERT_EQUAL(eagerCover.data(), lazyCover.data());
+    CPPUNIT_ASSERT_EQUAL(eagerCover, copiedCover);
+    CPPUNIT_ASSERT_MESSAGE("copy read independently", !copiedCover.lazyData());
+
+    // reading the data fails after closing the file but can be tried again after reopening it
+    lazyFile.clearParsingResults();
+    lazyFile.parseContainerFormat(diag, progress);
+    lazyFile.parseTags(diag, progress);
+    auto lazyCoverAfterClose = lazyFile.tags().front()->value(KnownField::Cover);
+    CPPUNIT_ASSERT_MESSAGE("cover not read yet", lazyCoverAfterClose.lazyData());
+    lazyFile.close();
+    CPPUNIT_ASSERT_THROW(lazyCoverAfterClose.loadData(), std::ios_base::failure);
+    CPPUNIT_ASSERT_THROW(lazyCoverAfterClose.data(), std::ios_base::failure);
+    CPPUNIT_ASSERT_MESSAGE("cover still lazy after failure", lazyCoverAfterClose.lazyData());
+    CPPUNIT_ASSERT_EQUAL(0x58f3_st, lazyCoverAfterClose.dataSize());
+    lazyFile.reopen(true);
+    lazyCoverAfterClose.loadData();
+    CPPUNIT_ASSERT_MESSAGE("cover read after reopening", !lazyCoverAfterClose.lazyData());
+    CPPUNIT_ASSERT_EQUAL(eagerCover.data(), lazyCoverAfterClose.data());
+}
+
+/*!
+ * \brief Parses the tag of the specified type from the specified file only decoding the title, changes the title and checks
+ *        whether all other fields have been preserved byte by byte when applying the change.
+ */
+template <class TagType> static void checkTagFieldFilterRoundTrip(const std::string &path)
+{
+    Diagnostics diag;
+    AbortableProgressFeedback progress;
+    const auto firstTag = [](MediaFileInfo &file) {
+        for (auto *const tag : file.tags()) {
+            if (auto *const concreteTag = dynamic_cast<TagType *>(tag)) {
+                return concreteTag;
+            }
+        }
+        CPPUNIT_FAIL("tag of expected type not present");
+        return static_cast<TagType *>(nullptr);
+    };
+
+    MediaFileInfo fullFile(testFilePath(path)), filteredFile(workingCopyPath(path));
+    fullFile.open(true);
+    fullFile.parseEverything(diag, progress);
+    filteredFile.setTagFieldFilter(TagFieldFilter{ KnownField::Title });
+    filteredFile.open();
+    filteredFile.parseEverything(diag, progress);
+    const auto *const fullTag = firstTag(fullFile);
+    auto *const filteredTag = firstTag(filteredFile);
+    CPPUNIT_ASSERT_MESSAGE("fields besides title skipped", !filteredTag->skippedFields().empty());
+
+    const auto newTitle = TagValue("new title"sv, TagTextEncoding::Utf8);
+    filteredTag->setValue(KnownField::Title, newTitle);
+    filteredFile.applyChanges(diag, progress);
+    CPPUNIT_ASSERT(diag.level() < DiagLevel::Critical);
+
+    // reparse without filter
+    filteredFile.clearParsingResults();
+    filteredFile.setTagFieldFilter(TagFieldFilter());
+    filteredFile.parseEverything(diag, progress);
+    const auto *const rewrittenTag = firstTag(filteredFile);
+    CPPUNIT_ASSERT_EQUAL(newTitle.toString(), rewrittenTag->value(KnownField::Title).toString(TagTextEncoding::Utf8));
+    for (const auto &[id, field] : fullTag->fields()) {
+        if (fullTag->knownField(id) == KnownField::Title) {
+            continue;
+        }
+        const auto expectedValues = fullTag->values(id), actualValues = rewrittenTag->values(id);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("number of values preserved", expectedValues.size(), actualValues.size());
+        for (auto i = std::size_t(); i != expectedValues.size(); ++i) {
+            CPPUNIT_ASSERT_EQUAL_MESSAGE("data preserved byte by byte", expectedValues[i]->data(), actualValues[i]->data());
+            CPPUNIT_ASSERT_EQUAL(expectedValues[i]->type(), actualValues[i]->type());
+        }
+    }
+    filteredFile.close();
+    remove(filteredFile.path().data());
+    remove((filteredFile.path() + ".bak").data());
+}
+
+void MediaFileInfoTests::testTagFieldFilter()
+{
+    Diagnostics diag;
+    AbortableProgressFeedback progress;
+    const auto path = testFilePath("mtx-test-data/alac/othertest-itunes.m4a");
+    MediaFileInfo fullFile(path), filteredFile(path);
+    filteredFile.setTagFieldFilter(TagFieldFilter{ KnownField::Title });
+    CPPUNIT_ASSERT(filteredFile.tagFieldFilter().isActive());
+    for (auto *const file : { &fullFile, &filteredFile }) {
+        file->open(true);
+        file->parseContainerFormat(diag, progress);
+        file->parseTags(diag, progress);
+        CPPUNIT_ASSERT_EQUAL(ParsingStatus::Ok, file->tagsParsingStatus());
+        CPPUNIT_ASSERT_EQUAL(1_st, file->tags().size());
+    }
+
+    auto *const fullTag = dynamic_cast<Mp4Tag *>(fullFile.tags().front());
+    auto *const filteredTag = dynamic_cast<Mp4Tag *>(filteredFile.tags().front());
+    CPPUNIT_ASSERT(fullTag);
+    CPPUNIT_ASSERT(filteredTag);
+    CPPUNIT_ASSERT(fullTag->skippedFields().empty());
+    CPPUNIT_ASSERT_EQUAL(fullTag->value(KnownField::Title), filteredTag->value(KnownField::Title));
+    CPPUNIT_ASSERT(!fullTag->value(KnownField::Cover).isEmpty());
+    CPPUNIT_ASSERT_MESSAGE("cover not decoded", filteredTag->value(KnownField::Cover).isEmpty());
+    CPPUNIT_ASSERT_MESSAGE("other fields kept as raw atoms", !filteredTag->skippedFields().empty());
+    CPPUNIT_ASSERT_EQUAL(fullTag->fields().size(), filteredTag->fields().size() + filteredTag->skippedFields().size());
+
+    // skipped atoms are written as-is so the made tag equals the one made from the fully parsed tag
+    auto fullTagData = std::stringstream(std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+    auto filteredTagData = std::stringstream(std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+    auto fullTagMaker = fullTag->prepareMaking(diag);
+    auto filteredTagMaker = filteredTag->prepareMaking(diag);
+    CPPUNIT_ASSERT_EQUAL(fullTagMaker.requiredSize(), filteredTagMaker.requiredSize());
+    fullTagMaker.make(fullTagData, diag);
+    filteredTagMaker.make(filteredTagData, diag);
+    // note: Only sizes are compared here as skipped atoms are written after decoded ones so the order differs. The
+    //       round-trips below compare the data of each field byte by byte.
+    CPPUNIT_ASSERT_EQUAL(fullTagData.str().size(), filteredTagData.str().size());
+
+    // skipped fields are preserved when applying changes (for all tag formats supporting the filter)
+    checkTagFieldFilterRoundTrip<Mp4Tag>("mtx-test-data/alac/othertest-itunes.m4a");
+    checkTagFieldFilterRoundTrip<Id3v2Tag>("misc/multiple_id3v2_4_values.mp3");
+    checkTagFieldFilterRoundTrip<VorbisComment>("flac/test.flac");
+    checkTagFieldFilterRoundTrip<MatroskaTag>("matroska_wave1/test1.mkv");
+
+    // raw IDs are matched against the IDs of the particular tag format; IDs not valid for a format are ignored for it
+    auto rawIdFilter = TagFieldFilter();
+    rawIdFilter.addRawId("TIT2").addRawId("©nam").addRawId("title");
+    CPPUNIT_ASSERT_EQUAL(3_st, rawIdFilter.rawIds().size());
+    auto rawIdFile = MediaFileInfo(testFilePath("misc/multiple_id3v2_4_values.mp3"));
+    rawIdFile.setTagFieldFilter(rawIdFilter);
+    rawIdFile.open(true);
+    rawIdFile.parseContainerFormat(diag, progress);
+    rawIdFile.parseTags(diag, progress);
+    CPPUNIT_ASSERT_EQUAL(1_st, rawIdFile.id3v2Tags().size());
+    const auto *const rawIdTag = rawIdFile.id3v2Tags().front().get();
+    CPPUNIT_ASSERT_EQUAL("Infinite (Original Mix)"s, rawIdTag->value(KnownField::Title).toString(TagTextEncoding::Utf8));
+    CPPUNIT_ASSERT_MESSAGE("artist not decoded", rawIdTag->value(KnownField::Artist).isEmpty());
+}
+
+void MediaFileInfoTests::testPendingChanges()
+{
+    Diagnostics diag;
+    AbortableProgressFeedback progress;
+    MediaFileInfo file(workingCopyPath("matroska_wave1/test1.mkv"));
+    file.setForceRewrite(false);
+    file.setTagPosition(ElementPosition::Keep);
+    file.setIndexPosition(ElementPosition::Keep);
+    CPPUNIT_ASSERT_MESSAGE("changes assumed to be pending before parsing", file.hasPendingChanges());
+    file.open();
+    file.parseEverything(diag, progress);
+    CPPUNIT_ASSERT_EQUAL(ParsingStatus::Ok, file.tagsParsingStatus());
+    CPPUNIT_ASSERT_EQUAL(ParsingStatus::Ok, file.tracksParsingStatus());
+    CPPUNIT_ASSERT_MESSAGE("padding assumed to violate max. padding if unknown", file.hasPendingChanges());
+    file.setMaxPadding(std::numeric_limits<std::size_t>::max());
+    CPPUNIT_ASSERT_MESSAGE("no pending changes after parsing", !file.hasPendingChanges());
+    file.setForceRewrite(true);
+    CPPUNIT_ASSERT_MESSAGE("forcing a rewrite is considered a pending change", file.hasPendingChanges());
+    file.setForceRewrite(false);
+
+    // assigning present values is not considered a modification
+    auto *const tag = file.tags().front();
+    auto *const track = file.tracks().front();
+    CPPUNIT_ASSERT_EQUAL("Big Buck Bunny - test 1"s, tag->value(KnownField::Title).toString());
+    CPPUNIT_ASSERT(tag->setValue(KnownField::Title, TagValue(tag->value(KnownField::Title))));
+    track->setName(track->name());
+    track->setEnabled(track->isEnabled());
+    CPPUNIT_ASSERT(!tag->isModified());
+    CPPUNIT_ASSERT(!track->isModified());
+    CPPUNIT_ASSERT(!file.hasPendingChanges());
+
+    // applying changes leaves the file untouched but clears the parsing results
+    const auto sizeBefore = file.size();
+    diag.clear();
+    file.applyChanges(diag, progress);
+    CPPUNIT_ASSERT_EQUAL(Diagnostics({ DiagMessage(DiagLevel::Information, "Changes are about to be applied.", "making file"),
+                             DiagMessage(DiagLevel::Information, "There are no changes to be applied; the file is left untouched.", "making file") }),
+        diag);
+    CPPUNIT_ASSERT_EQUAL(sizeBefore, file.size());
+    CPPUNIT_ASSERT_EQUAL(sizeBefore, static_cast<std::uint64_t>(std::filesystem::file_size(file.path())));
+    CPPUNIT_ASSERT_EQUAL(ParsingStatus::NotParsedYet, file.tagsParsingStatus());
+    CPPUNIT_ASSERT_EQUAL(ParsingStatus::NotParsedYet, file.tracksParsingStatus());
+
+    // adding/removing tags is considered a pending change
+    file.parseEverything(diag, progress);
+    CPPUNIT_ASSERT(!file.hasPendingChanges());
+    file.removeAllTags();
+    CPPUNIT_ASSERT(file.hasPendingChanges());
+
+    // modifying values is considered a pending change
+    file.clearParsingResults();
+    file.parseEverything(diag, progress);
+    CPPUNIT_ASSERT(!file.hasPendingChanges());
+    auto *const reparsedTag = file.tags().front();
+    CPPUNIT_ASSERT(reparsedTag->setValue(KnownField::Title, TagValue("Big Buck Bunny - test 1 (modified)"sv, TagTextEncoding::Utf8)));
+    CPPUNIT_ASSERT(reparsedTag->isModified());
+    CPPUNIT_ASSERT(file.hasPendingChanges());
+    file.clearParsingResults();
+    file.parseEverything(diag, progress);
+    auto *const reparsedTrack = file.tracks().front();
+    reparsedTrack->setName("foo"sv);
+    CPPUNIT_ASSERT(reparsedTrack->isModified());
+    CPPUNIT_ASSERT(file.hasPendingChanges());
+
+    // padding not within min./max. padding is considered a pending change (the padding is only known when doing a full parse)
+    file.setForceFullParse(true);
+    file.clearParsingResults();
+    file.parseEverything(diag, progress);
+    const auto padding = static_cast<std::size_t>(file.paddingSize());
+    file.setMinPadding(padding);
+    file.setMaxPadding(padding);
+    CPPUNIT_ASSERT_MESSAGE("padding within min./max. padding", !file.hasPendingChanges());
+    file.setMinPadding(padding + 1);
+    file.setMaxPadding(padding + 1);
+    CPPUNIT_ASSERT_MESSAGE("padding smaller than min. padding", file.hasPendingChanges());
+    file.setMinPadding(0);
+    file.setMaxPadding(padding ? padding - 1 : 0);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("padding bigger than max. padding", padding != 0, file.hasPendingChanges());
+    file.setMaxPadding(padding);
+
+    // enforced element positions not matching the present positions are considered a pending change
+    const auto tagPosition = file.container()->determineTagPosition(diag);
+    CPPUNIT_ASSERT(tagPosition != ElementPosition::Keep);
+    file.setTagPosition(tagPosition);
+    CPPUNIT_ASSERT(!file.hasPendingChanges());
+    file.setTagPosition(tagPosition == ElementPosition::BeforeData ? ElementPosition::AfterData : ElementPosition::BeforeData);
+    file.setForceTagPosition(false);
+    CPPUNIT_ASSERT_MESSAGE("tag position not enforced", !file.hasPendingChanges());
+    file.setForceTagPosition(true);
+    CPPUNIT_ASSERT_MESSAGE("tag position enforced", file.hasPendingChanges());
+    file.close();
+    remove(file.path().data());
+}
+
+void MediaFileInfoTests::testPlanningChanges()
+{
+    Diagnostics diag;
+    AbortableProgressFeedback progress;
+    MediaFileInfo file(workingCopyPath("matroska_wave1/test1.mkv"));
+    file.setForceRewrite(false);
+    file.setMaxPadding(std::numeric_limits<std::size_t>::max());
+    file.setTagPosition(ElementPosition::Keep);
+    file.setIndexPosition(ElementPosition::Keep);
+    file.open();
+    file.parseEverything(diag, progress);
+    CPPUNIT_ASSERT_EQUAL(ChangeStrategy::None, file.planChanges(diag, progress).strategy);
+
+    // planning neither alters the file nor the pending changes
+    auto *const tag = file.tags().front();
+    file.tracks().front()->setName("foo"sv);
+    const auto sizeBefore = file.size();
+    auto plan = file.planChanges(diag, progress);
+    CPPUNIT_ASSERT(plan.strategy != ChangeStrategy::None);
+    CPPUNIT_ASSERT(plan.bytesToCopy <= plan.bytesToWrite);
+    CPPUNIT_ASSERT_MESSAGE("making tags to compute their size does not mark them as modified", !tag->isModified());
+    CPPUNIT_ASSERT(file.hasPendingChanges());
+    CPPUNIT_ASSERT_EQUAL(ParsingStatus::Ok, file.tagsParsingStatus());
+    CPPUNIT_ASSERT_EQUAL(tag, file.tags().front());
+    CPPUNIT_ASSERT_EQUAL(sizeBefore, static_cast<std::uint64_t>(std::filesystem::file_size(file.path())));
+
+    // a rewrite copies the clusters and uses the preferred padding
+    file.setForceRewrite(true);
+    file.setPreferredPadding(1024);
+    plan = file.planChanges(diag, progress);
+    CPPUNIT_ASSERT_EQUAL(ChangeStrategy::Rewrite, plan.strategy);
+    CPPUNIT_ASSERT_EQUAL(std::uint64_t(1024), plan.newPadding);
+    CPPUNIT_ASSERT(plan.bytesToCopy > 0);
+    CPPUNIT_ASSERT_EQUAL(plan.newSize, plan.bytesToWrite);
+    CPPUNIT_ASSERT(!plan.isEstimated);
+
+    // plans the pending changes, checks whether the actual outcome matches the plan and parses the file again
+    // note: A backup file is only created when the file is rewritten so its presence tells the actual strategy.
+    const auto applyPlannedChanges = [&diag, &progress](MediaFileInfo &fileInfo, ChangeStrategy expectedStrategy) {
+        diag.clear();
+        const auto changePlan = fileInfo.planChanges(diag, progress);
+        CPPUNIT_ASSERT_EQUAL(expectedStrategy, changePlan.strategy);
+        const auto backupPath = fileInfo.path() + ".bak";
+        std::filesystem::remove(backupPath);
+        fileInfo.applyChanges(diag, progress);
+        CPPUNIT_ASSERT(diag.level() < DiagLevel::Critical);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("actual strategy matches plan", changePlan.strategy == ChangeStrategy::Rewrite, std::filesystem::exists(backupPath));
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("actual size matches plan", changePlan.newSize, fileInfo.size());
+        fileInfo.close();
+        CPPUNIT_ASSERT_EQUAL_MESSAGE(
+            "size on disk matches plan", changePlan.newSize, static_cast<std::uint64_t>(std::filesystem::file_size(fileInfo.path())));
+        std::filesystem::remove(backupPath);
+        fileInfo.open();
+        fileInfo.parseEverything(diag, progress);
+        CPPUNIT_ASSERT(diag.level() < DiagLevel::Critical);
+    };
+
+    // Matroska: rewrite
+    applyPlannedChanges(file, ChangeStrategy::Rewrite);
+
+    // Matroska: rewrite without padding, then append tags which do not fit in-place anymore to the end of the segment
+    file.setForceFullParse(true);
+    file.setMinPadding(0);
+    file.setMaxPadding(0);
+    file.setPreferredPadding(0);
+    file.setIndexPosition(ElementPosition::BeforeData);
+    file.setForceIndexPosition(true);
+    file.setTagPosition(ElementPosition::AfterData);
+    file.setForceTagPosition(true);
+    file.setWritingApplication(std::string_view());
+    file.tags().front()->setValue(KnownField::Title, TagValue("title"));
+    applyPlannedChanges(file, ChangeStrategy::Rewrite);
+    file.setForceRewrite(false);
+    file.setWritingApplication(std::string(512, 'x'));
+    file.tags().front()->setValue(KnownField::Title, TagValue(std::string(1000, 't'), TagTextEncoding::Utf8));
+    applyPlannedChanges(file, ChangeStrategy::InPlace);
+    CPPUNIT_ASSERT_EQUAL(ElementPosition::AfterData, file.container()->determineTagPosition(diag));
+    file.close();
+    remove(file.path().data());
+
+    // MP4: rewrite putting the tags before the media data followed by padding, then update the tags in-place using that padding
+    MediaFileInfo mp4File(workingCopyPath("mtx-test-data/alac/othertest-itunes.m4a"));
+    mp4File.setMaxPadding(std::numeric_limits<std::size_t>::max());
+    mp4File.setPreferredPadding(1024);
+    mp4File.setTagPosition(ElementPosition::BeforeData);
+    mp4File.setForceTagPosition(true);
+    mp4File.open();
+    mp4File.parseEverything(diag, progress);
+    mp4File.setForceRewrite(true);
+    mp4File.tags().front()->setValue(KnownField::Title, TagValue("long title which is replaced with a shorter one"));
+    applyPlannedChanges(mp4File, ChangeStrategy::Rewrite);
+    mp4File.setForceRewrite(false);
+    mp4File.tags().front()->setValue(KnownField::Title, TagValue("short title"));
+    applyPlannedChanges(mp4File, ChangeStrategy::InPlace);
+    mp4File.close();
+    remove(mp4File.path().data());
+
+    // MP3: rewrite adding padding after the ID3v2 tag, then update the ID3v2 tag in-place using that padding
+    MediaFileInfo mp3File(workingCopyPath("misc/multiple_id3v2_4_values.mp3"));
+    mp3File.setMaxPadding(std::numeric_limits<std::size_t>::max());
+    mp3File.setPreferredPadding(1024);
+    mp3File.open();
+    mp3File.parseEverything(diag, progress);
+    CPPUNIT_ASSERT(mp3File.id3v2Tags().size() > 0);
+    mp3File.setForceRewrite(true);
+    mp3File.id3v2Tags().front()->setValue(KnownField::Title, TagValue("long title which is replaced with a shorter one"));
+    applyPlannedChanges(mp3File, ChangeStrategy::Rewrite);
+    mp3File.setForceRewrite(false);
+    mp3File.id3v2Tags().front()->setValue(KnownField::Title, TagValue("short title"));
+    applyPlannedChanges(mp3File, ChangeStrategy::InPlace);
+    mp3File.close();
+    remove(mp3File.path().data());
+}
+
+void MediaFileInfoTests::testIoStatistics()
+{
+    Diagnostics diag;
+    AbortableProgressFeedback progress;
+    MediaFileInfo file(workingCopyPath("matroska_wave1/test1.mkv"));
+    CPPUNIT_ASSERT(!file.isIoStatisticsEnabled());
+    file.parseContainerFormat(diag, progress);
+    CPPUNIT_ASSERT_EQUAL(std::uint64_t(0), file.ioStatistics().total().bytesRead);
+
+    // parsing is accounted to the phases
+    file.setIoStatisticsEnabled(true);
+    CPPUNIT_ASSERT(file.isIoStatisticsEnabled());
+    file.parseTracks(diag, progress);
+    file.parseTags(diag, progress);
+    auto statistics = file.ioStatistics();
+    const auto &tracksCounters = statistics.phase(IoPhase::ParseTracks);
+    CPPUNIT_ASSERT(tracksCounters.bytesRead > 0);
+    CPPUNIT_ASSERT(tracksCounters.reads > 0);
+    CPPUNIT_ASSERT(tracksCounters.totalTime >= tracksCounters.ioTime);
+    CPPUNIT_ASSERT_EQUAL(std::uint64_t(0), tracksCounters.bytesWritten);
+    CPPUNIT_ASSERT_EQUAL(std::uint64_t(0), statistics.phase(IoPhase::ParseContainerFormat).bytesRead);
+    CPPUNIT_ASSERT_EQUAL(
+        tracksCounters.bytesRead + statistics.phase(IoPhase::ParseTags).bytesRead + statistics.phase(IoPhase::Other).bytesRead,
+        statistics.total().bytesRead);
+
+    // reading the stream outside of a phase is accounted to "other"
+    char buffer[4];
+    file.stream().seekg(0);
+    file.stream().read(buffer, sizeof(buffer));
+    statistics = file.ioStatistics();
+    CPPUNIT_ASSERT_EQUAL(std::uint64_t(4), statistics.phase(IoPhase::Other).bytesRead);
+    CPPUNIT_ASSERT_EQUAL(std::uint64_t(1), statistics.phase(IoPhase::Other).seeks);
+    CPPUNIT_ASSERT_EQUAL(std::chrono::nanoseconds::zero(), statistics.phase(IoPhase::Other).totalTime);
+
+    // rewriting the file reads the backup file and writes the whole file
+    file.resetIoStatistics();
+    CPPUNIT_ASSERT_EQUAL(std::uint64_t(0), file.ioStatistics().total().reads);
+    file.tracks().front()->setName("foo"sv);
+    file.applyChanges(diag, progress);
+    CPPUNIT_ASSERT(diag.level() < DiagLevel::Critical);
+    statistics = file.ioStatistics();
+    const auto &applyCounters = statistics.phase(IoPhase::ApplyChanges);
+    CPPUNIT_ASSERT(applyCounters.bytesRead > 0);
+    CPPUNIT_ASSERT(applyCounters.bytesWritten >= file.size());
+    CPPUNIT_ASSERT_EQUAL(applyCounters.bytesWritten, statistics.total().bytesWritten);
+
+    // disabling discards statistics
+    file.setIoStatisticsEnabled(false);
+    CPPUNIT_ASSERT_EQUAL(std::uint64_t(0), file.ioStatistics().total().bytesWritten);
+    file.close();
+    remove(file.path().data());
+    remove((file.path() + ".bak").data());
+}
+
+void MediaFileInfoTests::testMemoryUsage()
+{
+    Diagnostics diag;
+    AbortableProgressFeedback progress;
+    MediaFileInfo file(testFilePath("matroska_wave1/test1.mkv"));
+    CPPUNIT_ASSERT_EQUAL(0_st, file.memoryUsage().total());
+    file.open(true);
+    file.parseEverything(diag, progress);
+
+    // element tree, tracks and tags are accounted
+    auto usage = file.memoryUsage();
+    CPPUNIT_ASSERT(usage.elementCount > 0);
+    CPPUNIT_ASSERT(usage.elementNodes >= usage.elementCount * sizeof(EbmlElement));
+    CPPUNIT_ASSERT_EQUAL(0_st, usage.elementBuffers);
+    CPPUNIT_ASSERT(usage.tracks >= 2 * sizeof(MatroskaTrack));
+    CPPUNIT_ASSERT_EQUAL(0_st, usage.sampleTables);
+    CPPUNIT_ASSERT(usage.tags >= sizeof(MatroskaTag));
+    CPPUNIT_ASSERT_EQUAL(0_st, usage.attachments);
+    CPPUNIT_ASSERT_EQUAL(0_st, usage.oggPages);
+    CPPUNIT_ASSERT_EQUAL(usage.elementNodes + usage.tracks + usage.tags + usage.tagValuesTotal(), usage.total());
+
+    // buffered elements and values stored on the heap are accounted
+    auto *const firstElement = static_cast<MatroskaContainer *>(file.container())->firstElement();
+    firstElement->makeBuffer();
+    file.tags().front()->setValue(KnownField::Title, TagValue(std::string(100, 'x')));
+    usage = file.memoryUsage();
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::size_t>(firstElement->totalSize()), usage.elementBuffers);
+    CPPUNIT_ASSERT(usage.tagValuesOfType(TagDataType::Text) >= 100);
+    file.close();
+
+    // sample tables of MP4 tracks are accounted
+    MediaFileInfo mp4File(testFilePath("mtx-test-data/aac/he-aacv2-ps.m4a"));
+    mp4File.open(true);
+    mp4File.parseTracks(diag, progress);
+    mp4File.close();
+    auto sampleTableSize = std::size_t();
+    for (const auto *const track : mp4File.tracks()) {
+        sampleTableSize += static_cast<const Mp4Track *>(track)->sampleSizes().capacity() * sizeof(std::uint32_t);
+    }
+    CPPUNIT_ASSERT(sampleTableSize > 0);
+    CPPUNIT_ASSERT_EQUAL(sampleTableSize, mp4File.memoryUsage().sampleTables);
+}
+
+void MediaFileInfoTests::testBatchScanning()
+{
+    const auto mkvPath = testFilePath("matroska_wave1/test1.mkv");
+    const auto mp4Path = testFilePath("mtx-test-data/aac/he-aacv2-ps.m4a");
+    const auto unsupportedPath = testFilePath("unsupported.bin");
+    const auto paths = std::vector<std::string>{ mkvPath, mp4Path, unsupportedPath, mkvPath + ".does-not-exist", mp4Path, mkvPath, mkvPath };
+    auto scanner = BatchScanner(ParsingDepth::Tags);
+    scanner.setThreadCount(3);
+    scanner.setMaxOpenFiles(2);
+
+    // scan all files; the results might be passed in any order
+    auto progress = AbortableProgressFeedback();
+    auto scannedIndices = std::set<std::size_t>();
+    const auto scannedFiles = scanner.scan(
+        paths,
+        [&](BatchScanResult &&result) {
+            CPPUNIT_ASSERT_MESSAGE("each file passed only once", scannedIndices.emplace(result.index).second);
+            CPPUNIT_ASSERT(result.fileInfo);
+            CPPUNIT_ASSERT_EQUAL(paths[result.index], result.fileInfo->path());
+            CPPUNIT_ASSERT_MESSAGE("file closed after scanning", !result.fileInfo->isOpen());
+            if (result.index == 3) {
+                CPPUNIT_ASSERT_EQUAL(DiagLevel::Critical, result.diag.level());
+                return;
+            }
+            CPPUNIT_ASSERT_EQUAL(ParsingStatus::NotParsedYet, result.fileInfo->chaptersParsingStatus());
+            if (paths[result.index] == mkvPath) {
+                CPPUNIT_ASSERT_EQUAL(ContainerFormat::Matroska, result.fileInfo->containerFormat());
+                CPPUNIT_ASSERT_EQUAL(ParsingStatus::Ok, result.fileInfo->tagsParsingStatus());
+                CPPUNIT_ASSERT_EQUAL("Big Buck Bunny - test 1"s, result.fileInfo->tags().front()->value(KnownField::Title).toString());
+            } else if (paths[result.index] == mp4Path) {
+                CPPUNIT_ASSERT_EQUAL(ContainerFormat::Mp4, result.fileInfo->containerFormat());
+                CPPUNIT_ASSERT_EQUAL(ParsingStatus::Ok, result.fileInfo->tracksParsingStatus());
+            } else {
+                CPPUNIT_ASSERT_EQUAL(ParsingStatus::NotSupported, result.fileInfo->containerParsingStatus());
+            }
+        },
+        progress);
+    CPPUNIT_ASSERT_EQUAL(paths.size(), scannedFiles);
+    CPPUNIT_ASSERT_EQUAL(paths.size(), scannedIndices.size());
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::uint8_t>(100), progress.stepPercentage());
+
+    // aborting stops the scanning
+    auto abortedProgress = AbortableProgressFeedback();
+    auto resultsAfterAbort = std::size_t();
+    CPPUNIT_ASSERT_THROW(scanner.scan(
+                             paths,
+                             [&](BatchScanResult &&) {
+                                 if (abortedProgress.isAborted()) {
+                                     ++resultsAfterAbort;
+                                 }
+                                 abortedProgress.tryToAbort();
+                             },
+                             abortedProgress),
+        OperationAbortedException);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("no results passed after aborting", std::size_t(0), resultsAfterAbort);
+}
+
+void MediaFileInfoTests::testBatchWriting()
+{
+    const auto paths = std::vector<std::string>{ workingCopyPath("matroska_wave1/test1.mkv"), workingCopyPath("matroska_wave1/test2.mkv"),
+        workingCopyPath("mtx-test-data/ogg/qt4dance_medium.ogg") };
+    auto writer = BatchWriter();
+    writer.setThreadCount(2);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), writer.rewritesPerDevice());
+    CPPUNIT_ASSERT_MESSAGE("rewrite not forced by default", !(writer.fileHandlingFlags() & MediaFileHandlingFlags::ForceRewrite));
+
+    // set the title of all files except the second one
+    auto progress = AbortableProgressFeedback();
+    auto plans = std::vector<ChangePlan>(paths.size());
+    const auto processedFiles = writer.write(
+        paths,
+        [](MediaFileInfo &fileInfo, Diagnostics &) {
+            // accept the present padding and element positions so files are only altered if tags have been changed
+            fileInfo.setMaxPadding(std::numeric_limits<std::size_t>::max());
+            fileInfo.setTagPosition(ElementPosition::Keep);
+            fileInfo.setIndexPosition(ElementPosition::Keep);
+            if (fileInfo.containerFormat() == ContainerFormat::Matroska && fileInfo.path().find("test2.mkv") != std::string::npos) {
+                return;
+            }
+            fileInfo.createAppropriateTags();
+            fileInfo.tags().front()->setValue(KnownField::Title, TagValue("batch title"sv, TagTextEncoding::Utf8));
+        },
+        [&](BatchWriteResult &&result) {
+            CPPUNIT_ASSERT(result.fileInfo);
+            CPPUNIT_ASSERT_MESSAGE("file closed after writing", !result.fileInfo->isOpen());
+            CPPUNIT_ASSERT_MESSAGE("no critical errors", result.diag.level() < DiagLevel::Critical);
+            plans[result.index] = result.plan;
+        },
+        progress);
+    CPPUNIT_ASSERT_EQUAL(paths.size(), processedFiles);
+    CPPUNIT_ASSERT(plans[0].strategy != ChangeStrategy::None);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("new size planned exactly", plans[0].newSize, static_cast<std::uint64_t>(std::filesystem::file_size(paths[0])));
+    CPPUNIT_ASSERT_EQUAL(ChangeStrategy::None, plans[1].strategy);
+    CPPUNIT_ASSERT_EQUAL(ChangeStrategy::Rewrite, plans[2].strategy);
+    CPPUNIT_ASSERT_MESSAGE("Ogg plan only estimated", plans[2].isEstimated);
+
+    // exceptions thrown by the edit callback are propagated (and the files are left untouched)
+    auto resultCount = std::size_t();
+    auto failingProgress = AbortableProgressFeedback();
+    CPPUNIT_ASSERT_THROW(writer.write(
+                             paths, [](MediaFileInfo &, Diagnostics &) { throw std::logic_error("edit failed"); },
+                             [&resultCount](BatchWriteResult &&) { ++resultCount; }, failingProgress),
+        std::logic_error);
+    CPPUNIT_ASSERT(failingProgress.isAborted());
+    CPPUNIT_ASSERT_EQUAL(0_st, resultCount);
+
+    // check whether the changes have been applied
+    auto diag = Diagnostics();
+    for (auto index = std::size_t(); index != paths.size(); ++index) {
+        if (index == 1) {
+            CPPUNIT_ASSERT_EQUAL_MESSAGE("skipped file left untouched", std::filesystem::file_size(testFilePath("matroska_wave1/test2.mkv")),
+                std::filesystem::file_size(paths[index]));
+        } else {
+            auto file = MediaFileInfo(paths[index]);
+            file.open(true);
+            file.parseEverything(diag, progress);
+            CPPUNIT_ASSERT(!file.tags().empty());
+            CPPUNIT_ASSERT_EQUAL("batch title"s, file.tags().front()->value(KnownField::Title).toString());
+            file.close();
+        }
+        remove(paths[index].data());
+        remove((paths[index] + ".bak").data());
+    }
+
+    // rewrite files and count the rewrites in flight at once (all working copies are stored on the same device)
+    // note: The data of the attachment added to each file is only read when rewriting the file. So a rewrite is considered
+    //       in flight from the first read of that data until its result is passed to the callback (which happens before
+    //       the BatchWriter allows starting the next rewrite on the device).
+    const auto rewritePaths = std::vector<std::string>{ workingCopyPath("matroska_wave1/test3.mkv"), workingCopyPath("matroska_wave1/test4.mkv"),
+        workingCopyPath("matroska_wave1/test5.mkv"), workingCopyPath("matroska_wave1/test6.mkv") };
+    auto attachmentData = std::vector<std::stringstream>(rewritePaths.size());
+    auto rewriteMutex = std::mutex();
+    auto attachmentAdded = std::vector<bool>(rewritePaths.size()), rewriting = std::vector<bool>(rewritePaths.size());
+    auto rewritesInFlight = std::size_t(), maxRewritesInFlight = std::size_t();
+    writer.setThreadCount(rewritePaths.size());
+    writer.setFileHandlingFlags(writer.fileHandlingFlags() | MediaFileHandlingFlags::ForceRewrite);
+    for (const auto rewritesPerDevice : { std::size_t(1), std::size_t(2) }) {
+        writer.setRewritesPerDevice(rewritesPerDevice);
+        maxRewritesInFlight = 0;
+        const auto rewrittenFiles = writer.write(
+            rewritePaths,
+            [&](MediaFileInfo &fileInfo, Diagnostics &) {
+                const auto index = static_cast<std::size_t>(std::find(rewritePaths.begin(), rewritePaths.end(), fileInfo.path()) - rewritePaths.begin());
+                auto &data = attachmentData[index];
+                data.str(std::string(1024, 'x'));
+                data.clear();
+                auto *const attachment = fileInfo.container()->createAttachment();
+                attachment->setName("data.bin"sv);
+                attachment->setMimeType("application/octet-stream"sv);
+                attachment->setData(std::make_unique<StreamDataBlock>([&, index]() -> std::istream & {
+                    auto lock = std::unique_lock<std::mutex>(rewriteMutex);
+                    if (attachmentAdded[index] && !rewriting[index]) {
+                        rewriting[index] = true;
+                        maxRewritesInFlight = std::max(maxRewritesInFlight, ++rewritesInFlight);
+                        lock.unlock();
+                        std::this_thread::sleep_for(std::chrono::milliseconds(50)); // give other rewrites the chance to overlap
+                    }
+                    return attachmentData[index];
+                }));
+                const auto lock = std::lock_guard<std::mutex>(rewriteMutex);
+                attachmentAdded[index] = true;
+            },
+            [&](BatchWriteResult &&result) {
+                CPPUNIT_ASSERT_MESSAGE("no critical errors", result.diag.level() < DiagLevel::Critical);
+                CPPUNIT_ASSERT_EQUAL(ChangeStrategy::Rewrite, result.plan.strategy);
+                const auto lock = std::lock_guard<std::mutex>(rewriteMutex);
+                CPPUNIT_ASSERT_MESSAGE("attachment data read when rewriting", rewriting[result.index]);
+                rewriting[result.index] = attachmentAdded[result.index] = false;
+                --rewritesInFlight;
+            },
+            progress);
+        CPPUNIT_ASSERT_EQUAL(rewritePaths.size(), rewrittenFiles);
+        CPPUNIT_ASSERT_EQUAL(0_st, rewritesInFlight);
+        CPPUNIT_ASSERT_MESSAGE("at least one rewrite in flight", maxRewritesInFlight >= 1);
+        CPPUNIT_ASSERT_MESSAGE("no more rewrites in flight than allowed per device", maxRewritesInFlight <= rewritesPerDevice);
+    }
+    for (const auto &path : rewritePaths) {
+        remove(path.data());
+        remove((path + ".bak").data());
+    }
+}
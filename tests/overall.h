@@ -51,6 +51,7 @@ class OverallTests : public TestFixture {
     CPPUNIT_TEST(testFlacMaking);
     CPPUNIT_TEST(testMkvMakingWithDifferentSettings);
     CPPUNIT_TEST(testMkvMakingNestedTags);
+    CPPUNIT_TEST(testMkvMakingAppendingTags);
     CPPUNIT_TEST(testVorbisCommentFieldHandling);
     CPPUNIT_TEST_SUITE_END();
 
@@ -120,6 +121,7 @@ public:
     void testFlacParsing();
     void testMkvMakingWithDifferentSettings();
     void testMkvMakingNestedTags();
+    void testMkvMakingAppendingTags();
     void testMp4Making();
     void testMp4MakingWith64BitOffsets();
     void testMp3Making();
@@ -12,7 +12,9 @@
 #include <c++utilities/conversion/stringconversion.h>
 #include <c++utilities/io/misc.h>
 
+#include <algorithm>
 #include <cstring>
+#include <filesystem>
 #include <fstream>
 
 using namespace CppUtilities;
@@ -794,3 +796,110 @@ void OverallTests::testMkvMakingNestedTags()
     m_fileInfo.setIndexPosition(ElementPosition::BeforeData);
     makeFile(workingCopyPath("mkv/nested-tags.mkv"), &OverallTests::noop, &OverallTests::checkMkvTestfileNestedTags);
 }
+
+/*!
+ * \brief Tests appending tags to the end of the segment (instead of rewriting the file) via MediaFileInfo.
+ * \remarks
+ * - The files are rewritten first to get a well-defined layout without padding and the tags after the clusters.
+ * - Rewriting the file in-place is prevented by using a longer writing application which does not fit into the header
+ *   anymore. (The "WritingApp"-element is not updated when appending tags so appending is still possible.)
+ */
+void OverallTests::testMkvMakingAppendingTags()
+{
+    cerr << endl << "Matroska maker - appending tags" << endl;
+    m_fileInfo.setForceFullParse(true);
+    m_fileInfo.setMinPadding(0);
+    m_fileInfo.setMaxPadding(0);
+    m_fileInfo.setPreferredPadding(0);
+    m_fileInfo.setIndexPosition(ElementPosition::BeforeData);
+    m_fileInfo.setForceIndexPosition(true);
+    m_fileInfo.setForceTagPosition(true);
+
+    const auto isMessagePresent = [this](std::string_view message) {
+        return std::find_if(m_diag.cbegin(), m_diag.cend(), [message](const auto &msg) { return msg.message() == message; }) != m_diag.cend();
+    };
+    static constexpr auto appendedMessage = "The tags have been appended to the end of the segment to avoid rewriting the file."sv;
+    static constexpr auto notEnoughSpaceMessage
+        = "The tags can not be appended to the end of the segment because there is not enough space to update the \"SeekHead\"-element."sv;
+
+    // rewrites the specified file putting the tags at the specified position and parses the result
+    const auto prepareFile = [this](const std::string &path, ElementPosition tagPosition, bool addAttachment) {
+        cerr << "- testing " << path << endl;
+        m_diag.clear();
+        m_fileInfo.setPath(path);
+        m_fileInfo.reopen(true);
+        m_fileInfo.parseEverything(m_diag, m_progress);
+        m_fileInfo.setForceRewrite(true);
+        m_fileInfo.setTagPosition(tagPosition);
+        m_fileInfo.setWritingApplication(std::string_view());
+        if (addAttachment) {
+            setMkvTestMetaData();
+        } else {
+            m_fileInfo.tags().at(0)->setValue(KnownField::Title, m_testTitle);
+        }
+        m_fileInfo.applyChanges(m_diag, m_progress);
+        m_fileInfo.clearParsingResults();
+        m_fileInfo.parseEverything(m_diag, m_progress);
+        CPPUNIT_ASSERT(m_diag.level() <= DiagLevel::Information);
+        CPPUNIT_ASSERT_EQUAL(tagPosition, m_fileInfo.container()->determineTagPosition(m_diag));
+        CPPUNIT_ASSERT_EQUAL(0_st, static_cast<std::size_t>(m_fileInfo.paddingSize()));
+
+        // prepare applying further changes without forcing a rewrite
+        m_diag.clear();
+        m_fileInfo.setForceRewrite(false);
+        m_fileInfo.setTagPosition(ElementPosition::AfterData);
+        m_fileInfo.setWritingApplication(std::string(512, 'x'));
+    };
+    // applies the changes and parses the result
+    const auto applyChangesAndReparse = [this] {
+        m_fileInfo.applyChanges(m_diag, m_progress);
+        m_fileInfo.clearParsingResults();
+        m_fileInfo.parseEverything(m_diag, m_progress);
+        CPPUNIT_ASSERT(m_diag.level() <= DiagLevel::Information);
+        CPPUNIT_ASSERT_EQUAL(ElementPosition::AfterData, m_fileInfo.container()->determineTagPosition(m_diag));
+    };
+
+    // overwrite the "Tags"-element at the end of the segment with a bigger one (the "SeekHead"-element has enough space as its entry for
+    // the "Tags"-element keeps the same offset)
+    const auto longTitle = std::string(1000, 't');
+    prepareFile(workingCopyPath("matroska_wave1/test1.mkv"), ElementPosition::AfterData, false);
+    auto sizeBefore = m_fileInfo.size();
+    m_fileInfo.tags().at(0)->setValue(KnownField::Title, TagValue(longTitle, TagTextEncoding::Utf8));
+    applyChangesAndReparse();
+    CPPUNIT_ASSERT_MESSAGE("tags appended", isMessagePresent(appendedMessage));
+    CPPUNIT_ASSERT_GREATER(sizeBefore, m_fileInfo.size());
+    CPPUNIT_ASSERT_EQUAL(0_st, static_cast<std::size_t>(m_fileInfo.paddingSize()));
+    CPPUNIT_ASSERT_EQUAL(longTitle, m_fileInfo.tags().at(0)->value(KnownField::Title).toString());
+
+    // overwrite the "Tags"-element at the end of the segment with a smaller one (the file must be truncated)
+    m_diag.clear();
+    sizeBefore = m_fileInfo.size();
+    m_fileInfo.tags().at(0)->setValue(KnownField::Title, m_testTitle);
+    applyChangesAndReparse();
+    CPPUNIT_ASSERT_MESSAGE("tags appended", isMessagePresent(appendedMessage));
+    CPPUNIT_ASSERT_LESS(sizeBefore, m_fileInfo.size());
+    CPPUNIT_ASSERT_EQUAL(m_fileInfo.size(), static_cast<std::uint64_t>(std::filesystem::file_size(m_fileInfo.path())));
+    CPPUNIT_ASSERT_EQUAL(m_testTitle.toString(), m_fileInfo.tags().at(0)->value(KnownField::Title).toString());
+
+    // append a new "Tags"-element because the old one is followed by the "Attachments"-element (the old one must be voided)
+    prepareFile(workingCopyPath("matroska_wave1/test1.mkv"), ElementPosition::AfterData, true);
+    sizeBefore = m_fileInfo.size();
+    m_fileInfo.tags().at(0)->setValue(KnownField::Genre, TagValue(longTitle, TagTextEncoding::Utf8));
+    applyChangesAndReparse();
+    CPPUNIT_ASSERT_MESSAGE("tags appended", isMessagePresent(appendedMessage));
+    CPPUNIT_ASSERT_GREATER(sizeBefore, m_fileInfo.size());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("old tags not parsed anymore", 2_st, m_fileInfo.tags().size());
+    CPPUNIT_ASSERT_EQUAL(longTitle, m_fileInfo.tags().at(0)->value(KnownField::Genre).toString());
+    checkMkvTestMetaData();
+
+    // fall back to rewriting the file when the "SeekHead"-element has not enough space to refer to the "Tags"-element at the end
+    // note: The offset of the "Tags"-element before the clusters is denoted using fewer bytes than the offset at the end of the segment.
+    prepareFile(workingCopyPath("matroska_wave1/test1.mkv"), ElementPosition::BeforeData, false);
+    m_fileInfo.tags().at(0)->setValue(KnownField::Title, TagValue(longTitle, TagTextEncoding::Utf8));
+    applyChangesAndReparse();
+    CPPUNIT_ASSERT_MESSAGE("not enough space for SeekHead", isMessagePresent(notEnoughSpaceMessage));
+    CPPUNIT_ASSERT_MESSAGE("file rewritten", !isMessagePresent(appendedMessage));
+    CPPUNIT_ASSERT_EQUAL(longTitle, m_fileInfo.tags().at(0)->value(KnownField::Title).toString());
+
+    m_fileInfo.setWritingApplication(std::string_view());
+}
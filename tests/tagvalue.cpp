@@ -33,6 +33,8 @@ class TagValueTests : public TestFixture {
     CPPUNIT_TEST(testString);
     CPPUNIT_TEST(testEqualityOperator);
     CPPUNIT_TEST(testPopularityScaling);
+    CPPUNIT_TEST(testSmallBufferOptimization);
+    CPPUNIT_TEST(testTextConversion);
     CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -51,6 +53,8 @@ public:
     void testString();
     void testEqualityOperator();
     void testPopularityScaling();
+    void testSmallBufferOptimization();
+    void testTextConversion();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TagValueTests);
@@ -294,6 +298,16 @@ void TagValueTests::testEqualityOperator()
     CPPUNIT_ASSERT_MESSAGE("default-popularity not equal to empty tag value"s, TagValue(Popularity()) != TagValue());
     CPPUNIT_ASSERT_MESSAGE("popularity not equal"s, first != TagValue(Popularity({ .rating = 200 })));
 
+    // exact comparison
+    CPPUNIT_ASSERT_MESSAGE("no implicit conversion of types in exact comparison"s,
+        !TagValue("15", 2, TagTextEncoding::Latin1).compareTo(TagValue(15), TagValueComparisionFlags::Exact));
+    CPPUNIT_ASSERT_MESSAGE("no implicit conversion of encodings in exact comparison"s,
+        !TagValue("\0\x31\0\x35", 4, TagTextEncoding::Utf16BigEndian)
+             .compareTo(TagValue("15", 2, TagTextEncoding::Latin1), TagValueComparisionFlags::Exact));
+    CPPUNIT_ASSERT_MESSAGE("exact comparison of equal values"s,
+        TagValue("15", 2, TagTextEncoding::Latin1).compareTo(TagValue("15", 2, TagTextEncoding::Latin1), TagValueComparisionFlags::Exact));
+    CPPUNIT_ASSERT_MESSAGE("exact comparison of empty values"s, TagValue().compareTo(TagValue::empty(), TagValueComparisionFlags::Exact));
+
     // meta-data
     TagValue withDescription(15);
     withDescription.setDescription("test");
@@ -344,3 +358,111 @@ void TagValueTests::testPopularityScaling()
         CPPUNIT_ASSERT_EQUAL_MESSAGE("middle: generic to raw ", rawMiddle.rating, genericMiddle.scaled(rawMiddle.scale).rating);
     }
 }
+
+void TagValueTests::testSmallBufferOptimization()
+{
+    const auto isInline = [](const TagValue &value) {
+        const auto *const begin = reinterpret_cast<const char *>(&value);
+        return value.dataPointer() >= begin && value.dataPointer() < begin + sizeof(TagValue);
+    };
+
+    // short text and integers are stored inline
+    TagValue text("short text"sv), integer(15), unsignedInteger(std::uint64_t(42)), dateTime(DateTime(0));
+    CPPUNIT_ASSERT_MESSAGE("short text stored inline", isInline(text));
+    CPPUNIT_ASSERT_MESSAGE("integer stored inline", isInline(integer));
+    CPPUNIT_ASSERT_MESSAGE("unsigned integer stored inline", isInline(unsignedInteger));
+    CPPUNIT_ASSERT_MESSAGE("date time stored inline", isInline(dateTime));
+    CPPUNIT_ASSERT_EQUAL(15, integer.toInteger());
+    CPPUNIT_ASSERT_EQUAL(std::uint64_t(42), unsignedInteger.toUnsignedInteger());
+
+    // copies and moves of inline values are stored inline as well
+    const auto textCopy = text;
+    CPPUNIT_ASSERT_MESSAGE("copy stored inline", isInline(textCopy));
+    CPPUNIT_ASSERT(textCopy.dataPointer() != text.dataPointer());
+    CPPUNIT_ASSERT_EQUAL("short text"s, textCopy.toString());
+    const auto movedText = std::move(text);
+    CPPUNIT_ASSERT_MESSAGE("moved value stored inline", isInline(movedText));
+    CPPUNIT_ASSERT_EQUAL("short text"s, movedText.toString());
+    CPPUNIT_ASSERT_MESSAGE("moved-from value is null", text.isNull());
+    integer = movedText;
+    CPPUNIT_ASSERT_MESSAGE("copy-assigned value stored inline", isInline(integer));
+    CPPUNIT_ASSERT_EQUAL("short text"s, integer.toString());
+
+    // big values are stored on the heap and moved without copying
+    const auto bigData = std::string(1024, 'x');
+    auto picture = TagValue(bigData.data(), bigData.size(), TagDataType::Picture);
+    CPPUNIT_ASSERT_MESSAGE("big value stored on the heap", !isInline(picture));
+    const auto *const pictureData = picture.dataPointer();
+    const auto movedPicture = std::move(picture);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("heap data taken over when moving", pictureData, movedPicture.dataPointer());
+    CPPUNIT_ASSERT_EQUAL(bigData, std::string(movedPicture.data()));
+
+    // switching between inline and heap storage
+    auto value = TagValue(bigData, TagTextEncoding::Latin1);
+    CPPUNIT_ASSERT(!isInline(value));
+    value.assignText("foo"sv);
+    CPPUNIT_ASSERT(isInline(value));
+    CPPUNIT_ASSERT_EQUAL("foo"s, value.toString());
+    value.assignData(bigData.data(), bigData.size(), TagDataType::Binary);
+    CPPUNIT_ASSERT(!isInline(value));
+    CPPUNIT_ASSERT_EQUAL(bigData, std::string(value.data()));
+    value.clearData();
+    CPPUNIT_ASSERT(value.isNull());
+}
+
+void TagValueTests::testTextConversion()
+{
+    const auto utf16Bytes = [](std::u16string_view text, bool bigEndian) {
+        auto bytes = std::string();
+        for (const auto unit : text) {
+            const auto low = static_cast<char>(unit & 0xFF), high = static_cast<char>(unit >> 8);
+            bytes += bigEndian ? high : low;
+            bytes += bigEndian ? low : high;
+        }
+        return bytes;
+    };
+
+    // convert text exceeding the size of the chunks processed at once, mixing ASCII and non-ASCII characters
+    const auto utf8 = "Gr\xc3\xbc\xc3\x9f" "e aus K\xc3\xb6ln \xe2\x80\x93 \xf0\x9f\x8e\xb5 plus some more ASCII"s;
+    const auto utf16 = u"Gr\u00fc\u00dfe aus K\u00f6ln \u2013 \U0001F3B5 plus some more ASCII"sv;
+    const auto utf16LE = utf16Bytes(utf16, false), utf16BE = utf16Bytes(utf16, true);
+    const auto latin1 = "Gr\xfc\xdf" "e aus K\xf6ln plus some more ASCII"s;
+    const auto latin1AsUtf8 = "Gr\xc3\xbc\xc3\x9f" "e aus K\xc3\xb6ln plus some more ASCII"s;
+    CPPUNIT_ASSERT_EQUAL(utf16LE, TagValue(utf8, TagTextEncoding::Utf8).toString(TagTextEncoding::Utf16LittleEndian));
+    CPPUNIT_ASSERT_EQUAL(utf16BE, TagValue(utf8, TagTextEncoding::Utf8).toString(TagTextEncoding::Utf16BigEndian));
+    CPPUNIT_ASSERT_EQUAL(utf8, TagValue(utf16LE, TagTextEncoding::Utf16LittleEndian).toString(TagTextEncoding::Utf8));
+    CPPUNIT_ASSERT_EQUAL(utf8, TagValue(utf16BE, TagTextEncoding::Utf16BigEndian).toString(TagTextEncoding::Utf8));
+    CPPUNIT_ASSERT_EQUAL(utf16BE, TagValue(utf16LE, TagTextEncoding::Utf16LittleEndian).toString(TagTextEncoding::Utf16BigEndian));
+    CPPUNIT_ASSERT_EQUAL(latin1AsUtf8, TagValue(latin1, TagTextEncoding::Latin1).toString(TagTextEncoding::Utf8));
+    CPPUNIT_ASSERT_EQUAL(latin1, TagValue(latin1AsUtf8, TagTextEncoding::Utf8).toString(TagTextEncoding::Latin1));
+    CPPUNIT_ASSERT_EQUAL(latin1, TagValue(utf16Bytes(u"Gr\u00fc\u00dfe aus K\u00f6ln plus some more ASCII", true), TagTextEncoding::Utf16BigEndian)
+                                     .toString(TagTextEncoding::Latin1));
+    const auto wideString = TagValue(utf8, TagTextEncoding::Utf8).toWString(TagTextEncoding::Utf16LittleEndian);
+    CPPUNIT_ASSERT_EQUAL(utf16LE, std::string(reinterpret_cast<const char *>(wideString.data()), wideString.size() * sizeof(char16_t)));
+
+    // convert the assigned data and description in-place
+    auto value = TagValue(latin1, TagTextEncoding::Latin1);
+    value.setDescription(latin1, TagTextEncoding::Latin1);
+    value.convertDataEncoding(TagTextEncoding::Utf16BigEndian);
+    value.convertDescriptionEncoding(TagTextEncoding::Utf8);
+    CPPUNIT_ASSERT_EQUAL(TagTextEncoding::Utf16BigEndian, value.dataEncoding());
+    CPPUNIT_ASSERT_EQUAL(latin1AsUtf8, value.description());
+    CPPUNIT_ASSERT_EQUAL(latin1AsUtf8, value.toString(TagTextEncoding::Utf8));
+    value.convertDataEncoding(TagTextEncoding::Latin1);
+    CPPUNIT_ASSERT_EQUAL(latin1, value.toString(TagTextEncoding::Unspecified));
+    auto latin1Value = TagValue(latin1, TagTextEncoding::Latin1);
+    latin1Value.setDescription(latin1, TagTextEncoding::Latin1);
+    CPPUNIT_ASSERT_MESSAGE("description compared across encodings", value == latin1Value);
+
+    // fail on invalid input and on characters which can not be represented
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "truncated UTF-8", TagValue("foo\xc3"s, TagTextEncoding::Utf8).toString(TagTextEncoding::Latin1), ConversionException);
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "overlong UTF-8", TagValue("\xc0\xaf"s, TagTextEncoding::Utf8).toString(TagTextEncoding::Utf16LittleEndian), ConversionException);
+    CPPUNIT_ASSERT_THROW_MESSAGE("unpaired surrogate",
+        TagValue(utf16Bytes(u"a\xd83c", false), TagTextEncoding::Utf16LittleEndian).toString(TagTextEncoding::Utf8), ConversionException);
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "odd UTF-16", TagValue("a\0b"s, TagTextEncoding::Utf16LittleEndian).toString(TagTextEncoding::Utf8), ConversionException);
+    CPPUNIT_ASSERT_THROW_MESSAGE(
+        "not representable in Latin-1", TagValue(utf8, TagTextEncoding::Utf8).toString(TagTextEncoding::Latin1), ConversionException);
+}
@@ -1,9 +1,12 @@
 #include "./helper.h"
 
+#include "../abstractattachment.h"
 #include "../aspectratio.h"
 #include "../backuphelper.h"
+#include "../concurrentdiagnostics.h"
 #include "../diagnostics.h"
 #include "../exceptions.h"
+#include "../flatmultimap.h"
 #include "../margin.h"
 #include "../mediafileinfo.h"
 #include "../mediaformat.h"
@@ -12,8 +15,13 @@
 #include "../signature.h"
 #include "../size.h"
 #include "../tagtarget.h"
+#include "../tracing.h"
 
 #include "../id3/id3v2tag.h"
+#include "../matroska/ebmlelement.h"
+#include "../matroska/matroskatag.h"
+#include "../mp4/mp4tag.h"
+#include "../vorbis/vorbiscomment.h"
 
 #include <c++utilities/conversion/stringbuilder.h>
 #include <c++utilities/tests/testutils.h>
@@ -22,9 +30,14 @@ using namespace CppUtilities;
 #include <cppunit/TestFixture.h>
 #include <cppunit/extensions/HelperMacros.h>
 
+#include <atomic>
+#include <cctype>
 #include <cstdio>
 #include <filesystem>
+#include <random>
 #include <regex>
+#include <sstream>
+#include <thread>
 
 using namespace std;
 using namespace CppUtilities::Literals;
@@ -45,9 +58,18 @@ class UtilitiesTests : public TestFixture {
     CPPUNIT_TEST(testPositionInSet);
     CPPUNIT_TEST(testProgressFeedback);
     CPPUNIT_TEST(testAbortableProgressFeedback);
+    CPPUNIT_TEST(testProgressCounter);
     CPPUNIT_TEST(testDiagnostics);
+    CPPUNIT_TEST(testConcurrentDiagnostics);
+    CPPUNIT_TEST(testTracing);
     CPPUNIT_TEST(testBackupFile);
     CPPUNIT_TEST(testFieldConversions);
+    CPPUNIT_TEST(testStreamDataBlock);
+    CPPUNIT_TEST(testEbmlDenotations);
+    CPPUNIT_TEST(testFlatMultiMap);
+    CPPUNIT_TEST(testId3v2Unsynchronisation);
+    CPPUNIT_TEST(testId3v2SizeExceedingStream);
+    CPPUNIT_TEST(testMakingIntoBuffer);
     CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -64,9 +86,18 @@ public:
     void testPositionInSet();
     void testProgressFeedback();
     void testAbortableProgressFeedback();
+    void testProgressCounter();
     void testDiagnostics();
+    void testConcurrentDiagnostics();
+    void testTracing();
     void testBackupFile();
     void testFieldConversions();
+    void testStreamDataBlock();
+    void testEbmlDenotations();
+    void testFlatMultiMap();
+    void testId3v2Unsynchronisation();
+    void testId3v2SizeExceedingStream();
+    void testMakingIntoBuffer();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(UtilitiesTests);
@@ -281,6 +312,46 @@ void UtilitiesTests::testAbortableProgressFeedback()
     CPPUNIT_ASSERT_EQUAL(25u, overallPercentage);
 }
 
+void UtilitiesTests::testProgressCounter()
+{
+    auto percentageUpdates = 0u;
+    auto progressFeedback
+        = AbortableProgressFeedback(AbortableProgressFeedback::Callback(), [&](const AbortableProgressFeedback &) { ++percentageUpdates; });
+    progressFeedback.updateStep("counting");
+
+    // updates are throttled
+    auto counter = ProgressCounter(progressFeedback, 200, std::chrono::hours(1));
+    counter.add(1);
+    CPPUNIT_ASSERT_MESSAGE("percentage not changed", !counter.report());
+    counter.add(1);
+    CPPUNIT_ASSERT_EQUAL(std::uint8_t(1), counter.percentage());
+    CPPUNIT_ASSERT_MESSAGE("first change reported immediately", counter.report());
+    CPPUNIT_ASSERT_EQUAL(1u, percentageUpdates);
+    CPPUNIT_ASSERT_EQUAL(std::uint8_t(1), progressFeedback.stepPercentage());
+    counter.add(98);
+    CPPUNIT_ASSERT_MESSAGE("further changes throttled", !counter.report());
+    CPPUNIT_ASSERT_EQUAL(1u, percentageUpdates);
+    counter.reportNow();
+    CPPUNIT_ASSERT_EQUAL(2u, percentageUpdates);
+    CPPUNIT_ASSERT_EQUAL(std::uint8_t(50), progressFeedback.stepPercentage());
+
+    // updates without interval are only skipped if the percentage does not change
+    auto unthrottledCounter = ProgressCounter(progressFeedback, 4, ProgressCounter::Clock::duration::zero());
+    unthrottledCounter.set(3);
+    CPPUNIT_ASSERT(unthrottledCounter.report());
+    CPPUNIT_ASSERT(!unthrottledCounter.report());
+    unthrottledCounter.add(100);
+    CPPUNIT_ASSERT(unthrottledCounter.report());
+    CPPUNIT_ASSERT_EQUAL(std::uint8_t(100), progressFeedback.stepPercentage());
+    CPPUNIT_ASSERT_EQUAL(4u, percentageUpdates);
+
+    // aborting is forwarded
+    CPPUNIT_ASSERT(!counter.isAborted());
+    progressFeedback.tryToAbort();
+    CPPUNIT_ASSERT(counter.isAborted());
+    CPPUNIT_ASSERT_THROW(counter.stopIfAborted(), OperationAbortedException);
+}
+
 void UtilitiesTests::testDiagnostics()
 {
     Diagnostics diag;
@@ -291,6 +362,109 @@ void UtilitiesTests::testDiagnostics()
     diag.emplace_back(DiagLevel::Critical, "critical msg", "context");
     CPPUNIT_ASSERT_EQUAL(DiagLevel::Critical, diag.level());
     CPPUNIT_ASSERT(diag.has(DiagLevel::Critical));
+    CPPUNIT_ASSERT_EQUAL("context"s, diag[1].context());
+
+    // messages constructed with a DiagContext refer to it instead of holding a copy (so no allocation is needed for it)
+    static const auto context = DiagContext("context which is too long for the small string optimization");
+    diag.emplace_back(DiagLevel::Warning, "warning msg", context);
+    diag.emplaceFormatted(DiagLevel::Warning, context, "warning msg ", 2);
+    const auto copy = diag;
+    CPPUNIT_ASSERT_MESSAGE("context not copied", &context == &diag[2].context());
+    CPPUNIT_ASSERT_MESSAGE("context not copied when formatting", &context == &diag[3].context());
+    CPPUNIT_ASSERT_MESSAGE("context not copied when copying message", &context == &copy[3].context());
+    CPPUNIT_ASSERT_MESSAGE("other contexts are copied", &diag[0].context() != &diag[1].context());
+    CPPUNIT_ASSERT_EQUAL(DiagMessage(DiagLevel::Warning, "warning msg 2", std::string(context)), diag[3]);
+    diag.erase(diag.begin() + 2, diag.end());
+
+    // messages below the min level are dropped
+    diag.setMinLevel(DiagLevel::Warning);
+    CPPUNIT_ASSERT(!diag.isEnabled(DiagLevel::Information));
+    CPPUNIT_ASSERT(diag.isEnabled(DiagLevel::Warning));
+    diag.emplace_back(DiagLevel::Information, "information msg", "context");
+    diag.emplaceFormatted(DiagLevel::Debug, "context", "debug msg ", 1);
+    CPPUNIT_ASSERT_EQUAL(2_st, diag.size());
+    diag.emplaceFormatted(DiagLevel::Warning, "other context", "warning msg ", 2);
+    CPPUNIT_ASSERT_EQUAL(3_st, diag.size());
+    CPPUNIT_ASSERT_EQUAL(DiagMessage(DiagLevel::Warning, "warning msg 2", "other context"), diag.back());
+}
+
+/*!
+ * \brief Stress-tests ConcurrentDiagnostics by adding messages from many threads at once.
+ * \remarks Supposed to be run under ThreadSanitizer as well (configure with ENABLE_TSAN=ON).
+ */
+void UtilitiesTests::testConcurrentDiagnostics()
+{
+    constexpr auto threadCount = std::size_t(8), itemCount = std::size_t(2000);
+    auto sink = ConcurrentDiagnostics(DiagLevel::Warning);
+    auto nextItem = std::atomic<std::size_t>(0);
+    const auto work = [&] {
+        for (auto item = nextItem++; item < itemCount; item = nextItem++) {
+            sink.collect(item, [item](Diagnostics &diag) {
+                diag.emplaceFormatted(DiagLevel::Information, "stress test", "dropped ", item);
+                diag.emplaceFormatted(DiagLevel::Warning, argsToString("stress test ", item % 7), "item ", item);
+                if (item % 3 == 0) {
+                    diag.emplaceFormatted(DiagLevel::Critical, "stress test", "item ", item, " again");
+                }
+            });
+        }
+    };
+    auto threads = std::vector<std::thread>();
+    for (auto i = std::size_t(); i != threadCount; ++i) {
+        threads.emplace_back(work);
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    // the messages are ordered by item regardless of the thread scheduling
+    const auto diag = sink.merge();
+    CPPUNIT_ASSERT_EQUAL(itemCount + (itemCount + 2) / 3, diag.size());
+    auto message = diag.cbegin();
+    for (auto item = std::size_t(); item != itemCount; ++item) {
+        CPPUNIT_ASSERT_EQUAL(DiagMessage(DiagLevel::Warning, argsToString("item ", item), argsToString("stress test ", item % 7)), *message++);
+        if (item % 3 == 0) {
+            CPPUNIT_ASSERT_EQUAL(DiagMessage(DiagLevel::Critical, argsToString("item ", item, " again"), "stress test"), *message++);
+        }
+    }
+    CPPUNIT_ASSERT_MESSAGE("sink empty after merging", sink.merge().empty());
+}
+
+void UtilitiesTests::testTracing()
+{
+    auto json = std::stringstream();
+    {
+        auto sink = TraceSink(json);
+        TraceSpan::step("ignored as there is no span");
+        {
+            const auto ignored = TraceSpan("ignored as no sink is set");
+        }
+        setTraceSink(&sink);
+        CPPUNIT_ASSERT_EQUAL(&sink, traceSink());
+        {
+            const auto outer = TraceSpan("outer");
+            TraceSpan::step("first \"step\"");
+            {
+                const auto inner = TraceSpan("inner", "test");
+                TraceSpan::step("inner step");
+            }
+            TraceSpan::step("second step");
+        }
+        setTraceSink(nullptr);
+        CPPUNIT_ASSERT_EQUAL(std::size_t(5), sink.eventCount());
+    }
+
+    // spans are written when they end; steps end when the next step starts or when their span ends
+    const auto document = json.str();
+    CPPUNIT_ASSERT(document.find("ignored") == std::string::npos);
+    const auto positionOf = [&document](const char *name) { return document.find(argsToString("{\"name\":\"", name, '"')); };
+    CPPUNIT_ASSERT(positionOf("inner step") < positionOf("inner"));
+    CPPUNIT_ASSERT(positionOf("inner") < positionOf("first \\\"step\\\""));
+    CPPUNIT_ASSERT(positionOf("first \\\"step\\\"") < positionOf("second step"));
+    CPPUNIT_ASSERT(positionOf("second step") < positionOf("outer"));
+    CPPUNIT_ASSERT(positionOf("outer") != std::string::npos);
+    CPPUNIT_ASSERT(document.find("\"cat\":\"test\",\"ph\":\"X\"") != std::string::npos);
+    CPPUNIT_ASSERT(document.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0) == 0);
+    CPPUNIT_ASSERT(document.find("\n]}\n") == document.size() - 4);
 }
 
 void UtilitiesTests::testBackupFile()
@@ -413,4 +587,370 @@ void UtilitiesTests::testFieldConversions()
             CPPUNIT_ASSERT_EQUAL_MESSAGE("reverse mapping for known field exists", knownField, tag.knownField(fieldId));
         }
     }
+
+    // note: Language (Vorbis comment), Genre and Actor (Matroska) have intentionally no or a different reverse mapping
+    const auto vorbisComment = VorbisComment();
+    for (auto knownField = firstKnownField; knownField != KnownField::Invalid; knownField = nextKnownField(knownField)) {
+        auto fieldId = vorbisComment.fieldId(knownField);
+        if (fieldId.empty() || knownField == KnownField::Language) {
+            continue;
+        }
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("reverse mapping for known field exists", knownField, vorbisComment.knownField(fieldId));
+        for (auto &c : fieldId) {
+            c = static_cast<char>(std::tolower(c));
+        }
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("reverse mapping is case-insensitive", knownField, vorbisComment.knownField(fieldId));
+    }
+    CPPUNIT_ASSERT_EQUAL(KnownField::RecordDate, vorbisComment.knownField("year"));
+    CPPUNIT_ASSERT_EQUAL("LANGUAGE"s, vorbisComment.fieldId(KnownField::Language));
+    CPPUNIT_ASSERT_EQUAL(KnownField::Invalid, vorbisComment.knownField("LANGUAGE"));
+    CPPUNIT_ASSERT_EQUAL(KnownField::Invalid, vorbisComment.knownField("FOO"));
+    const auto matroskaTag = MatroskaTag();
+    for (auto knownField = firstKnownField; knownField != KnownField::Invalid; knownField = nextKnownField(knownField)) {
+        const auto fieldId = matroskaTag.fieldId(knownField);
+        if (fieldId.empty() || knownField == KnownField::Genre || knownField == KnownField::Actor) {
+            continue;
+        }
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("reverse mapping for known field exists", knownField, matroskaTag.knownField(fieldId));
+    }
+    CPPUNIT_ASSERT_EQUAL(KnownField::Performers, matroskaTag.knownField(std::string(MatroskaTagIds::actor())));
+    CPPUNIT_ASSERT_EQUAL(KnownField::Invalid, matroskaTag.knownField("title"));
+    CPPUNIT_ASSERT_EQUAL("GENRE"s, matroskaTag.fieldId(KnownField::Genre));
+    CPPUNIT_ASSERT_EQUAL(KnownField::Invalid, matroskaTag.knownField("GENRE"));
+}
+
+/*!
+ * \brief Tests copying a StreamDataBlock, also within the stream it refers to (like when a file is modified in-place).
+ */
+void UtilitiesTests::testStreamDataBlock()
+{
+    auto stream = std::stringstream("0123456789abcdefghij"s, ios_base::in | ios_base::out | ios_base::binary);
+    const auto block = StreamDataBlock([&stream]() -> std::istream & { return stream; }, 10, ios_base::beg, 20, ios_base::beg);
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::uint64_t>(10), block.size());
+
+    // copy to another stream
+    auto otherStream = std::stringstream();
+    block.copyTo(otherStream);
+    CPPUNIT_ASSERT_EQUAL("abcdefghij"s, otherStream.str());
+
+    // copy within the same stream towards the beginning
+    stream.seekp(4);
+    block.copyTo(stream);
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::streamoff>(14), static_cast<std::streamoff>(stream.tellp()));
+    CPPUNIT_ASSERT_EQUAL("0123abcdefghijefghij"s, stream.str());
+
+    // data which is already at the write position is just skipped
+    stream.seekp(10);
+    block.copyTo(stream);
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::streamoff>(20), static_cast<std::streamoff>(stream.tellp()));
+    CPPUNIT_ASSERT_EQUAL("0123abcdefghijefghij"s, stream.str());
+
+    // copy within the same stream towards the end (the data is larger than the chunks used when copying towards the beginning
+    // so copying in chunks would overwrite data which has not been read yet)
+    auto data = std::string(0x4000, '\0');
+    for (auto i = std::size_t(); i != data.size(); ++i) {
+        data[i] = static_cast<char>(i % 251);
+    }
+    auto largeStream = std::stringstream(data, ios_base::in | ios_base::out | ios_base::binary);
+    const auto largeBlock = StreamDataBlock([&largeStream]() -> std::istream & { return largeStream; }, 0, ios_base::beg, 0x3000, ios_base::beg);
+    largeStream.seekp(0x1000);
+    largeBlock.copyTo(largeStream);
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::streamoff>(0x4000), static_cast<std::streamoff>(largeStream.tellp()));
+    CPPUNIT_ASSERT_MESSAGE("data not corrupted", largeStream.str() == data.substr(0, 0x1000) + data.substr(0, 0x3000));
+}
+
+/*!
+ * \brief Makes an EBML size denotation the byte-wise way (reference for testEbmlDenotations()).
+ */
+static std::uint8_t makeSizeDenotationByteWise(std::uint64_t size, char *buff, std::uint8_t minBytes)
+{
+    static constexpr std::uint64_t maxSizes[] = { 0, 125ul, 16382ul, 2097150ul, 268435454ul, 34359738366ul, 4398046511102ul, 562949953421310ul,
+        72057594037927934ul };
+    for (std::uint8_t length = 1; length <= 8; ++length) {
+        if (minBytes <= length && size <= maxSizes[length]) {
+            for (std::uint8_t i = length; i; --i, size >>= 8) {
+                buff[i - 1] = static_cast<char>(size & 0xFF);
+            }
+            buff[0] = static_cast<char>(buff[0] | (0x80 >> (length - 1)));
+            return length;
+        }
+    }
+    throw InvalidDataException();
+}
+
+/*!
+ * \brief Tests encoding and decoding EBML IDs, size denotations and unsigned integers against byte-wise reference implementations.
+ */
+void UtilitiesTests::testEbmlDenotations()
+{
+    // use random values of all lengths plus the values at the boundaries
+    auto randomEngine = std::mt19937_64(42);
+    auto values = std::vector<std::uint64_t>();
+    for (auto bits = 0; bits <= 64; ++bits) {
+        const auto mask = bits < 64 ? ((std::uint64_t(1) << bits) - 1) : ~std::uint64_t(0);
+        values.emplace_back(mask);
+        values.emplace_back(mask + 1);
+        values.emplace_back(mask - 1);
+        for (auto i = 0; i != 100; ++i) {
+            values.emplace_back(randomEngine() & mask);
+        }
+    }
+
+    char buff[16], expectedBuff[16];
+    for (const auto value : values) {
+        // check size denotations
+        for (std::uint8_t minBytes = 0; minBytes <= 9; ++minBytes) {
+            std::uint8_t length = 0, expectedLength = 0;
+            try {
+                expectedLength = makeSizeDenotationByteWise(value, expectedBuff, minBytes);
+            } catch (const InvalidDataException &) {
+                CPPUNIT_ASSERT_THROW(EbmlElement::makeSizeDenotation(value, buff, minBytes), InvalidDataException);
+                continue;
+            }
+            memset(buff, 0, sizeof(buff));
+            CPPUNIT_ASSERT_NO_THROW(length = EbmlElement::makeSizeDenotation(value, buff, minBytes));
+            CPPUNIT_ASSERT_EQUAL(static_cast<unsigned int>(expectedLength), static_cast<unsigned int>(length));
+            CPPUNIT_ASSERT_EQUAL(string(expectedBuff, expectedLength), string(buff, length));
+            if (minBytes <= 1) {
+                CPPUNIT_ASSERT_EQUAL(static_cast<unsigned int>(length), static_cast<unsigned int>(EbmlElement::calculateSizeDenotationLength(value)));
+                CPPUNIT_ASSERT_EQUAL(static_cast<unsigned int>(length), static_cast<unsigned int>(EbmlElement::makeSizeDenotation(value, buff)));
+                CPPUNIT_ASSERT_EQUAL(string(expectedBuff, expectedLength), string(buff, length));
+            }
+            CPPUNIT_ASSERT_EQUAL(static_cast<unsigned int>(length),
+                static_cast<unsigned int>(EbmlElement::calculateDenotationLength(static_cast<std::uint8_t>(*buff))));
+            CPPUNIT_ASSERT_EQUAL(value, EbmlElement::decodeSizeDenotation(buff, length));
+        }
+
+        // check unsigned integers
+        for (std::uint8_t minBytes = 0; minBytes <= 9; ++minBytes) {
+            const auto length = EbmlElement::makeUInteger(value, buff, minBytes);
+            auto expectedLength = static_cast<std::uint8_t>(1);
+            while (expectedLength < 8 && (expectedLength < minBytes || (value >> (expectedLength * 8)))) {
+                ++expectedLength;
+            }
+            CPPUNIT_ASSERT_EQUAL(static_cast<unsigned int>(expectedLength), static_cast<unsigned int>(length));
+            auto decodedValue = std::uint64_t();
+            for (std::uint8_t i = 0; i != length; ++i) {
+                decodedValue = (decodedValue << 8) | static_cast<std::uint8_t>(buff[i]);
+            }
+            CPPUNIT_ASSERT_EQUAL(value, decodedValue);
+            if (minBytes <= 1) {
+                CPPUNIT_ASSERT_EQUAL(static_cast<unsigned int>(length), static_cast<unsigned int>(EbmlElement::calculateUIntegerLength(value)));
+                CPPUNIT_ASSERT_EQUAL(static_cast<unsigned int>(length), static_cast<unsigned int>(EbmlElement::makeUInteger(value, buff)));
+            }
+        }
+
+        // check IDs
+        if (value > 0x1FFFFFFF) {
+            continue;
+        }
+        const auto id = static_cast<EbmlElement::IdentifierType>(value);
+        const auto idLength = EbmlElement::makeId(id, buff);
+        CPPUNIT_ASSERT_EQUAL(static_cast<unsigned int>(idLength), static_cast<unsigned int>(EbmlElement::calculateIdLength(id)));
+        if (EbmlElement::calculateDenotationLength(static_cast<std::uint8_t>(*buff)) == idLength) {
+            CPPUNIT_ASSERT_EQUAL(id, EbmlElement::decodeId(buff, idLength));
+        }
+    }
+
+    // check special cases when decoding
+    CPPUNIT_ASSERT_EQUAL(static_cast<unsigned int>(9), static_cast<unsigned int>(EbmlElement::calculateDenotationLength(0x00)));
+    CPPUNIT_ASSERT_EQUAL(static_cast<unsigned int>(1), static_cast<unsigned int>(EbmlElement::calculateDenotationLength(0xFF)));
+    const char segmentHeader[] = { '\x18', '\x53', '\x80', '\x67', '\x01', '\x00', '\x00', '\x00', '\x00', '\x00', '\x01', '\x23' };
+    CPPUNIT_ASSERT_EQUAL(static_cast<EbmlElement::IdentifierType>(MatroskaIds::Segment), EbmlElement::decodeId(segmentHeader, 4));
+    CPPUNIT_ASSERT_EQUAL(static_cast<std::uint64_t>(0x123), EbmlElement::decodeSizeDenotation(segmentHeader + 4, 8));
+}
+
+void UtilitiesTests::testFlatMultiMap()
+{
+    // check whether the ID3v2 frame comparer is a strict weak ordering, also when mixing long IDs with short IDs which can not be
+    // converted to a long ID ("TZZ" and "XYZ")
+    using namespace Id3v2FrameIds;
+    constexpr auto unconvertibleTextId = std::uint32_t(0x545A5A), unconvertibleId = std::uint32_t(0x58595A);
+    const std::uint32_t ids[] = { lTitle, sTitle, lAlbum, sAlbum, lArtist, lGenre, lCover, sCover, lComment, lTrackPosition, unconvertibleTextId,
+        unconvertibleId };
+    const auto comparer = FrameComparer();
+    const auto equivalent = [&](std::uint32_t lhs, std::uint32_t rhs) { return !comparer(lhs, rhs) && !comparer(rhs, lhs); };
+    for (const auto a : ids) {
+        CPPUNIT_ASSERT_MESSAGE("irreflexive", !comparer(a, a));
+        for (const auto b : ids) {
+            CPPUNIT_ASSERT_MESSAGE("asymmetric", !(comparer(a, b) && comparer(b, a)));
+            for (const auto c : ids) {
+                CPPUNIT_ASSERT_MESSAGE("transitive", !(comparer(a, b) && comparer(b, c)) || comparer(a, c));
+                CPPUNIT_ASSERT_MESSAGE("equivalence transitive", !(equivalent(a, b) && equivalent(b, c)) || equivalent(a, c));
+            }
+        }
+    }
+    CPPUNIT_ASSERT_MESSAGE("short and long ID equivalent", equivalent(sTitle, lTitle));
+    CPPUNIT_ASSERT_MESSAGE("unconvertible short ID before long ID", comparer(unconvertibleId, lTitle));
+    CPPUNIT_ASSERT_MESSAGE("long ID after unconvertible short ID", !comparer(lTitle, unconvertibleId));
+    CPPUNIT_ASSERT_MESSAGE("unconvertible short ID before convertible short ID", comparer(unconvertibleTextId, sTitle));
+
+    // insert/erase the same random elements into FlatMultiMap and std::multimap using the ID3v2 frame comparer which treats
+    // short and long IDs as equivalent and puts the title frames first
+    auto randomEngine = std::mt19937(42);
+    auto flatMap = FlatMultiMap<std::uint32_t, int, FrameComparer>();
+    auto multiMap = std::multimap<std::uint32_t, int, FrameComparer>();
+    const auto sameElement = [](const auto &lhs, const auto &rhs) { return lhs.first == rhs.first && lhs.second == rhs.second; };
+    const auto checkEqual = [&] {
+        CPPUNIT_ASSERT_EQUAL(multiMap.size(), flatMap.size());
+        CPPUNIT_ASSERT_MESSAGE("same ordering", std::equal(flatMap.begin(), flatMap.end(), multiMap.begin(), multiMap.end(), sameElement));
+        for (const auto id : ids) {
+            const auto [flatFirst, flatLast] = flatMap.equal_range(id);
+            const auto [first, last] = multiMap.equal_range(id);
+            CPPUNIT_ASSERT_EQUAL(multiMap.count(id), flatMap.count(id));
+            CPPUNIT_ASSERT_MESSAGE("same equal range", std::equal(flatFirst, flatLast, first, last, sameElement));
+            CPPUNIT_ASSERT_EQUAL(multiMap.find(id) == multiMap.end(), flatMap.find(id) == flatMap.end());
+        }
+    };
+    for (auto i = 0; i != 1000; ++i) {
+        const auto id = ids[randomEngine() % std::size(ids)];
+        if (randomEngine() % 4) {
+            CPPUNIT_ASSERT_EQUAL(i, flatMap.emplace(id, i)->second);
+            multiMap.emplace(id, i);
+        } else {
+            CPPUNIT_ASSERT_EQUAL(multiMap.erase(id), flatMap.erase(id));
+        }
+        if (!(i % 100)) {
+            checkEqual();
+        }
+    }
+    checkEqual();
+
+    // erasing via iterators
+    const auto [first, last] = flatMap.equal_range(lTitle);
+    const auto next = flatMap.erase(first, last);
+    multiMap.erase(lTitle);
+    CPPUNIT_ASSERT(next == flatMap.begin());
+    checkEqual();
+    flatMap.clear();
+    CPPUNIT_ASSERT(flatMap.empty());
+}
+
+/*!
+ * \brief Tests reverting the unsynchronisation when parsing an ID3v2 tag.
+ */
+void UtilitiesTests::testId3v2Unsynchronisation()
+{
+    char data[] = "\xff\x00\xff\x00\x00\xe0\xff";
+    CPPUNIT_ASSERT_EQUAL(std::size_t(5), Id3v2Frame::decodeUnsynchronisation(data, 7));
+    CPPUNIT_ASSERT_EQUAL("\xff\xff\x00\xe0\xff"s, std::string(data, 5));
+    char plainData[] = "foo";
+    CPPUNIT_ASSERT_EQUAL(std::size_t(3), Id3v2Frame::decodeUnsynchronisation(plainData, 3));
+
+    // ID3v2.3 tag with unsynchronisation flag containing a TIT2 frame with the Latin-1 text "a\xffb" and 5 bytes padding
+    auto stream = std::stringstream("ID3\x03\x00\x80\x00\x00\x00\x14"
+                                    "TIT2\x00\x00\x00\x04\x00\x00"
+                                    "\x00" "a\xff\x00" "b"
+                                    "\x00\x00\x00\x00\x00"s);
+    auto diag = Diagnostics();
+    auto tag = Id3v2Tag();
+    tag.parse(stream, 30, diag);
+    CPPUNIT_ASSERT_EQUAL(DiagLevel::None, diag.level());
+    CPPUNIT_ASSERT_EQUAL("a\xff" "b"s, tag.value(KnownField::Title).toString(TagTextEncoding::Unspecified));
+    CPPUNIT_ASSERT_EQUAL(std::uint64_t(5), tag.paddingSize());
+
+    // the tag is written without unsynchronisation
+    auto output = std::stringstream();
+    tag.make(output, 0, diag);
+    const auto written = output.str();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("unsynchronisation flag unset", '\0', written.at(5));
+    CPPUNIT_ASSERT_MESSAGE("frame written as-is", written.find("\x00" "a\xff" "b"s) != std::string::npos);
+}
+
+/*!
+ * \brief Tests parsing an ID3v2 tag denoting a size which exceeds the end of the stream.
+ * \remarks The frames are only read up to the end of the stream instead of allocating a buffer of the denoted size.
+ */
+void UtilitiesTests::testId3v2SizeExceedingStream()
+{
+    // ID3v2.4 tag denoting the max. size (256 MiB) but only containing a TIT2 frame with the Latin-1 text "a" and 4 bytes padding
+    auto stream = std::stringstream("ID3\x04\x00\x00\x7f\x7f\x7f\x7f"
+                                    "TIT2\x00\x00\x00\x02\x00\x00"
+                                    "\x00" "a"
+                                    "\x00\x00\x00\x00"s);
+    stream.exceptions(std::ios_base::failbit | std::ios_base::badbit);
+    auto diag = Diagnostics();
+    auto tag = Id3v2Tag();
+    tag.parse(stream, 0, diag);
+    CPPUNIT_ASSERT_EQUAL(DiagLevel::Critical, diag.level());
+    CPPUNIT_ASSERT_EQUAL("Frames are truncated: the tag denotes 268435455 bytes but only 16 bytes are left in the stream."s, diag.front().message());
+    CPPUNIT_ASSERT_EQUAL("a"s, tag.value(KnownField::Title).toString(TagTextEncoding::Unspecified));
+}
+
+void UtilitiesTests::testMakingIntoBuffer()
+{
+    auto diag = Diagnostics();
+    const auto makeIntoBuffer = [](std::uint64_t size, const auto &make) {
+        auto buffer = std::string(static_cast<std::size_t>(size) + 1, '?');
+        make(buffer.data());
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("nothing written beyond required size", '?', buffer.back());
+        buffer.pop_back();
+        return buffer;
+    };
+
+    // ID3v2 tag including padding: header, "TIT2" frame with Latin-1 encoding byte and terminated string, padding
+    auto id3v2Tag = Id3v2Tag();
+    id3v2Tag.setValue(KnownField::Title, TagValue("title"));
+    auto id3v2Maker = id3v2Tag.prepareMaking(diag);
+    auto id3v2Stream = std::stringstream();
+    id3v2Maker.make(id3v2Stream, 7, diag);
+    const auto id3v2Buffer = makeIntoBuffer(id3v2Maker.requiredSize() + 7, [&](char *buffer) { id3v2Maker.make(buffer, 7, diag); });
+    const auto expectedId3v2 = "ID3\x04\x00\x00"
+                               "\x00\x00\x00\x18"
+                               "TIT2"
+                               "\x00\x00\x00\x07"
+                               "\x00\x00"
+                               "\x00"
+                               "title\x00"
+                               "\x00\x00\x00\x00\x00\x00\x00"s;
+    CPPUNIT_ASSERT_EQUAL(expectedId3v2, id3v2Buffer);
+    CPPUNIT_ASSERT_EQUAL(expectedId3v2, id3v2Stream.str());
+
+    // MP4 tag: "meta" atom with "hdlr" atom and "ilst" atom containing the "\xA9nam" atom with a UTF-8 "data" atom
+    auto mp4Tag = Mp4Tag();
+    mp4Tag.setValue(KnownField::Title, TagValue("title"));
+    auto mp4Maker = mp4Tag.prepareMaking(diag);
+    auto mp4Stream = std::stringstream();
+    mp4Maker.make(mp4Stream, diag);
+    const auto mp4Buffer = makeIntoBuffer(mp4Maker.requiredSize(), [&](char *buffer) { mp4Maker.make(buffer, diag); });
+    const auto expectedMp4 = "\x00\x00\x00\x52"
+                             "meta"
+                             "\x00\x00\x00\x00"
+                             "\x00\x00\x00\x21"
+                             "hdlr"
+                             "\x00\x00\x00\x00\x00\x00\x00\x00"
+                             "mdirappl"
+                             "\x00\x00\x00\x00\x00\x00\x00\x00\x00"
+                             "\x00\x00\x00\x25"
+                             "ilst"
+                             "\x00\x00\x00\x1D"
+                             "\xA9nam"
+                             "\x00\x00\x00\x15"
+                             "data"
+                             "\x00\x00\x00\x01"
+                             "\x00\x00\x00\x00"
+                             "title"s;
+    CPPUNIT_ASSERT_EQUAL(expectedMp4, mp4Buffer);
+    CPPUNIT_ASSERT_EQUAL(expectedMp4, mp4Stream.str());
+
+    // Matroska tag: "Tag" element with empty "Targets" element and "SimpleTag" element
+    auto matroskaTag = MatroskaTag();
+    matroskaTag.setValue(KnownField::Title, TagValue("title"));
+    const auto matroskaMaker = matroskaTag.prepareMaking(diag);
+    auto matroskaStream = std::stringstream();
+    matroskaMaker.make(matroskaStream);
+    const auto matroskaBuffer = makeIntoBuffer(matroskaMaker.requiredSize(), [&](char *buffer) { matroskaMaker.make(buffer); });
+    const auto expectedMatroska = "\x73\x73\xA0"
+                                  "\x63\xC0\x80"
+                                  "\x67\xC8\x9A"
+                                  "\x45\xA3\x85"
+                                  "TITLE"
+                                  "\x44\x7A\x83"
+                                  "und"
+                                  "\x44\x84\x81\x00"
+                                  "\x44\x87\x85"
+                                  "title"s;
+    CPPUNIT_ASSERT_EQUAL(expectedMatroska, matroskaBuffer);
+    CPPUNIT_ASSERT_EQUAL(expectedMatroska, matroskaStream.str());
+    CPPUNIT_ASSERT_EQUAL(DiagLevel::None, diag.level());
 }
@@ -0,0 +1,366 @@
+#include "./textconversion.h"
+
+#include <c++utilities/conversion/conversionexception.h>
+
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+using namespace std;
+using namespace CppUtilities;
+
+namespace TagParser {
+
+/// \cond
+
+/*
+ * The transcoders below convert between the text encodings supported by TagValue without going through iconv and without
+ * allocating intermediate buffers. Runs of ASCII characters are processed eight bytes at a time; the loops handling them
+ * have a fixed trip count and are vectorized by the compiler.
+ */
+
+/*!
+ * \brief Returns whether the eight bytes at \a input are all ASCII characters.
+ */
+static inline bool isAsciiChunk(const unsigned char *input)
+{
+    std::uint64_t chunk;
+    std::memcpy(&chunk, input, sizeof(chunk));
+    return !(chunk & 0x8080808080808080u);
+}
+
+/*!
+ * \brief The Latin1Codec struct reads and writes ISO-8859-1.
+ */
+struct Latin1Codec {
+    static constexpr std::size_t unitSize = 1;
+    static constexpr std::size_t chunkUnits = 8;
+
+    static bool isAscii(const unsigned char *input)
+    {
+        return isAsciiChunk(input);
+    }
+    static unsigned char asciiAt(const unsigned char *input, std::size_t index)
+    {
+        return input[index];
+    }
+    static char32_t decode(const unsigned char *&input, const unsigned char *)
+    {
+        return *input++;
+    }
+    static unsigned char *encodeAscii(unsigned char *output, unsigned char c)
+    {
+        *output++ = c;
+        return output;
+    }
+    static unsigned char *encode(unsigned char *output, char32_t c)
+    {
+        if (c > 0xFF) {
+            throw ConversionException("Character can not be represented in Latin-1.");
+        }
+        *output++ = static_cast<unsigned char>(c);
+        return output;
+    }
+};
+
+/*!
+ * \brief The Utf8Codec struct reads and writes UTF-8.
+ */
+struct Utf8Codec {
+    static constexpr std::size_t unitSize = 1;
+    static constexpr std::size_t chunkUnits = 8;
+
+    static bool isAscii(const unsigned char *input)
+    {
+        return isAsciiChunk(input);
+    }
+    static unsigned char asciiAt(const unsigned char *input, std::size_t index)
+    {
+        return input[index];
+    }
+    static char32_t decode(const unsigned char *&input, const unsigned char *end)
+    {
+        const auto lead = *input++;
+        if (lead < 0x80) {
+            return lead;
+        }
+        auto continuationBytes = std::size_t();
+        auto c = char32_t(), min = char32_t();
+        if ((lead & 0xE0) == 0xC0) {
+            continuationBytes = 1, c = lead & 0x1F, min = 0x80;
+        } else if ((lead & 0xF0) == 0xE0) {
+            continuationBytes = 2, c = lead & 0x0F, min = 0x800;
+        } else if ((lead & 0xF8) == 0xF0) {
+            continuationBytes = 3, c = lead & 0x07, min = 0x10000;
+        } else {
+            throw ConversionException("Invalid UTF-8 lead byte.");
+        }
+        if (static_cast<std::size_t>(end - input) < continuationBytes) {
+            throw ConversionException("Truncated UTF-8 sequence.");
+        }
+        for (; continuationBytes; --continuationBytes) {
+            const auto continuation = *input++;
+            if ((continuation & 0xC0) != 0x80) {
+                throw ConversionException("Invalid UTF-8 continuation byte.");
+            }
+            c = (c << 6) | (continuation & 0x3F);
+        }
+        if (c < min || c > 0x10FFFF || (c >= 0xD800 && c <= 0xDFFF)) {
+            throw ConversionException("Invalid UTF-8 sequence.");
+        }
+        return c;
+    }
+    static unsigned char *encodeAscii(unsigned char *output, unsigned char c)
+    {
+        *output++ = c;
+        return output;
+    }
+    static unsigned char *encode(unsigned char *output, char32_t c)
+    {
+        if (c < 0x80) {
+            *output++ = static_cast<unsigned char>(c);
+        } else if (c < 0x800) {
+            *output++ = static_cast<unsigned char>(0xC0 | (c >> 6));
+            *output++ = static_cast<unsigned char>(0x80 | (c & 0x3F));
+        } else if (c < 0x10000) {
+            *output++ = static_cast<unsigned char>(0xE0 | (c >> 12));
+            *output++ = static_cast<unsigned char>(0x80 | ((c >> 6) & 0x3F));
+            *output++ = static_cast<unsigned char>(0x80 | (c & 0x3F));
+        } else {
+            *output++ = static_cast<unsigned char>(0xF0 | (c >> 18));
+            *output++ = static_cast<unsigned char>(0x80 | ((c >> 12) & 0x3F));
+            *output++ = static_cast<unsigned char>(0x80 | ((c >> 6) & 0x3F));
+            *output++ = static_cast<unsigned char>(0x80 | (c & 0x3F));
+        }
+        return output;
+    }
+};
+
+/*!
+ * \brief The Utf16Codec struct reads and writes UTF-16 in the byte order specified via \a bigEndian.
+ */
+template <bool bigEndian> struct Utf16Codec {
+    static constexpr std::size_t unitSize = 2;
+    static constexpr std::size_t chunkUnits = 4;
+    static constexpr std::size_t lowByte = bigEndian ? 1 : 0;
+    static constexpr std::size_t highByte = bigEndian ? 0 : 1;
+
+    static bool isAscii(const unsigned char *input)
+    {
+        auto low = static_cast<unsigned char>(0), high = static_cast<unsigned char>(0);
+        for (std::size_t i = 0; i != chunkUnits * unitSize; i += unitSize) {
+            low |= input[i + lowByte];
+            high |= input[i + highByte];
+        }
+        return !high && !(low & 0x80);
+    }
+    static unsigned char asciiAt(const unsigned char *input, std::size_t index)
+    {
+        return input[index * unitSize + lowByte];
+    }
+    static std::uint16_t readUnit(const unsigned char *input)
+    {
+        return static_cast<std::uint16_t>((input[highByte] << 8) | input[lowByte]);
+    }
+    static unsigned char *writeUnit(unsigned char *output, std::uint16_t unit)
+    {
+        output[lowByte] = static_cast<unsigned char>(unit & 0xFF);
+        output[highByte] = static_cast<unsigned char>(unit >> 8);
+        return output + unitSize;
+    }
+    static char32_t decode(const unsigned char *&input, const unsigned char *end)
+    {
+        const auto unit = readUnit(input);
+        input += unitSize;
+        if (unit < 0xD800 || unit > 0xDFFF) {
+            return unit;
+        }
+        if (unit > 0xDBFF || static_cast<std::size_t>(end - input) < unitSize) {
+            throw ConversionException("Unpaired UTF-16 surrogate.");
+        }
+        const auto lowSurrogate = readUnit(input);
+        if (lowSurrogate < 0xDC00 || lowSurrogate > 0xDFFF) {
+            throw ConversionException("Unpaired UTF-16 surrogate.");
+        }
+        input += unitSize;
+        return 0x10000 + ((static_cast<char32_t>(unit) - 0xD800) << 10) + (lowSurrogate - 0xDC00);
+    }
+    static unsigned char *encodeAscii(unsigned char *output, unsigned char c)
+    {
+        output[lowByte] = c;
+        output[highByte] = 0;
+        return output + unitSize;
+    }
+    static unsigned char *encode(unsigned char *output, char32_t c)
+    {
+        if (c < 0x10000) {
+            return writeUnit(output, static_cast<std::uint16_t>(c));
+        }
+        c -= 0x10000;
+        output = writeUnit(output, static_cast<std::uint16_t>(0xD800 | (c >> 10)));
+        return writeUnit(output, static_cast<std::uint16_t>(0xDC00 | (c & 0x3FF)));
+    }
+};
+
+/*!
+ * \brief Transcodes the text within [\a input, \a end) from InputCodec to OutputCodec writing it to \a output.
+ * \returns Returns the end of the written output.
+ */
+template <typename InputCodec, typename OutputCodec>
+static unsigned char *transcode(const unsigned char *input, const unsigned char *end, unsigned char *output)
+{
+    constexpr auto chunkSize = InputCodec::chunkUnits * InputCodec::unitSize;
+    while (input != end) {
+        while (static_cast<std::size_t>(end - input) >= chunkSize && InputCodec::isAscii(input)) {
+            for (std::size_t i = 0; i != InputCodec::chunkUnits; ++i) {
+                output = OutputCodec::encodeAscii(output, InputCodec::asciiAt(input, i));
+            }
+            input += chunkSize;
+        }
+        if (input != end) {
+            output = OutputCodec::encode(output, InputCodec::decode(input, end));
+        }
+    }
+    return output;
+}
+
+/*!
+ * \brief Transcodes the text within [\a input, \a end) from InputCodec to the specified \a outputEncoding writing it to \a output.
+ * \returns Returns the end of the written output.
+ */
+template <typename InputCodec>
+static unsigned char *transcodeTo(TagTextEncoding outputEncoding, const unsigned char *input, const unsigned char *end, unsigned char *output)
+{
+    switch (outputEncoding) {
+    case TagTextEncoding::Latin1:
+        return transcode<InputCodec, Latin1Codec>(input, end, output);
+    case TagTextEncoding::Utf8:
+        return transcode<InputCodec, Utf8Codec>(input, end, output);
+    case TagTextEncoding::Utf16LittleEndian:
+        return transcode<InputCodec, Utf16Codec<false>>(input, end, output);
+    case TagTextEncoding::Utf16BigEndian:
+        return transcode<InputCodec, Utf16Codec<true>>(input, end, output);
+    default:
+        throw ConversionException("Unsupported output encoding.");
+    }
+}
+
+static constexpr bool isUtf16(TagTextEncoding encoding)
+{
+    return encoding == TagTextEncoding::Utf16LittleEndian || encoding == TagTextEncoding::Utf16BigEndian;
+}
+
+/*!
+ * \brief Returns the number of bytes the output buffer passed to transcodeText() needs to provide at least.
+ */
+std::size_t maxTranscodedTextSize(TagTextEncoding inputEncoding, TagTextEncoding outputEncoding, std::size_t inputSize)
+{
+    if (inputEncoding == outputEncoding || (isUtf16(inputEncoding) && isUtf16(outputEncoding))) {
+        return inputSize;
+    }
+    switch (inputEncoding) {
+    case TagTextEncoding::Latin1:
+        return inputSize * 2; // Latin-1 to UTF-8: up to 2 bytes per character, to UTF-16: 2 bytes per character
+    case TagTextEncoding::Utf8:
+        return outputEncoding == TagTextEncoding::Latin1 ? inputSize : inputSize * 2; // no UTF-8 sequence takes more than twice the size in UTF-16
+    default:
+        return outputEncoding == TagTextEncoding::Latin1 ? inputSize / 2 : inputSize / 2 * 3; // one unit makes up to 3 bytes in UTF-8
+    }
+}
+
+/*!
+ * \brief Converts the \a inputSize bytes at \a input from \a inputEncoding to \a outputEncoding.
+ * \param output Specifies the buffer to write the converted text to. It must provide at least maxTranscodedTextSize() bytes.
+ * \returns Returns the number of bytes written to \a output.
+ * \throws Throws ConversionException if the input is invalid or a character can not be represented in \a outputEncoding.
+ * \remarks
+ * - Only checks whether the input is valid if a conversion is actually required. Changing the byte-order of UTF-16 does not
+ *   count as conversion in that regard.
+ * - A byte order mark is not treated specially.
+ */
+std::size_t transcodeText(TagTextEncoding inputEncoding, TagTextEncoding outputEncoding, const char *input, std::size_t inputSize, char *output)
+{
+    if (isUtf16(inputEncoding) && (inputSize % 2)) {
+        throw ConversionException("UTF-16 input has odd number of bytes.");
+    }
+    if (!inputSize) {
+        return 0;
+    }
+    if (inputEncoding == outputEncoding) {
+        std::memcpy(output, input, inputSize);
+        return inputSize;
+    }
+    if (isUtf16(inputEncoding) && isUtf16(outputEncoding)) {
+        std::memcpy(output, input, inputSize);
+        swapUtf16ByteOrder(output, inputSize);
+        return inputSize;
+    }
+
+    const auto *const begin = reinterpret_cast<const unsigned char *>(input);
+    const auto *const end = begin + inputSize;
+    auto *const outputBegin = reinterpret_cast<unsigned char *>(output);
+    auto *outputEnd = outputBegin;
+    switch (inputEncoding) {
+    case TagTextEncoding::Latin1:
+        outputEnd = transcodeTo<Latin1Codec>(outputEncoding, begin, end, outputBegin);
+        break;
+    case TagTextEncoding::Utf8:
+        outputEnd = transcodeTo<Utf8Codec>(outputEncoding, begin, end, outputBegin);
+        break;
+    case TagTextEncoding::Utf16LittleEndian:
+        outputEnd = transcodeTo<Utf16Codec<false>>(outputEncoding, begin, end, outputBegin);
+        break;
+    case TagTextEncoding::Utf16BigEndian:
+        outputEnd = transcodeTo<Utf16Codec<true>>(outputEncoding, begin, end, outputBegin);
+        break;
+    default:
+        throw ConversionException("Unsupported input encoding.");
+    }
+    return static_cast<std::size_t>(outputEnd - outputBegin);
+}
+
+/*!
+ * \brief Converts the \a inputSize bytes at \a input from \a inputEncoding to \a outputEncoding.
+ * \param output Specifies the string to assign the converted text to. Its capacity is reused.
+ * \throws Throws ConversionException if the input is invalid or a character can not be represented in \a outputEncoding.
+ */
+void transcodeText(TagTextEncoding inputEncoding, TagTextEncoding outputEncoding, const char *input, std::size_t inputSize, std::string &output)
+{
+    output.resize(maxTranscodedTextSize(inputEncoding, outputEncoding, inputSize));
+    output.resize(transcodeText(inputEncoding, outputEncoding, input, inputSize, output.data()));
+}
+
+/*!
+ * \brief Converts the \a inputSize bytes at \a input from \a inputEncoding to \a outputEncoding.
+ * \param output Specifies the string to assign the converted text to. Its capacity is reused.
+ * \throws Throws ConversionException if the input is invalid or a character can not be represented in \a outputEncoding.
+ * \remarks Only makes sense if \a outputEncoding is a UTF-16 encoding. Otherwise a trailing odd byte is dropped.
+ */
+void transcodeText(
+    TagTextEncoding inputEncoding, TagTextEncoding outputEncoding, const char *input, std::size_t inputSize, std::u16string &output)
+{
+    output.resize((maxTranscodedTextSize(inputEncoding, outputEncoding, inputSize) + 1) / sizeof(char16_t));
+    output.resize(transcodeText(inputEncoding, outputEncoding, input, inputSize, reinterpret_cast<char *>(output.data())) / sizeof(char16_t));
+}
+
+/*!
+ * \brief Swaps the byte order of the UTF-16 units within the specified \a data in-place.
+ * \remarks A trailing odd byte is left as-is.
+ */
+void swapUtf16ByteOrder(char *data, std::size_t size)
+{
+    auto *const end = data + (size & ~static_cast<std::size_t>(1));
+    for (; end - data >= 8; data += 8) {
+        std::uint64_t chunk;
+        std::memcpy(&chunk, data, sizeof(chunk));
+        chunk = ((chunk & 0x00FF00FF00FF00FFu) << 8) | ((chunk >> 8) & 0x00FF00FF00FF00FFu);
+        std::memcpy(data, &chunk, sizeof(chunk));
+    }
+    for (; data != end; data += 2) {
+        std::swap(data[0], data[1]);
+    }
+}
+
+/// \endcond
+
+} // namespace TagParser
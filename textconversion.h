@@ -0,0 +1,25 @@
+#ifndef TAG_PARSER_TEXTCONVERSION_H
+#define TAG_PARSER_TEXTCONVERSION_H
+
+#include "./tagvalue.h"
+
+#include <cstddef>
+#include <string>
+
+namespace TagParser {
+
+/// \cond
+
+std::size_t maxTranscodedTextSize(TagTextEncoding inputEncoding, TagTextEncoding outputEncoding, std::size_t inputSize);
+std::size_t transcodeText(TagTextEncoding inputEncoding, TagTextEncoding outputEncoding, const char *input, std::size_t inputSize, char *output);
+void transcodeText(
+    TagTextEncoding inputEncoding, TagTextEncoding outputEncoding, const char *input, std::size_t inputSize, std::string &output);
+void transcodeText(
+    TagTextEncoding inputEncoding, TagTextEncoding outputEncoding, const char *input, std::size_t inputSize, std::u16string &output);
+void swapUtf16ByteOrder(char *data, std::size_t size);
+
+/// \endcond
+
+} // namespace TagParser
+
+#endif // TAG_PARSER_TEXTCONVERSION_H
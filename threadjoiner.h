@@ -0,0 +1,84 @@
+#ifndef TAG_PARSER_THREADJOINER_H
+#define TAG_PARSER_THREADJOINER_H
+
+#include <cstddef>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace TagParser {
+
+/// \cond
+
+/*!
+ * \brief The ThreadJoiner class starts worker threads and joins them at the latest when it is destroyed.
+ * \remarks
+ * - Destroying a joinable std::thread ends the process. Using this class instead of a plain std::vector<std::thread>
+ *   ensures all workers are joined even if the calling thread throws while they are still running.
+ * - The workers must not let exceptions escape and must stop on their own (e.g. when the operation has been aborted)
+ *   because the destructor blocks until all of them have returned.
+ * - The ThreadJoiner must be declared after all objects the workers refer to so it is destroyed before them.
+ */
+class ThreadJoiner {
+public:
+    ThreadJoiner() = default;
+    ThreadJoiner(const ThreadJoiner &) = delete;
+    ThreadJoiner &operator=(const ThreadJoiner &) = delete;
+    ~ThreadJoiner();
+
+    template <typename Function, typename... Args> bool tryToStart(Function &&function, Args &&...args);
+    std::size_t count() const;
+    void joinAll();
+
+private:
+    std::vector<std::thread> m_threads;
+};
+
+/*!
+ * \brief Joins all threads which have not been joined yet.
+ */
+inline ThreadJoiner::~ThreadJoiner()
+{
+    joinAll();
+}
+
+/*!
+ * \brief Starts a new thread invoking \a function with the specified \a args.
+ * \returns Returns whether the thread could be started. Returns false if the system is unable to start another thread
+ *          (std::thread's constructor threw std::system_error) so the caller can continue with fewer threads.
+ */
+template <typename Function, typename... Args> bool ThreadJoiner::tryToStart(Function &&function, Args &&...args)
+{
+    try {
+        m_threads.emplace_back(std::forward<Function>(function), std::forward<Args>(args)...);
+    } catch (const std::system_error &) {
+        return false;
+    }
+    return true;
+}
+
+/*!
+ * \brief Returns the number of threads which have been started and not been joined yet.
+ */
+inline std::size_t ThreadJoiner::count() const
+{
+    return m_threads.size();
+}
+
+/*!
+ * \brief Joins all threads which have not been joined yet.
+ */
+inline void ThreadJoiner::joinAll()
+{
+    for (auto &thread : m_threads) {
+        thread.join();
+    }
+    m_threads.clear();
+}
+
+/// \endcond
+
+} // namespace TagParser
+
+#endif // TAG_PARSER_THREADJOINER_H
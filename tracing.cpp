@@ -0,0 +1,239 @@
+#include "./tracing.h"
+
+#include <atomic>
+#include <cstdint>
+#include <iomanip>
+
+using namespace std;
+
+namespace TagParser {
+
+/// \cond
+namespace {
+
+std::atomic<TraceSink *> currentSink(nullptr);
+thread_local TraceSpan *currentSpan = nullptr;
+
+/*!
+ * \brief Returns a small, sequential ID for the current thread as Chrome's trace viewer shows these IDs as track names.
+ */
+std::uint64_t currentThreadId()
+{
+    static auto nextThreadId = std::atomic<std::uint64_t>(1);
+    thread_local const auto threadId = nextThreadId++;
+    return threadId;
+}
+
+/*!
+ * \brief Writes the specified \a value as JSON string to \a stream.
+ */
+void writeJsonString(std::ostream &stream, std::string_view value)
+{
+    stream.put('"');
+    for (const auto c : value) {
+        switch (c) {
+        case '"':
+            stream << "\\\"";
+            break;
+        case '\\':
+            stream << "\\\\";
+            break;
+        case '\n':
+            stream << "\\n";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                stream << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+            } else {
+                stream.put(c);
+            }
+        }
+    }
+    stream.put('"');
+}
+
+/*!
+ * \brief Writes the specified \a duration as microseconds (the unit of the trace-event format) to \a stream.
+ */
+void writeMicroseconds(std::ostream &stream, std::chrono::nanoseconds duration)
+{
+    const auto ns = duration.count() < 0 ? 0 : duration.count();
+    stream << (ns / 1000) << '.' << std::setw(3) << std::setfill('0') << (ns % 1000);
+}
+
+} // namespace
+/// \endcond
+
+/*!
+ * \class TagParser::TraceSink
+ * \brief The TraceSink class writes spans recorded via TraceSpan in Chrome's trace-event format to a stream.
+ *
+ * The written JSON document can be loaded in chrome://tracing or https://ui.perfetto.dev to get a timeline of the
+ * phases and steps of parsing and applying changes. Spans are written as "complete" events as soon as they end so the
+ * document is only valid after finish() has been called (or the sink has been destroyed).
+ *
+ * To record spans, the library needs to be built with the CMake option ENABLE_TRACING and the sink needs to be set via
+ * setTraceSink().
+ *
+ * \remarks Writing is thread-safe. The stream should be buffered as each span causes a few small writes.
+ */
+
+/*!
+ * \brief Constructs a new sink writing to the specified \a stream and writes the beginning of the JSON document.
+ * \remarks Timestamps are relative to the construction of the sink.
+ */
+TraceSink::TraceSink(std::ostream &stream)
+    : m_stream(stream)
+    , m_epoch(std::chrono::steady_clock::now())
+    , m_eventCount(0)
+    , m_finished(false)
+{
+    m_stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+}
+
+/*!
+ * \brief Finishes the JSON document if not done yet.
+ * \remarks The sink must be unset via setTraceSink() before being destroyed.
+ */
+TraceSink::~TraceSink()
+{
+    finish();
+}
+
+/*!
+ * \brief Writes a span with the specified \a name and \a category from \a start to \a end for the current thread.
+ * \remarks This function is thread-safe. Spans written after finish() are discarded.
+ */
+void TraceSink::writeSpan(
+    std::string_view name, std::string_view category, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end)
+{
+    const auto threadId = currentThreadId();
+    const auto lock = std::lock_guard<std::mutex>(m_mutex);
+    if (m_finished) {
+        return;
+    }
+    m_stream << (m_eventCount++ ? ",\n{\"name\":" : "\n{\"name\":");
+    writeJsonString(m_stream, name);
+    m_stream << ",\"cat\":";
+    writeJsonString(m_stream, category);
+    m_stream << ",\"ph\":\"X\",\"ts\":";
+    writeMicroseconds(m_stream, start - m_epoch);
+    m_stream << ",\"dur\":";
+    writeMicroseconds(m_stream, end - start);
+    m_stream << ",\"pid\":1,\"tid\":" << threadId << '}';
+}
+
+/*!
+ * \brief Writes the end of the JSON document and flushes the stream.
+ * \remarks This function is thread-safe. Subsequent calls have no effect.
+ */
+void TraceSink::finish()
+{
+    const auto lock = std::lock_guard<std::mutex>(m_mutex);
+    if (m_finished) {
+        return;
+    }
+    m_finished = true;
+    m_stream << "\n]}\n";
+    m_stream.flush();
+}
+
+/*!
+ * \brief Returns the number of spans written so far.
+ */
+std::size_t TraceSink::eventCount() const
+{
+    const auto lock = std::lock_guard<std::mutex>(m_mutex);
+    return m_eventCount;
+}
+
+/*!
+ * \brief Sets the \a sink spans are written to; pass nullptr to stop tracing.
+ * \remarks
+ * - The sink must not be destroyed while spans which have been started when it was set are still ongoing.
+ * - Has no effect unless the library has been built with tracing enabled (see isTracingEnabled()).
+ */
+void setTraceSink(TraceSink *sink)
+{
+    currentSink.store(sink);
+}
+
+/*!
+ * \brief Returns the sink spans are written to or nullptr if tracing is not active.
+ */
+TraceSink *traceSink()
+{
+    return currentSink.load(std::memory_order_relaxed);
+}
+
+/*!
+ * \class TagParser::TraceSpan
+ * \brief The TraceSpan class records a span from its construction until its destruction.
+ *
+ * Spans started on the same thread nest. Steps (see step()) split the innermost span into sub-spans; the progress
+ * feedback starts a step whenever the operation updates its step so each progress step shows up in the timeline.
+ *
+ * The library uses this class only via the macros TAG_PARSER_TRACE_SPAN() and TAG_PARSER_TRACE_STEP() which expand to
+ * nothing unless the library has been built with tracing enabled. When tracing is compiled in but no sink is set,
+ * a span only costs a relaxed atomic load.
+ */
+
+/*!
+ * \brief Starts a span with the specified \a name and \a category.
+ * \remarks Both strings are not copied and must outlive the span.
+ */
+TraceSpan::TraceSpan(std::string_view name, std::string_view category)
+    : m_sink(traceSink())
+    , m_parent(nullptr)
+    , m_name(name)
+    , m_category(category)
+    , m_start(m_sink ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point())
+{
+    if (m_sink) {
+        m_parent = currentSpan;
+        currentSpan = this;
+    }
+}
+
+/*!
+ * \brief Ends the span and its current step and writes them to the sink.
+ */
+TraceSpan::~TraceSpan()
+{
+    if (!m_sink) {
+        return;
+    }
+    const auto end = std::chrono::steady_clock::now();
+    finishStep(end);
+    m_sink->writeSpan(m_name, m_category, m_start, end);
+    currentSpan = m_parent;
+}
+
+/*!
+ * \brief Ends the current step of the innermost span of the current thread and starts a new step with the specified \a name.
+ * \remarks Does nothing if there is no span on the current thread.
+ */
+void TraceSpan::step(std::string_view name)
+{
+    auto *const span = currentSpan;
+    if (!span) {
+        return;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    span->finishStep(now);
+    span->m_step.assign(name);
+    span->m_stepStart = now;
+}
+
+/*!
+ * \brief Writes the current step (if any) ending at \a end to the sink.
+ */
+void TraceSpan::finishStep(std::chrono::steady_clock::time_point end)
+{
+    if (!m_step.empty()) {
+        m_sink->writeSpan(m_step, "step", m_stepStart, end);
+        m_step.clear();
+    }
+}
+
+} // namespace TagParser
@@ -0,0 +1,98 @@
+#ifndef TAG_PARSER_TRACING_H
+#define TAG_PARSER_TRACING_H
+
+#include "./global.h"
+
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace TagParser {
+
+class TAG_PARSER_EXPORT TraceSink {
+public:
+    explicit TraceSink(std::ostream &stream);
+    TraceSink(const TraceSink &) = delete;
+    TraceSink &operator=(const TraceSink &) = delete;
+    ~TraceSink();
+
+    void writeSpan(std::string_view name, std::string_view category, std::chrono::steady_clock::time_point start,
+        std::chrono::steady_clock::time_point end);
+    void finish();
+    std::size_t eventCount() const;
+
+private:
+    mutable std::mutex m_mutex;
+    std::ostream &m_stream;
+    const std::chrono::steady_clock::time_point m_epoch;
+    std::size_t m_eventCount;
+    bool m_finished;
+};
+
+TAG_PARSER_EXPORT void setTraceSink(TraceSink *sink);
+TAG_PARSER_EXPORT TraceSink *traceSink();
+
+/*!
+ * \brief Returns whether the library has been built with tracing enabled (CMake option ENABLE_TRACING).
+ * \remarks If not, TAG_PARSER_TRACE_SPAN() and TAG_PARSER_TRACE_STEP() expand to nothing and no events are written to
+ *          the TraceSink.
+ */
+constexpr bool isTracingEnabled()
+{
+#ifdef TAG_PARSER_ENABLE_TRACING
+    return true;
+#else
+    return false;
+#endif
+}
+
+class TAG_PARSER_EXPORT TraceSpan {
+public:
+    explicit TraceSpan(std::string_view name, std::string_view category = "tagparser");
+    TraceSpan(const TraceSpan &) = delete;
+    TraceSpan &operator=(const TraceSpan &) = delete;
+    ~TraceSpan();
+
+    static void step(std::string_view name);
+
+private:
+    void finishStep(std::chrono::steady_clock::time_point end);
+
+    TraceSink *const m_sink;
+    TraceSpan *m_parent;
+    const std::string_view m_name;
+    const std::string_view m_category;
+    const std::chrono::steady_clock::time_point m_start;
+    std::chrono::steady_clock::time_point m_stepStart;
+    std::string m_step;
+};
+
+} // namespace TagParser
+
+#define TAG_PARSER_TRACE_CONCAT_IMPL(a, b) a##b
+#define TAG_PARSER_TRACE_CONCAT(a, b) TAG_PARSER_TRACE_CONCAT_IMPL(a, b)
+
+/*!
+ * \def TAG_PARSER_TRACE_SPAN
+ * \brief Records a span with the specified \a name (which must outlive the enclosing scope) until the end of the scope.
+ * \remarks Expands to nothing unless the library has been built with tracing enabled.
+ */
+
+/*!
+ * \def TAG_PARSER_TRACE_STEP
+ * \brief Starts a step with the specified \a name within the innermost span of the current thread.
+ * \remarks Expands to nothing unless the library has been built with tracing enabled.
+ */
+
+#ifdef TAG_PARSER_ENABLE_TRACING
+#define TAG_PARSER_TRACE_SPAN(name) const ::TagParser::TraceSpan TAG_PARSER_TRACE_CONCAT(tagParserTraceSpan, __LINE__)(name)
+#define TAG_PARSER_TRACE_STEP(name) ::TagParser::TraceSpan::step(name)
+#else
+#define TAG_PARSER_TRACE_SPAN(name)
+#define TAG_PARSER_TRACE_STEP(name)
+#endif
+
+#endif // TAG_PARSER_TRACING_H
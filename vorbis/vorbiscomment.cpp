@@ -5,13 +5,14 @@
 
 #include "../diagnostics.h"
 #include "../exceptions.h"
+#include "../fieldidtable.h"
+#include "../tagfieldfilter.h"
 
 #include <c++utilities/conversion/stringbuilder.h>
 #include <c++utilities/io/binaryreader.h>
 #include <c++utilities/io/binarywriter.h>
 #include <c++utilities/io/copy.h>
 
-#include <map>
 #include <memory>
 
 using namespace std;
@@ -45,139 +46,85 @@ bool VorbisComment::setValue(KnownField field, const TagValue &value)
     }
 }
 
+/// \cond
+// mappings between KnownField and field names used to create the tables for both directions; the field names are sorted
+// case-insensitively at compile-time
+// clang-format off
+constexpr FieldIdMapping<std::string_view> vorbisCommentFieldMappings[] = {
+    { VorbisCommentIds::album(), KnownField::Album },
+    { VorbisCommentIds::artist(), KnownField::Artist },
+    { VorbisCommentIds::comment(), KnownField::Comment },
+    { VorbisCommentIds::cover(), KnownField::Cover },
+    { VorbisCommentIds::date(), KnownField::RecordDate },
+    { VorbisCommentIds::title(), KnownField::Title },
+    { VorbisCommentIds::genre(), KnownField::Genre },
+    { VorbisCommentIds::trackNumber(), KnownField::TrackPosition },
+    { VorbisCommentIds::diskNumber(), KnownField::DiskPosition },
+    { VorbisCommentIds::partNumber(), KnownField::PartNumber },
+    { VorbisCommentIds::composer(), KnownField::Composer },
+    { VorbisCommentIds::encoder(), KnownField::Encoder },
+    { VorbisCommentIds::encodedBy(), KnownField::EncodedBy },
+    { VorbisCommentIds::encoderSettings(), KnownField::EncoderSettings },
+    { VorbisCommentIds::description(), KnownField::Description },
+    { VorbisCommentIds::grouping(), KnownField::Grouping },
+    { VorbisCommentIds::label(), KnownField::RecordLabel },
+    { VorbisCommentIds::performer(), KnownField::Performers },
+    { VorbisCommentIds::language(), KnownField::Language },
+    { VorbisCommentIds::lyricist(), KnownField::Lyricist },
+    { VorbisCommentIds::lyrics(), KnownField::Lyrics },
+    { VorbisCommentIds::albumArtist(), KnownField::AlbumArtist },
+    { VorbisCommentIds::conductor(), KnownField::Conductor },
+    { VorbisCommentIds::copyright(), KnownField::Copyright },
+    { VorbisCommentIds::license(), KnownField::License },
+    { VorbisCommentIds::director(), KnownField::Director },
+    { VorbisCommentIds::isrc(), KnownField::ISRC },
+    { VorbisCommentIds::rating(), KnownField::Rating },
+    { VorbisCommentIds::bpm(), KnownField::Bpm },
+    { VorbisCommentIds::publisher(), KnownField::Publisher },
+    { VorbisCommentIds::publisherWebpage(), KnownField::PublisherWebpage },
+    { VorbisCommentIds::website(), KnownField::PerformerWebpage },
+    { VorbisCommentIds::arranger(), KnownField::Arranger },
+};
+// clang-format on
+// exceptions only applying when looking up the KnownField for a field name
+// note: "YEAR" is read as record date as well; "LANGUAGE" is not mapped back to KnownField::Language (it never has been,
+//       so this is kept for compatibility)
+constexpr FieldIdMapping<std::string_view> vorbisCommentKnownFieldExceptions[] = {
+    { VorbisCommentIds::year(), KnownField::RecordDate },
+    { VorbisCommentIds::language(), KnownField::Invalid },
+};
+constexpr auto vorbisCommentFieldIds = makeFieldIdTable(vorbisCommentFieldMappings);
+constexpr auto vorbisCommentKnownFields
+    = makeKnownFieldTable(vorbisCommentFieldMappings, vorbisCommentKnownFieldExceptions, CaseInsensitiveStringComparer());
+/// \endcond
+
 VorbisComment::IdentifierType VorbisComment::internallyGetFieldId(KnownField field) const
 {
-    using namespace VorbisCommentIds;
-    switch (field) {
-    case KnownField::Album:
-        return std::string(album());
-    case KnownField::Artist:
-        return std::string(artist());
-    case KnownField::Comment:
-        return std::string(comment());
-    case KnownField::Cover:
-        return std::string(cover());
-    case KnownField::RecordDate:
-        return std::string(date());
-    case KnownField::Title:
-        return std::string(title());
-    case KnownField::Genre:
-        return std::string(genre());
-    case KnownField::TrackPosition:
-        return std::string(trackNumber());
-    case KnownField::DiskPosition:
-        return std::string(diskNumber());
-    case KnownField::PartNumber:
-        return std::string(partNumber());
-    case KnownField::Composer:
-        return std::string(composer());
-    case KnownField::Encoder:
-        return std::string(encoder());
-    case KnownField::EncodedBy:
-        return std::string(encodedBy());
-    case KnownField::EncoderSettings:
-        return std::string(encoderSettings());
-    case KnownField::Description:
-        return std::string(description());
-    case KnownField::Grouping:
-        return std::string(grouping());
-    case KnownField::RecordLabel:
-        return std::string(label());
-    case KnownField::Performers:
-        return std::string(performer());
-    case KnownField::Language:
-        return std::string(language());
-    case KnownField::Lyricist:
-        return std::string(lyricist());
-    case KnownField::Lyrics:
-        return std::string(lyrics());
-    case KnownField::AlbumArtist:
-        return std::string(albumArtist());
-    case KnownField::Conductor:
-        return std::string(conductor());
-    case KnownField::Copyright:
-        return std::string(copyright());
-    case KnownField::License:
-        return std::string(license());
-    case KnownField::Director:
-        return std::string(director());
-    case KnownField::ISRC:
-        return std::string(isrc());
-    case KnownField::Rating:
-        return std::string(rating());
-    case KnownField::Bpm:
-        return std::string(bpm());
-    case KnownField::Publisher:
-        return std::string(publisher());
-    case KnownField::PublisherWebpage:
-        return std::string(publisherWebpage());
-    case KnownField::PerformerWebpage:
-        return std::string(website());
-    case KnownField::Arranger:
-        return std::string(arranger());
-    default:
-        return std::string();
-    }
+    return std::string(fieldIdFromTable(vorbisCommentFieldIds, field));
 }
 
 KnownField VorbisComment::internallyGetKnownField(const IdentifierType &id) const
 {
-    using namespace VorbisCommentIds;
-    // clang-format off
-    static const std::map<std::string_view, KnownField, CaseInsensitiveStringComparer> fieldMap({
-         { album(), KnownField::Album },
-         { artist(), KnownField::Artist },
-         { comment(), KnownField::Comment },
-         { cover(), KnownField::Cover },
-         { date(), KnownField::RecordDate },
-         { year(), KnownField::RecordDate },
-         { title(), KnownField::Title },
-         { genre(), KnownField::Genre },
-         { trackNumber(), KnownField::TrackPosition },
-         { diskNumber(), KnownField::DiskPosition },
-         { partNumber(), KnownField::PartNumber },
-         { composer(), KnownField::Composer },
-         { encoder(), KnownField::Encoder },
-         { encodedBy(), KnownField::EncodedBy },
-         { encoderSettings(), KnownField::EncoderSettings },
-         { description(), KnownField::Description },
-         { grouping(), KnownField::Grouping },
-         { label(), KnownField::RecordLabel },
-         { performer(), KnownField::Performers },
-         { lyricist(), KnownField::Lyricist },
-         { lyrics(), KnownField::Lyrics },
-         { albumArtist(), KnownField::AlbumArtist },
-         { conductor(), KnownField::Conductor },
-         { copyright(), KnownField::Copyright },
-         { license(), KnownField::License },
-         { director(), KnownField::Director },
-         { isrc(), KnownField::ISRC },
-         { rating(), KnownField::Rating },
-         { bpm(), KnownField::Bpm },
-         { publisher(), KnownField::Publisher },
-         { publisherWebpage(), KnownField::PublisherWebpage },
-         { website(), KnownField::PerformerWebpage },
-         { arranger(), KnownField::Arranger },
-    });
-    // clang-format on
-    const auto knownField(fieldMap.find(id));
-    return knownField != fieldMap.cend() ? knownField->second : KnownField::Invalid;
+    return knownFieldFromTable(vorbisCommentKnownFields, std::string_view(id), CaseInsensitiveStringComparer());
 }
 
 /// \cond
 void VorbisComment::extendPositionInSetField(std::string_view field, std::string_view totalField, const std::string &diagContext, Diagnostics &diag)
 {
-    auto totalValues = std::vector<std::int32_t>();
-    auto fieldsIter = fields().equal_range(std::string(totalField));
-    auto fieldsDist = std::distance(fieldsIter.first, fieldsIter.second);
+    // check via const access first so the tag is only considered modified if there is actually something to convert
+    const auto totalFieldId = std::string(totalField);
+    const auto fieldsDist = const_cast<const VorbisComment *>(this)->fields().count(totalFieldId);
     if (!fieldsDist) {
         return;
     }
-    totalValues.reserve(static_cast<std::size_t>(fieldsDist));
-    for (; fieldsIter.first != fieldsIter.second;) {
+    auto totalValues = std::vector<std::int32_t>();
+    auto fieldsIter = fields().equal_range(totalFieldId);
+    totalValues.reserve(fieldsDist);
+    // note: Counting the fields instead of comparing with fieldsIter.second as erasing might invalidate it (depending on the container).
+    for (auto remaining = fieldsDist; remaining; --remaining) {
         try {
             totalValues.emplace_back(fieldsIter.first->second.value().toInteger());
-            fields().erase(fieldsIter.first++);
+            fieldsIter.first = fields().erase(fieldsIter.first);
         } catch (const ConversionException &e) {
             diag.emplace_back(DiagLevel::Warning, argsToString("Unable to parse \"", totalField, "\" as integer: ", e.what()), diagContext);
             totalValues.emplace_back(0);
@@ -225,15 +172,36 @@ void VorbisComment::convertTotalFields(const std::string &diagContext, Diagnosti
     extendPositionInSetField(VorbisCommentIds::partNumber(), VorbisCommentIds::partTotal(), diagContext, diag);
 }
 
+/*!
+ * \brief Returns whether the field with the specified \a id is accepted by the specified \a fieldFilter.
+ * \remarks The fields which are combined into PositionInSet values via VorbisCommentFlags::ConvertTotalFields are
+ *          accepted along with the corresponding position field.
+ */
+bool VorbisComment::isFieldAccepted(const TagFieldFilter &fieldFilter, const IdentifierType &id) const
+{
+    if (fieldFilter.accepts(*this, id)) {
+        return true;
+    }
+    const auto isId = [&id, compare = Compare()](std::string_view otherId) { return !compare(id, otherId) && !compare(otherId, id); };
+    return (fieldFilter.acceptsField(KnownField::TrackPosition) && isId(VorbisCommentIds::trackTotal()))
+        || (fieldFilter.acceptsField(KnownField::DiskPosition) && isId(VorbisCommentIds::diskTotal()))
+        || (fieldFilter.acceptsField(KnownField::PartNumber) && isId(VorbisCommentIds::partTotal()));
+}
+
 /*!
  * \brief Internal implementation for parsing.
  */
 template <class StreamType>
-void VorbisComment::internalParse(StreamType &stream, std::uint64_t maxSize, VorbisCommentFlags flags, std::uint64_t &padding, Diagnostics &diag)
+void VorbisComment::internalParse(StreamType &stream, std::uint64_t maxSize, VorbisCommentFlags flags, std::uint64_t &padding, Diagnostics &diag,
+    const TagFieldFilter *fieldFilter)
 {
     // prepare parsing
-    static const string context("parsing Vorbis comment");
+    static const auto context = DiagContext("parsing Vorbis comment");
     const auto startOffset = static_cast<std::uint64_t>(stream.tellg());
+    auto isIdAccepted = std::function<bool(const IdentifierType &)>();
+    if (fieldFilter && fieldFilter->isActive()) {
+        isIdAccepted = [this, fieldFilter](const IdentifierType &id) { return isFieldAccepted(*fieldFilter, id); };
+    }
     try {
         // read signature: 0x3 + "vorbis"
         char sig[8];
@@ -268,8 +236,12 @@ void VorbisComment::internalParse(StreamType &stream, std::uint64_t maxSize, Vor
                 // read fields
                 VorbisCommentField field;
                 try {
-                    field.parse(stream, maxSize, diag);
-                    fields().emplace(field.id(), std::move(field));
+                    if (field.parse(stream, maxSize, diag, isIdAccepted)) {
+                        fields().emplace(field.id(), std::move(field));
+                    } else {
+                        // keep the raw field so it is preserved when making the tag
+                        skippedFields().emplace(field.id(), std::move(field.value()));
+                    }
                 } catch (const TruncatedDataException &) {
                     throw;
                 } catch (const Failure &) {
@@ -280,16 +252,24 @@ void VorbisComment::internalParse(StreamType &stream, std::uint64_t maxSize, Vor
                 stream.ignore(); // skip framing byte
             }
             m_size = static_cast<std::uint64_t>(stream.tellg()) - startOffset;
+            // consider the tag only modified if fields are converted (as they would be written in converted form)
+            m_modified = false;
             // turn "YEAR" into "DATE" (unless "DATE" exists)
             // note: "DATE" is an official field and "YEAR" only an unofficial one but present in some files. In consistency with
             //       MediaInfo and VLC player it is treated like "DATE" here.
             static const auto dateFieldId = std::string(VorbisCommentIds::date()), yearFieldId = std::string(VorbisCommentIds::year());
-            if (fields().find(dateFieldId) == fields().end()) {
+            if (const auto &parsedFields = const_cast<const VorbisComment *>(this)->fields();
+                parsedFields.find(dateFieldId) == parsedFields.end() && parsedFields.find(yearFieldId) != parsedFields.end()) {
                 const auto [first, end] = fields().equal_range(yearFieldId);
+                auto yearFields = std::vector<VorbisCommentField>();
+                yearFields.reserve(static_cast<std::size_t>(std::distance(first, end)));
                 for (auto i = first; i != end; ++i) {
-                    fields().emplace(dateFieldId, std::move(i->second));
+                    yearFields.emplace_back(std::move(i->second));
                 }
                 fields().erase(first, end);
+                for (auto &yearField : yearFields) {
+                    fields().emplace(dateFieldId, std::move(yearField));
+                }
             }
         } else {
             diag.emplace_back(DiagLevel::Critical, "Signature is invalid.", context);
@@ -314,7 +294,7 @@ void VorbisComment::internalParse(StreamType &stream, std::uint64_t maxSize, Vor
             }
         }
         if (bytesRemaining) {
-            diag.emplace_back(DiagLevel::Information, argsToString(bytesRemaining, " bytes left in last segment."), context);
+            diag.emplaceFormatted(DiagLevel::Information, context, bytesRemaining, " bytes left in last segment.");
             padding += bytesRemaining;
         }
     }
@@ -327,39 +307,46 @@ void VorbisComment::internalParse(StreamType &stream, std::uint64_t maxSize, Vor
 /*!
  * \brief Parses tag information using the specified Ogg \a iterator.
  *
+ * Fields not accepted by the specified \a fieldFilter are not decoded. Their raw data is added to skippedFields().
+ *
  * \throws Throws std::ios_base::failure when an IO error occurs.
  * \throws Throws TagParser::Failure or a derived exception when a parsing
  *         error occurs.
  */
-void VorbisComment::parse(OggIterator &iterator, VorbisCommentFlags flags, Diagnostics &diag)
+void VorbisComment::parse(OggIterator &iterator, VorbisCommentFlags flags, Diagnostics &diag, const TagFieldFilter *fieldFilter)
 {
     auto padding = std::uint64_t();
-    internalParse(iterator, iterator.streamSize(), flags, padding, diag);
+    internalParse(iterator, iterator.streamSize(), flags, padding, diag, fieldFilter);
 }
 
 /*!
  * \brief Parses tag information using the specified Ogg \a iterator.
  *
+ * Fields not accepted by the specified \a fieldFilter are not decoded. Their raw data is added to skippedFields().
+ *
  * \throws Throws std::ios_base::failure when an IO error occurs.
  * \throws Throws TagParser::Failure or a derived exception when a parsing
  *         error occurs.
  */
-void VorbisComment::parse(OggIterator &iterator, VorbisCommentFlags flags, std::uint64_t &padding, Diagnostics &diag)
+void VorbisComment::parse(
+    OggIterator &iterator, VorbisCommentFlags flags, std::uint64_t &padding, Diagnostics &diag, const TagFieldFilter *fieldFilter)
 {
-    internalParse(iterator, iterator.streamSize(), flags, padding, diag);
+    internalParse(iterator, iterator.streamSize(), flags, padding, diag, fieldFilter);
 }
 
 /*!
  * \brief Parses tag information using the specified Ogg \a iterator.
  *
+ * Fields not accepted by the specified \a fieldFilter are not decoded. Their raw data is added to skippedFields().
+ *
  * \throws Throws std::ios_base::failure when an IO error occurs.
  * \throws Throws TagParser::Failure or a derived exception when a parsing
  *         error occurs.
  */
-void VorbisComment::parse(istream &stream, std::uint64_t maxSize, VorbisCommentFlags flags, Diagnostics &diag)
+void VorbisComment::parse(istream &stream, std::uint64_t maxSize, VorbisCommentFlags flags, Diagnostics &diag, const TagFieldFilter *fieldFilter)
 {
     auto padding = std::uint64_t();
-    internalParse(stream, maxSize, flags, padding, diag);
+    internalParse(stream, maxSize, flags, padding, diag, fieldFilter);
 }
 
 /// \cond
@@ -388,7 +375,7 @@ static std::uint32_t makeField(VorbisCommentField &field, BinaryWriter &writer,
 void VorbisComment::make(std::ostream &stream, VorbisCommentFlags flags, Diagnostics &diag)
 {
     // prepare making
-    static const string context("making Vorbis comment");
+    static const auto context = DiagContext("making Vorbis comment");
     string vendor;
     try {
         m_vendor.toString(vendor);
@@ -410,12 +397,19 @@ void VorbisComment::make(std::ostream &stream, VorbisCommentFlags flags, Diagnos
     // write fields
     std::uint32_t fieldsWritten = 0;
     static const auto coverId = std::string(VorbisCommentIds::cover());
-    for (auto &i : fields()) {
+    // note: The fields are accessed via internallyGetFields() so the comment is not considered modified by just making it.
+    auto &fields = internallyGetFields();
+    for (auto &i : fields) {
         if (i.first != coverId) { // write cover at the end
             fieldsWritten += makeField(i.second, writer, flags, diag);
         }
     }
-    if (const auto cover = fields().find(coverId); cover != fields().end()) {
+    for (const auto &[id, rawField] : internallyGetSkippedFields()) {
+        writer.writeUInt32LE(static_cast<std::uint32_t>(rawField.dataSize()));
+        writer.write(rawField.dataPointer(), static_cast<std::streamsize>(rawField.dataSize()));
+        ++fieldsWritten;
+    }
+    if (const auto cover = fields.find(coverId); cover != fields.end()) {
         fieldsWritten += makeField(cover->second, writer, flags, diag);
     }
     // write field count
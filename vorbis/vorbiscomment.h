@@ -13,6 +13,7 @@ namespace TagParser {
 
 class OggIterator;
 class VorbisComment;
+class TagFieldFilter;
 class Diagnostics;
 
 /*!
@@ -22,10 +23,12 @@ template <> class TAG_PARSER_EXPORT FieldMapBasedTagTraits<VorbisComment> {
 public:
     using FieldType = VorbisCommentField;
     using Compare = CaseInsensitiveStringComparer;
+    template <typename Key, typename Value, typename KeyCompare> using Container = FlatMultiMap<Key, Value, KeyCompare>;
 };
 
 class TAG_PARSER_EXPORT VorbisComment : public FieldMapBasedTag<VorbisComment> {
     friend class FieldMapBasedTag<VorbisComment>;
+    friend class FlacStream;
     friend class ::OverallTests;
 
 public:
@@ -41,9 +44,10 @@ public:
     using FieldMapBasedTag<VorbisComment>::setValue;
     bool setValue(KnownField field, const TagValue &value) override;
 
-    void parse(OggIterator &iterator, VorbisCommentFlags flags, Diagnostics &diag);
-    void parse(OggIterator &iterator, VorbisCommentFlags flags, std::uint64_t &padding, Diagnostics &diag);
-    void parse(std::istream &stream, std::uint64_t maxSize, VorbisCommentFlags flags, Diagnostics &diag);
+    void parse(OggIterator &iterator, VorbisCommentFlags flags, Diagnostics &diag, const TagFieldFilter *fieldFilter = nullptr);
+    void parse(
+        OggIterator &iterator, VorbisCommentFlags flags, std::uint64_t &padding, Diagnostics &diag, const TagFieldFilter *fieldFilter = nullptr);
+    void parse(std::istream &stream, std::uint64_t maxSize, VorbisCommentFlags flags, Diagnostics &diag, const TagFieldFilter *fieldFilter = nullptr);
     void make(std::ostream &stream, VorbisCommentFlags flags, Diagnostics &diag);
 
     const TagValue &vendor() const;
@@ -56,7 +60,9 @@ protected:
 
 private:
     template <class StreamType>
-    void internalParse(StreamType &stream, std::uint64_t maxSize, VorbisCommentFlags flags, std::uint64_t &padding, Diagnostics &diag);
+    void internalParse(StreamType &stream, std::uint64_t maxSize, VorbisCommentFlags flags, std::uint64_t &padding, Diagnostics &diag,
+        const TagFieldFilter *fieldFilter);
+    bool isFieldAccepted(const TagFieldFilter &fieldFilter, const IdentifierType &id) const;
     void extendPositionInSetField(std::string_view field, std::string_view totalField, const std::string &diagContext, Diagnostics &diag);
     void convertTotalFields(const std::string &diagContext, Diagnostics &diag);
 
@@ -91,7 +97,10 @@ inline const TagValue &VorbisComment::vendor() const
  */
 inline void VorbisComment::setVendor(const TagValue &vendor)
 {
-    m_vendor = vendor;
+    if (!m_vendor.compareTo(vendor, TagValueComparisionFlags::Exact)) {
+        m_vendor = vendor;
+        m_modified = true;
+    }
 }
 
 /*!
@@ -45,9 +45,11 @@ VorbisCommentField::VorbisCommentField(const IdentifierType &id, const TagValue
 /*!
  * \brief Internal implementation for parsing.
  */
-template <class StreamType> void VorbisCommentField::internalParse(StreamType &stream, std::uint64_t &maxSize, Diagnostics &diag)
+template <class StreamType>
+bool VorbisCommentField::internalParse(
+    StreamType &stream, std::uint64_t &maxSize, Diagnostics &diag, const std::function<bool(const IdentifierType &)> &isIdAccepted)
 {
-    static const string context("parsing Vorbis comment  field");
+    static const auto context = DiagContext("parsing Vorbis comment  field");
     char buff[4];
     if (maxSize < 4) {
         diag.emplace_back(DiagLevel::Critical, argsToString("Field expected at ", static_cast<std::streamoff>(stream.tellg()), '.'), context);
@@ -72,6 +74,10 @@ template <class StreamType> void VorbisCommentField::internalParse(StreamType &s
                 diag.emplace_back(
                     DiagLevel::Critical, argsToString("The field ID at ", static_cast<std::streamoff>(stream.tellg()), " is empty."), context);
                 throw InvalidDataException();
+            } else if (isIdAccepted && !isIdAccepted(id())) {
+                // keep the raw data (ID and value) without decoding it
+                value().assignData(std::move(data), size, TagDataType::Binary);
+                return false;
             } else if (id() == VorbisCommentIds::cover()) {
                 // extract cover value
                 try {
@@ -118,6 +124,7 @@ template <class StreamType> void VorbisCommentField::internalParse(StreamType &s
             throw TruncatedDataException();
         }
     }
+    return true;
 }
 
 /*!
@@ -133,7 +140,7 @@ template <class StreamType> void VorbisCommentField::internalParse(StreamType &s
 void VorbisCommentField::parse(OggIterator &iterator, Diagnostics &diag)
 {
     std::uint64_t maxSize = iterator.streamSize() - iterator.currentCharacterOffset();
-    internalParse(iterator, maxSize, diag);
+    internalParse(iterator, maxSize, diag, std::function<bool(const IdentifierType &)>());
 }
 
 /*!
@@ -142,13 +149,18 @@ void VorbisCommentField::parse(OggIterator &iterator, Diagnostics &diag)
  * The currentCharacterOffset() of the iterator is expected to be
  * at the beginning of the field to be parsed.
  *
+ * If \a isIdAccepted is specified and returns false for the field's ID, the value is not decoded. Instead, the raw
+ * data (ID and value) is assigned as binary value.
+ *
+ * \returns Returns whether the value has been decoded.
  * \throws Throws std::ios_base::failure when an IO error occurs.
  * \throws Throws TagParser::Failure or a derived exception when a parsing
  *         error occurs.
  */
-void VorbisCommentField::parse(OggIterator &iterator, std::uint64_t &maxSize, Diagnostics &diag)
+bool VorbisCommentField::parse(
+    OggIterator &iterator, std::uint64_t &maxSize, Diagnostics &diag, const std::function<bool(const IdentifierType &)> &isIdAccepted)
 {
-    internalParse(iterator, maxSize, diag);
+    return internalParse(iterator, maxSize, diag, isIdAccepted);
 }
 
 /*!
@@ -157,13 +169,18 @@ void VorbisCommentField::parse(OggIterator &iterator, std::uint64_t &maxSize, Di
  * The position of the current character in the input stream is expected to be
  * at the beginning of the field to be parsed.
  *
+ * If \a isIdAccepted is specified and returns false for the field's ID, the value is not decoded. Instead, the raw
+ * data (ID and value) is assigned as binary value.
+ *
+ * \returns Returns whether the value has been decoded.
  * \throws Throws std::ios_base::failure when an IO error occurs.
  * \throws Throws TagParser::Failure or a derived exception when a parsing
  *         error occurs.
  */
-void VorbisCommentField::parse(istream &stream, std::uint64_t &maxSize, Diagnostics &diag)
+bool VorbisCommentField::parse(
+    istream &stream, std::uint64_t &maxSize, Diagnostics &diag, const std::function<bool(const IdentifierType &)> &isIdAccepted)
 {
-    internalParse(stream, maxSize, diag);
+    return internalParse(stream, maxSize, diag, isIdAccepted);
 }
 
 /*!
@@ -177,7 +194,7 @@ void VorbisCommentField::parse(istream &stream, std::uint64_t &maxSize, Diagnost
  */
 bool VorbisCommentField::make(BinaryWriter &writer, VorbisCommentFlags flags, Diagnostics &diag)
 {
-    static const string context("making Vorbis comment  field");
+    static const auto context = DiagContext("making Vorbis comment  field");
     if (id().empty()) {
         diag.emplace_back(DiagLevel::Critical, "The field ID is empty.", context);
     }
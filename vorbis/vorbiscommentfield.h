@@ -5,6 +5,8 @@
 
 #include <c++utilities/misc/flagenumclass.h>
 
+#include <functional>
+
 namespace CppUtilities {
 class BinaryReader;
 class BinaryWriter;
@@ -51,8 +53,10 @@ public:
     VorbisCommentField(const IdentifierType &id, const TagValue &value);
 
     void parse(OggIterator &iterator, Diagnostics &diag);
-    void parse(OggIterator &iterator, std::uint64_t &maxSize, Diagnostics &diag);
-    void parse(std::istream &stream, std::uint64_t &maxSize, Diagnostics &diag);
+    bool parse(OggIterator &iterator, std::uint64_t &maxSize, Diagnostics &diag,
+        const std::function<bool(const IdentifierType &)> &isIdAccepted = std::function<bool(const IdentifierType &)>());
+    bool parse(std::istream &stream, std::uint64_t &maxSize, Diagnostics &diag,
+        const std::function<bool(const IdentifierType &)> &isIdAccepted = std::function<bool(const IdentifierType &)>());
     bool make(CppUtilities::BinaryWriter &writer, VorbisCommentFlags flags, Diagnostics &diag);
     bool isAdditionalTypeInfoUsed() const;
     bool supportsNestedFields() const;
@@ -61,7 +65,9 @@ public:
     static std::string fieldIdToString(const std::string &id);
 
 private:
-    template <class StreamType> void internalParse(StreamType &stream, std::uint64_t &maxSize, Diagnostics &diag);
+    template <class StreamType>
+    bool internalParse(
+        StreamType &stream, std::uint64_t &maxSize, Diagnostics &diag, const std::function<bool(const IdentifierType &)> &isIdAccepted);
 };
 
 /*!
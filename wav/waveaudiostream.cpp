@@ -148,7 +148,7 @@ void WaveAudioStream::internalParseHeader(Diagnostics &diag, AbortableProgressFe
 {
     CPP_UTILITIES_UNUSED(progress)
 
-    const string context("parsing RIFF/WAVE header");
+    static const auto context = DiagContext("parsing RIFF/WAVE header");
     if (!m_istream) {
         throw NoDataFoundException();
     }